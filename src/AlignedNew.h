@@ -0,0 +1,42 @@
+//============================================================================
+// Name        : AlignedNew.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : A new and delete for classes aligned to more than new
+//               promises.
+//
+//               Our lock-free queues and the work-stealing deque keep the
+//               indexes that different threads write on separate cache
+//               lines, with alignas(64).  That holds for a global or a
+//               local, but a plain new only promises the alignment of a
+//               long double, usually 16, until C++17's aligned new.  A
+//               class that holds one of them, and is made with new,
+//               derives from AlignedNew<itself>, whose operator new asks
+//               posix_memalign() for the class's own alignment.
+//
+//               It has no members, so it adds nothing to the class's size.
+//
+//============================================================================
+
+#ifndef ALIGNED_NEW_H
+#define ALIGNED_NEW_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+template <typename T>
+struct AlignedNew {
+    static void *operator new(size_t bytes)
+    {
+        void *memory = nullptr;
+        if (posix_memalign(&memory, alignof(T), bytes) != 0)
+            throw std::bad_alloc();
+        return memory;
+    }
+
+    static void operator delete(void *memory) { free(memory); }
+};
+
+#endif // ALIGNED_NEW_H
@@ -0,0 +1,513 @@
+//============================================================================
+// Name        : ChunkCuller.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Culls the chunks of a big mesh against the view, through a
+//               bounding volume hierarchy, on a few threads.
+//
+//============================================================================
+
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+#include "ChunkCuller.h"
+#include "DebugLog.h"
+#include "FrameBenchmark.h"
+
+static bool Overlaps(const GLfloat aMin[3], const GLfloat aMax[3],
+                     const GLfloat bMin[3], const GLfloat bMax[3])
+{
+    for (int a = 0; a < 3; a++) {
+        if (aMax[a] < bMin[a] || aMin[a] > bMax[a])
+            return false;
+    }
+
+    return true;
+}
+
+static bool Contains(const GLfloat outerMin[3], const GLfloat outerMax[3],
+                     const GLfloat innerMin[3], const GLfloat innerMax[3])
+{
+    for (int a = 0; a < 3; a++) {
+        if (innerMin[a] < outerMin[a] || innerMax[a] > outerMax[a])
+            return false;
+    }
+
+    return true;
+}
+
+ChunkCuller::ChunkCuller()
+    : triangleCount(0),
+      buildMs(0.0),
+      threadCount(1),
+      frameNumber(0),
+      stopping(false),
+      nextTask(0),
+      finishedTasks(0)
+{
+}
+
+ChunkCuller::~ChunkCuller()
+{
+    Destroy();
+}
+
+void ChunkCuller::SetThreads(int count)
+{
+    if (count <= 0) {
+        count = static_cast<int>(std::thread::hardware_concurrency());
+        if (count <= 0)
+            count = 1;
+    }
+
+    threadCount = count;
+}
+
+bool ChunkCuller::Build(const Pipeline &pipeline, int chunkTriangles)
+{
+    std::chrono::steady_clock::time_point begin =
+        std::chrono::steady_clock::now();
+
+    if (!ReadChunks(pipeline, chunkTriangles)) {
+        chunks.clear();
+        return false;
+    }
+
+    chunkOrder.resize(chunks.size());
+    for (size_t i = 0; i < chunks.size(); i++)
+        chunkOrder[i] = static_cast<int>(i);
+
+    nodes.clear();
+    BuildNode(0, static_cast<int>(chunks.size()));
+    SplitTasks();
+
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - begin;
+    buildMs = elapsed.count();
+
+    // the render thread is one of them
+    int count = std::min(threadCount, static_cast<int>(tasks.size()));
+    for (int t = 1; t < count; t++)
+        workers.push_back(std::thread(&ChunkCuller::RunTasks, this));
+
+    return true;
+}
+
+bool ChunkCuller::ReadChunks(const Pipeline &pipeline, int chunkTriangles)
+{
+    VertexFormat format = pipeline.Format();
+
+    const VertexAttribute *position = nullptr;
+    for (int i = 0; i < format.AttributeCount(); i++) {
+        if (format.Attributes()[i].location == 0)
+            position = &format.Attributes()[i];
+    }
+
+    if (position == nullptr || position->components < 2 ||
+        (position->type != GL_FLOAT && position->type != GL_HALF_FLOAT)) {
+        Log("Can't cull this mesh: the position must be attribute 0, "
+            "of 2 or more floats or half floats");
+        return false;
+    }
+
+    GLsizei elements = pipeline.Count();
+    GLenum indexType = pipeline.IndexType();
+    triangleCount = elements / 3;
+
+    if (triangleCount == 0 || format.Stride() <= 0) {
+        Log("Can't cull an empty mesh");
+        return false;
+    }
+
+    // Note: this is behind the state cache's back, like all our setup
+    glBindBuffer(GL_ARRAY_BUFFER, pipeline.VertexBuffer());
+
+    GLint bufferSize = 0;
+    glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &bufferSize);
+    GLsizei vertexCount = bufferSize / format.Stride();
+
+    const GLubyte *vertices = static_cast<const GLubyte *>(
+                                  glMapBuffer(GL_ARRAY_BUFFER, GL_READ_ONLY));
+
+    // the index buffer is bound through the vertex array
+    const GLvoid *indices = nullptr;
+    if (indexType != 0) {
+        glBindVertexArray(pipeline.VertexArray());
+        indices = glMapBuffer(GL_ELEMENT_ARRAY_BUFFER, GL_READ_ONLY);
+    }
+
+    bool read = vertices != nullptr && (indexType == 0 || indices != nullptr);
+
+    if (read) {
+        GLsizei chunkElements = static_cast<GLsizei>(chunkTriangles) * 3;
+        chunks.clear();
+
+        for (GLsizei first = 0; first + 3 <= elements && read;
+             first += chunkElements) {
+            Chunk chunk;
+            chunk.first = first;
+            chunk.count = std::min(chunkElements, (elements - first) / 3 * 3);
+
+            for (int a = 0; a < 3; a++) {
+                chunk.bounds.min[a] = 1e30f;
+                chunk.bounds.max[a] = -1e30f;
+            }
+
+            for (GLsizei e = first; e < first + chunk.count; e++) {
+                GLuint vertex = static_cast<GLuint>(e);
+                if (indexType == GL_UNSIGNED_SHORT)
+                    vertex = static_cast<const GLushort *>(indices)[e];
+                else if (indexType == GL_UNSIGNED_INT)
+                    vertex = static_cast<const GLuint *>(indices)[e];
+
+                if (vertex >= static_cast<GLuint>(vertexCount)) {
+                    Log("Can't cull this mesh: index %u is past the end of "
+                        "the vertex buffer", vertex);
+                    read = false;
+                    break;
+                }
+
+                const GLubyte *p = vertices +
+                                   static_cast<size_t>(vertex) *
+                                   format.Stride() + position->offset;
+
+                GLfloat xyz[3] = {0.0f, 0.0f, 0.0f};
+                for (int a = 0; a < 3 && a < position->components; a++) {
+                    if (position->type == GL_FLOAT)
+                        xyz[a] = reinterpret_cast<const GLfloat *>(p)[a];
+                    else
+                        xyz[a] = FromHalfFloat(
+                                     reinterpret_cast<const HalfFloat *>(p)[a]);
+                }
+
+                for (int a = 0; a < 3; a++) {
+                    chunk.bounds.min[a] = std::min(chunk.bounds.min[a],
+                                                   xyz[a]);
+                    chunk.bounds.max[a] = std::max(chunk.bounds.max[a],
+                                                   xyz[a]);
+                }
+            }
+
+            chunks.push_back(chunk);
+        }
+    }
+    else {
+        Log("Couldn't read the mesh back to cull it");
+    }
+
+    if (indices != nullptr)
+        glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+    if (indexType != 0)
+        glBindVertexArray(0);
+
+    if (vertices != nullptr)
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return read && !chunks.empty();
+}
+
+int ChunkCuller::BuildNode(int firstChunk, int chunkCount)
+{
+    Node node;
+    node.left = node.right = -1;
+    node.firstChunk = firstChunk;
+    node.chunkCount = chunkCount;
+    node.bounds = chunks[chunkOrder[firstChunk]].bounds;
+
+    for (int i = firstChunk + 1; i < firstChunk + chunkCount; i++) {
+        const Box &box = chunks[chunkOrder[i]].bounds;
+        for (int a = 0; a < 3; a++) {
+            node.bounds.min[a] = std::min(node.bounds.min[a], box.min[a]);
+            node.bounds.max[a] = std::max(node.bounds.max[a], box.max[a]);
+        }
+    }
+
+    // Note: the children are pushed after us, so we fill them in through
+    //       an index; a reference would not survive the vector growing
+    int index = static_cast<int>(nodes.size());
+    nodes.push_back(node);
+
+    if (chunkCount <= LeafChunks)
+        return index;
+
+    // split the chunks in half, by their centers along the longest side
+    int axis = 0;
+    for (int a = 1; a < 3; a++) {
+        if (node.bounds.max[a] - node.bounds.min[a] >
+            node.bounds.max[axis] - node.bounds.min[axis])
+            axis = a;
+    }
+
+    std::vector<int>::iterator first = chunkOrder.begin() + firstChunk;
+    int half = chunkCount / 2;
+
+    std::nth_element(first, first + half, first + chunkCount,
+                     [&](int a, int b) {
+        return chunks[a].bounds.min[axis] + chunks[a].bounds.max[axis] <
+               chunks[b].bounds.min[axis] + chunks[b].bounds.max[axis];
+    });
+
+    int left = BuildNode(firstChunk, half);
+    int right = BuildNode(firstChunk + half, chunkCount - half);
+    nodes[index].left = left;
+    nodes[index].right = right;
+
+    return index;
+}
+
+void ChunkCuller::SplitTasks()
+{
+    // Take the tree apart from the top until there are a few subtrees for
+    // each thread, so that a thread that drew a small one takes another.
+    size_t wanted = static_cast<size_t>(threadCount) * 4;
+
+    tasks.assign(1, 0);
+    while (tasks.size() < wanted) {
+        std::vector<int> next;
+        for (size_t i = 0; i < tasks.size(); i++) {
+            const Node &node = nodes[tasks[i]];
+            if (node.left < 0) {
+                next.push_back(tasks[i]);
+            }
+            else {
+                next.push_back(node.left);
+                next.push_back(node.right);
+            }
+        }
+
+        if (next.size() == tasks.size())
+            break;
+        tasks.swap(next);
+    }
+
+    results.assign(tasks.size(), TaskResult());
+}
+
+void ChunkCuller::CullNode(int index, TaskResult &result) const
+{
+    const Node &node = nodes[index];
+
+    if (!Overlaps(node.bounds.min, node.bounds.max,
+                  viewBox.min, viewBox.max))
+        return;
+
+    if (Contains(viewBox.min, viewBox.max, node.bounds.min, node.bounds.max)) {
+        TakeAll(index, result);
+        return;
+    }
+
+    if (node.left >= 0) {
+        CullNode(node.left, result);
+        CullNode(node.right, result);
+        return;
+    }
+
+    for (int i = node.firstChunk; i < node.firstChunk + node.chunkCount;
+         i++) {
+        const Box &box = chunks[chunkOrder[i]].bounds;
+        if (Overlaps(box.min, box.max, viewBox.min, viewBox.max))
+            result.visible.push_back(chunkOrder[i]);
+    }
+}
+
+void ChunkCuller::TakeAll(int index, TaskResult &result) const
+{
+    const Node &node = nodes[index];
+
+    result.visible.insert(result.visible.end(),
+                          chunkOrder.begin() + node.firstChunk,
+                          chunkOrder.begin() + node.firstChunk +
+                          node.chunkCount);
+}
+
+void ChunkCuller::RunTasks()
+{
+    long long seen = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait(lock, [&]() {
+                return stopping || frameNumber != seen;
+            });
+
+            if (stopping)
+                return;
+            seen = frameNumber;
+        }
+
+        Work();
+    }
+}
+
+void ChunkCuller::Work()
+{
+    int count = static_cast<int>(tasks.size());
+
+    for (;;) {
+        int task = nextTask.fetch_add(1);
+        if (task >= count)
+            break;
+
+        results[task].visible.clear();
+        CullNode(tasks[task], results[task]);
+
+        finishedTasks.fetch_add(1);
+    }
+}
+
+void ChunkCuller::Cull(const GLfloat view[4])
+{
+    if (!Enabled())
+        return;
+
+    std::chrono::steady_clock::time_point begin =
+        std::chrono::steady_clock::now();
+
+    // What the view maps onto the screen, from -1 to 1, in the mesh's
+    // coordinates.  It doesn't move z, so the near and far planes stay put.
+    for (int a = 0; a < 2; a++) {
+        GLfloat low = (-1.0f - view[2 + a]) / view[a];
+        GLfloat high = (1.0f - view[2 + a]) / view[a];
+        viewBox.min[a] = std::min(low, high);
+        viewBox.max[a] = std::max(low, high);
+    }
+    viewBox.min[2] = -1.0f;
+    viewBox.max[2] = 1.0f;
+
+    // Note: the view box is written before the tasks are handed out, and
+    //       the atomics order it for the workers
+    finishedTasks.store(0);
+    nextTask.store(0);
+
+    if (!workers.empty()) {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        frameNumber++;
+    }
+    wake.notify_all();
+
+    // this thread does its share too, then waits for the stragglers
+    Work();
+    while (finishedTasks.load() < static_cast<int>(tasks.size()))
+        std::this_thread::yield();
+
+    std::vector<int> visible;
+    for (size_t i = 0; i < results.size(); i++)
+        visible.insert(visible.end(), results[i].visible.begin(),
+                       results[i].visible.end());
+
+    // Chunks next to each other in the buffer are drawn with one call
+    std::sort(visible.begin(), visible.end());
+
+    rangeFirst.clear();
+    rangeCount.clear();
+
+    FrameStats stats;
+    stats.submitted = static_cast<int>(visible.size());
+    stats.culled = static_cast<int>(chunks.size() - visible.size());
+    stats.triangles = 0;
+
+    for (size_t i = 0; i < visible.size(); i++) {
+        const Chunk &chunk = chunks[visible[i]];
+        stats.triangles += chunk.count / 3;
+
+        if (i > 0 && visible[i] == visible[i - 1] + 1)
+            rangeCount.back() += chunk.count;
+        else {
+            rangeFirst.push_back(chunk.first);
+            rangeCount.push_back(chunk.count);
+        }
+    }
+
+    stats.drawCalls = static_cast<int>(rangeFirst.size());
+
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - begin;
+    stats.cullMs = elapsed.count();
+
+    frames.push_back(stats);
+}
+
+void ChunkCuller::Draw(const Pipeline &pipeline) const
+{
+    pipeline.Bind();
+
+    for (size_t i = 0; i < rangeFirst.size(); i++)
+        pipeline.DrawRange(rangeFirst[i], rangeCount[i]);
+}
+
+void ChunkCuller::Destroy()
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (size_t i = 0; i < workers.size(); i++)
+        workers[i].join();
+    workers.clear();
+
+    stopping = false;
+}
+
+void ChunkCuller::Report(std::ostream &out) const
+{
+    if (!Enabled())
+        return;
+
+    int chunkTriangles = chunks[0].count / 3;
+
+    out << std::fixed << std::setprecision(3)
+        << "Culling: " << chunks.size() << " chunks of " << chunkTriangles
+        << " triangles, " << nodes.size() << " nodes, " << tasks.size()
+        << " subtrees on " << workers.size() + 1 << " threads, built in "
+        << buildMs << " ms" << std::endl;
+
+    if (frames.empty()) {
+        out.unsetf(std::ios_base::floatfield);
+        out << std::setprecision(6);
+        return;
+    }
+
+    std::vector<double> sorted;
+    double submitted = 0.0;
+    double culled = 0.0;
+    double drawCalls = 0.0;
+    double triangles = 0.0;
+
+    for (size_t i = 0; i < frames.size(); i++) {
+        sorted.push_back(frames[i].cullMs);
+        submitted += frames[i].submitted;
+        culled += frames[i].culled;
+        drawCalls += frames[i].drawCalls;
+        triangles += static_cast<double>(frames[i].triangles);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    double n = static_cast<double>(frames.size());
+    double meanMs = 0.0;
+    for (size_t i = 0; i < sorted.size(); i++)
+        meanMs += sorted[i];
+    meanMs /= n;
+
+    out << "    cull " << meanMs << " ms mean, "
+        << Percentile(sorted, 99.0) << " ms p99, " << sorted.back()
+        << " ms max" << std::endl
+        << std::setprecision(1)
+        << "    per frame: " << submitted / n << " chunks submitted ("
+        << 100.0 * submitted / (n * chunks.size()) << "%), "
+        << culled / n << " culled, " << drawCalls / n << " draw calls, "
+        << triangles / n << " of " << triangleCount << " triangles"
+        << std::endl;
+
+    out.unsetf(std::ios_base::floatfield);
+    out << std::setprecision(6);
+}
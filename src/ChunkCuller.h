@@ -0,0 +1,174 @@
+//============================================================================
+// Name        : ChunkCuller.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Draws only the parts of a big mesh that are in view.
+//
+//               A Pipeline draws all of its vertices, every frame, whether
+//               they end up on screen or not.  With a mesh of millions of
+//               triangles, zoomed in so that only a corner of it shows,
+//               the GPU spends nearly all its time on vertices that are
+//               clipped away.
+//
+//               Build() reads the mesh back once, splits it into chunks of
+//               a fixed number of consecutive triangles, and works out the
+//               bounding box of each.  The chunks go into a bounding volume
+//               hierarchy: a binary tree of boxes, each split along its
+//               longest side, down to a few chunks per leaf.
+//
+//               Each frame, Cull() walks the tree against the view volume.
+//               Our view is an orthographic 2D pan and zoom (see
+//               Pipeline::SetView()), so the view volume is a box, and the
+//               test is box against box.  A node that is entirely outside
+//               is skipped with everything under it, and a node entirely
+//               inside is taken whole, without testing its children.
+//
+//               The top of the tree is cut into subtrees, which a few
+//               worker threads (kept between frames) and the render thread
+//               share out through an atomic counter, the same way the
+//               MeshGenerator shares out rows.  The visible chunks are then
+//               sorted, and neighbouring chunks merged, so that Draw() can
+//               submit them through the pipeline with as few glDrawArrays()
+//               (or glDrawElements()) calls as possible.
+//
+//               Report() says how long the culling took, and how many
+//               chunks and triangles were submitted and culled, per frame.
+//
+//============================================================================
+
+#ifndef CHUNK_CULLER_H
+#define CHUNK_CULLER_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include "Pipeline.h"
+
+class ChunkCuller {
+public:
+    static const int DefaultChunkTriangles = 1024;
+
+    ChunkCuller();
+    ~ChunkCuller();
+
+    // threads to cull on, including the render thread, 0 for one per core.
+    // Call before Build().
+    void SetThreads(int count);
+
+    // Read the pipeline's mesh back, and build the hierarchy over chunks
+    // of chunkTriangles triangles.  The position must be attribute 0, of
+    // floats or half floats.  Needs a current context, with the vertex
+    // (and index) buffer of the pipeline.
+    bool Build(const Pipeline &pipeline,
+               int chunkTriangles = DefaultChunkTriangles);
+
+    // Find the chunks inside the pipeline's view.  Render thread only.
+    void Cull(const GLfloat view[4]);
+
+    // Draw the chunks that the last Cull() found, through the pipeline
+    void Draw(const Pipeline &pipeline) const;
+
+    // stop the worker threads
+    void Destroy();
+
+    bool Enabled() const { return !chunks.empty(); }
+
+    // the triangles that the last Cull() found
+    long long TrianglesDrawn() const
+    {
+        return frames.empty() ? 0 : frames.back().triangles;
+    }
+
+    void Report(std::ostream &out) const;
+
+private:
+    ChunkCuller(const ChunkCuller &);
+    ChunkCuller &operator=(const ChunkCuller &);
+
+    // a leaf holds at most this many chunks
+    static const int LeafChunks = 4;
+
+    struct Box {
+        GLfloat min[3];
+        GLfloat max[3];
+    };
+
+    struct Chunk {
+        Box bounds;
+        GLint first;        // vertex, or index, of the first triangle
+        GLsizei count;      // vertices, or indices
+    };
+
+    // An inner node has two children, left and right, and a leaf has
+    // none (left is -1).  Either way, all the chunks under a node are one
+    // run of chunkOrder, chunkCount long from firstChunk.
+    struct Node {
+        Box bounds;
+        int left;
+        int right;
+        int firstChunk;
+        int chunkCount;
+    };
+
+    // what one subtree found
+    struct TaskResult {
+        std::vector<int> visible;
+    };
+
+    struct FrameStats {
+        double cullMs;
+        int submitted;
+        int culled;
+        int drawCalls;
+        long long triangles;
+    };
+
+    bool ReadChunks(const Pipeline &pipeline, int chunkTriangles);
+    int BuildNode(int firstChunk, int chunkCount);
+    void SplitTasks();
+
+    // cull the subtree under node, into result
+    void CullNode(int node, TaskResult &result) const;
+    void TakeAll(int node, TaskResult &result) const;
+    void RunTasks();
+    void Work();
+
+    std::vector<Chunk> chunks;
+    std::vector<int> chunkOrder;
+    std::vector<Node> nodes;
+    std::vector<int> tasks;             // the subtree roots
+    std::vector<TaskResult> results;    // one per task
+    long long triangleCount;
+    double buildMs;
+
+    // the view volume of this frame, in the mesh's coordinates
+    Box viewBox;
+
+    // the merged ranges Draw() submits
+    std::vector<GLint> rangeFirst;
+    std::vector<GLsizei> rangeCount;
+
+    // The workers wait for a new frame number, and share the tasks out
+    // through nextTask.  finishedTasks tells the render thread when
+    // they are all done.
+    int threadCount;
+    std::vector<std::thread> workers;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    long long frameNumber;
+    bool stopping;
+    std::atomic<int> nextTask;
+    std::atomic<int> finishedTasks;
+
+    std::vector<FrameStats> frames;
+};
+
+#endif // CHUNK_CULLER_H
@@ -0,0 +1,195 @@
+//============================================================================
+// Name        : DebugLog.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Diagnostics that never hold up the thread that logs them.
+//
+//============================================================================
+
+#include <iostream>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "DebugLog.h"
+
+// how long the writer sleeps when there is nothing to write
+static const int IdleMilliseconds = 5;
+
+DebugLog::DebugLog()
+    : out(&std::cout),
+      stopping(false),
+      dropped(0),
+      droppedReported(0)
+{
+}
+
+DebugLog::~DebugLog()
+{
+    Stop();
+}
+
+DebugLog &DebugLog::Global()
+{
+    // Note: constructed on first use, after cout, so it is destroyed, and
+    //       written out, before cout is
+    static DebugLog log;
+    return log;
+}
+
+void DebugLog::Start(std::ostream &out)
+{
+    if (writer.joinable())
+        return;
+
+    this->out = &out;
+    stopping = false;
+    writer = std::thread(&DebugLog::Run, this);
+}
+
+void DebugLog::Flush()
+{
+    // Note: rather than wait for the writer to wake up, which could take
+    //       IdleMilliseconds, we write it out ourselves.  If the writer is
+    //       part way through a batch, Drain() waits for it to finish.
+    Drain();
+}
+
+void DebugLog::Stop()
+{
+    stopping = true;
+    if (writer.joinable())
+        writer.join();
+
+    // whatever came in after the writer's last look
+    Drain();
+}
+
+void DebugLog::Write(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    WriteV(format, args);
+    va_end(args);
+}
+
+void DebugLog::WriteV(const char *format, va_list args)
+{
+    char text[RecordSize];
+
+    va_list again;
+    va_copy(again, args);
+    int length = std::vsnprintf(text, sizeof(text), format, args);
+
+    if (length < 0) {
+        va_end(again);
+        return;
+    }
+
+    if (static_cast<size_t>(length) < sizeof(text)) {
+        va_end(again);
+
+        // Note: one record, unless it has lines of its own
+        if (std::memchr(text, '\n', length) == nullptr)
+            Push(text, length);
+        else
+            WriteText(text);
+        return;
+    }
+
+    // Note: only a long message pays for the allocation
+    std::vector<char> longText(length + 1);
+    std::vsnprintf(longText.data(), longText.size(), format, again);
+    va_end(again);
+
+    WriteText(longText.data());
+}
+
+void DebugLog::WriteText(const char *text)
+{
+    const char *end = text + std::strlen(text);
+
+    // a trailing newline doesn't make an empty line
+    if (end > text && end[-1] == '\n')
+        end--;
+
+    while (text <= end) {
+        const char *newline = static_cast<const char *>(
+            std::memchr(text, '\n', end - text));
+        const char *lineEnd = newline != nullptr ? newline : end;
+
+        // a line too long for a record goes on in the next one
+        do {
+            size_t length = std::min(static_cast<size_t>(lineEnd - text),
+                                     RecordSize - 1);
+            Push(text, length);
+            text += length;
+        } while (text < lineEnd);
+
+        text = lineEnd + 1;
+    }
+}
+
+void DebugLog::Push(const char *text, size_t length)
+{
+    Record record;
+    std::memcpy(record.text, text, length);
+    record.text[length] = '\0';
+
+    if (!ring.Push(record))
+        dropped++;
+}
+
+long long DebugLog::Drain()
+{
+    std::lock_guard<std::mutex> lock(drainMutex);
+
+    Record record;
+    long long count = 0;
+
+    while (ring.Pop(record)) {
+        *out << record.text << '\n';
+        count++;
+    }
+
+    long long droppedNow = dropped;
+    bool reportDropped = droppedNow != droppedReported;
+    if (reportDropped) {
+        *out << "(" << droppedNow - droppedReported
+             << " log messages dropped, the log was full)" << '\n';
+        droppedReported = droppedNow;
+    }
+
+    // Note: one flush for the whole batch
+    if (count > 0 || reportDropped)
+        out->flush();
+
+    return count;
+}
+
+void DebugLog::Run()
+{
+    while (!stopping) {
+        if (Drain() == 0) {
+            std::this_thread::sleep_for(
+                std::chrono::milliseconds(IdleMilliseconds));
+        }
+    }
+}
+
+void Log(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    DebugLog::Global().WriteV(format, args);
+    va_end(args);
+}
+
+void LogText(const char *text)
+{
+    DebugLog::Global().WriteText(text);
+}
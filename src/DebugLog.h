@@ -0,0 +1,109 @@
+//============================================================================
+// Name        : DebugLog.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Diagnostics that never hold up the thread that logs them.
+//
+//               Our messages used to go straight to cout, with endl, which
+//               flushes, so every one was a write() system call on whatever
+//               thread had something to say: the render thread, the shader
+//               reloader, or the driver's own thread, in a debug callback.
+//               Now each message is formatted into a fixed size record, on
+//               the stack, and pushed into a lock-free ring (an MpscQueue,
+//               since any thread may log).  A thread of our own takes them
+//               out and writes them, a batch at a time, with one flush per
+//               batch.  If the ring is full, the record is dropped and
+//               counted, rather than waited for.
+//
+//               A message longer than a record, like a shader info log, is
+//               split into one record per line.  Records from different
+//               threads may come out interleaved, but each thread's come
+//               out in the order it logged them.
+//
+//               Reports still go to cout directly, so Flush() first, to
+//               have the log written out before them.
+//
+//============================================================================
+
+#ifndef DEBUG_LOG_H
+#define DEBUG_LOG_H
+
+#include <atomic>
+#include <cstdarg>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+#include "MpscQueue.h"
+
+class DebugLog {
+public:
+    // records that can wait to be written, and the characters in each,
+    // with the terminator
+    static const size_t Capacity = 1024;
+    static const size_t RecordSize = 256;
+
+    DebugLog();
+    ~DebugLog();
+
+    // the log that Log() and LogText() write to, which is written out to
+    // cout, and stopped at exit
+    static DebugLog &Global();
+
+    // Start the thread that writes the records out.  Until then, they
+    // wait in the ring.
+    void Start(std::ostream &out);
+
+    // Write out everything logged so far, on this thread
+    void Flush();
+
+    // write out what is left, and stop the thread
+    void Stop();
+
+    // printf() style.  Never waits.
+    void Write(const char *format, ...)
+        __attribute__((format(printf, 2, 3)));
+
+    void WriteV(const char *format, va_list args);
+
+    // a text of any length, a record for each line
+    void WriteText(const char *text);
+
+    long long Dropped() const { return dropped; }
+
+private:
+    DebugLog(const DebugLog &);
+    DebugLog &operator=(const DebugLog &);
+
+    struct Record {
+        char text[RecordSize];
+    };
+
+    void Push(const char *text, size_t length);
+
+    // write out whatever is in the ring, and return how much that was
+    long long Drain();
+    void Run();
+
+    MpscQueue<Record, Capacity> ring;
+
+    std::ostream *out;
+    std::thread writer;
+    std::atomic<bool> stopping;
+
+    // Note: producers never touch this.  It only keeps Flush() and Stop()
+    //       from draining the ring while the writer does, since there can
+    //       only be one consumer at a time.
+    std::mutex drainMutex;
+
+    std::atomic<long long> dropped;
+    long long droppedReported;
+};
+
+// DebugLog::Global().Write() and WriteText(), for short
+void Log(const char *format, ...) __attribute__((format(printf, 1, 2)));
+void LogText(const char *text);
+
+#endif // DEBUG_LOG_H
@@ -0,0 +1,1117 @@
+//============================================================================
+// Name        : DemoApp.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Sets up, runs and tears down a Hello Triangle demo.
+//
+//============================================================================
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+using std::cout;
+using std::endl;
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+// GLFW
+#include <GLFW/glfw3.h>
+
+#include "AlignedNew.h"
+#include "DemoApp.h"
+#include "HeadlessContext.h"
+#include "FrameBenchmark.h"
+#include "FrameProfiler.h"
+#include "TriangleBatch.h"
+#include "ProgramCache.h"
+#include "GLStateCache.h"
+#include "GLHandle.h"
+#include "Pipeline.h"
+#include "RenderThread.h"
+#include "FramePacer.h"
+#include "MeshGenerator.h"
+#include "MeshFile.h"
+#include "DemoMesh.h"
+#include "FrameCapture.h"
+#include "ChunkCuller.h"
+#include "ShaderReloader.h"
+#include "DemoSoftware.h"
+#include "DebugLog.h"
+#include "GLDebug.h"
+#include "StartupTrace.h"
+#include "DynamicResolution.h"
+#include "DemoJobs.h"
+
+// Another window, drawing the same geometry as the first, through a
+// context that shares its buffers and program.  It has its own render
+// thread, and its own state cache and vertex array, since those belong to
+// the context.  The render thread's queue is cache line aligned, so new
+// goes through AlignedNew.
+struct SharedWindow : AlignedNew<SharedWindow> {
+    SharedWindow(FramePacer::Mode mode, double fps, int swapInterval)
+        : window(nullptr),
+          profiler(false),
+          pacer(mode, fps, swapInterval)
+    {
+    }
+
+    GLFWwindow *window;
+    GLStateCache stateCache;
+    Pipeline view;
+    FrameProfiler profiler;     // only the first window is profiled
+    FramePacer pacer;
+    RenderThread renderThread;
+};
+
+typedef std::vector<std::unique_ptr<SharedWindow> > SharedWindows;
+
+// forward declarations defined after RunDemo()
+// I like organizing my functions in a top-down fashion
+static void ConfigureGLFW();
+static void report_error(int code, const char * description);
+static void key_callback(GLFWwindow* window,
+                         int key, int scancode, int action, int mode);
+static void framebuffer_size_callback(GLFWwindow* window,
+                                      int width, int height);
+static void window_refresh_callback(GLFWwindow* window);
+static void PanView(Pipeline &pipeline, int zoom, long long frame);
+static void DrawScene(const Pipeline &pipeline, TriangleBatch *batch,
+                      ChunkCuller *culler, FrameProfiler &profiler);
+static void OpenSharedWindows(const DemoOptions &options,
+                              const DemoScene &scene, GLFWwindow *window,
+                              const Pipeline &pipeline,
+                              FramePacer::Mode pacingMode,
+                              SharedWindows &sharedWindows);
+static void StartSharedWindows(SharedWindows &sharedWindows);
+static void CloseSharedWindows(SharedWindows &sharedWindows);
+static void ReportSharedWindows(const FramePacer &pacer,
+                                const SharedWindows &sharedWindows);
+static int RunOnContext(const DemoOptions &options, const DemoScene &scene,
+                        StartupTrace &trace,
+                        std::chrono::steady_clock::time_point startupBegin);
+static bool CreateContext(const DemoOptions &options, const DemoScene &scene,
+                          StartupTrace &trace, HeadlessContext &headless,
+                          GLFWwindow *&window);
+static int RunScene(const DemoOptions &options, const DemoScene &scene,
+                    StartupTrace &trace,
+                    std::chrono::steady_clock::time_point startupBegin,
+                    HeadlessContext &headless, GLFWwindow *window);
+
+int RunDemo(int argc, char *argv[], const DemoScene &scene) {
+    // we report how long it took to get to the first frame
+    std::chrono::steady_clock::time_point startupBegin =
+        std::chrono::steady_clock::now();
+
+    // and where the time went, phase by phase
+    StartupTrace trace(startupBegin);
+    trace.NameThread("main");
+
+    DemoOptions options;
+    if (!ParseDemoOptions(argc, argv, options)) {
+        return -1;
+    }
+
+    // Rendering on the CPU doesn't need OpenGL, or a display
+    if (options.software || options.softwareBenchmark) {
+        return RunSoftwareDemo(options, scene);
+    }
+
+    // From here on, what we have to say goes through the log, written out
+    // on a thread of its own, so that no thread waits on the terminal
+    DebugLog::Global().Start(cout);
+
+    // Every way out goes back through here, so the log is always stopped,
+    // and written out, before we return
+    int result;
+    if (!options.jobsPath.empty()) {
+        // the batch jobs make contexts of their own, one per worker
+        result = RunJobsDemo(options, scene);
+    }
+    else {
+        result = RunOnContext(options, scene, trace, startupBegin);
+    }
+
+    DebugLog::Global().Stop();
+    return result;
+}
+
+// Make the headless context or the window, run the demo on it, and take
+// it down again, whether or not the demo got as far as the first frame
+static int RunOnContext(const DemoOptions &options, const DemoScene &scene,
+                        StartupTrace &trace,
+                        std::chrono::steady_clock::time_point startupBegin)
+{
+    // In headless mode, we don't touch GLFW at all, since it will
+    // want to talk to a display server.
+    HeadlessContext headless;
+    GLFWwindow* window = nullptr;
+
+    int result = -1;
+    if (CreateContext(options, scene, trace, headless, window)) {
+        result = RunScene(options, scene, trace, startupBegin, headless,
+                          window);
+    }
+
+    // Note: RunScene() has let go of everything it made on the context by
+    //       now, one way or another
+    if (options.headless) {
+        headless.Destroy();
+        Log("Destroyed headless context...");
+    }
+    else {
+        glfwTerminate();
+        Log("Terminated GLFW...");
+    }
+
+    return result;
+}
+
+// Note: GLFW can be terminated even if it failed to initialize, so a
+//       failure here leaves nothing for RunOnContext() to skip
+static bool CreateContext(const DemoOptions &options, const DemoScene &scene,
+                          StartupTrace &trace, HeadlessContext &headless,
+                          GLFWwindow *&window)
+{
+    if (options.headless) {
+        trace.Begin("create EGL context");
+        if (!headless.Create()) {
+            Log("Failed to create headless context");
+            return false;
+        }
+        trace.End();
+    }
+    else {
+        trace.Begin("glfwInit");
+        if (!glfwInit()) {
+            // Initialization failed
+            Log("GLFW Initialization Failed!!");
+            return false;
+        }
+        else {
+            Log("Initialized GLFW...");
+        }
+
+        glfwSetErrorCallback(&report_error);
+        Log("Set GLFW Error Callback...");
+        trace.End();
+
+        trace.Begin("create window");
+        ConfigureGLFW();
+        Log("Initialized GLFW Window Hints...");
+
+
+        window = glfwCreateWindow(options.width, options.height,
+                                  scene.title,
+                                  nullptr, nullptr);
+
+        if (window == nullptr) {
+            Log("Failed to create GLFW window");
+            return false;
+        }
+        else {
+            Log("Created GLFW window");
+        }
+
+        glfwMakeContextCurrent(window);
+        trace.End();
+    }
+
+    return true;
+}
+
+// Everything from loading the GL functions to the last report, on the
+// context that RunOnContext() made.  Whatever this makes on the context
+// is gone when it returns, through the Destroy()s at the end, or the
+// destructors on an early return.
+static int RunScene(const DemoOptions &options, const DemoScene &scene,
+                    StartupTrace &trace,
+                    std::chrono::steady_clock::time_point startupBegin,
+                    HeadlessContext &headless, GLFWwindow *window)
+{
+    // In a window, we render on our own thread, and the callbacks tell it
+    // what changed.
+    RenderThread renderThread;
+
+    // Note: the functions are looked up through the current context, so
+    //       this has to wait until there is one
+    trace.Begin("load GL functions");
+    if (!GLLoaderInit(options.headless ? eglGetProcAddress :
+                                         glfwGetProcAddress,
+                      options.glLoader == "lazy")) {
+        Log("Failed to load the OpenGL functions");
+        return -1;
+    }
+    else {
+        Log("Loaded the OpenGL functions (%s)...", options.glLoader.c_str());
+    }
+    trace.End();
+
+    Log("OpenGL version supported by this platform: %s",
+        reinterpret_cast<const char *>(glGetString(GL_VERSION)));
+    Log("GLSL version supported by this platform: %s",
+        reinterpret_cast<const char *>(
+            glGetString(GL_SHADING_LANGUAGE_VERSION)));
+
+    // Without KHR_debug, it's glGetError(), in debug builds only
+    if (EnableGLDebugOutput())
+        Log("Logging GL errors through KHR_debug...");
+
+    trace.Begin("framebuffer");
+    int width, height;
+    if (options.headless) {
+        if (!headless.CreateFramebuffer(options.width, options.height)) {
+            return -1;
+        }
+
+        width = headless.Width();
+        height = headless.Height();
+    }
+    else {
+        glfwGetFramebufferSize(window, &width, &height);
+    }
+
+    glViewport(0, 0, width, height);
+    Log("Set the Viewport...");
+    trace.End();
+
+    // The benchmarks only need the context, for their buffers
+    if (options.generatorBenchmark || !options.meshBenchmarkDir.empty() ||
+            options.handleBenchmark) {
+        DebugLog::Global().Flush();
+
+        if (options.generatorBenchmark) {
+            MeshGenerator::Benchmark(cout, options.subdivisions > 0 ?
+                                           options.subdivisions : 1000,
+                                     true);
+        }
+
+        if (!options.meshBenchmarkDir.empty())
+            MeshFile::Benchmark(cout, options.meshBenchmarkDir);
+
+        if (options.handleBenchmark)
+            GLHandleBenchmark(cout);
+
+        return 0;
+    }
+
+    if (window != nullptr) {
+        glfwSetWindowUserPointer(window, &renderThread);
+        glfwSetKeyCallback(window, key_callback);
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+        glfwSetWindowRefreshCallback(window, window_refresh_callback);
+    }
+
+    // Here is where we build and compile our shader program.
+    // The program cache loads the binary that an earlier run saved, if it
+    // can, and only compiles from source if it can't.
+    // Note: we only submit the program here, and the driver compiles it
+    //       while we set up our buffers.  We check on it afterwards.
+    trace.Begin("submit shaders");
+    std::string shaderCacheDir;
+    if (options.shaderCache) {
+        shaderCacheDir = options.shaderCacheDir.empty() ?
+                         ProgramCache::DefaultDirectory() :
+                         options.shaderCacheDir;
+    }
+
+    ProgramCache programCache(shaderCacheDir);
+    programCache.SetSequential(options.sequentialStartup);
+
+    const VertexFormat *format = scene.chooseFormat(options);
+    if (format == nullptr) {
+        return -1;
+    }
+
+    // The reloader builds new programs on a context of its own, which
+    // shares them with ours: a second EGL context, or a hidden window.
+    // Note: it is declared first, so that on an early return the reloader's
+    //       thread is stopped before its context goes
+    HeadlessContext reloadContext;
+    GLFWwindow *reloadWindow = nullptr;
+
+    // With a shader directory, the shaders come from files there, which
+    // are watched for changes once we are up and running.
+    ShaderReloader reloader;
+    const GLchar *vertexShaderSource = scene.vertexShaderSource;
+    const GLchar *fragmentShaderSource = scene.fragmentShaderSource;
+
+    if (!options.shaderDir.empty()) {
+        if (!reloader.Load(options.shaderDir, scene.programName,
+                           vertexShaderSource, fragmentShaderSource)) {
+            return -1;
+        }
+
+        vertexShaderSource = reloader.VertexSource();
+        fragmentShaderSource = reloader.FragmentSource();
+    }
+
+    std::vector<AttributeBinding> attributes = format->AttributeBindings();
+    int programHandle = programCache.Submit(
+                            scene.programName,
+                            vertexShaderSource,
+                            fragmentShaderSource,
+                            attributes.data(),
+                            static_cast<int>(attributes.size()));
+    trace.End();
+
+    // Our program, vertex array and buffers, which are deleted when we
+    // return, however we get there.
+    trace.Begin("vertex buffers");
+    Pipeline pipeline;
+    pipeline.Create();
+
+    // bind our Vertex Array Object first
+    glBindVertexArray(pipeline.VertexArray());
+
+    // Then bind and fill our one buffer, and let the format set up the
+    // attribute pointers into it.
+    // Note: the order in which things are done here is important. The order
+    //       of operations that works for me is:
+    //       - bind the buffer object
+    //       - copy the data into the buffer
+    //       - Set the attribute pointers
+    glBindBuffer(GL_ARRAY_BUFFER, pipeline.VertexBuffer());
+    scene.uploadVertices(*format, scene.vertices, scene.colors);
+
+    format->PointAttributes();
+    format->EnableAttributes();
+    pipeline.SetFormat(*format);
+    pipeline.SetCount(3);
+
+    // Note that this is allowed, the call to glVertexAttribPointer
+    // registered VBO as the currently bound vertex buffer object so
+    // afterwards we can safely unbind.
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Note: Remember, do NOT unbind the EBO, keep it bound to this VAO
+
+    // Unbind the Vertex Array Object.
+    // (It is always good to unbind any buffer/array to prevent strange bugs)
+    glBindVertexArray(0);
+    trace.End();
+
+    // If we were asked for more than one triangle, they are drawn by the
+    // batch renderer, which uses instancing if the platform supports it.
+    TriangleBatch batch;
+    TriangleBatch *activeBatch = nullptr;
+
+    if (options.triangles > 1 || options.batchMode != "auto") {
+        TriangleBatch::Mode mode = TriangleBatch::ModeAuto;
+        if (options.batchMode == "instanced")
+            mode = TriangleBatch::ModeInstanced;
+        else if (options.batchMode == "merged")
+            mode = TriangleBatch::ModeMerged;
+        else if (options.batchMode == "streamed")
+            mode = TriangleBatch::ModeStreamed;
+        else if (options.batchMode == "uniform-buffer")
+            mode = TriangleBatch::ModeUniformBuffer;
+        else if (options.batchMode == "texture-buffer")
+            mode = TriangleBatch::ModeTextureBuffer;
+
+        trace.Begin("triangle batch");
+        if (!batch.Create(programCache, scene.vertices, scene.colors,
+                          options.triangles, options.batchSize, mode)) {
+            Log("Failed to create the triangle batch");
+            return -1;
+        }
+        trace.End();
+
+        activeBatch = &batch;
+    }
+
+    // The programs are still being built.  Between the setup steps we take
+    // any that the driver says are done, and we only wait for the rest
+    // once there is nothing left to set up.
+    bool programTaken = false;
+    auto takeReadyPrograms = [&]() {
+        if (!programTaken && programCache.Ready(programHandle)) {
+            pipeline.SetProgram(GLProgram(programCache.Wait(programHandle)));
+            programTaken = true;
+        }
+
+        if (activeBatch != nullptr && activeBatch->ProgramReady(programCache))
+            activeBatch->WaitProgram(programCache);
+    };
+    takeReadyPrograms();
+
+    // A generated or loaded mesh takes the place of our 3 vertices, in
+    // the same buffer and vertex array.
+    if (activeBatch == nullptr && DemoMeshRequested(options)) {
+        trace.Begin("mesh");
+        if (!CreateDemoMesh(options, scene.vertices, scene.colors,
+                            pipeline)) {
+            Log("Failed to create the mesh");
+            return -1;
+        }
+        trace.End();
+
+        takeReadyPrograms();
+    }
+
+    // the rest of what a frame needs, which is mostly optional
+    trace.Begin("frame setup");
+
+    if (!options.shaderDir.empty()) {
+        ShaderReloader::MakeCurrentFunction makeCurrent;
+        ShaderReloader::ReleaseFunction release;
+        ShaderReloader::NotifyFunction notify = []() {};
+
+        if (options.headless) {
+            if (!reloadContext.CreateShared(headless)) {
+                Log("Failed to create the shader reload context");
+                return -1;
+            }
+
+            makeCurrent = [&]() { return reloadContext.MakeCurrent(); };
+            release = [&]() { reloadContext.ReleaseCurrent(); };
+        }
+        else {
+            glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+            reloadWindow = glfwCreateWindow(1, 1, scene.title, nullptr,
+                                            window);
+            glfwWindowHint(GLFW_VISIBLE, GL_TRUE);
+
+            if (reloadWindow == nullptr) {
+                Log("Failed to create the shader reload window");
+                return -1;
+            }
+
+            // Note: creating a window can leave its context current
+            glfwMakeContextCurrent(window);
+
+            makeCurrent = [reloadWindow]() {
+                glfwMakeContextCurrent(reloadWindow);
+                return true;
+            };
+            release = []() { glfwMakeContextCurrent(nullptr); };
+
+            // wakes up the main thread, to ask for a frame
+            notify = []() { glfwPostEmptyEvent(); };
+        }
+
+        if (!reloader.Start(attributes, makeCurrent, release, notify)) {
+            return -1;
+        }
+
+        takeReadyPrograms();
+    }
+
+    // With a mesh, only the chunks of it in view need drawing.  This reads
+    // the mesh back, so it comes before the state cache is invalidated.
+    ChunkCuller culler;
+    ChunkCuller *activeCuller = nullptr;
+
+    if (options.cull && activeBatch == nullptr) {
+        culler.SetThreads(options.cullThreads);
+        if (!culler.Build(pipeline, options.cullChunk)) {
+            Log("Failed to build the culling hierarchy");
+            return -1;
+        }
+
+        activeCuller = &culler;
+        takeReadyPrograms();
+    }
+
+    // Note: the GPU timings are read back a few frames late, so
+    //       profiling doesn't stall the pipeline.
+    FrameProfiler profiler(options.profile);
+    profiler.Init();
+
+    // With a frame time to hold, the scene is drawn smaller, as need be,
+    // and scaled up to the window or the headless framebuffer
+    DynamicResolution resolution;
+    if (options.dynamicResolutionMs > 0.0 &&
+        !resolution.Create(options.headless ? headless.Framebuffer() : 0,
+                           width, height, options.dynamicResolutionMs,
+                           options.minScale)) {
+        return -1;
+    }
+
+    // The captured frames are read back late too, and written out on a
+    // thread of their own.
+    FrameCapture capture;
+    if (!options.capturePath.empty() &&
+        !capture.Create(options.capturePath, width, height, options.fps,
+                        options.captureRing)) {
+        return -1;
+    }
+
+    trace.End();
+
+    // By now the compiler has had the whole setup to work with
+    trace.Begin("wait for shaders");
+    if (!programTaken)
+        pipeline.SetProgram(GLProgram(programCache.Wait(programHandle)));
+    bool batchBuilt = activeBatch == nullptr ||
+                      activeBatch->WaitProgram(programCache);
+    trace.End();
+
+    if (pipeline.Program() == 0 || !batchBuilt) {
+        Log("Failed to build the shader program");
+        return -1;
+    }
+
+    std::chrono::duration<double, std::milli> startupTime =
+        std::chrono::steady_clock::now() - startupBegin;
+    Log("Startup took %g ms (%s), %g ms of it waiting on the shader "
+        "compiler", startupTime.count(),
+        options.sequentialStartup ? "sequential" : "overlapped",
+        programCache.WaitMilliseconds());
+    CHECK_GL_ERRORS("startup");
+
+    // We set up our buffers, vertex arrays and programs behind the state
+    // cache's back, so it can't trust anything it thinks it knows.
+    GLStateCache::Current().SetEnabled(options.stateCache);
+    GLStateCache::Current().Invalidate();
+
+    // the frames drawn so far, for panning the view
+    long long frame = 0;
+
+    // what we return, once everything is cleaned up
+    int result = 0;
+
+    // Note: the reports go straight to cout, after what was logged
+    trace.Begin("flush log");
+    DebugLog::Global().Flush();
+    trace.End();
+
+    if (options.headless && options.softwareCheck) {
+        // one frame, drawn both ways
+        PanView(pipeline, options.zoom, frame);
+        DrawScene(pipeline, activeBatch, activeCuller, profiler);
+        glFinish();
+
+        if (!CheckSoftwareFrame(options, scene, pipeline.View(), width,
+                                height))
+            result = -1;
+    }
+    else if (options.headless) {
+        // Render a fixed number of frames as fast as we can.
+        // There is no swap to wait on, so glFinish() takes its place,
+        // and each frame time includes the GPU work.
+        for (int i = 0; i < options.warmupFrames; i++) {
+            bool firstFrame = frame == 0;
+            if (firstFrame)
+                trace.Begin("first frame");
+
+            reloader.Poll(pipeline);
+            PanView(pipeline, options.zoom, frame++);
+            resolution.BeginFrame();
+            DrawScene(pipeline, activeBatch, activeCuller, profiler);
+            resolution.EndFrame();
+            glFinish();
+            reloader.FrameDone();
+
+            if (firstFrame)
+                trace.End();
+            GLStateCache::Current().EndFrame();
+        }
+
+        // Note: a culled frame draws what Cull() found, not all of these
+        long long sceneTriangles = activeBatch != nullptr ?
+                                   activeBatch->TriangleCount() :
+                                   pipeline.Count() / 3;
+        FrameBenchmark benchmark(options.frames,
+                                 static_cast<long long>(width) * height,
+                                 sceneTriangles);
+
+        for (int i = 0; i < options.frames; i++) {
+            bool firstFrame = frame == 0;
+            if (firstFrame)
+                trace.Begin("first frame");
+
+            benchmark.BeginFrame();
+            profiler.BeginFrame();
+
+            reloader.Poll(pipeline);
+            PanView(pipeline, options.zoom, frame++);
+            resolution.BeginFrame();
+            DrawScene(pipeline, activeBatch, activeCuller, profiler);
+            resolution.EndFrame();
+            capture.Capture();
+
+            profiler.BeginStage(FrameProfiler::StageSwap);
+            glFinish();
+            profiler.EndStage();
+            reloader.FrameDone();
+
+            profiler.EndFrame();
+            GLStateCache::Current().EndFrame();
+            if (activeCuller != nullptr)
+                benchmark.EndFrame(activeCuller->TrianglesDrawn());
+            else
+                benchmark.EndFrame();
+
+            if (firstFrame)
+                trace.End();
+        }
+
+        DebugLog::Global().Flush();
+        benchmark.Report(cout);
+    }
+    else {
+        RenderState initialState = {width, height, false};
+
+        FramePacer::Mode pacingMode = FramePacer::ModeOnDemand;
+        if (options.pacing == "continuous")
+            pacingMode = FramePacer::ModeContinuous;
+        else if (options.pacing == "capped")
+            pacingMode = FramePacer::ModeCapped;
+        else if (options.pacing == "vsync")
+            pacingMode = FramePacer::ModeVsync;
+
+        FramePacer pacer(pacingMode, options.fps, options.swapInterval);
+
+        // Any more windows are set up while our context is still here,
+        // and are drawn by threads of their own
+        SharedWindows sharedWindows;
+        if (options.windows > 1) {
+            OpenSharedWindows(options, scene, window, pipeline, pacingMode,
+                              sharedWindows);
+            StartSharedWindows(sharedWindows);
+        }
+
+        // one frame, on whichever thread is rendering
+        RenderThread::FrameFunction drawFrame =
+            [&](const RenderState &state) -> bool {
+                // Note: on the render thread, unless it is single threaded
+                bool firstFrame = frame == 0;
+                if (firstFrame) {
+                    trace.NameThread(options.singleThread ? "main" :
+                                                            "render");
+                    trace.Begin("first frame");
+                }
+
+                if (activeBatch != nullptr)
+                    activeBatch->SetPaused(state.paused);
+
+                resolution.Resize(state.width, state.height);
+
+                profiler.BeginFrame();
+
+                reloader.Poll(pipeline);
+                PanView(pipeline, options.zoom, frame++);
+                resolution.BeginFrame();
+                DrawScene(pipeline, activeBatch, activeCuller, profiler);
+                resolution.EndFrame();
+                capture.Capture();
+
+                profiler.BeginStage(FrameProfiler::StageSwap);
+                glfwSwapBuffers(window);
+                profiler.EndStage();
+                reloader.FrameDone();
+
+                profiler.EndFrame();
+                GLStateCache::Current().EndFrame();
+
+                if (firstFrame)
+                    trace.End();
+
+                // a zoomed in view keeps panning, and a shader reload
+                // keeps us going until it is swapped in
+                return options.zoom > 1 || reloader.Pending() ||
+                       (activeBatch != nullptr && activeBatch->Animated());
+            };
+
+        if (options.singleThread) {
+            // our main loop, events and frames taking turns
+            renderThread.RunOnMainThread(window, initialState, drawFrame,
+                                         pacer);
+        }
+        else {
+            // The render thread takes the context, and this thread only
+            // waits for events, and passes them on.
+            renderThread.Start(window, initialState, drawFrame, pacer);
+
+            // Note: closing any of the windows ends the demo
+            bool closed = false;
+            while(!closed)
+            {
+                glfwWaitEvents();
+
+                // the shader reloader woke us up
+                if (reloader.Pending())
+                    renderThread.RequestRedraw();
+
+                closed = glfwWindowShouldClose(window);
+                for (size_t i = 0; i < sharedWindows.size(); i++)
+                    closed = closed ||
+                             glfwWindowShouldClose(sharedWindows[i]->window);
+            }
+
+            renderThread.Stop();
+            CloseSharedWindows(sharedWindows);
+        }
+
+        DebugLog::Global().Flush();
+        if (!sharedWindows.empty())
+            cout << "Window 1:" << endl;
+        renderThread.Report(cout);
+        pacer.Report(cout);
+        ReportSharedWindows(pacer, sharedWindows);
+    }
+
+    if (activeBatch != nullptr) {
+        activeBatch->Report(cout);
+    }
+
+    if (!options.traceStartupPath.empty()) {
+        trace.Report(cout);
+        GLLoaderReport(cout);
+
+        if (trace.WriteJson(options.traceStartupPath)) {
+            cout << "Wrote the startup trace to "
+                 << options.traceStartupPath << endl;
+        }
+        else {
+            cout << "Failed to write the startup trace to "
+                 << options.traceStartupPath << endl;
+        }
+    }
+
+    if (activeCuller != nullptr)
+        activeCuller->Report(cout);
+
+    // Note: the reloader's context goes before ours, which is back on this
+    //       thread by now, and deletes a program that was never used
+    if (!options.shaderDir.empty()) {
+        reloader.Stop();
+        reloader.Report(cout);
+
+        if (options.headless)
+            reloadContext.Destroy();
+        else
+            glfwDestroyWindow(reloadWindow);
+    }
+
+    // Note: this needs the context, which is back on this thread by now
+    if (capture.Enabled()) {
+        capture.Finish();
+        capture.Report(cout);
+    }
+
+    if (profiler.Enabled()) {
+        profiler.Finish();
+        profiler.Report(cout);
+        GLStateCache::Current().Report(cout);
+
+        if (!options.timingCsvPath.empty()) {
+            if (profiler.WriteCsv(options.timingCsvPath)) {
+                cout << "Wrote frame timings to "
+                     << options.timingCsvPath << endl;
+            }
+            else {
+                cout << "Failed to write frame timings to "
+                     << options.timingCsvPath << endl;
+            }
+        }
+
+        profiler.Destroy();
+    }
+
+    if (resolution.Enabled()) {
+        resolution.Finish();
+        resolution.Report(cout);
+
+        if (!options.resolutionCsvPath.empty()) {
+            if (resolution.WriteCsv(options.resolutionCsvPath)) {
+                cout << "Wrote the frame scales to "
+                     << options.resolutionCsvPath << endl;
+            }
+            else {
+                cout << "Failed to write the frame scales to "
+                     << options.resolutionCsvPath << endl;
+            }
+        }
+    }
+
+    // Properly deallocate all resources once we are done.
+    // Note: this has to happen before the context goes away, so we don't
+    //       leave it to the destructors.
+    batch.Destroy();
+    culler.Destroy();
+    capture.Destroy();
+    resolution.Destroy();
+    pipeline.Destroy();
+
+    return result;
+}
+
+const GLfloat DemoClearColor[4] = {0.2f, 0.3f, 0.3f, 1.0f};
+
+void DemoPanView(int zoom, long long frame, GLfloat view[4])
+{
+    if (zoom <= 1) {
+        view[0] = view[1] = 1.0f;
+        view[2] = view[3] = 0.0f;
+        return;
+    }
+
+    // Circle around the middle, close enough to it that the view never
+    // runs off the edge of the generated meshes, from -0.9 to 0.9.
+    double angle = frame * 0.005;
+    double radius = std::max(0.0, 0.9 - 1.0 / zoom);
+    GLfloat x = static_cast<GLfloat>(radius * std::cos(angle));
+    GLfloat y = static_cast<GLfloat>(radius * std::sin(angle));
+
+    view[0] = view[1] = static_cast<GLfloat>(zoom);
+    view[2] = -x * zoom;
+    view[3] = -y * zoom;
+}
+
+static void PanView(Pipeline &pipeline, int zoom, long long frame)
+{
+    if (zoom <= 1)
+        return;
+
+    GLfloat view[4];
+    DemoPanView(zoom, frame, view);
+    pipeline.SetView(view);
+}
+
+static void DrawScene(const Pipeline &pipeline, TriangleBatch *batch,
+                      ChunkCuller *culler, FrameProfiler &profiler)
+{
+    //
+    // rendering routines
+    //
+    // Note: the binds and uses go through the state cache, which skips
+    //       the ones that wouldn't change anything.
+    profiler.BeginStage(FrameProfiler::StageClear);
+    GLStateCache::Current().ClearColor(DemoClearColor[0], DemoClearColor[1],
+                                       DemoClearColor[2], DemoClearColor[3]);
+    glClear(GL_COLOR_BUFFER_BIT);
+    profiler.EndStage();
+
+    if (culler != nullptr) {
+        profiler.BeginStage(FrameProfiler::StageCull);
+        culler->Cull(pipeline.View());
+        profiler.EndStage();
+    }
+
+    profiler.BeginStage(FrameProfiler::StageDraw);
+
+    if (batch != nullptr) {
+        // lots of triangles, the batch knows how to draw them
+        batch->Draw();
+    }
+    else if (culler != nullptr) {
+        // only the parts of the mesh that are in view
+        culler->Draw(pipeline);
+    }
+    else {
+        // our triangle, or the mesh that took its place
+        pipeline.Draw();
+    }
+    profiler.EndStage();
+
+    //
+    // done rendering
+    //
+    CHECK_GL_ERRORS("DrawScene");
+}
+
+static void OpenSharedWindows(const DemoOptions &options,
+                              const DemoScene &scene, GLFWwindow *window,
+                              const Pipeline &pipeline,
+                              FramePacer::Mode pacingMode,
+                              SharedWindows &sharedWindows)
+{
+    GLStateCache &mainCache = GLStateCache::Current();
+
+    // Note: objects made in one context are only safe to use in another
+    //       once the commands that made them have been flushed
+    glFlush();
+
+    for (int i = 1; i < options.windows; i++) {
+        std::string title = std::string(scene.title) + " (" +
+                            std::to_string(i + 1) + ")";
+
+        // the last argument is the context to share objects with
+        GLFWwindow *sharing = glfwCreateWindow(options.width, options.height,
+                                               title.c_str(), nullptr,
+                                               window);
+        if (sharing == nullptr) {
+            Log("Failed to create GLFW window %d, carrying on with %d",
+                i + 1, i);
+            break;
+        }
+
+        std::unique_ptr<SharedWindow> shared(
+            new SharedWindow(pacingMode, options.fps, options.swapInterval));
+        shared->window = sharing;
+
+        // set up the window's context while it is current here; the
+        // render thread takes it, and its state cache, in Start()
+        glfwMakeContextCurrent(sharing);
+        GLStateCache::SetCurrent(&shared->stateCache);
+        EnableGLDebugOutput();
+
+        int width, height;
+        glfwGetFramebufferSize(sharing, &width, &height);
+        glViewport(0, 0, width, height);
+
+        shared->view.CreateView(pipeline);
+        shared->stateCache.SetEnabled(options.stateCache);
+
+        glfwSetWindowUserPointer(sharing, &shared->renderThread);
+        glfwSetKeyCallback(sharing, key_callback);
+        glfwSetFramebufferSizeCallback(sharing, framebuffer_size_callback);
+        glfwSetWindowRefreshCallback(sharing, window_refresh_callback);
+
+        sharedWindows.push_back(std::move(shared));
+    }
+
+    GLStateCache::SetCurrent(&mainCache);
+    glfwMakeContextCurrent(window);
+
+    Log("Opened %d windows, sharing one set of buffers and programs",
+        static_cast<int>(sharedWindows.size()) + 1);
+}
+
+static void StartSharedWindows(SharedWindows &sharedWindows)
+{
+    GLStateCache &mainCache = GLStateCache::Current();
+    GLFWwindow *window = glfwGetCurrentContext();
+
+    for (size_t i = 0; i < sharedWindows.size(); i++) {
+        SharedWindow &shared = *sharedWindows[i];
+
+        int width, height;
+        glfwGetFramebufferSize(shared.window, &width, &height);
+        RenderState initialState = {width, height, false};
+
+        // the same frame as the first window's, minus the profiler, the
+        // capture and the batch
+        RenderThread::FrameFunction drawFrame =
+            [&shared](const RenderState &) -> bool {
+                DrawScene(shared.view, nullptr, nullptr, shared.profiler);
+                glfwSwapBuffers(shared.window);
+                GLStateCache::Current().EndFrame();
+                return false;
+            };
+
+        glfwMakeContextCurrent(shared.window);
+        GLStateCache::SetCurrent(&shared.stateCache);
+        shared.renderThread.Start(shared.window, initialState, drawFrame,
+                                  shared.pacer);
+    }
+
+    GLStateCache::SetCurrent(&mainCache);
+    glfwMakeContextCurrent(window);
+}
+
+static void CloseSharedWindows(SharedWindows &sharedWindows)
+{
+    GLStateCache &mainCache = GLStateCache::Current();
+    GLFWwindow *window = glfwGetCurrentContext();
+
+    // each context comes back to this thread, to delete its vertex array
+    for (size_t i = 0; i < sharedWindows.size(); i++) {
+        SharedWindow &shared = *sharedWindows[i];
+
+        shared.renderThread.Stop();
+        GLStateCache::SetCurrent(&shared.stateCache);
+        shared.view.Destroy();
+    }
+
+    GLStateCache::SetCurrent(&mainCache);
+    glfwMakeContextCurrent(window);
+}
+
+// each window's frames, and all of them together, next to the first one's
+static void ReportSharedWindows(const FramePacer &pacer,
+                                const SharedWindows &sharedWindows)
+{
+    if (sharedWindows.empty())
+        return;
+
+    double total = pacer.FrameRate();
+
+    for (size_t i = 0; i < sharedWindows.size(); i++) {
+        cout << "Window " << i + 2 << ":" << endl;
+        sharedWindows[i]->renderThread.Report(cout);
+        sharedWindows[i]->pacer.Report(cout);
+        total += sharedWindows[i]->pacer.FrameRate();
+    }
+
+    size_t windows = sharedWindows.size() + 1;
+    cout << windows << " windows: " << total << " frames/s in all, "
+         << total / windows << " frames/s per window" << endl;
+}
+
+static void ConfigureGLFW() {
+
+    // Note: I don't know if it is ever a good idea requiring a version
+    //       It would be nice if we could query the version and provide
+    //       backward compatibility, at least down to OpenGL version 2.0
+    //       (GLSL version 1.x)
+    // glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    // glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+
+    // Note: Context profiles are only defined for OpenGL version 3.2
+    //       and above.  My old PC uses old NVidia linux drivers, so it is not
+    //       possible to set this.
+    // glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    glfwWindowHint(GLFW_RESIZABLE, GL_FALSE);
+
+    // so that KHR_debug tells us all it can
+#ifndef NDEBUG
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
+#endif
+}
+
+
+static void report_error(int code, const char * description)
+{
+    Log("GLFW Error: (%d)\n\t%s", code, description);
+}
+
+
+static void key_callback(GLFWwindow* window, int key, int, int action,
+                         int)
+{
+    // When a user presses the escape key, we set the WindowShouldClose property to true,
+    // closing the application
+    if(key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, GL_TRUE);
+
+    // The space bar pauses the animation
+    if(key == GLFW_KEY_SPACE && action == GLFW_PRESS) {
+        RenderThread *renderThread =
+            static_cast<RenderThread *>(glfwGetWindowUserPointer(window));
+        RenderState state = renderThread->PostedState();
+        state.paused = !state.paused;
+        renderThread->Post(state);
+    }
+}
+
+
+static void framebuffer_size_callback(GLFWwindow* window,
+                                      int width, int height)
+{
+    // Note: we may not have the context here, so the viewport is set by
+    //       whoever is rendering, before the next frame.
+    RenderThread *renderThread =
+        static_cast<RenderThread *>(glfwGetWindowUserPointer(window));
+    RenderState state = renderThread->PostedState();
+    state.width = width;
+    state.height = height;
+    renderThread->Post(state);
+}
+
+
+static void window_refresh_callback(GLFWwindow* window)
+{
+    // the window needs repainting, even if nothing we know of changed
+    RenderThread *renderThread =
+        static_cast<RenderThread *>(glfwGetWindowUserPointer(window));
+    renderThread->RequestRedraw();
+}
@@ -0,0 +1,70 @@
+//============================================================================
+// Name        : DemoApp.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : The main() that the Hello Triangle demos share.
+//
+//               HelloTriangle and HelloColorTriangle used to each have
+//               their own copy of the whole thing: the window or headless
+//               context, the GL loader, the program cache, the batch, the mesh, the
+//               profiler, the capture, the headless benchmark and the
+//               windowed render loop, and the GLFW callbacks.  Every
+//               feature went in twice, and the copies drifted apart.
+//
+//               Now a demo is only what makes it different, a DemoScene:
+//               its shaders, its triangle, and how its vertices are laid
+//               out.  RunDemo() does everything else, the same way for
+//               both, so they are built and benchmarked alike.  The GL
+//               objects live in a Pipeline, and are deleted before the
+//               context goes away, however we get there.
+//
+//============================================================================
+
+#ifndef DEMO_APP_H
+#define DEMO_APP_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include "DemoOptions.h"
+#include "VertexLayout.h"
+
+struct DemoScene {
+    const char *title;          // of the window
+    const char *programName;    // in the program cache
+
+    const GLchar *vertexShaderSource;
+    const GLchar *fragmentShaderSource;
+
+    // the triangle's corners, and the color of each, 3 floats each
+    GLfloat vertices[9];
+    GLfloat colors[9];
+
+    // The vertex format the options ask for, or nullptr (after saying
+    // why) if this platform can't do it
+    const VertexFormat *(*chooseFormat)(const DemoOptions &options);
+
+    // Fill the buffer bound to GL_ARRAY_BUFFER with the triangle, in that
+    // format
+    void (*uploadVertices)(const VertexFormat &format,
+                           const GLfloat vertices[9],
+                           const GLfloat colors[9]);
+
+    // True if the fragment shader fills the triangles with one color, the
+    // first of colors, rather than blending the vertex colors, for the
+    // software rasterizer
+    bool flat;
+};
+
+// The color every frame is cleared to
+extern const GLfloat DemoClearColor[4];
+
+// The view uniform for frame number frame: zoomed in zoom times, and
+// panning around the middle in a slow circle, or as is if zoom is 1
+void DemoPanView(int zoom, long long frame, GLfloat view[4]);
+
+// Run the demo, and return what main() should
+int RunDemo(int argc, char *argv[], const DemoScene &scene);
+
+#endif // DEMO_APP_H
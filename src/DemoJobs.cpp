@@ -0,0 +1,545 @@
+//============================================================================
+// Name        : DemoJobs.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : A Hello Triangle demo, as a batch of offscreen render jobs.
+//
+//============================================================================
+
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+#include "DebugLog.h"
+#include "DemoJobs.h"
+#include "FileUtil.h"
+#include "FrameBenchmark.h"
+#include "FrameCapture.h"
+#include "GLDebug.h"
+#include "GLStateCache.h"
+#include "HeadlessContext.h"
+#include "Pipeline.h"
+#include "ProgramCache.h"
+#include "WorkStealingDeque.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// how one job went
+struct JobResult {
+    bool ran;
+    bool failed;
+    bool stolen;
+    int worker;
+    double latencyMs;   // from the start of the batch
+    double runMs;       // from being picked up
+};
+
+struct WorkerStats {
+    int jobs;
+    int stolen;
+    double busyMs;
+};
+
+// What the workers share, for one run of the batch.  Each job's result is
+// only written by the worker that ran it, and each worker's stats by that
+// worker, and they are read after every worker is done.
+struct JobsRun {
+    const DemoOptions *options;
+    const DemoScene *scene;
+    const VertexFormat *format;
+    const HeadlessContext *display;     // the context whose display we use
+    std::string shaderCacheDir;
+
+    const std::vector<DemoJob> *jobs;
+    std::vector<std::unique_ptr<WorkStealingDeque<int> > > deques;
+
+    std::vector<JobResult> results;
+    std::vector<WorkerStats> workers;
+    Clock::time_point start;
+};
+
+static int CoreCount()
+{
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    return cores > 0 ? cores : 1;
+}
+
+bool LoadDemoJobs(const std::string &path, const DemoScene &scene,
+                  std::vector<DemoJob> &jobs)
+{
+    std::ifstream file(path.c_str());
+    if (!file) {
+        Log("Failed to open the job file %s", path.c_str());
+        return false;
+    }
+
+    std::string text;
+    int line = 0;
+
+    while (std::getline(file, text)) {
+        line++;
+
+        size_t comment = text.find('#');
+        if (comment != std::string::npos)
+            text.erase(comment);
+
+        std::istringstream fields(text);
+        std::string size;
+        if (!(fields >> size))
+            continue;
+
+        DemoJob job;
+        job.line = line;
+        std::copy(scene.vertices, scene.vertices + 9, job.vertices);
+        std::copy(scene.colors, scene.colors + 9, job.colors);
+
+        char trailing;
+        bool valid = std::sscanf(size.c_str(), "%dx%d%c", &job.width,
+                                 &job.height, &trailing) == 2 &&
+                     job.width > 0 && job.height > 0 &&
+                     (fields >> job.frames) && job.frames > 0 &&
+                     (fields >> job.outputPath);
+
+        // then the corners, and the colors, if the job has its own
+        std::vector<GLfloat> numbers;
+        GLfloat number;
+        while (valid && fields >> number)
+            numbers.push_back(number);
+
+        valid = valid && fields.eof() &&
+                (numbers.empty() || numbers.size() == 9 ||
+                 numbers.size() == 18);
+
+        if (!valid) {
+            Log("%s:%d: expected WxH FRAMES OUTPUT, and 0, 9 or 18 numbers",
+                path.c_str(), line);
+            return false;
+        }
+
+        // the same frame numbering as --capture's
+        if (!EndsWith(job.outputPath, ".y4m") &&
+            !ValidFramePattern(job.outputPath)) {
+            Log("%s:%d: OUTPUT can have one %%d in it, and %%%% for a %%, "
+                "but nothing else after a %%", path.c_str(), line);
+            return false;
+        }
+
+        if (numbers.size() >= 9)
+            std::copy(numbers.begin(), numbers.begin() + 9, job.vertices);
+        if (numbers.size() == 18)
+            std::copy(numbers.begin() + 9, numbers.end(), job.colors);
+
+        jobs.push_back(job);
+    }
+
+    if (jobs.empty()) {
+        Log("There are no jobs in %s", path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+// Draw one job's frames into the worker's framebuffer, and write them out.
+// Returns false if it couldn't, or a write failed.
+static bool RunJob(const JobsRun &run, HeadlessContext &context,
+                   Pipeline &pipeline, const DemoJob &job)
+{
+    const DemoOptions &options = *run.options;
+
+    if (!context.CreateFramebuffer(job.width, job.height))
+        return false;
+
+    glViewport(0, 0, job.width, job.height);
+
+    GLStateCache &state = GLStateCache::Current();
+    state.BindBuffer(GL_ARRAY_BUFFER, pipeline.VertexBuffer());
+    run.scene->uploadVertices(*run.format, job.vertices, job.colors);
+
+    // Note: every frame is the job's output, so we wait for the writer
+    //       rather than drop one
+    FrameCapture capture;
+    capture.SetLossless(true);
+    if (!capture.Create(job.outputPath, job.width, job.height, options.fps,
+                        options.captureRing))
+        return false;
+
+    GLfloat view[4];
+
+    for (int frame = 0; frame < job.frames; frame++) {
+        state.ClearColor(DemoClearColor[0], DemoClearColor[1],
+                         DemoClearColor[2], DemoClearColor[3]);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        DemoPanView(options.zoom, frame, view);
+        pipeline.SetView(view);
+        pipeline.Draw();
+
+        capture.Capture();
+    }
+    CHECK_GL_ERRORS("RunJob");
+
+    capture.Finish();
+    bool written = !capture.Failed();
+    capture.Destroy();
+
+    return written;
+}
+
+// the next job for worker: its own, or else one stolen from the others,
+// starting with the next worker along.  False once there are none left.
+static bool NextJob(JobsRun &run, int worker, int &job, bool &stolen)
+{
+    stolen = false;
+    if (run.deques[worker]->Pop(job))
+        return true;
+
+    int count = static_cast<int>(run.deques.size());
+    for (int i = 1; i < count; i++) {
+        if (run.deques[(worker + i) % count]->Steal(job)) {
+            stolen = true;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void RunWorker(JobsRun &run, int worker)
+{
+    const DemoScene &scene = *run.scene;
+    const VertexFormat &format = *run.format;
+
+    // a worker that can't get a context leaves its jobs to be stolen
+    HeadlessContext context;
+    if (!context.CreateSeparate(*run.display) || !context.MakeCurrent()) {
+        Log("Worker %d has no context, and leaves its jobs to the others",
+            worker + 1);
+        return;
+    }
+
+    // The same setup as RunDemo(), in our own context: the program, which
+    // the main thread has already put in the program cache, and the vertex
+    // array, pointed into a buffer that each job fills with its triangle
+    ProgramCache programCache(run.shaderCacheDir);
+    std::vector<AttributeBinding> attributes = format.AttributeBindings();
+
+    Pipeline pipeline;
+    pipeline.Create();
+
+    glBindVertexArray(pipeline.VertexArray());
+    glBindBuffer(GL_ARRAY_BUFFER, pipeline.VertexBuffer());
+    scene.uploadVertices(format, scene.vertices, scene.colors);
+
+    format.PointAttributes();
+    format.EnableAttributes();
+    pipeline.SetFormat(format);
+    pipeline.SetCount(3);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    pipeline.SetProgram(GLProgram(programCache.BuildProgram(
+                            scene.programName, scene.vertexShaderSource,
+                            scene.fragmentShaderSource, attributes.data(),
+                            static_cast<int>(attributes.size()))));
+
+    // the setup was behind the state cache's back
+    GLStateCache::Current().Invalidate();
+
+    if (pipeline.Program() == 0) {
+        Log("Worker %d failed to build the shader program, and leaves its "
+            "jobs to the others", worker + 1);
+        pipeline.Destroy();
+        context.Destroy();
+        return;
+    }
+
+    WorkerStats &stats = run.workers[worker];
+    int job;
+    bool stolen;
+
+    while (NextJob(run, worker, job, stolen)) {
+        Clock::time_point begin = Clock::now();
+        bool done = RunJob(run, context, pipeline, (*run.jobs)[job]);
+        Clock::time_point end = Clock::now();
+
+        JobResult &result = run.results[job];
+        result.ran = true;
+        result.failed = !done;
+        result.stolen = stolen;
+        result.worker = worker;
+        result.latencyMs = std::chrono::duration<double, std::milli>(
+                               end - run.start).count();
+        result.runMs = std::chrono::duration<double, std::milli>(
+                           end - begin).count();
+
+        stats.jobs++;
+        stats.stolen += stolen ? 1 : 0;
+        stats.busyMs += result.runMs;
+    }
+
+    pipeline.Destroy();
+    context.Destroy();
+}
+
+// Run every job once, on workerCount workers, and return how long it took,
+// in milliseconds
+static double RunJobs(JobsRun &run, int workerCount)
+{
+    const std::vector<DemoJob> &jobs = *run.jobs;
+
+    JobResult noResult = {false, true, false, -1, 0.0, 0.0};
+    WorkerStats noStats = {0, 0, 0.0};
+    run.results.assign(jobs.size(), noResult);
+    run.workers.assign(static_cast<size_t>(workerCount), noStats);
+
+    // Deal the jobs out in runs, in file order.  Each worker takes its own
+    // from the bottom, newest first, so each run goes in backwards, and
+    // the thieves take the end of it.
+    run.deques.clear();
+    for (int i = 0; i < workerCount; i++)
+        run.deques.emplace_back(new WorkStealingDeque<int>(jobs.size()));
+
+    for (size_t i = jobs.size(); i-- > 0;) {
+        size_t worker = i * workerCount / jobs.size();
+        run.deques[worker]->Push(static_cast<int>(i));
+    }
+
+    run.start = Clock::now();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < workerCount; i++)
+        threads.emplace_back(RunWorker, std::ref(run), i);
+
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    return std::chrono::duration<double, std::milli>(
+               Clock::now() - run.start).count();
+}
+
+static void SortedTimes(const JobsRun &run, std::vector<double> &latencies,
+                        std::vector<double> &runTimes)
+{
+    for (size_t i = 0; i < run.results.size(); i++) {
+        if (!run.results[i].ran)
+            continue;
+
+        latencies.push_back(run.results[i].latencyMs);
+        runTimes.push_back(run.results[i].runMs);
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    std::sort(runTimes.begin(), runTimes.end());
+}
+
+static void ReportTimes(std::ostream &out, const char *name,
+                        const std::vector<double> &sorted)
+{
+    double total = 0.0;
+    for (size_t i = 0; i < sorted.size(); i++)
+        total += sorted[i];
+
+    out << "    " << name << " (ms): mean "
+        << (sorted.empty() ? 0.0 : total / sorted.size())
+        << "  p50 " << Percentile(sorted, 50.0)
+        << "  p90 " << Percentile(sorted, 90.0)
+        << "  p99 " << Percentile(sorted, 99.0)
+        << "  max " << (sorted.empty() ? 0.0 : sorted.back()) << endl;
+}
+
+static int ReportJobs(std::ostream &out, const JobsRun &run, double wallMs)
+{
+    const std::vector<DemoJob> &jobs = *run.jobs;
+
+    int failed = 0;
+    long long frames = 0;
+
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (run.results[i].failed)
+            failed++;
+        else
+            frames += jobs[i].frames;
+    }
+
+    std::vector<double> latencies;
+    std::vector<double> runTimes;
+    SortedTimes(run, latencies, runTimes);
+
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    out << std::fixed << std::setprecision(3);
+    out << "Jobs: " << jobs.size() << " from " << run.options->jobsPath
+        << " on " << run.workers.size() << " workers (" << CoreCount()
+        << " cores), " << failed << " failed" << endl
+        << "    " << wallMs / 1000.0 << " s, "
+        << (jobs.size() - failed) * 1000.0 / wallMs << " jobs/s, "
+        << frames * 1000.0 / wallMs << " frames/s" << endl;
+
+    ReportTimes(out, "latency", latencies);
+    ReportTimes(out, "run time", runTimes);
+
+    for (size_t i = 0; i < run.workers.size(); i++) {
+        const WorkerStats &stats = run.workers[i];
+        out << "    worker " << i + 1 << ": " << stats.jobs << " jobs ("
+            << stats.stolen << " stolen), busy " << stats.busyMs
+            << " ms, " << 100.0 * stats.busyMs / wallMs << "%" << endl;
+    }
+
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (run.results[i].failed) {
+            out << "    job on line " << jobs[i].line << " ("
+                << jobs[i].outputPath << ") "
+                << (run.results[i].ran ? "FAILED" : "never ran") << endl;
+        }
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+    return failed;
+}
+
+// the whole batch on 1, 2, 4... workers, up to one per core
+static int BenchmarkJobs(std::ostream &out, JobsRun &run)
+{
+    int maxWorkers = run.options->workers > 0 ? run.options->workers :
+                                                CoreCount();
+
+    std::vector<int> workerCounts;
+    for (int workers = 1; workers < maxWorkers; workers *= 2)
+        workerCounts.push_back(workers);
+    workerCounts.push_back(maxWorkers);
+
+    const char *rasterizerThreads = std::getenv("LP_NUM_THREADS");
+
+    DebugLog::Global().Flush();
+    out << "Jobs benchmark: " << run.jobs->size() << " jobs from "
+        << run.options->jobsPath << ", " << CoreCount() << " cores, "
+        << "LP_NUM_THREADS=" << (rasterizerThreads != nullptr ?
+                                 rasterizerThreads : "unset") << endl;
+
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    double singleWorkerRate = 0.0;
+    int failed = 0;
+
+    for (size_t w = 0; w < workerCounts.size(); w++) {
+        double wallMs = RunJobs(run, workerCounts[w]);
+
+        int runFailed = 0;
+        int stolen = 0;
+        for (size_t i = 0; i < run.results.size(); i++) {
+            runFailed += run.results[i].failed ? 1 : 0;
+            stolen += run.results[i].stolen ? 1 : 0;
+        }
+        failed += runFailed;
+
+        std::vector<double> latencies;
+        std::vector<double> runTimes;
+        SortedTimes(run, latencies, runTimes);
+
+        double rate = (run.results.size() - runFailed) * 1000.0 / wallMs;
+        if (w == 0)
+            singleWorkerRate = rate;
+
+        DebugLog::Global().Flush();
+        out << std::fixed << std::setprecision(3)
+            << "    " << std::setw(3) << workerCounts[w] << " workers: "
+            << std::setw(9) << rate << " jobs/s, " << std::setprecision(2)
+            << (singleWorkerRate > 0.0 ? rate / singleWorkerRate : 0.0)
+            << "x, " << std::setprecision(3) << "latency p50 "
+            << Percentile(latencies, 50.0) << " p99 "
+            << Percentile(latencies, 99.0) << " ms, run time p50 "
+            << Percentile(runTimes, 50.0) << " ms, " << stolen
+            << " stolen" << (runFailed > 0 ? ", some FAILED" : "") << endl;
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+    return failed;
+}
+
+int RunJobsDemo(const DemoOptions &options, const DemoScene &scene)
+{
+    std::vector<DemoJob> jobs;
+    if (!LoadDemoJobs(options.jobsPath, scene, jobs))
+        return -1;
+
+    // Note: llvmpipe reads this when the display is initialized
+    setenv("LP_NUM_THREADS", "0", 0);
+
+    // The main thread's context only looks up the GL functions, which
+    // every context on the display can call, and builds the program once,
+    // so the workers find it in the program cache.
+    HeadlessContext display;
+    if (!display.Create()) {
+        Log("Failed to create headless context");
+        return -1;
+    }
+
+    if (!GLLoaderInit(eglGetProcAddress, options.glLoader == "lazy")) {
+        Log("Failed to load the OpenGL functions");
+        return -1;
+    }
+
+    const VertexFormat *format = scene.chooseFormat(options);
+    if (format == nullptr)
+        return -1;
+
+    JobsRun run;
+    run.options = &options;
+    run.scene = &scene;
+    run.format = format;
+    run.display = &display;
+    run.jobs = &jobs;
+
+    if (options.shaderCache) {
+        run.shaderCacheDir = options.shaderCacheDir.empty() ?
+                             ProgramCache::DefaultDirectory() :
+                             options.shaderCacheDir;
+    }
+
+    {
+        ProgramCache programCache(run.shaderCacheDir);
+        std::vector<AttributeBinding> attributes =
+            format->AttributeBindings();
+        GLProgram program(programCache.BuildProgram(
+                              scene.programName, scene.vertexShaderSource,
+                              scene.fragmentShaderSource, attributes.data(),
+                              static_cast<int>(attributes.size())));
+
+        if (!program) {
+            Log("Failed to build the shader program");
+            return -1;
+        }
+    }
+
+    int failed;
+    if (options.jobsBenchmark) {
+        failed = BenchmarkJobs(cout, run);
+    }
+    else {
+        int workers = options.workers > 0 ? options.workers : CoreCount();
+        double wallMs = RunJobs(run, workers);
+
+        DebugLog::Global().Flush();
+        failed = ReportJobs(cout, run, wallMs);
+    }
+
+    display.Destroy();
+    return failed > 0 ? -1 : 0;
+}
@@ -0,0 +1,76 @@
+//============================================================================
+// Name        : DemoJobs.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : A Hello Triangle demo, as a batch of offscreen render jobs.
+//
+//               --jobs FILE renders every job in FILE, headless, and
+//               writes each one's frames out, the way --capture does: a
+//               .y4m video, or numbered .ppm images.  A job is a line:
+//
+//                   WxH FRAMES OUTPUT [X Y Z x 3 [R G B x 3]]
+//
+//               its resolution, how many frames, where they go, and,
+//               optionally, its own triangle's corners and their colors,
+//               in place of the demo's.  Blank lines, and anything after
+//               a #, are ignored.  --zoom pans every job's frames, as it
+//               does the demo's.
+//
+//               The jobs run on --workers threads (0 for one per core),
+//               each with an EGL context of its own, on one display,
+//               sharing nothing, so that no two of them ever wait on each
+//               other's objects.  The jobs are dealt out in runs, in file
+//               order, to a WorkStealingDeque per worker, and a worker that
+//               runs out of its own steals from the others' far ends, so
+//               that a run of big jobs doesn't leave the rest idle.
+//
+//               The report gives the jobs per second, and the latency of
+//               each job, from the start of the batch, when every job was
+//               submitted, to its last frame being written, and its run
+//               time, from being picked up.  --jobs-benchmark runs the
+//               whole batch on 1, 2, 4... workers, up to one per core,
+//               instead, to show how it scales.
+//
+//               Note: llvmpipe draws each context on threads of its own,
+//                     one per core, so N workers would run N times as many.
+//                     Unless LP_NUM_THREADS says otherwise, we set it to 0,
+//                     which draws on the worker's own thread, since the
+//                     workers keep every core busy already.
+//
+//============================================================================
+
+#ifndef DEMO_JOBS_H
+#define DEMO_JOBS_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <string>
+#include <vector>
+
+#include "DemoApp.h"
+#include "DemoOptions.h"
+
+struct DemoJob {
+    int line;               // in the job file, for the report
+    int width;
+    int height;
+    int frames;
+    std::string outputPath;
+
+    // the scene's triangle, unless the job has its own
+    GLfloat vertices[9];
+    GLfloat colors[9];
+};
+
+// Read the jobs in path.  Returns false, after saying which line was
+// wrong, if any of them doesn't parse.
+bool LoadDemoJobs(const std::string &path, const DemoScene &scene,
+                  std::vector<DemoJob> &jobs);
+
+// Render the jobs in options.jobsPath, or benchmark them, and return what
+// main() should
+int RunJobsDemo(const DemoOptions &options, const DemoScene &scene);
+
+#endif // DEMO_JOBS_H
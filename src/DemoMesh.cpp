@@ -0,0 +1,311 @@
+//============================================================================
+// Name        : DemoMesh.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Generates or loads the mesh a Hello Triangle demo draws.
+//
+//============================================================================
+
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "DemoMesh.h"
+#include "DebugLog.h"
+#include "MeshFile.h"
+#include "MeshGenerator.h"
+#include "MeshIndexer.h"
+#include "VertexLayout.h"
+
+bool DemoMeshRequested(const DemoOptions &options)
+{
+    return options.subdivisions > 0 || options.gridColumns > 0 ||
+           !options.meshPath.empty();
+}
+
+// The generated shape, written by the generator to out, which is either
+// the mapped vertex buffer or the mapped block of a new mesh file
+static void GenerateShape(const DemoOptions &options,
+                          const MeshGenerator &generator,
+                          const MeshPatch &patch, ColorVertex *out)
+{
+    if (options.subdivisions > 0)
+        generator.GenerateTriangle(patch, options.subdivisions, out);
+    else
+        generator.GenerateGrid(patch, options.gridColumns, options.gridRows,
+                               out);
+}
+
+static void ConfigureGenerator(const DemoOptions &options,
+                               MeshGenerator &generator)
+{
+    MeshGenerator::Kernel kernel = MeshGenerator::KernelAuto;
+    if (options.generator == "scalar")
+        kernel = MeshGenerator::KernelScalar;
+    else if (options.generator == "sse")
+        kernel = MeshGenerator::KernelSSE;
+    else if (options.generator == "avx2")
+        kernel = MeshGenerator::KernelAVX2;
+
+    generator.SetKernel(kernel);
+    generator.SetThreads(options.generatorThreads);
+}
+
+static long long ShapeVertexCount(const DemoOptions &options)
+{
+    return options.subdivisions > 0 ?
+        MeshGenerator::TriangleVertexCount(options.subdivisions) :
+        MeshGenerator::GridVertexCount(options.gridColumns,
+                                       options.gridRows);
+}
+
+static MeshPatch ShapePatch(const DemoOptions &options,
+                            const GLfloat vertices[9],
+                            const GLfloat colors[9])
+{
+    return options.subdivisions > 0 ?
+        MeshGenerator::TrianglePatch(vertices, colors) :
+        MeshGenerator::RectanglePatch(-0.9f, -0.9f, 0.9f, 0.9f, colors);
+}
+
+// Generate the shape into our own memory, weld it into an indexed mesh,
+// and reorder that for the vertex cache.  Then save it to the mesh file,
+// for the caller to load, or upload it into the pipeline's buffers.
+static bool CreateIndexedMesh(const DemoOptions &options,
+                              const MeshGenerator &generator,
+                              const MeshPatch &patch, long long count,
+                              Pipeline &pipeline)
+{
+    // Note: glDrawElements() takes an int count
+    if (count > INT_MAX) {
+        Log("A mesh of %lld indices is too big to draw in one call", count);
+        return false;
+    }
+
+    MeshIndexer indexer;
+    {
+        std::vector<ColorVertex> triangles(static_cast<size_t>(count));
+        GenerateShape(options, generator, patch, triangles.data());
+        indexer.Weld(triangles.data(), count);
+    }
+
+    MeshIndexer::Order order = MeshIndexer::OrderNone;
+    if (options.reorder == "tipsify")
+        order = MeshIndexer::OrderTipsify;
+
+    indexer.Optimize(order, options.vertexCache);
+
+    // Note: after what the startup has logged so far
+    DebugLog::Global().Flush();
+    indexer.Report(cout);
+
+    VertexFormat format = VertexFormat::ColorVertexFormat();
+
+    if (!options.saveMeshPath.empty()) {
+        MeshFile file;
+        if (!file.Create(options.saveMeshPath, format, indexer.VertexCount(),
+                         indexer.IndexCount(), indexer.IndexType()))
+            return false;
+
+        std::memcpy(file.Vertices(), indexer.Vertices().data(),
+                    indexer.Vertices().size() * sizeof(ColorVertex));
+        indexer.WriteIndices(file.Indices());
+        file.Close();
+
+        Log("Saved the mesh to %s", options.saveMeshPath.c_str());
+        return true;
+    }
+
+    // the index buffer binding is part of the vertex array, so it stays
+    glBindBuffer(GL_ARRAY_BUFFER, pipeline.VertexBuffer());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pipeline.CreateIndexBuffer());
+    indexer.Upload(GL_STATIC_DRAW);
+
+    format.PointAttributes();
+    format.EnableAttributes();
+    pipeline.SetFormat(format);
+
+    pipeline.SetCount(static_cast<GLsizei>(indexer.IndexCount()),
+                      indexer.IndexType());
+    return true;
+}
+
+static bool LoadMesh(const DemoOptions &options, const std::string &path,
+                     Pipeline &pipeline)
+{
+    MeshFile file;
+    if (!file.Open(path))
+        return false;
+
+    MeshFile::UploadMode mode = MeshFile::UploadAuto;
+    if (options.meshUpload == "mapped")
+        mode = MeshFile::UploadMapped;
+    else if (options.meshUpload == "streamed")
+        mode = MeshFile::UploadStreamed;
+    else if (options.meshUpload == "read")
+        mode = MeshFile::UploadRead;
+    file.SetUploadMode(mode);
+
+    long long count = file.IndexType() != 0 ? file.IndexCount() :
+                                              file.VertexCount();
+
+    // Note: glDrawArrays() and glDrawElements() take an int count
+    if (count > INT_MAX) {
+        Log("A mesh of %lld vertices is too big to draw in one call",
+            count);
+        return false;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, pipeline.VertexBuffer());
+    if (!file.UploadVertices(GL_STATIC_DRAW))
+        return false;
+
+    file.Format().PointAttributes();
+    file.Format().EnableAttributes();
+    pipeline.SetFormat(file.Format());
+
+    // the index buffer binding is part of the vertex array, so it stays
+    if (file.IndexType() != 0) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pipeline.CreateIndexBuffer());
+
+        if (!file.UploadIndices(GL_STATIC_DRAW))
+            return false;
+    }
+
+    pipeline.SetCount(static_cast<GLsizei>(count), file.IndexType());
+    return true;
+}
+
+bool CreateDemoMesh(const DemoOptions &options, const GLfloat vertices[9],
+                    const GLfloat colors[9], Pipeline &pipeline)
+{
+    std::chrono::steady_clock::time_point begin =
+        std::chrono::steady_clock::now();
+
+    bool generated = options.subdivisions > 0 || options.gridColumns > 0;
+    std::string path = options.meshPath;
+    bool created = true;
+
+    glBindVertexArray(pipeline.VertexArray());
+
+    if (generated) {
+        MeshGenerator generator;
+        ConfigureGenerator(options, generator);
+
+        long long count = ShapeVertexCount(options);
+        MeshPatch patch = ShapePatch(options, vertices, colors);
+
+        if (options.indexed) {
+            created = CreateIndexedMesh(options, generator, patch, count,
+                                        pipeline);
+            if (!options.saveMeshPath.empty())
+                path = options.saveMeshPath;
+        }
+        else if (!options.saveMeshPath.empty()) {
+            // Generate into the mapped file, and load it from there
+            MeshFile file;
+            created = file.Create(options.saveMeshPath,
+                                  VertexFormat::ColorVertexFormat(), count);
+            if (created) {
+                GenerateShape(options, generator, patch,
+                              static_cast<ColorVertex *>(file.Vertices()));
+                file.Close();
+                Log("Saved the mesh to %s", options.saveMeshPath.c_str());
+            }
+
+            path = options.saveMeshPath;
+        }
+        else if (count > INT_MAX) {
+            // Note: glDrawArrays() takes an int count
+            Log("A mesh of %lld vertices is too big to draw in one call",
+                count);
+            created = false;
+        }
+        else {
+            // The generator maps the buffer and writes the vertices
+            // straight into it, so there is no copy of the mesh in our
+            // memory.
+            // Note: drivers warn about mapping a GL_STATIC_DRAW buffer,
+            //       which they may have put where the CPU can't reach
+            glBindBuffer(GL_ARRAY_BUFFER, pipeline.VertexBuffer());
+
+            created = options.subdivisions > 0 ?
+                generator.UploadTriangle(patch, options.subdivisions,
+                                         GL_DYNAMIC_DRAW) :
+                generator.UploadGrid(patch, options.gridColumns,
+                                     options.gridRows, GL_DYNAMIC_DRAW);
+
+            if (created) {
+                VertexFormat format = VertexFormat::ColorVertexFormat();
+                format.PointAttributes();
+                format.EnableAttributes();
+                pipeline.SetFormat(format);
+
+                pipeline.SetCount(static_cast<GLsizei>(count));
+            }
+        }
+
+        if (created) {
+            Log("Generated %lld vertices (%s kernel, %d threads)", count,
+                MeshGenerator::KernelName(generator.ActiveKernel()),
+                generator.Threads());
+        }
+    }
+
+    if (created && !path.empty())
+        created = LoadMesh(options, path, pipeline);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    if (!created)
+        return false;
+
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - begin;
+    Log("Mesh: %d %s, ready in %g ms", static_cast<int>(pipeline.Count()),
+        pipeline.IndexType() != 0 ? "indices" : "vertices",
+        elapsed.count());
+
+    return true;
+}
+
+bool GenerateDemoMesh(const DemoOptions &options, const GLfloat vertices[9],
+                      const GLfloat colors[9], std::vector<ColorVertex> &out)
+{
+    if (!options.meshPath.empty()) {
+        cout << "Only generated meshes can be drawn in memory" << endl;
+        return false;
+    }
+
+    if (options.subdivisions <= 0 && options.gridColumns <= 0) {
+        // just the triangle
+        out.resize(3);
+
+        for (int v = 0; v < 3; v++) {
+            for (int c = 0; c < 3; c++) {
+                out[v].position[c] = vertices[v * 3 + c];
+                out[v].color[c] = ToUNorm8(colors[v * 3 + c]);
+            }
+            out[v].color[3] = ToUNorm8(1.0f);
+        }
+
+        return true;
+    }
+
+    MeshGenerator generator;
+    ConfigureGenerator(options, generator);
+
+    MeshPatch patch = ShapePatch(options, vertices, colors);
+    out.resize(static_cast<size_t>(ShapeVertexCount(options)));
+    GenerateShape(options, generator, patch, out.data());
+
+    return true;
+}
@@ -0,0 +1,48 @@
+//============================================================================
+// Name        : DemoMesh.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : The mesh a Hello Triangle demo draws in place of its own
+//               3 vertices, when the command line asks for one.
+//
+//               It is either generated on the CPU (--subdivide, --grid),
+//               straight into the vertex buffer, or loaded from a mesh file
+//               (--mesh).  --save-mesh writes the generated mesh to a file,
+//               and then loads it back from there, the way --mesh would.
+//               --indexed welds the generated mesh's shared vertices and
+//               reorders its triangles first (see MeshIndexer.h), and it
+//               is drawn, or saved, with an index buffer.
+//
+//============================================================================
+
+#ifndef DEMO_MESH_H
+#define DEMO_MESH_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <vector>
+
+#include "DemoOptions.h"
+#include "Pipeline.h"
+#include "VertexLayout.h"
+
+// whether the options ask for a mesh at all
+bool DemoMeshRequested(const DemoOptions &options);
+
+// Fill the pipeline's vertex buffer with the mesh, point its vertex
+// array's attributes into it, and set its count.  A mesh file with indices
+// fills the pipeline's index buffer too.
+// The triangle's corners and colors (3 floats each) shape the generated
+// meshes.
+bool CreateDemoMesh(const DemoOptions &options, const GLfloat vertices[9],
+                    const GLfloat colors[9], Pipeline &pipeline);
+
+// The triangle, or the generated shape the options ask for, into our own
+// memory, for the software rasterizer.  Returns false, after saying why,
+// if it can't be generated (a mesh file).
+bool GenerateDemoMesh(const DemoOptions &options, const GLfloat vertices[9],
+                      const GLfloat colors[9], std::vector<ColorVertex> &out);
+
+#endif // DEMO_MESH_H
@@ -0,0 +1,557 @@
+//============================================================================
+// Name        : DemoOptions.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Command line parsing for the Hello Triangle demos.
+//
+//               Note: We stick to plain C++ 11 here, no getopt, so that
+//                     this will still build on the Mac as well as Linux.
+//
+//============================================================================
+
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "DemoOptions.h"
+#include "FileUtil.h"
+
+// parse a strictly positive integer, rejecting any trailing garbage
+static bool ParsePositiveInt(const char *text, int &value)
+{
+    char *end = nullptr;
+    long parsed = std::strtol(text, &end, 10);
+
+    if (end == text || *end != '\0' || parsed <= 0 || parsed > 1000000000L)
+        return false;
+
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+// a number of milliseconds, or a fraction, which has to be more than 0
+static bool ParsePositiveDouble(const char *text, double &value)
+{
+    char *end = nullptr;
+    double parsed = std::strtod(text, &end);
+
+    if (end == text || *end != '\0' || !(parsed > 0.0) || parsed > 1.0e9)
+        return false;
+
+    value = parsed;
+    return true;
+}
+
+// same as above, but zero is allowed
+static bool ParseCount(const char *text, int &value)
+{
+    if (std::strcmp(text, "0") == 0) {
+        value = 0;
+        return true;
+    }
+
+    return ParsePositiveInt(text, value);
+}
+
+// parse a resolution in the form WIDTHxHEIGHT, e.g. 1920x1080
+static bool ParseSize(const char *text, int &width, int &height)
+{
+    int w, h;
+    char trailing;
+
+    if (std::sscanf(text, "%dx%d%c", &w, &h, &trailing) != 2)
+        return false;
+
+    if (w <= 0 || h <= 0)
+        return false;
+
+    width = w;
+    height = h;
+    return true;
+}
+
+bool ParseDemoOptions(int argc, char *argv[], DemoOptions &options)
+{
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+
+        // every option except the flags takes a single value
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        bool valid = true;
+
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            PrintDemoUsage(argv[0]);
+            return false;
+        }
+        else if (std::strcmp(arg, "--headless") == 0) {
+            options.headless = true;
+        }
+        else if (std::strcmp(arg, "--frames") == 0) {
+            valid = value && ParsePositiveInt(value, options.frames);
+            i++;
+        }
+        else if (std::strcmp(arg, "--warmup") == 0) {
+            valid = value && ParseCount(value, options.warmupFrames);
+            i++;
+        }
+        else if (std::strcmp(arg, "--profile") == 0) {
+            options.profile = true;
+        }
+        else if (std::strcmp(arg, "--timing-csv") == 0) {
+            valid = value != nullptr;
+            if (valid) {
+                options.timingCsvPath = value;
+                options.profile = true;
+            }
+            i++;
+        }
+        else if (std::strcmp(arg, "--triangles") == 0) {
+            valid = value && ParsePositiveInt(value, options.triangles);
+            i++;
+        }
+        else if (std::strcmp(arg, "--batch-size") == 0) {
+            valid = value && ParseCount(value, options.batchSize);
+            i++;
+        }
+        else if (std::strcmp(arg, "--batch-mode") == 0) {
+            valid = value && (std::strcmp(value, "auto") == 0 ||
+                              std::strcmp(value, "instanced") == 0 ||
+                              std::strcmp(value, "merged") == 0 ||
+                              std::strcmp(value, "streamed") == 0 ||
+                              std::strcmp(value, "uniform-buffer") == 0 ||
+                              std::strcmp(value, "texture-buffer") == 0);
+            if (valid)
+                options.batchMode = value;
+            i++;
+        }
+        else if (std::strcmp(arg, "--animate") == 0) {
+            options.batchMode = "streamed";
+        }
+        else if (std::strcmp(arg, "--shader-cache") == 0) {
+            valid = value != nullptr;
+            if (valid)
+                options.shaderCacheDir = value;
+            i++;
+        }
+        else if (std::strcmp(arg, "--no-shader-cache") == 0) {
+            options.shaderCache = false;
+        }
+        else if (std::strcmp(arg, "--sequential-startup") == 0) {
+            options.sequentialStartup = true;
+        }
+        else if (std::strcmp(arg, "--vertex-format") == 0) {
+            valid = value && (std::strcmp(value, "auto") == 0 ||
+                              std::strcmp(value, "packed") == 0 ||
+                              std::strcmp(value, "float") == 0);
+            if (valid)
+                options.vertexFormat = value;
+            i++;
+        }
+        else if (std::strcmp(arg, "--pacing") == 0) {
+            valid = value && (std::strcmp(value, "on-demand") == 0 ||
+                              std::strcmp(value, "continuous") == 0 ||
+                              std::strcmp(value, "capped") == 0 ||
+                              std::strcmp(value, "vsync") == 0);
+            if (valid)
+                options.pacing = value;
+            i++;
+        }
+        else if (std::strcmp(arg, "--fps") == 0) {
+            valid = value && ParsePositiveInt(value, options.fps);
+            if (valid)
+                options.pacing = "capped";
+            i++;
+        }
+        else if (std::strcmp(arg, "--swap-interval") == 0) {
+            valid = value && ParsePositiveInt(value, options.swapInterval);
+            if (valid)
+                options.pacing = "vsync";
+            i++;
+        }
+        else if (std::strcmp(arg, "--single-thread") == 0) {
+            options.singleThread = true;
+        }
+        else if (std::strcmp(arg, "--no-state-cache") == 0) {
+            options.stateCache = false;
+        }
+        else if (std::strcmp(arg, "--subdivide") == 0) {
+            valid = value && ParsePositiveInt(value, options.subdivisions);
+            i++;
+        }
+        else if (std::strcmp(arg, "--grid") == 0) {
+            valid = value && ParseSize(value, options.gridColumns,
+                                       options.gridRows);
+            i++;
+        }
+        else if (std::strcmp(arg, "--generator") == 0) {
+            valid = value && (std::strcmp(value, "auto") == 0 ||
+                              std::strcmp(value, "scalar") == 0 ||
+                              std::strcmp(value, "sse") == 0 ||
+                              std::strcmp(value, "avx2") == 0);
+            if (valid)
+                options.generator = value;
+            i++;
+        }
+        else if (std::strcmp(arg, "--generator-threads") == 0) {
+            valid = value && ParseCount(value, options.generatorThreads);
+            i++;
+        }
+        else if (std::strcmp(arg, "--generator-benchmark") == 0) {
+            options.generatorBenchmark = true;
+        }
+        else if (std::strcmp(arg, "--mesh") == 0) {
+            valid = value != nullptr;
+            if (valid)
+                options.meshPath = value;
+            i++;
+        }
+        else if (std::strcmp(arg, "--save-mesh") == 0) {
+            valid = value != nullptr;
+            if (valid)
+                options.saveMeshPath = value;
+            i++;
+        }
+        else if (std::strcmp(arg, "--mesh-upload") == 0) {
+            valid = value && (std::strcmp(value, "auto") == 0 ||
+                              std::strcmp(value, "mapped") == 0 ||
+                              std::strcmp(value, "streamed") == 0 ||
+                              std::strcmp(value, "read") == 0);
+            if (valid)
+                options.meshUpload = value;
+            i++;
+        }
+        else if (std::strcmp(arg, "--mesh-benchmark") == 0) {
+            valid = value != nullptr;
+            if (valid)
+                options.meshBenchmarkDir = value;
+            i++;
+        }
+        else if (std::strcmp(arg, "--capture") == 0) {
+            valid = value != nullptr;
+            if (valid)
+                options.capturePath = value;
+            i++;
+        }
+        else if (std::strcmp(arg, "--capture-ring") == 0) {
+            valid = value && ParseCount(value, options.captureRing);
+            i++;
+        }
+        else if (std::strcmp(arg, "--handle-benchmark") == 0) {
+            options.handleBenchmark = true;
+        }
+        else if (std::strcmp(arg, "--windows") == 0) {
+            valid = value && ParsePositiveInt(value, options.windows);
+            i++;
+        }
+        else if (std::strcmp(arg, "--zoom") == 0) {
+            valid = value && ParsePositiveInt(value, options.zoom);
+            i++;
+        }
+        else if (std::strcmp(arg, "--cull") == 0) {
+            options.cull = true;
+        }
+        else if (std::strcmp(arg, "--cull-chunk") == 0) {
+            valid = value && ParsePositiveInt(value, options.cullChunk);
+            i++;
+        }
+        else if (std::strcmp(arg, "--cull-threads") == 0) {
+            valid = value && ParseCount(value, options.cullThreads);
+            i++;
+        }
+        else if (std::strcmp(arg, "--indexed") == 0) {
+            options.indexed = true;
+        }
+        else if (std::strcmp(arg, "--reorder") == 0) {
+            valid = value && (std::strcmp(value, "none") == 0 ||
+                              std::strcmp(value, "tipsify") == 0);
+            if (valid)
+                options.reorder = value;
+            i++;
+        }
+        else if (std::strcmp(arg, "--vertex-cache") == 0) {
+            valid = value && ParsePositiveInt(value, options.vertexCache);
+            i++;
+        }
+        else if (std::strcmp(arg, "--shader-dir") == 0) {
+            valid = value != nullptr;
+            if (valid)
+                options.shaderDir = value;
+            i++;
+        }
+        else if (std::strcmp(arg, "--software") == 0) {
+            options.software = true;
+        }
+        else if (std::strcmp(arg, "--software-threads") == 0) {
+            valid = value && ParseCount(value, options.softwareThreads);
+            i++;
+        }
+        else if (std::strcmp(arg, "--software-benchmark") == 0) {
+            options.softwareBenchmark = true;
+        }
+        else if (std::strcmp(arg, "--software-check") == 0) {
+            options.softwareCheck = true;
+        }
+        else if (std::strcmp(arg, "--gl-loader") == 0) {
+            valid = value && (std::strcmp(value, "batch") == 0 ||
+                              std::strcmp(value, "lazy") == 0);
+            if (valid)
+                options.glLoader = value;
+            i++;
+        }
+        else if (std::strcmp(arg, "--trace-startup") == 0) {
+            valid = value != nullptr;
+            if (valid)
+                options.traceStartupPath = value;
+            i++;
+        }
+        else if (std::strcmp(arg, "--dynamic-resolution") == 0) {
+            valid = value &&
+                    ParsePositiveDouble(value, options.dynamicResolutionMs);
+            i++;
+        }
+        else if (std::strcmp(arg, "--min-scale") == 0) {
+            valid = value && ParsePositiveDouble(value, options.minScale) &&
+                    options.minScale <= 1.0;
+            i++;
+        }
+        else if (std::strcmp(arg, "--resolution-csv") == 0) {
+            valid = value != nullptr;
+            if (valid)
+                options.resolutionCsvPath = value;
+            i++;
+        }
+        else if (std::strcmp(arg, "--jobs") == 0) {
+            valid = value != nullptr;
+            if (valid)
+                options.jobsPath = value;
+            i++;
+        }
+        else if (std::strcmp(arg, "--workers") == 0) {
+            valid = value && ParseCount(value, options.workers);
+            i++;
+        }
+        else if (std::strcmp(arg, "--jobs-benchmark") == 0) {
+            options.jobsBenchmark = true;
+        }
+        else if (std::strcmp(arg, "--size") == 0) {
+            valid = value && ParseSize(value, options.width, options.height);
+            i++;
+        }
+        else {
+            cout << "Unknown option: " << arg << endl;
+            PrintDemoUsage(argv[0]);
+            return false;
+        }
+
+        if (!valid) {
+            cout << "Bad or missing value for option: " << arg << endl;
+            PrintDemoUsage(argv[0]);
+            return false;
+        }
+    }
+
+    // Note: the other windows only share the buffers and programs, so they
+    //       draw our triangle or mesh, each on its own thread
+    if (options.windows > 1 && (options.headless || options.singleThread ||
+                                options.triangles > 1 ||
+                                options.batchMode != "auto")) {
+        cout << "--windows can't be used with --headless, --single-thread, "
+                "--triangles or --batch-mode" << endl;
+        return false;
+    }
+
+    // Note: only the pipeline's own program is reloaded, not the batch's.
+    //       The other windows' threads would need telling as well, and
+    //       the single threaded loop only wakes up for input.
+    if (!options.shaderDir.empty() && (options.windows > 1 ||
+                                       options.singleThread ||
+                                       options.triangles > 1 ||
+                                       options.batchMode != "auto")) {
+        cout << "--shader-dir can't be used with --windows, --single-thread, "
+                "--triangles or --batch-mode" << endl;
+        return false;
+    }
+
+    // Note: the software rasterizer only draws what our shaders do, to the
+    //       triangle or a generated mesh
+    bool software = options.software || options.softwareBenchmark ||
+                    options.softwareCheck;
+    if (software && (options.windows > 1 || options.triangles > 1 ||
+                     options.batchMode != "auto" ||
+                     !options.meshPath.empty() ||
+                     !options.shaderDir.empty())) {
+        cout << "The software rasterizer can't be used with --windows, "
+                "--triangles, --batch-mode, --mesh or --shader-dir" << endl;
+        return false;
+    }
+
+    if ((options.software || options.softwareBenchmark) &&
+            options.headless) {
+        cout << "--software doesn't use OpenGL, so it needs no --headless"
+             << endl;
+        return false;
+    }
+
+    if (options.softwareCheck && !options.headless) {
+        cout << "--software-check compares with OpenGL, and needs --headless"
+             << endl;
+        return false;
+    }
+
+    // Note: the other windows draw on threads of their own, at full size,
+    //       and the check compares full size frames
+    if (options.dynamicResolutionMs > 0.0 && (options.windows > 1 ||
+                                             options.softwareCheck)) {
+        cout << "--dynamic-resolution can't be used with --windows or "
+                "--software-check" << endl;
+        return false;
+    }
+
+    // Note: the frame number goes in the one %d, and nothing else may
+    //       follow a %
+    if (!options.capturePath.empty() &&
+        !EndsWith(options.capturePath, ".y4m") &&
+        !ValidFramePattern(options.capturePath)) {
+        cout << "--capture can have one %d in it, like frames/%04d.ppm, "
+                "and %% for a %, but nothing else after a %" << endl;
+        return false;
+    }
+
+    // Note: each job draws its own triangle, on a worker's context, and
+    //       writes its own frames
+    bool jobs = !options.jobsPath.empty();
+    if (jobs && (options.windows > 1 || options.triangles > 1 ||
+                 options.batchMode != "auto" || software ||
+                 options.subdivisions > 0 || options.gridColumns > 0 ||
+                 !options.meshPath.empty() || !options.shaderDir.empty() ||
+                 !options.capturePath.empty() ||
+                 options.dynamicResolutionMs > 0.0)) {
+        cout << "--jobs can't be used with --windows, --triangles, "
+                "--batch-mode, --subdivide, --grid, --mesh, --shader-dir, "
+                "--capture, --dynamic-resolution or the software rasterizer"
+             << endl;
+        return false;
+    }
+
+    if (options.jobsBenchmark && !jobs) {
+        cout << "--jobs-benchmark needs --jobs" << endl;
+        return false;
+    }
+
+    return true;
+}
+
+void PrintDemoUsage(const char *programName)
+{
+    cout << "Usage: " << programName << " [options]" << endl
+         << "    --headless       render offscreen (EGL) and print frame "
+            "time statistics" << endl
+         << "    --frames N       number of measured frames in headless "
+            "mode (default 1000)" << endl
+         << "    --warmup N       unmeasured frames rendered first "
+            "(default 10)" << endl
+         << "    --size WxH       window or framebuffer resolution "
+            "(default 800x600)" << endl
+         << "    --profile        time the clear/draw/swap stages on the "
+            "CPU and GPU" << endl
+         << "    --timing-csv F   write the per-frame stage timings to F "
+            "(implies --profile)" << endl
+         << "    --triangles N    draw N copies of the triangle "
+            "(default 1)" << endl
+         << "    --batch-size N   triangles per draw call, 0 for all "
+            "(default 0)" << endl
+         << "    --batch-mode M   auto, instanced, merged, streamed, "
+            "uniform-buffer or texture-buffer" << endl
+         << "                     (default auto)" << endl
+         << "    --animate        spin the triangles, streaming new "
+            "vertices every frame" << endl
+         << "    --shader-cache D keep program binaries in directory D "
+            "(default ~/.cache/hello_triangle)" << endl
+         << "    --no-shader-cache  always compile the shaders from source"
+         << endl
+         << "    --sequential-startup  compile the shaders one at a time, "
+            "the old way" << endl
+         << "    --no-state-cache  pass every bind straight to OpenGL"
+         << endl
+         << "    --vertex-format F  auto, packed or float vertices "
+            "(default auto)" << endl
+         << "    --pacing P       when a window draws: on-demand, "
+            "continuous, capped or vsync (default on-demand)" << endl
+         << "    --fps N          cap the frame rate at N "
+            "(implies --pacing capped, default 60)" << endl
+         << "    --swap-interval N  swap every N refreshes "
+            "(implies --pacing vsync, default 1)" << endl
+         << "    --single-thread  render on the main thread, between events"
+         << endl
+         << "    --subdivide N    draw the triangle as N x N little ones, "
+            "generated on the CPU" << endl
+         << "    --grid WxH       draw a generated grid of W x H cells"
+         << endl
+         << "    --generator K    auto, scalar, sse or avx2 mesh generator "
+            "(default auto)" << endl
+         << "    --generator-threads N  threads generating the mesh, 0 for "
+            "one per core (default 0)" << endl
+         << "    --generator-benchmark  time the mesh generators "
+            "(--subdivide sets the size), then exit" << endl
+         << "    --mesh F         draw the mesh in file F" << endl
+         << "    --save-mesh F    write the generated mesh to file F, and "
+            "draw it from there" << endl
+         << "    --mesh-upload M  auto, mapped, streamed or read "
+            "(default auto)" << endl
+         << "    --mesh-benchmark D  time loading meshes from files in "
+            "directory D, then exit" << endl
+         << "    --capture F      record the frames to F, a .y4m video or "
+            "numbered .ppm images" << endl
+         << "    --capture-ring N  pixel buffers to read frames back "
+            "through, 0 for none (default 3)" << endl
+         << "    --handle-benchmark  time the GL handles against bare "
+            "names, then exit" << endl
+         << "    --windows N      open N windows drawing the same "
+            "geometry, each on its own thread" << endl
+         << "    --zoom N         zoom N times into the scene, panning "
+            "around it" << endl
+         << "    --cull           only draw the chunks of the mesh that "
+            "are in view" << endl
+         << "    --cull-chunk N   triangles per culled chunk "
+            "(default 1024)" << endl
+         << "    --cull-threads N  threads culling, 0 for one per core "
+            "(default 0)" << endl
+         << "    --indexed        weld the generated mesh and draw it "
+            "with an index buffer" << endl
+         << "    --reorder M      none or tipsify, the order of indexed "
+            "triangles (default tipsify)" << endl
+         << "    --vertex-cache N  vertex cache size to reorder for "
+            "(default 16)" << endl
+         << "    --shader-dir D   load the shaders from directory D, and "
+            "reload them when they change" << endl
+         << "    --software       render on the CPU, without OpenGL, and "
+            "print frame time statistics" << endl
+         << "    --software-threads N  threads rendering on the CPU, 0 for "
+            "one per core (default 0)" << endl
+         << "    --software-benchmark  time the software rasterizer on 1 "
+            "thread up to N, then exit" << endl
+         << "    --software-check  draw a frame with OpenGL and on the CPU, "
+            "compare them, then exit" << endl
+         << "    --gl-loader M    batch or lazy, when the GL functions are "
+            "looked up (default batch)" << endl
+         << "    --trace-startup F  write the startup phases to F, as a "
+            "Chrome trace" << endl
+         << "    --dynamic-resolution MS  render at a scale that holds MS "
+            "of GPU time per frame" << endl
+         << "    --min-scale S    the lowest dynamic resolution scale "
+            "(default 0.5)" << endl
+         << "    --resolution-csv F  write each frame's scale and times "
+            "to F" << endl
+         << "    --jobs F         render the jobs in F offscreen, on "
+            "every core, then exit" << endl
+         << "    --workers N      threads running the jobs, 0 for one per "
+            "core (default 0)" << endl
+         << "    --jobs-benchmark  run the jobs on 1 worker up to N, then "
+            "exit" << endl
+         << "    --help           show this message" << endl;
+}
@@ -0,0 +1,190 @@
+//============================================================================
+// Name        : DemoOptions.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Command line options shared by the Hello Triangle demos.
+//
+//               With no arguments, the demos behave as they always have,
+//               opening an 800x600 window and rendering until the user
+//               closes it.
+//
+//               --headless renders into an offscreen framebuffer instead
+//               of a window, which lets us run on build boxes that have
+//               no display and no GPU (Mesa llvmpipe is fine), and get
+//               repeatable frame timings for the draw path.
+//
+//============================================================================
+
+#ifndef DEMO_OPTIONS_H
+#define DEMO_OPTIONS_H
+
+#include <string>
+
+struct DemoOptions {
+    bool headless = false;
+
+    // resolution of the window, or of the offscreen framebuffer
+    int width = 800;
+    int height = 600;
+
+    // headless mode renders a fixed number of frames and then exits.
+    // The warmup frames are rendered first, but not measured.
+    int frames = 1000;
+    int warmupFrames = 10;
+
+    // time the clear, draw and swap stages of each frame, on the CPU and
+    // with GPU timer queries, and report them on exit.
+    // Asking for a CSV file turns the profiling on too.
+    bool profile = false;
+    std::string timingCsvPath;
+
+    // How many copies of the triangle to draw, and how many of them go
+    // into each draw call (0 means all of them in one call).
+    // A single triangle is drawn the way it always has been.
+    // --animate is short for the streamed mode, where the triangles spin
+    // and are generated on the CPU and uploaded again every frame.  In the
+    // uniform-buffer and texture-buffer modes they spin too, but only each
+    // copy's transform and color is uploaded, into one buffer.
+    int triangles = 1;
+    int batchSize = 0;
+    std::string batchMode = "auto";    // auto, instanced, merged, streamed,
+                                       // uniform-buffer, texture-buffer
+
+    // Where linked program binaries are kept between runs.  An empty
+    // directory means the default, ~/.cache/hello_triangle
+    bool shaderCache = true;
+    std::string shaderCacheDir;
+
+    // Build each shader program completely before moving on, instead of
+    // letting the driver compile them while we set up our buffers.
+    // Only useful for comparing the startup times.
+    bool sequentialStartup = false;
+
+    // Skip the binds and uses that wouldn't change anything.
+    // Turning it off is only useful for measuring what it saves.
+    bool stateCache = true;
+
+    // How HelloColorTriangle stores its vertices: packed is half float
+    // positions and byte colors, float is the old 3 floats each.  Both are
+    // interleaved in one buffer.  Auto is packed, if the platform has
+    // half float vertices.
+    std::string vertexFormat = "auto";   // auto, packed, float
+
+    // Render on the main thread, between handling events, the way we
+    // used to, instead of on a thread of its own.
+    bool singleThread = false;
+
+    // When a window draws its frames:
+    // on-demand only when something changed, continuous as fast as it
+    // can, capped at most fps frames per second, or vsync every
+    // swapInterval refreshes.
+    std::string pacing = "on-demand";  // on-demand, continuous, capped, vsync
+    int fps = 60;
+    int swapInterval = 1;
+
+    // Draw a generated mesh instead of our 3 vertices: the triangle cut
+    // into subdivisions x subdivisions little ones, or a grid of
+    // gridColumns x gridRows cells across the window (0 means neither).
+    // The generator runs on generatorThreads threads (0 means one per
+    // core), with the best SIMD kernel the CPU has, unless told otherwise.
+    int subdivisions = 0;
+    int gridColumns = 0;
+    int gridRows = 0;
+    std::string generator = "auto";    // auto, scalar, sse, avx2
+    int generatorThreads = 0;
+
+    // time every generator kernel, then exit
+    bool generatorBenchmark = false;
+
+    // Draw the mesh in this file instead (see MeshFile.h), or write the
+    // generated mesh to a file and draw it from there.  The upload mode is
+    // auto, mapped, streamed or read.
+    std::string meshPath;
+    std::string saveMeshPath;
+    std::string meshUpload = "auto";
+
+    // load meshes of growing size from files in this directory, every
+    // way we can, then exit
+    std::string meshBenchmarkDir;
+
+    // Record every frame to this file: a .y4m video, or else a sequence of
+    // PPM images.  They are read back through a ring of captureRing pixel
+    // buffers (0 reads each one back straight away, the slow way).
+    std::string capturePath;
+    int captureRing = 3;
+
+    // time our GL handles against bare object names, then exit
+    bool handleBenchmark = false;
+
+    // Open this many windows, sharing one set of buffers and programs,
+    // each drawn by its own render thread.  Only the first one is profiled
+    // and captured.
+    int windows = 1;
+
+    // Zoom into the middle of the scene zoom times, panning around in a
+    // slow circle, so that most of a big mesh is off screen.
+    int zoom = 1;
+
+    // Split the mesh into chunks of cullChunk triangles, in a bounding
+    // volume hierarchy, and only draw the chunks in view.  Culling runs on
+    // cullThreads threads (0 for one per core).
+    bool cull = false;
+    int cullChunk = 1024;
+    int cullThreads = 0;
+
+    // Weld the generated mesh's shared vertices and draw it with an index
+    // buffer, with its triangles reordered for a post-transform vertex
+    // cache of vertexCache vertices (see MeshIndexer.h).
+    bool indexed = false;
+    std::string reorder = "tipsify";   // none, tipsify
+    int vertexCache = 16;
+
+    // Load the shaders from <program>.vert and <program>.frag in this
+    // directory (writing the built-in ones there first), and rebuild the
+    // program on a worker thread whenever they change.
+    std::string shaderDir;
+
+    // Render on the CPU, with the SoftwareRasterizer, on softwareThreads
+    // threads (0 for one per core), instead of OpenGL.  The benchmark
+    // times it on more and more threads, and the check draws one frame
+    // both ways (headless), and compares them.
+    bool software = false;
+    int softwareThreads = 0;
+    bool softwareBenchmark = false;
+    bool softwareCheck = false;
+
+    // Look up the GL functions all at once, or each on its first call
+    // (see GLLoader.h)
+    std::string glLoader = "batch";   // batch, lazy
+
+    // Write the time each step of startup took, up to the end of the first
+    // frame, to this file, in the Chrome trace event format
+    std::string traceStartupPath;
+
+    // Render into an offscreen framebuffer, at a fraction of the output's
+    // size that holds dynamicResolutionMs of GPU time per frame (0 for
+    // off), but no less than minScale, and upscale it (see
+    // DynamicResolution.h).  Each frame's scale and times can be written
+    // to resolutionCsvPath.
+    double dynamicResolutionMs = 0.0;
+    double minScale = 0.5;
+    std::string resolutionCsvPath;
+
+    // Render every job in this file offscreen, on workers threads (0 for
+    // one per core), each with a context of its own, and report the jobs
+    // per second and their latencies (see DemoJobs.h).  The benchmark runs
+    // them on 1, 2, 4... workers instead.
+    std::string jobsPath;
+    int workers = 0;
+    bool jobsBenchmark = false;
+};
+
+// Fills in the options from the command line.
+// Returns false (after printing the usage) if the arguments don't make
+// sense, or if the user simply asked for --help.
+bool ParseDemoOptions(int argc, char *argv[], DemoOptions &options);
+
+void PrintDemoUsage(const char *programName);
+
+#endif // DEMO_OPTIONS_H
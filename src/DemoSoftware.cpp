@@ -0,0 +1,210 @@
+//============================================================================
+// Name        : DemoSoftware.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : A Hello Triangle demo, rendered on the CPU.
+//
+//============================================================================
+
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "DemoMesh.h"
+#include "DemoSoftware.h"
+#include "FileUtil.h"
+#include "FrameBenchmark.h"
+#include "SoftwareRasterizer.h"
+
+// How far the check lets the two frames drift apart: pixels that only one
+// of them covers, along the edges, as a fraction of the frame, and the
+// difference in a color channel, where both cover a pixel
+static const double CheckCoverageTolerance = 0.001;
+static const int CheckColorTolerance = 1;
+
+// the scene's colors, and how it fills its triangles
+static void SetUpRasterizer(const DemoScene &scene,
+                            SoftwareRasterizer &rasterizer)
+{
+    const GLfloat flatColor[4] = {scene.colors[0], scene.colors[1],
+                                  scene.colors[2], 1.0f};
+
+    rasterizer.SetClearColor(DemoClearColor);
+    rasterizer.SetFlatColor(scene.flat ? flatColor : nullptr);
+}
+
+int RunSoftwareDemo(const DemoOptions &options, const DemoScene &scene)
+{
+    std::vector<ColorVertex> vertices;
+    if (!GenerateDemoMesh(options, scene.vertices, scene.colors, vertices))
+        return -1;
+
+    long long count = static_cast<long long>(vertices.size());
+
+    if (options.softwareBenchmark) {
+        const GLfloat flatColor[4] = {scene.colors[0], scene.colors[1],
+                                      scene.colors[2], 1.0f};
+        GLfloat view[4];
+        DemoPanView(options.zoom, 0, view);
+
+        SoftwareRasterizer::Benchmark(cout, options.width, options.height,
+                                      options.softwareThreads,
+                                      DemoClearColor,
+                                      scene.flat ? flatColor : nullptr,
+                                      view, vertices.data(), count);
+        return 0;
+    }
+
+    if (!options.capturePath.empty() && !EndsWith(options.capturePath,
+                                                  ".ppm")) {
+        cout << "--software can only capture .ppm images" << endl;
+        return -1;
+    }
+
+    SoftwareRasterizer rasterizer;
+    rasterizer.SetThreads(options.softwareThreads);
+    if (!rasterizer.Create(options.width, options.height))
+        return -1;
+
+    SetUpRasterizer(scene, rasterizer);
+
+    cout << "Rendering " << count / 3 << " triangles on the CPU, "
+         << SoftwareRasterizer::KernelName(rasterizer.ActiveKernel())
+         << " kernel, " << rasterizer.Threads() << " threads" << endl;
+
+    // Render a fixed number of frames as fast as we can, like the
+    // headless mode
+    long long frame = 0;
+    GLfloat view[4];
+
+    for (int i = 0; i < options.warmupFrames; i++) {
+        DemoPanView(options.zoom, frame++, view);
+        rasterizer.SetView(view);
+        rasterizer.Render(vertices.data(), count);
+    }
+
+    FrameBenchmark benchmark(options.frames,
+                             static_cast<long long>(options.width) *
+                             options.height,
+                             count / 3);
+    long long captured = 0;
+    bool captureFailed = false;
+
+    for (int i = 0; i < options.frames; i++) {
+        benchmark.BeginFrame();
+
+        DemoPanView(options.zoom, frame++, view);
+        rasterizer.SetView(view);
+        rasterizer.Render(vertices.data(), count);
+
+        benchmark.EndFrame();
+
+        // Note: outside the frame time, since the GL capture is mostly
+        //       done on a thread of its own
+        if (!options.capturePath.empty() && !captureFailed) {
+            captureFailed = !rasterizer.WritePPM(
+                FrameFileName(options.capturePath, captured));
+            if (!captureFailed)
+                captured++;
+        }
+    }
+
+    benchmark.Report(cout);
+    rasterizer.Report(cout);
+
+    if (!options.capturePath.empty()) {
+        cout << "Frame capture: " << captured << " frames written"
+             << (captureFailed ? ", writing FAILED" : "") << endl;
+    }
+
+    rasterizer.Destroy();
+    return captureFailed ? -1 : 0;
+}
+
+bool CheckSoftwareFrame(const DemoOptions &options, const DemoScene &scene,
+                        const GLfloat view[4], int width, int height)
+{
+    std::vector<uint32_t> drawn(static_cast<size_t>(width) * height);
+
+    // Note: tightly packed RGBA rows, bottom first, like the rasterizer's
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
+                 drawn.data());
+
+    std::vector<ColorVertex> vertices;
+    if (!GenerateDemoMesh(options, scene.vertices, scene.colors, vertices))
+        return false;
+
+    SoftwareRasterizer rasterizer;
+    rasterizer.SetThreads(options.softwareThreads);
+    if (!rasterizer.Create(width, height))
+        return false;
+
+    SetUpRasterizer(scene, rasterizer);
+    rasterizer.SetView(view);
+    rasterizer.Render(vertices.data(),
+                      static_cast<long long>(vertices.size()));
+
+    // A pixel that only one of them covers still has the clear color in
+    // the other one
+    uint32_t clearColor = SoftwareRasterizer::PackColor(DemoClearColor);
+
+    long long differing = 0;
+    long long coverage = 0;
+    int largest = 0;
+
+    for (int y = 0; y < height; y++) {
+        const uint32_t *software = rasterizer.Row(y);
+        const uint32_t *gl = drawn.data() + static_cast<size_t>(y) * width;
+
+        for (int x = 0; x < width; x++) {
+            if (software[x] == gl[x])
+                continue;
+
+            differing++;
+
+            if (software[x] == clearColor || gl[x] == clearColor) {
+                coverage++;
+                continue;
+            }
+
+            for (int i = 0; i < 4; i++) {
+                int a = (software[x] >> (i * 8)) & 0xFF;
+                int b = (gl[x] >> (i * 8)) & 0xFF;
+                largest = std::max(largest, std::abs(a - b));
+            }
+        }
+    }
+
+    rasterizer.Destroy();
+
+    double pixels = static_cast<double>(width) * height;
+    bool passed = coverage <= CheckCoverageTolerance * pixels &&
+                  largest <= CheckColorTolerance;
+
+    cout << std::fixed << std::setprecision(3)
+         << "Software check: " << width << "x" << height << ", "
+         << vertices.size() / 3 << " triangles, against "
+         << glGetString(GL_RENDERER) << endl
+         << "    " << differing << " pixels differ ("
+         << 100.0 * differing / pixels << "%), " << coverage
+         << " of them covered by only one ("
+         << 100.0 * coverage / pixels << "%)" << endl
+         << "    largest color difference where both cover a pixel: "
+         << largest << endl
+         << "    " << (passed ? "PASSED" : "FAILED") << endl;
+
+    cout.unsetf(std::ios_base::floatfield);
+    cout << std::setprecision(6);
+
+    return passed;
+}
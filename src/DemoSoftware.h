@@ -0,0 +1,44 @@
+//============================================================================
+// Name        : DemoSoftware.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : A Hello Triangle demo, rendered on the CPU.
+//
+//               On a machine with no GPU, and no OpenGL, the demos used to
+//               stop at glfwCreateWindow(), or at loading the OpenGL
+//               functions.  --software draws the same frames with the
+//               SoftwareRasterizer instead, without a window, a context, or
+//               any OpenGL: the triangle, or the generated mesh, with the
+//               same pan and zoom, and the flat or blended colors of the
+//               demo's fragment shader.  Like the headless mode, it
+//               renders --frames frames and reports the frame times, and
+//               --capture writes them out as .ppm images.
+//
+//               --software-benchmark times the rasterizer on 1, 2, 4...
+//               threads instead, and --software-check draws one frame with
+//               OpenGL (headless, so llvmpipe on a machine without a GPU)
+//               and one on the CPU, and compares them pixel by pixel.
+//
+//============================================================================
+
+#ifndef DEMO_SOFTWARE_H
+#define DEMO_SOFTWARE_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include "DemoApp.h"
+#include "DemoOptions.h"
+
+// Render the demo on the CPU, or benchmark the rasterizer, and return
+// what main() should
+int RunSoftwareDemo(const DemoOptions &options, const DemoScene &scene);
+
+// Read back the frame OpenGL just drew, draw it again on the CPU, through
+// the same view, and compare.  Returns false if they differ by more than
+// the rounding of an edge or a color.
+bool CheckSoftwareFrame(const DemoOptions &options, const DemoScene &scene,
+                        const GLfloat view[4], int width, int height);
+
+#endif // DEMO_SOFTWARE_H
@@ -0,0 +1,399 @@
+//============================================================================
+// Name        : DynamicResolution.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Renders at whatever resolution holds a GPU frame time.
+//
+//============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+#include "DebugLog.h"
+#include "DynamicResolution.h"
+// we aim for this much of the target, and leave the scale alone while we
+// are between the low and high marks
+static const double Aim = 0.9;
+static const double LowMark = 0.8;
+static const double HighMark = 0.95;
+
+// the most the scale moves at once, down and up
+static const double MaxDrop = 0.75;
+static const double MaxRise = 1.1;
+
+// the scale is a multiple of this, so that noise doesn't change it by a
+// pixel or two every time
+static const double ScaleStep = 1.0 / 32.0;
+
+// frames at a new scale to average over before we judge it, and how much
+// each new one counts
+static const int MinSamples = 3;
+static const double Smoothing = 0.25;
+
+DynamicResolution::DynamicResolution()
+    : output(0),
+      framebuffer(0),
+      colorBuffer(0),
+      width(0),
+      height(0),
+      targetMs(0.0),
+      minScale(1.0),
+      scale(1.0),
+      floorScale(1.0),
+      droppedFrom(0.0),
+      droppedFromMs(0.0),
+      samples(0),
+      smoothedMs(0.0),
+      changes(0),
+      current(0),
+      oldest(0),
+      inFlight(0),
+      frameNumber(0),
+      frameStarted(false)
+{
+    for (int i = 0; i < RingSize; i++) {
+        ring[i].queries[0] = ring[i].queries[1] = 0;
+        ring[i].pending = false;
+        ring[i].record = 0;
+    }
+}
+
+bool DynamicResolution::Create(GLuint output, int width, int height,
+                               double targetMs, double minScale)
+{
+    if (!GLL_VERSION_3_0 && !GLL_ARB_framebuffer_object) {
+        Log("Dynamic resolution needs framebuffer blits "
+            "(OpenGL 3.0 or GL_ARB_framebuffer_object)");
+        return false;
+    }
+
+    if (!GLL_VERSION_3_3 && !GLL_ARB_timer_query) {
+        Log("Dynamic resolution needs timestamp queries "
+            "(OpenGL 3.3 or GL_ARB_timer_query)");
+        return false;
+    }
+
+    this->output = output;
+    this->targetMs = targetMs;
+    this->minScale = minScale;
+    scale = 1.0;
+    floorScale = minScale;
+
+    glGenRenderbuffers(1, &colorBuffer);
+    Resize(width, height);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                              GL_RENDERBUFFER, colorBuffer);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, output);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        Log("Dynamic resolution framebuffer is incomplete: 0x%x", status);
+        Destroy();
+        return false;
+    }
+
+    for (int i = 0; i < RingSize; i++)
+        glGenQueries(2, ring[i].queries);
+
+    Log("Rendering at a dynamic resolution, holding %g ms of GPU time",
+        targetMs);
+    return true;
+}
+
+void DynamicResolution::Resize(int width, int height)
+{
+    if (colorBuffer == 0 || (width == this->width && height == this->height))
+        return;
+
+    this->width = std::max(width, 1);
+    this->height = std::max(height, 1);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, this->width,
+                          this->height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+}
+
+void DynamicResolution::BeginFrame()
+{
+    if (!Enabled())
+        return;
+
+    Clock::time_point now = Clock::now();
+
+    if (frameStarted) {
+        std::chrono::duration<double, std::milli> elapsed = now - frameStart;
+        records.back().frameMs = elapsed.count();
+    }
+
+    frameStart = now;
+    frameStarted = true;
+
+    Collect(false);
+
+    // If the GPU is so far behind that every slot is still in flight, we
+    // would rather lose the oldest frame's time than wait for it.
+    if (inFlight == RingSize) {
+        ring[oldest].pending = false;
+        oldest = (oldest + 1) % RingSize;
+        inFlight--;
+    }
+
+    current = (oldest + inFlight) % RingSize;
+
+    FrameRecord record = {frameNumber++, scale, ScaledWidth(),
+                          ScaledHeight(), -1.0, -1.0};
+    ring[current].record = records.size();
+    records.push_back(record);
+
+    glQueryCounter(ring[current].queries[0], GL_TIMESTAMP);
+
+    // at full size, there is nothing to scale up
+    if (record.scale == 1.0)
+        return;
+
+    // Note: glClear() ignores the viewport, but not the scissor
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, record.width, record.height);
+    glScissor(0, 0, record.width, record.height);
+    glEnable(GL_SCISSOR_TEST);
+}
+
+void DynamicResolution::EndFrame()
+{
+    if (!Enabled())
+        return;
+
+    const FrameRecord &record = records.back();
+    if (record.scale != 1.0)
+        Upscale(record);
+
+    glQueryCounter(ring[current].queries[1], GL_TIMESTAMP);
+    ring[current].pending = true;
+    inFlight++;
+}
+
+void DynamicResolution::Upscale(const FrameRecord &record)
+{
+    // Note: the blit is scissored too
+    glDisable(GL_SCISSOR_TEST);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, output);
+    glBlitFramebuffer(0, 0, record.width, record.height, 0, 0, width, height,
+                      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, output);
+    glViewport(0, 0, width, height);
+}
+
+void DynamicResolution::Finish()
+{
+    if (!Enabled())
+        return;
+
+    Collect(true);
+}
+
+void DynamicResolution::Collect(bool wait)
+{
+    while (inFlight > 0) {
+        FrameSlot &slot = ring[oldest];
+
+        // Note: the end of the frame comes after its start, so it is the
+        //       only one to check
+        if (!wait) {
+            GLint available = 0;
+            glGetQueryObjectiv(slot.queries[1], GL_QUERY_RESULT_AVAILABLE,
+                               &available);
+            if (!available)
+                break;
+        }
+
+        GLuint64 begin = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(slot.queries[0], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(slot.queries[1], GL_QUERY_RESULT, &end);
+
+        FrameRecord &record = records[slot.record];
+        record.gpuMs = (end - begin) / 1.0e6;
+        slot.pending = false;
+
+        Adjust(record);
+
+        oldest = (oldest + 1) % RingSize;
+        inFlight--;
+    }
+}
+
+void DynamicResolution::Adjust(const FrameRecord &record)
+{
+    // frames drawn before the last change say nothing about this scale
+    if (record.scale != scale)
+        return;
+
+    smoothedMs = samples == 0 ? record.gpuMs :
+                 smoothedMs + (record.gpuMs - smoothedMs) * Smoothing;
+    samples++;
+
+    if (samples < MinSamples || smoothedMs <= 0.0)
+        return;
+
+    // If the last drop didn't make the frames any faster, they don't cost
+    // what the pixels do, and the blit is only making it worse
+    if (droppedFrom > scale) {
+        double from = droppedFrom;
+        droppedFrom = 0.0;
+
+        if (smoothedMs >= droppedFromMs) {
+            Log("A lower resolution didn't make frames any faster, "
+                "staying at a scale of %g", from);
+            floorScale = from;
+            scale = from;
+            samples = 0;
+            changes++;
+            return;
+        }
+    }
+
+    if (smoothedMs >= targetMs * LowMark && smoothedMs <= targetMs * HighMark)
+        return;
+
+    double wanted = scale * std::sqrt(targetMs * Aim / smoothedMs);
+    wanted = std::min(std::max(wanted, scale * MaxDrop), scale * MaxRise);
+    wanted = std::floor(wanted / ScaleStep + 0.5) * ScaleStep;
+    wanted = std::min(std::max(wanted, floorScale), 1.0);
+
+    if (wanted == scale)
+        return;
+
+    if (wanted < scale) {
+        droppedFrom = scale;
+        droppedFromMs = smoothedMs;
+    }
+
+    scale = wanted;
+    samples = 0;
+    changes++;
+}
+
+int DynamicResolution::ScaledWidth() const
+{
+    return std::max(static_cast<int>(std::lround(width * scale)), 1);
+}
+
+int DynamicResolution::ScaledHeight() const
+{
+    return std::max(static_cast<int>(std::lround(height * scale)), 1);
+}
+
+void DynamicResolution::Report(std::ostream &out) const
+{
+    if (!Enabled())
+        return;
+
+    std::vector<double> gpuMs;
+    double scaleTotal = 0.0;
+    double lowest = 1.0;
+    long long over = 0;
+
+    for (size_t i = 0; i < records.size(); i++) {
+        scaleTotal += records[i].scale;
+        lowest = std::min(lowest, records[i].scale);
+
+        if (records[i].gpuMs >= 0.0) {
+            gpuMs.push_back(records[i].gpuMs);
+            if (records[i].gpuMs > targetMs)
+                over++;
+        }
+    }
+
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    out << std::fixed << std::setprecision(3);
+    out << "Dynamic resolution: holding " << targetMs
+        << " ms of GPU time, scale " << minScale << " to 1.000" << std::endl;
+
+    if (records.empty()) {
+        out << "    no frames were drawn" << std::endl;
+    }
+    else {
+        out << "    scale: mean " << scaleTotal / records.size()
+            << ", lowest " << lowest << ", last " << scale << " ("
+            << ScaledWidth() << "x" << ScaledHeight() << "), "
+            << changes << " changes over " << records.size() << " frames"
+            << std::endl;
+    }
+
+    if (!gpuMs.empty()) {
+        std::sort(gpuMs.begin(), gpuMs.end());
+
+        double total = 0.0;
+        for (size_t i = 0; i < gpuMs.size(); i++)
+            total += gpuMs[i];
+
+        size_t p99 = std::min(gpuMs.size() - 1,
+                              static_cast<size_t>(gpuMs.size() * 0.99));
+
+        out << "    GPU frame time (ms): mean " << total / gpuMs.size()
+            << "  p99 " << gpuMs[p99] << "  max " << gpuMs.back()
+            << ", " << over << " of " << gpuMs.size()
+            << " frames over the target" << std::endl;
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+bool DynamicResolution::WriteCsv(const std::string &path) const
+{
+    std::ofstream csv(path.c_str());
+    if (!csv)
+        return false;
+
+    csv << "frame,scale,width,height,frame_ms,gpu_ms\n";
+    csv << std::fixed << std::setprecision(4);
+
+    for (size_t i = 0; i < records.size(); i++) {
+        const FrameRecord &record = records[i];
+
+        csv << record.frame << "," << record.scale << "," << record.width
+            << "," << record.height << ",";
+        if (record.frameMs >= 0.0)
+            csv << record.frameMs;
+        csv << ",";
+        if (record.gpuMs >= 0.0)
+            csv << record.gpuMs;
+        csv << "\n";
+    }
+
+    return static_cast<bool>(csv);
+}
+
+void DynamicResolution::Destroy()
+{
+    if (ring[0].queries[0] != 0) {
+        for (int i = 0; i < RingSize; i++) {
+            glDeleteQueries(2, ring[i].queries);
+            ring[i].queries[0] = ring[i].queries[1] = 0;
+        }
+    }
+
+    if (framebuffer != 0) {
+        glDeleteFramebuffers(1, &framebuffer);
+        framebuffer = 0;
+    }
+
+    if (colorBuffer != 0) {
+        glDeleteRenderbuffers(1, &colorBuffer);
+        colorBuffer = 0;
+    }
+}
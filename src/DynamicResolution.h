@@ -0,0 +1,160 @@
+//============================================================================
+// Name        : DynamicResolution.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Renders at whatever resolution holds a GPU frame time.
+//
+//               Filling the window costs in proportion to its size, so a
+//               big window, or a slow GPU, can miss the frame time we want
+//               however little we draw.  Instead, we draw the scene into a
+//               framebuffer object of our own, at a fraction (the scale) of
+//               the output's width and height, and blit it up to the
+//               output with linear filtering.
+//
+//               At a scale of 1, the scene is drawn straight into the
+//               output, as if we weren't here.  Copying it over would cost
+//               a full screen of bandwidth for nothing, and a filtered blit
+//               can be a slow path: on llvmpipe, a 3840x2160 one took 80 ms,
+//               several times longer than drawing the frame.
+//
+//               The scale follows the GPU's frame times.  Each frame is
+//               timed with a pair of GL_TIMESTAMP queries, from the clear
+//               to the end of the blit, which are read a few frames late,
+//               like the FrameProfiler's.  (Timestamps, rather than
+//               GL_TIME_ELAPSED, so that the two can run at once.)  Once a
+//               few frames at the current scale are in, their smoothed
+//               time picks the next scale: the cost goes with the area,
+//               the square of the scale, so it moves by the square root of
+//               how far off we are.  It aims a little under the target, so
+//               ordinary noise doesn't push it over, doesn't move at all
+//               while the time is close enough, and goes down faster than
+//               it comes back up.  If going down didn't make the frames any
+//               faster, they aren't paying for pixels, and the blit only
+//               adds to them, so it goes back, and stays at least there.
+//
+//               The framebuffer is the output's full size, and only the
+//               corner we draw into is used, so changing the scale doesn't
+//               reallocate anything.  A scissor keeps the clear to it too.
+//
+//               Needs OpenGL 3.0 or GL_ARB_framebuffer_object, for the
+//               blit, and GL_ARB_timer_query (core in 3.3), for the
+//               timestamps.
+//
+//============================================================================
+
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class DynamicResolution {
+public:
+    DynamicResolution();
+
+    // Upscale into output, 0 for the window's own framebuffer, which is
+    // width x height.  Hold targetMs of GPU time per frame, without going
+    // below minScale.  Must be called with a current context.
+    bool Create(GLuint output, int width, int height, double targetMs,
+                double minScale);
+
+    // the output changed size, e.g. the window was resized
+    void Resize(int width, int height);
+
+    // Draw the frame, at the current scale, between these.  EndFrame()
+    // leaves the output bound, with its full viewport.
+    void BeginFrame();
+    void EndFrame();
+
+    // Collect the frames that are still in flight, waiting on the GPU if
+    // we have to.  Only meant to be called once, when we are done rendering.
+    void Finish();
+
+    bool Enabled() const { return framebuffer != 0; }
+    double Scale() const { return scale; }
+
+    void Report(std::ostream &out) const;
+
+    // one line per frame: its scale and size, and how long it took
+    bool WriteCsv(const std::string &path) const;
+
+    // The context needs to be current, so we don't leave this to the
+    // destructor.
+    void Destroy();
+
+private:
+    DynamicResolution(const DynamicResolution &);
+    DynamicResolution &operator=(const DynamicResolution &);
+
+    typedef std::chrono::steady_clock Clock;
+
+    // results are read this many frames late
+    static const int RingSize = 4;
+
+    struct FrameRecord {
+        long long frame;
+        double scale;
+        int width;
+        int height;
+        double frameMs;   // CPU, from this frame's start to the next's
+        double gpuMs;     // or -1, if it never came back
+    };
+
+    struct FrameSlot {
+        GLuint queries[2];
+        bool pending;
+        size_t record;
+    };
+
+    // read the oldest frames in flight, if the GPU is done with them
+    void Collect(bool wait);
+
+    // pick the next scale, with a new GPU time
+    void Adjust(const FrameRecord &record);
+
+    // blit what we drew, scaled up, into the output
+    void Upscale(const FrameRecord &record);
+
+    int ScaledWidth() const;
+    int ScaledHeight() const;
+
+    GLuint output;
+    GLuint framebuffer;
+    GLuint colorBuffer;
+    int width;
+    int height;
+
+    double targetMs;
+    double minScale;
+    double scale;
+
+    // the lowest scale that has been worth it, and the one we last went
+    // down from (0 once it is judged), with its time
+    double floorScale;
+    double droppedFrom;
+    double droppedFromMs;
+
+    // the frames at this scale whose times are in, and their average
+    int samples;
+    double smoothedMs;
+    int changes;
+
+    FrameSlot ring[RingSize];
+    int current;
+    int oldest;
+    int inFlight;
+
+    long long frameNumber;
+    bool frameStarted;
+    Clock::time_point frameStart;
+
+    std::vector<FrameRecord> records;
+};
+
+#endif // DYNAMIC_RESOLUTION_H
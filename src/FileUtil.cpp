@@ -0,0 +1,147 @@
+//============================================================================
+// Name        : FileUtil.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Small helpers for files and directories.
+//
+//============================================================================
+
+#include <cstdio>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "FileUtil.h"
+
+// the widest %d that a frame pattern may ask for
+static const int MaxFrameWidth = 20;
+
+bool MakeDirectories(const std::string &path)
+{
+    for (size_t slash = path.find('/', 1); ;
+            slash = path.find('/', slash + 1)) {
+        std::string partial = path.substr(0, slash);
+
+        if (mkdir(partial.c_str(), 0755) != 0) {
+            struct stat info;
+            if (stat(partial.c_str(), &info) != 0 || !S_ISDIR(info.st_mode))
+                return false;
+        }
+
+        if (slash == std::string::npos)
+            break;
+    }
+
+    return true;
+}
+
+bool EndsWith(const std::string &text, const std::string &ending)
+{
+    return text.size() >= ending.size() &&
+           text.compare(text.size() - ending.size(), ending.size(),
+                        ending) == 0;
+}
+
+// The length of the %d at path[at], which is a '%', with its flag and
+// width, or 0 if there isn't one there
+static size_t ConversionAt(const std::string &path, size_t at, bool &zeros,
+                           int &width)
+{
+    size_t i = at + 1;
+
+    zeros = i < path.size() && path[i] == '0';
+    if (zeros)
+        i++;
+
+    width = 0;
+    for (; i < path.size() && path[i] >= '0' && path[i] <= '9'; i++) {
+        width = width * 10 + (path[i] - '0');
+        if (width > MaxFrameWidth)
+            return 0;
+    }
+
+    if (i >= path.size() || path[i] != 'd')
+        return 0;
+
+    return i + 1 - at;
+}
+
+bool ValidFramePattern(const std::string &path)
+{
+    if (path.find('%') == std::string::npos)
+        return true;
+
+    int conversions = 0;
+
+    for (size_t i = 0; i < path.size(); i++) {
+        if (path[i] != '%')
+            continue;
+
+        if (i + 1 < path.size() && path[i + 1] == '%') {
+            i++;
+            continue;
+        }
+
+        bool zeros;
+        int width;
+        size_t length = ConversionAt(path, i, zeros, width);
+        if (length == 0)
+            return false;
+
+        conversions++;
+        i += length - 1;
+    }
+
+    return conversions == 1;
+}
+
+std::string FrameFileName(const std::string &path, long long frame)
+{
+    char number[64];
+
+    if (path.find('%') == std::string::npos) {
+        size_t dot = path.rfind('.');
+        size_t slash = path.rfind('/');
+        if (dot == std::string::npos ||
+            (slash != std::string::npos && dot < slash))
+            dot = path.size();
+
+        std::snprintf(number, sizeof(number), "_%05lld", frame);
+        return path.substr(0, dot) + number + path.substr(dot);
+    }
+
+    // Note: only the first %d is filled in, and any other '%' is kept as
+    //       it is
+    std::string name;
+    bool filled = false;
+
+    for (size_t i = 0; i < path.size(); i++) {
+        if (path[i] != '%') {
+            name += path[i];
+            continue;
+        }
+
+        if (i + 1 < path.size() && path[i + 1] == '%') {
+            name += '%';
+            i++;
+            continue;
+        }
+
+        bool zeros;
+        int width;
+        size_t length = ConversionAt(path, i, zeros, width);
+        if (length == 0 || filled) {
+            name += '%';
+            continue;
+        }
+
+        std::snprintf(number, sizeof(number), zeros ? "%0*lld" : "%*lld",
+                      width, frame);
+        name += number;
+        filled = true;
+        i += length - 1;
+    }
+
+    return name;
+}
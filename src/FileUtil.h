@@ -0,0 +1,38 @@
+//============================================================================
+// Name        : FileUtil.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Small helpers for the files and directories that the
+//               caches, the reloader and the captures write.
+//
+//               They only use POSIX calls, like the rest of the file
+//               handling, and don't log: the caller knows what the file
+//               was for, and says so when one fails.
+//
+//============================================================================
+
+#ifndef FILE_UTIL_H
+#define FILE_UTIL_H
+
+#include <string>
+
+// Make a directory and any missing parents, like mkdir -p.  Returns true
+// if path is a directory afterwards, even if it already was.
+bool MakeDirectories(const std::string &path);
+
+// does the path end in this extension?
+bool EndsWith(const std::string &text, const std::string &ending);
+
+// Is path a usable name for a numbered sequence of files?  Either it has
+// no '%' at all, or exactly one %d, with an optional 0 flag and a width of
+// up to 20, like frames/%04d.ppm, and %% for any literal '%'.
+bool ValidFramePattern(const std::string &path);
+
+// The name of frame number frame's file: path with its %d filled in, or,
+// without one, the number before the extension, so that frames.ppm
+// becomes frames_00000.ppm.  The path is never used as a printf format,
+// and a pattern that ValidFramePattern() refuses still gets a name.
+std::string FrameFileName(const std::string &path, long long frame);
+
+#endif // FILE_UTIL_H
@@ -0,0 +1,93 @@
+//============================================================================
+// Name        : FrameBenchmark.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Frame time collection and reporting for the headless mode.
+//
+//============================================================================
+
+#include <algorithm>
+#include <iomanip>
+
+#include "FrameBenchmark.h"
+
+double Percentile(const std::vector<double> &sorted, double percent)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    size_t rank = static_cast<size_t>(percent / 100.0 * sorted.size() + 0.5);
+    if (rank > 0)
+        rank--;
+
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+FrameBenchmark::FrameBenchmark(int expectedFrames, long long pixelsPerFrame,
+                               long long trianglesPerFrame)
+    : pixelsPerFrame(pixelsPerFrame),
+      trianglesPerFrame(trianglesPerFrame),
+      trianglesDrawn(0)
+{
+    frameTimes.reserve(expectedFrames);
+}
+
+void FrameBenchmark::BeginFrame()
+{
+    frameStart = Clock::now();
+
+    if (frameTimes.empty())
+        firstFrameStart = frameStart;
+}
+
+void FrameBenchmark::EndFrame()
+{
+    EndFrame(trianglesPerFrame);
+}
+
+void FrameBenchmark::EndFrame(long long triangles)
+{
+    trianglesDrawn += triangles;
+    lastFrameEnd = Clock::now();
+
+    std::chrono::duration<double, std::milli> elapsed =
+        lastFrameEnd - frameStart;
+    frameTimes.push_back(elapsed.count());
+}
+
+void FrameBenchmark::Report(std::ostream &out) const
+{
+    if (frameTimes.empty()) {
+        out << "No frames were measured" << std::endl;
+        return;
+    }
+
+    std::vector<double> sorted(frameTimes);
+    std::sort(sorted.begin(), sorted.end());
+
+    double total = 0.0;
+    for (double t : sorted)
+        total += t;
+
+    // Note: throughput is measured over the whole run, wall clock, so it
+    //       includes whatever the loop does between frames.
+    std::chrono::duration<double> wall = lastFrameEnd - firstFrameStart;
+    double fps = sorted.size() / wall.count();
+    double trianglesPerSecond = trianglesDrawn / wall.count();
+
+    out << std::fixed << std::setprecision(3)
+        << "Frames measured: " << sorted.size() << std::endl
+        << "Frame time (ms): min " << sorted.front()
+        << "  median " << Percentile(sorted, 50.0)
+        << "  p99 " << Percentile(sorted, 99.0)
+        << "  max " << sorted.back()
+        << "  mean " << total / sorted.size() << std::endl
+        << std::setprecision(1)
+        << "Throughput: " << fps << " frames/s, "
+        << fps * pixelsPerFrame / 1.0e6 << " Mpixels/s, "
+        << trianglesPerSecond / 1.0e6 << " Mtriangles/s" << std::endl;
+
+    out.unsetf(std::ios_base::floatfield);
+    out << std::setprecision(6);
+}
@@ -0,0 +1,59 @@
+//============================================================================
+// Name        : FrameBenchmark.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Frame time collection and reporting for the headless mode.
+//
+//               We time each frame on the CPU with a monotonic clock.  In
+//               headless mode there is no swap to wait on, so the render
+//               loop calls glFinish() before EndFrame(), and the frame
+//               time includes the GPU work, not just the submission.
+//
+//============================================================================
+
+#ifndef FRAME_BENCHMARK_H
+#define FRAME_BENCHMARK_H
+
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+// The nearest-rank percentile, from 0 to 100, of an already sorted list,
+// or 0 if it is empty.  Every report that gives a p99 uses this one.
+double Percentile(const std::vector<double> &sorted, double percent);
+
+class FrameBenchmark {
+public:
+    // pixelsPerFrame and trianglesPerFrame are only used to report
+    // the fill and vertex throughput
+    FrameBenchmark(int expectedFrames, long long pixelsPerFrame,
+                   long long trianglesPerFrame);
+
+    void BeginFrame();
+    void EndFrame();
+
+    // for a frame that drew some other number of triangles, like a culled
+    // one
+    void EndFrame(long long triangles);
+
+    // frame times in milliseconds, in the order they were recorded
+    const std::vector<double> &FrameTimes() const { return frameTimes; }
+
+    // print min/median/p99 frame times and the throughput
+    void Report(std::ostream &out) const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point frameStart;
+    Clock::time_point firstFrameStart;
+    Clock::time_point lastFrameEnd;
+
+    std::vector<double> frameTimes;
+    long long pixelsPerFrame;
+    long long trianglesPerFrame;
+    long long trianglesDrawn;
+};
+
+#endif // FRAME_BENCHMARK_H
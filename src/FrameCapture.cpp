@@ -0,0 +1,423 @@
+//============================================================================
+// Name        : FrameCapture.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Reads frames back through a ring of pixel buffers, and
+//               writes them out on a thread of their own.
+//
+//============================================================================
+
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+
+#include "FrameCapture.h"
+#include "DebugLog.h"
+#include "FileUtil.h"
+
+FrameCapture::FrameCapture()
+    : enabled(false),
+      lossless(false),
+      format(FormatPPM),
+      width(0),
+      height(0),
+      frameRate(60),
+      frameBytes(0),
+      ringSize(0),
+      nextBuffer(0),
+      written(0),
+      failed(false),
+      frames(0),
+      dropped(0),
+      maxLag(0),
+      lagTotal(0),
+      captureMsTotal(0.0),
+      captureMsMax(0.0)
+{
+}
+
+FrameCapture::~FrameCapture()
+{
+    // Note: without a context we can only stop the writer, and drop the
+    //       frames still in the ring; Destroy() should have been called
+    //       while there was one.
+    if (writer.joinable()) {
+        while (!filledSlots.Push(-1))
+            std::this_thread::yield();
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+        }
+        wake.notify_one();
+        writer.join();
+    }
+}
+
+void FrameCapture::SetLossless(bool lossless)
+{
+    this->lossless = lossless;
+}
+
+bool FrameCapture::Create(const std::string &path, int width, int height,
+                          int frameRate, int ringSize)
+{
+    this->path = path;
+    this->width = width;
+    this->height = height;
+    this->frameRate = frameRate;
+    frameBytes = static_cast<size_t>(width) * height * 4;
+    format = EndsWith(path, ".y4m") ? FormatY4M : FormatPPM;
+
+    if (format == FormatY4M) {
+        video.open(path.c_str(), std::ios::binary | std::ios::trunc);
+        if (!video) {
+            Log("Failed to open %s for the capture", path.c_str());
+            return false;
+        }
+
+        // Note: C420jpeg is full range BT.601, which is what we convert to
+        video << "YUV4MPEG2 W" << width << " H" << height << " F"
+              << frameRate << ":1 Ip A1:1 C420jpeg\n";
+    }
+
+    if (ringSize > 0 && !GLL_VERSION_2_1 && !GLL_ARB_pixel_buffer_object) {
+        Log("Pixel buffer objects are not supported by this platform, "
+            "so every captured frame will be read back straight away");
+        ringSize = 0;
+    }
+
+    // Allocate the pixel buffers up front, for the driver to read into
+    this->ringSize = ringSize;
+    pixelBuffers.assign(static_cast<size_t>(ringSize), 0);
+    bufferFrames.assign(static_cast<size_t>(ringSize), -1);
+
+    if (ringSize > 0) {
+        glGenBuffers(ringSize, pixelBuffers.data());
+
+        for (int i = 0; i < ringSize; i++) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers[i]);
+            glBufferData(GL_PIXEL_PACK_BUFFER,
+                         static_cast<GLsizeiptr>(frameBytes), NULL,
+                         GL_STREAM_READ);
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    for (int i = 0; i < SlotCount; i++) {
+        slots[i].pixels.resize(frameBytes);
+        slots[i].frame = -1;
+        freeSlots.Push(i);
+    }
+
+    // every row of RGBA pixels is a multiple of 4 bytes anyway
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    writer = std::thread(&FrameCapture::Run, this);
+    enabled = true;
+
+    Log("Capturing frames to %s (%s, %d pixel buffers)", path.c_str(),
+        format == FormatY4M ? "Y4M" : "PPM", ringSize);
+
+    return true;
+}
+
+void FrameCapture::Capture()
+{
+    if (!enabled)
+        return;
+
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
+    long long frame = frames++;
+
+    if (pixelBuffers.empty()) {
+        // the old way: wait for the frame to finish, and copy it
+        int index;
+        if (FreeSlot(index)) {
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
+                         slots[index].pixels.data());
+            slots[index].frame = frame;
+
+            filledSlots.Push(index);
+            {
+                std::lock_guard<std::mutex> lock(wakeMutex);
+            }
+            wake.notify_one();
+        }
+        else {
+            dropped++;
+        }
+    }
+    else {
+        // The oldest frame in the ring has had a couple of frames to
+        // arrive, so take it out before reusing its buffer.
+        if (bufferFrames[nextBuffer] >= 0)
+            ReadBack(nextBuffer);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers[nextBuffer]);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        bufferFrames[nextBuffer] = frame;
+        nextBuffer = (nextBuffer + 1) % static_cast<int>(pixelBuffers.size());
+    }
+
+    // everything captured that isn't written or dropped yet
+    long long lag = frames - written.load() - dropped;
+    maxLag = std::max(maxLag, lag);
+    lagTotal += lag;
+
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    captureMsTotal += elapsed.count();
+    captureMsMax = std::max(captureMsMax, elapsed.count());
+}
+
+void FrameCapture::ReadBack(int index)
+{
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers[index]);
+
+    const void *pixels = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if (pixels != nullptr) {
+        Queue(pixels, bufferFrames[index]);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    else {
+        dropped++;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    bufferFrames[index] = -1;
+}
+
+void FrameCapture::Queue(const void *pixels, long long frame)
+{
+    int index;
+    if (!FreeSlot(index)) {
+        dropped++;
+        return;
+    }
+
+    std::memcpy(slots[index].pixels.data(), pixels, frameBytes);
+    slots[index].frame = frame;
+
+    filledSlots.Push(index);
+
+    // Note: the same dance as RenderThread::Send(), so that the writer
+    //       can't miss the wake up.
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    wake.notify_one();
+}
+
+bool FrameCapture::FreeSlot(int &index)
+{
+    if (freeSlots.Pop(index))
+        return true;
+
+    // the writer is too far behind, and we won't wait for it
+    if (!lossless)
+        return false;
+
+    // Note: we are the only one popping, so a slot seen here is ours
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    freed.wait(lock, [&]() { return freeSlots.Pop(index); });
+    return true;
+}
+
+void FrameCapture::Finish()
+{
+    if (!enabled)
+        return;
+
+    // oldest first, so the frames stay in order
+    for (size_t i = 0; i < pixelBuffers.size(); i++) {
+        int index = (nextBuffer + static_cast<int>(i)) %
+                    static_cast<int>(pixelBuffers.size());
+        if (bufferFrames[index] >= 0)
+            ReadBack(index);
+    }
+
+    // there is always room for this, with only SlotCount slots around
+    filledSlots.Push(-1);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    wake.notify_one();
+
+    writer.join();
+    video.close();
+    enabled = false;
+}
+
+void FrameCapture::Destroy()
+{
+    if (enabled)
+        Finish();
+
+    if (!pixelBuffers.empty()) {
+        glDeleteBuffers(static_cast<GLsizei>(pixelBuffers.size()),
+                        pixelBuffers.data());
+        pixelBuffers.clear();
+        bufferFrames.clear();
+    }
+}
+
+void FrameCapture::Run()
+{
+    for (;;) {
+        int index;
+
+        if (!filledSlots.Pop(index)) {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait(lock, [this]() { return filledSlots.Size() > 0; });
+            continue;
+        }
+
+        if (index < 0)
+            break;
+
+        // after a failed write, just keep the slots moving
+        if (!failed.load() && !Write(slots[index]))
+            failed.store(true);
+
+        written.fetch_add(1);
+        freeSlots.Push(index);
+
+        if (lossless) {
+            {
+                std::lock_guard<std::mutex> lock(wakeMutex);
+            }
+            freed.notify_one();
+        }
+    }
+}
+
+bool FrameCapture::Write(const Slot &slot)
+{
+    return format == FormatY4M ? WriteY4M(slot) : WritePPM(slot);
+}
+
+bool FrameCapture::WriteY4M(const Slot &slot)
+{
+    // Note: odd sizes round the chroma planes up, as Y4M expects
+    int chromaWidth = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    size_t lumaSize = static_cast<size_t>(width) * height;
+    size_t chromaSize = static_cast<size_t>(chromaWidth) * chromaHeight;
+
+    planes.resize(lumaSize + 2 * chromaSize);
+    unsigned char *luma = planes.data();
+    unsigned char *cb = luma + lumaSize;
+    unsigned char *cr = cb + chromaSize;
+
+    const unsigned char *pixels = slot.pixels.data();
+
+    // OpenGL gives us the bottom row first, Y4M wants the top
+    for (int y = 0; y < height; y++) {
+        const unsigned char *row = pixels +
+                                   static_cast<size_t>(height - 1 - y) *
+                                   width * 4;
+        unsigned char *out = luma + static_cast<size_t>(y) * width;
+
+        for (int x = 0; x < width; x++) {
+            const unsigned char *p = row + x * 4;
+            out[x] = static_cast<unsigned char>(
+                         (77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8);
+        }
+    }
+
+    // each chroma sample is the average of a 2x2 block
+    for (int cy = 0; cy < chromaHeight; cy++) {
+        for (int cx = 0; cx < chromaWidth; cx++) {
+            int r = 0, g = 0, b = 0, count = 0;
+
+            for (int dy = 0; dy < 2; dy++) {
+                int y = std::min(cy * 2 + dy, height - 1);
+                const unsigned char *row =
+                    pixels + static_cast<size_t>(height - 1 - y) * width * 4;
+
+                for (int dx = 0; dx < 2; dx++) {
+                    int x = std::min(cx * 2 + dx, width - 1);
+                    r += row[x * 4];
+                    g += row[x * 4 + 1];
+                    b += row[x * 4 + 2];
+                    count++;
+                }
+            }
+
+            r /= count;
+            g /= count;
+            b /= count;
+
+            size_t at = static_cast<size_t>(cy) * chromaWidth + cx;
+            int blue = (-43 * r - 85 * g + 128 * b + 32768 + 128) >> 8;
+            int red = (128 * r - 107 * g - 21 * b + 32768 + 128) >> 8;
+            cb[at] = static_cast<unsigned char>(std::min(blue, 255));
+            cr[at] = static_cast<unsigned char>(std::min(red, 255));
+        }
+    }
+
+    video << "FRAME\n";
+    video.write(reinterpret_cast<const char *>(planes.data()),
+                static_cast<std::streamsize>(planes.size()));
+
+    return video.good();
+}
+
+bool FrameCapture::WritePPM(const Slot &slot)
+{
+    std::string name = FrameFileName(path, slot.frame);
+
+    std::ofstream file(name.c_str(), std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    file << "P6\n" << width << " " << height << "\n255\n";
+
+    std::vector<unsigned char> row(static_cast<size_t>(width) * 3);
+
+    for (int y = height - 1; y >= 0; y--) {
+        const unsigned char *in = slot.pixels.data() +
+                                  static_cast<size_t>(y) * width * 4;
+        for (int x = 0; x < width; x++) {
+            row[x * 3] = in[x * 4];
+            row[x * 3 + 1] = in[x * 4 + 1];
+            row[x * 3 + 2] = in[x * 4 + 2];
+        }
+
+        file.write(reinterpret_cast<const char *>(row.data()),
+                   static_cast<std::streamsize>(row.size()));
+    }
+
+    return file.good();
+}
+
+void FrameCapture::Report(std::ostream &out) const
+{
+    if (frames == 0)
+        return;
+
+    out << std::fixed << std::setprecision(3)
+        << "Frame capture: " << frames << " frames, " << written.load()
+        << " written, " << dropped << " dropped"
+        << (failed.load() ? ", writing FAILED" : "") << std::endl
+        << "    behind the renderer by " << maxLag << " frames max, "
+        << std::setprecision(1) << static_cast<double>(lagTotal) / frames
+        << " mean (" << ringSize << " of that is the pixel buffer ring)"
+        << std::endl
+        << std::setprecision(3) << "    capture took "
+        << captureMsTotal / frames << " ms mean, " << captureMsMax
+        << " ms max per frame on the render thread" << std::endl;
+
+    out.unsetf(std::ios_base::floatfield);
+    out << std::setprecision(6);
+}
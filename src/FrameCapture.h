@@ -0,0 +1,170 @@
+//============================================================================
+// Name        : FrameCapture.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Records the rendered frames to a file, without holding up
+//               the render loop.
+//
+//               A glReadPixels() into our own memory, right after drawing,
+//               has to wait for the GPU to finish the frame, every frame.
+//               Instead, each frame is read into a pixel buffer object
+//               (core in OpenGL 2.1), which returns straight away, and the
+//               copy happens on the GPU's time.  The pixel buffers are a
+//               ring, three by default, so by the time we map one to get
+//               its pixels, two more frames have been queued behind it and
+//               the copy is long done.
+//
+//               The mapped pixels are copied into one of a few frame slots
+//               and handed to a writer thread, through a lock-free queue,
+//               which converts and writes them out:
+//               - a .y4m file is one YUV 4:2:0 video stream, that ffmpeg,
+//                 mpv and friends can read directly
+//               - anything else is a numbered sequence of PPM images, e.g.
+//                 frames.ppm becomes frames_00000.ppm, frames_00001.ppm...
+//                 (or give one %d, like frames/%04d.ppm, and %% for a %)
+//
+//               If the writer falls so far behind that every slot is still
+//               waiting to be written, the frame is dropped rather than
+//               making the renderer wait.  Report() says how far behind
+//               the capture got, and how many frames it dropped.
+//
+//               A ring size of 0 reads every frame back straight away, the
+//               slow way, for comparison.
+//
+//               Where every frame matters more than the frame rate, as in
+//               the batch jobs, SetLossless() makes the renderer wait for
+//               a free slot instead.
+//
+//============================================================================
+
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SpscQueue.h"
+
+class FrameCapture {
+public:
+    static const int DefaultRingSize = 3;
+
+    FrameCapture();
+    ~FrameCapture();
+
+    // Wait for the writer, rather than dropping the frame, when every slot
+    // is taken.  Call it before Create().
+    void SetLossless(bool lossless);
+
+    // Start capturing width x height frames to path, and start the writer.
+    // frameRate only goes into the header of a .y4m file.
+    // Needs a current context.
+    bool Create(const std::string &path, int width, int height,
+                int frameRate, int ringSize = DefaultRingSize);
+
+    // Render thread only, after drawing and before the swap.
+    // Does nothing if the capture wasn't created.
+    void Capture();
+
+    // Read back the frames still in the ring, and wait for the writer to
+    // write everything out.  Needs the context.
+    void Finish();
+
+    void Destroy();
+
+    bool Enabled() const { return enabled; }
+
+    // a write failed, and the frames after it were thrown away
+    bool Failed() const { return failed.load(); }
+
+    // call after Finish()
+    void Report(std::ostream &out) const;
+
+private:
+    FrameCapture(const FrameCapture &);
+    FrameCapture &operator=(const FrameCapture &);
+
+    enum Format {
+        FormatY4M = 0,
+        FormatPPM
+    };
+
+    // frames waiting for the writer, at most.  Past this, we drop them.
+    static const int SlotCount = 8;
+
+    struct Slot {
+        std::vector<unsigned char> pixels;   // RGBA, bottom row first
+        long long frame;
+    };
+
+    // Render thread: copy a frame's pixels into a free slot and queue it
+    // for the writer, or count it as dropped if there is no free slot.
+    void Queue(const void *pixels, long long frame);
+
+    // Render thread: a free slot, waited for if we are lossless.  False if
+    // there is none, and the frame has to be dropped.
+    bool FreeSlot(int &index);
+
+    // Render thread: get the pixels out of one of the pixel buffers
+    void ReadBack(int index);
+
+    // the writer thread
+    void Run();
+    bool Write(const Slot &slot);
+    bool WriteY4M(const Slot &slot);
+    bool WritePPM(const Slot &slot);
+
+    bool enabled;
+    bool lossless;
+    Format format;
+    std::string path;
+    int width;
+    int height;
+    int frameRate;
+    size_t frameBytes;
+
+    // the ring of pixel buffers, and which frame each one holds (-1 for
+    // none)
+    int ringSize;
+    std::vector<GLuint> pixelBuffers;
+    std::vector<long long> bufferFrames;
+    int nextBuffer;
+
+    // Slot indices go to the writer through filledSlots, and come back
+    // through freeSlots, so each queue has one producer and one consumer.
+    // Note: a slot index of -1 tells the writer to finish.
+    Slot slots[SlotCount];
+    SpscQueue<int, 16> filledSlots;
+    SpscQueue<int, 16> freeSlots;
+
+    std::thread writer;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::condition_variable freed;      // only when lossless
+
+    // the writer's output
+    std::ofstream video;
+    std::vector<unsigned char> planes;
+    std::atomic<long long> written;
+    std::atomic<bool> failed;
+
+    // only touched on the render thread
+    long long frames;
+    long long dropped;
+    long long maxLag;
+    long long lagTotal;
+    double captureMsTotal;
+    double captureMsMax;
+};
+
+#endif // FRAME_CAPTURE_H
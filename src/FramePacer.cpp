@@ -0,0 +1,181 @@
+//============================================================================
+// Name        : FramePacer.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Decides when the next frame gets drawn, and measures the
+//               CPU use and jitter that came of it.
+//
+//============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+#include <thread>
+
+// GLFW
+#include <GLFW/glfw3.h>
+
+#include "FrameBenchmark.h"
+#include "FramePacer.h"
+
+// Sleeping can overshoot by about this much, so we stop sleeping this
+// long before a capped frame is due, and spin for the rest.
+static const std::chrono::microseconds SpinMargin(1500);
+
+// the CPU time the calling thread has used, which std::clock() can't give
+// us: it counts every thread in the process
+static double ThreadCpuSeconds()
+{
+    timespec now;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0)
+        return 0.0;
+
+    return now.tv_sec + now.tv_nsec / 1.0e9;
+}
+
+FramePacer::FramePacer(Mode pacingMode, double fps, int interval)
+    : mode(pacingMode),
+      targetFps(fps),
+      swapInterval(interval),
+      period(Clock::duration::zero()),
+      cpuBegin(0.0),
+      wallSeconds(0.0),
+      cpuSeconds(0.0)
+{
+    if (mode == ModeCapped && targetFps > 0.0) {
+        period = std::chrono::duration_cast<Clock::duration>(
+                     std::chrono::duration<double>(1.0 / targetFps));
+    }
+}
+
+const char *FramePacer::ModeName(Mode mode)
+{
+    switch (mode) {
+    case ModeOnDemand:
+        return "on demand";
+    case ModeCapped:
+        return "capped";
+    case ModeVsync:
+        return "vsync";
+    default:
+        return "continuous";
+    }
+}
+
+void FramePacer::Init()
+{
+    // Note: we set it in every mode, so that the driver's default doesn't
+    //       quietly turn continuous into vsync.  On demand frames are
+    //       rare, so they may as well not tear.
+    if (mode == ModeVsync)
+        glfwSwapInterval(swapInterval);
+    else if (mode == ModeOnDemand)
+        glfwSwapInterval(1);
+    else
+        glfwSwapInterval(0);
+}
+
+void FramePacer::Begin()
+{
+    begin = lastFrame = deadline = Clock::now();
+    cpuBegin = ThreadCpuSeconds();
+    intervals.clear();
+}
+
+void FramePacer::WaitForFrame(bool handleEvents)
+{
+    if (mode != ModeCapped)
+        return;
+
+    deadline += period;
+
+    // if we fell more than a frame behind, don't try to catch up
+    Clock::time_point now = Clock::now();
+    if (now > deadline + period)
+        deadline = now;
+
+    Clock::time_point wake = deadline - SpinMargin;
+
+    if (handleEvents) {
+        // the events may wake us early, so keep waiting until it's time
+        while ((now = Clock::now()) < wake) {
+            std::chrono::duration<double> remaining = wake - now;
+            glfwWaitEventsTimeout(remaining.count());
+        }
+    }
+    else {
+        std::this_thread::sleep_until(wake);
+    }
+
+    while (Clock::now() < deadline) {
+        // spin
+    }
+}
+
+void FramePacer::FrameDone()
+{
+    Clock::time_point now = Clock::now();
+    std::chrono::duration<double, std::milli> interval = now - lastFrame;
+    lastFrame = now;
+
+    intervals.push_back(interval.count());
+}
+
+void FramePacer::End()
+{
+    std::chrono::duration<double> wall = Clock::now() - begin;
+    wallSeconds = wall.count();
+    cpuSeconds = ThreadCpuSeconds() - cpuBegin;
+}
+
+double FramePacer::FrameRate() const
+{
+    return wallSeconds > 0.0 ? intervals.size() / wallSeconds : 0.0;
+}
+
+void FramePacer::Report(std::ostream &out) const
+{
+    if (wallSeconds <= 0.0)
+        return;
+
+    out << std::fixed << std::setprecision(3)
+        << "Frame pacing (" << ModeName(mode);
+    if (mode == ModeCapped)
+        out << " at " << targetFps << " fps";
+    else if (mode == ModeVsync)
+        out << ", swap interval " << swapInterval;
+    out << "): " << intervals.size() << " frames in " << wallSeconds
+        << " s, " << intervals.size() / wallSeconds << " frames/s"
+        << std::endl;
+
+    // The first interval is from Begin(), not from a frame, so it doesn't
+    // count towards the jitter.
+    if (intervals.size() > 1) {
+        std::vector<double> sorted(intervals.begin() + 1, intervals.end());
+        std::sort(sorted.begin(), sorted.end());
+
+        double mean = 0.0;
+        for (size_t i = 0; i < sorted.size(); i++)
+            mean += sorted[i];
+        mean /= sorted.size();
+
+        double variance = 0.0;
+        for (size_t i = 0; i < sorted.size(); i++)
+            variance += (sorted[i] - mean) * (sorted[i] - mean);
+        variance /= sorted.size();
+
+        out << "    frame interval " << mean << " ms mean, "
+            << std::sqrt(variance) << " ms jitter (std dev), "
+            << Percentile(sorted, 99.0) << " ms p99, "
+            << sorted.back() << " ms max" << std::endl;
+    }
+
+    out << "    CPU time " << cpuSeconds << " s, "
+        << std::setprecision(1) << 100.0 * cpuSeconds / wallSeconds
+        << "% of one core, on the render thread" << std::endl;
+
+    out.unsetf(std::ios_base::floatfield);
+    out << std::setprecision(6);
+}
@@ -0,0 +1,96 @@
+//============================================================================
+// Name        : FramePacer.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Decides when the next frame gets drawn.
+//
+//               Our triangle hardly ever changes, but we used to draw it
+//               again as fast as we could, burning a whole core and the
+//               GPU on identical frames.  Which way is best depends on
+//               where the program runs, so there are a few to pick from:
+//               - Continuous: as fast as we can, the old way.
+//               - On demand: only when something changed (the state, the
+//                 window needs repainting, or the scene is animated), and
+//                 otherwise sleep until there is an event.
+//               - Capped: at most a given rate.  We sleep until just
+//                 before the frame is due, since a sleep can oversleep by
+//                 a millisecond or more, and then spin for the rest.
+//               - Vsync: glfwSwapInterval() makes the swap wait for the
+//                 display, every N refreshes.
+//
+//               We measure how much CPU time the rendering thread used
+//               while rendering, and how evenly spaced the frames were
+//               (jitter), so the modes can be compared.  It is the thread's
+//               own time, so that each window's render thread reports its
+//               own, but that leaves out any threads of the driver's.
+//
+//============================================================================
+
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+class FramePacer {
+public:
+    enum Mode {
+        ModeContinuous = 0,
+        ModeOnDemand,
+        ModeCapped,
+        ModeVsync
+    };
+
+    // targetFps is only used when capped, swapInterval only with vsync
+    FramePacer(Mode mode, double targetFps, int swapInterval);
+
+    // Set the swap interval for the mode.  Must be called with the
+    // context current, on the thread that will render.
+    void Init();
+
+    // Start measuring.  Called just before the first frame.
+    void Begin();
+
+    // Wait until the next frame is due.  Only does anything when capped.
+    // With handleEvents, we wait in glfwWaitEventsTimeout(), so that the
+    // events don't have to wait for us.
+    void WaitForFrame(bool handleEvents);
+
+    // true if we should skip frames that nothing asked for
+    bool OnDemand() const { return mode == ModeOnDemand; }
+
+    // the frame has been swapped
+    void FrameDone();
+
+    // Stop measuring.  Called after the last frame.
+    void End();
+
+    void Report(std::ostream &out) const;
+
+    // frames per second, between Begin() and End()
+    double FrameRate() const;
+
+    static const char *ModeName(Mode mode);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    Mode mode;
+    double targetFps;
+    int swapInterval;
+
+    Clock::duration period;
+    Clock::time_point deadline;
+
+    Clock::time_point begin;
+    Clock::time_point lastFrame;
+    double cpuBegin;        // the thread's CPU time, in seconds
+    double wallSeconds;
+    double cpuSeconds;
+
+    std::vector<double> intervals;
+};
+
+#endif // FRAME_PACER_H
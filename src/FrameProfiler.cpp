@@ -0,0 +1,351 @@
+//============================================================================
+// Name        : FrameProfiler.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Per-frame CPU and GPU timing of the render loop stages.
+//
+//============================================================================
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#include "FrameBenchmark.h"
+#include "FrameProfiler.h"
+
+static const char *StageNames[FrameProfiler::StageCount] = {
+    "clear", "cull", "draw", "swap"
+};
+
+// upper edges of the histogram buckets, in milliseconds.
+// The last bucket catches everything slower.
+static const double BucketEdges[] = {
+    0.05, 0.1, 0.25, 0.5, 1.0, 2.0, 4.0, 8.0, 16.7, 33.3
+};
+static const int BucketCount = sizeof(BucketEdges) / sizeof(double) + 1;
+
+FrameProfiler::FrameProfiler(bool enabled)
+    : enabled(enabled),
+      gpuTimers(false),
+      useExtTimerQuery(false),
+      current(0),
+      oldest(0),
+      inFlight(0),
+      frameNumber(0),
+      droppedFrames(0),
+      activeStage(StageClear),
+      stageActive(false)
+{
+    for (int i = 0; i < RingSize; i++) {
+        for (int s = 0; s < StageCount; s++)
+            ring[i].used[s] = false;
+        ring[i].pending = false;
+    }
+}
+
+void FrameProfiler::Init()
+{
+    if (!enabled)
+        return;
+
+    if (GLL_ARB_timer_query || GLL_VERSION_3_3) {
+        gpuTimers = true;
+        useExtTimerQuery = false;
+    }
+    else if (GLL_EXT_timer_query) {
+        gpuTimers = true;
+        useExtTimerQuery = true;
+    }
+
+    if (gpuTimers) {
+        for (int i = 0; i < RingSize; i++) {
+            for (int s = 0; s < StageCount; s++)
+                ring[i].queries[s] = GLQuery::Create();
+        }
+    }
+}
+
+void FrameProfiler::BeginFrame()
+{
+    if (!enabled)
+        return;
+
+    Collect(false);
+
+    // If the GPU is so far behind that every slot is still in flight, we
+    // would rather lose the oldest frame's GPU timings than wait for them.
+    if (inFlight == RingSize) {
+        oldest = (oldest + 1) % RingSize;
+        inFlight--;
+        droppedFrames++;
+    }
+
+    current = (oldest + inFlight) % RingSize;
+
+    FrameSlot &slot = ring[current];
+    slot.timing.frame = frameNumber++;
+
+    for (int s = 0; s < StageCount; s++) {
+        slot.used[s] = false;
+        slot.timing.cpuMs[s] = -1.0;
+        slot.timing.gpuMs[s] = -1.0;
+    }
+}
+
+void FrameProfiler::BeginStage(Stage stage)
+{
+    if (!enabled)
+        return;
+
+    activeStage = stage;
+    stageActive = true;
+
+    FrameSlot &slot = ring[current];
+    slot.used[stage] = true;
+
+    // Note: only one GL_TIME_ELAPSED query can be active at a time,
+    //       which is fine, since our stages don't overlap.
+    if (gpuTimers)
+        glBeginQuery(GL_TIME_ELAPSED, slot.queries[stage].Get());
+
+    stageStart = Clock::now();
+}
+
+void FrameProfiler::EndStage()
+{
+    if (!enabled || !stageActive)
+        return;
+
+    std::chrono::duration<double, std::milli> elapsed =
+        Clock::now() - stageStart;
+
+    if (gpuTimers)
+        glEndQuery(GL_TIME_ELAPSED);
+
+    ring[current].timing.cpuMs[activeStage] = elapsed.count();
+    stageActive = false;
+}
+
+void FrameProfiler::EndFrame()
+{
+    if (!enabled)
+        return;
+
+    if (gpuTimers) {
+        ring[current].pending = true;
+        inFlight++;
+    }
+    else {
+        // nothing to wait for, the CPU timings are already there
+        completed.push_back(ring[current].timing);
+    }
+}
+
+void FrameProfiler::Finish()
+{
+    if (enabled)
+        Collect(true);
+}
+
+void FrameProfiler::Collect(bool wait)
+{
+    while (inFlight > 0) {
+        FrameSlot &slot = ring[oldest];
+
+        if (!wait && !SlotAvailable(slot))
+            break;
+
+        Record(slot);
+
+        oldest = (oldest + 1) % RingSize;
+        inFlight--;
+    }
+}
+
+bool FrameProfiler::SlotAvailable(const FrameSlot &slot) const
+{
+    // queries complete in order, so checking the last one used is enough
+    for (int s = StageCount - 1; s >= 0; s--) {
+        if (slot.used[s]) {
+            GLint available = 0;
+            glGetQueryObjectiv(slot.queries[s].Get(),
+                               GL_QUERY_RESULT_AVAILABLE, &available);
+            return available != 0;
+        }
+    }
+
+    return true;
+}
+
+void FrameProfiler::Record(FrameSlot &slot)
+{
+    for (int s = 0; s < StageCount; s++) {
+        if (slot.used[s])
+            slot.timing.gpuMs[s] = QueryResult(slot.queries[s].Get()) / 1.0e6;
+    }
+
+    slot.pending = false;
+    completed.push_back(slot.timing);
+}
+
+GLuint64 FrameProfiler::QueryResult(GLuint query) const
+{
+    // the elapsed time is in nanoseconds, which overflows 32 bits
+    // after about 4 seconds, so we always ask for the 64 bit result.
+    GLuint64 result = 0;
+
+    if (useExtTimerQuery) {
+        GLuint64EXT extResult = 0;
+        glGetQueryObjectui64vEXT(query, GL_QUERY_RESULT, &extResult);
+        result = extResult;
+    }
+    else {
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &result);
+    }
+
+    return result;
+}
+
+void FrameProfiler::Report(std::ostream &out) const
+{
+    if (!enabled)
+        return;
+
+    if (completed.empty()) {
+        out << "No frame timings were collected" << std::endl;
+        return;
+    }
+
+    size_t first = (completed.size() > static_cast<size_t>(WindowSize)) ?
+                   completed.size() - WindowSize : 0;
+    size_t count = completed.size() - first;
+
+    out << std::fixed << std::setprecision(3)
+        << "Stage timings over the last " << count << " frames (ms)";
+    if (!gpuTimers)
+        out << ", no GPU timer queries on this platform";
+    out << std::endl;
+
+    out << "    stage        mean    median       p99       max" << std::endl;
+
+    // the histogram counts for each stage, CPU rows first, then GPU rows
+    std::vector<std::vector<int> > histograms;
+    std::vector<std::string> labels;
+
+    for (int side = 0; side < 2; side++) {
+        if (side == 1 && !gpuTimers)
+            break;
+
+        for (int s = 0; s < StageCount; s++) {
+            std::vector<double> samples;
+            samples.reserve(count);
+
+            for (size_t i = first; i < completed.size(); i++) {
+                double ms = (side == 0) ? completed[i].cpuMs[s] :
+                                          completed[i].gpuMs[s];
+                if (ms >= 0.0)
+                    samples.push_back(ms);
+            }
+
+            if (samples.empty())
+                continue;
+
+            double total = 0.0;
+            std::vector<int> buckets(BucketCount, 0);
+
+            for (double ms : samples) {
+                total += ms;
+
+                int b = 0;
+                while (b < BucketCount - 1 && ms >= BucketEdges[b])
+                    b++;
+
+                buckets[b]++;
+            }
+
+            std::sort(samples.begin(), samples.end());
+
+            std::string label = std::string(side == 0 ? "cpu " : "gpu ") +
+                                StageNames[s];
+
+            out << "    " << std::left << std::setw(9) << label << std::right
+                << std::setw(9) << total / samples.size()
+                << std::setw(10) << Percentile(samples, 50.0)
+                << std::setw(10) << Percentile(samples, 99.0)
+                << std::setw(10) << samples.back() << std::endl;
+
+            labels.push_back(label);
+            histograms.push_back(buckets);
+        }
+    }
+
+    // Then the histograms, one row per stage, one column per bucket
+    out << std::setprecision(2) << "    frames   <";
+    for (int b = 0; b < BucketCount - 1; b++)
+        out << std::setw(6) << BucketEdges[b];
+    out << "  more" << std::endl;
+
+    for (size_t h = 0; h < histograms.size(); h++) {
+        out << "    " << std::left << std::setw(9) << labels[h] << std::right;
+        for (int b = 0; b < BucketCount; b++)
+            out << std::setw(6) << histograms[h][b];
+        out << std::endl;
+    }
+
+    if (droppedFrames > 0) {
+        out << "    " << droppedFrames
+            << " frames lost their GPU timings, the GPU was more than "
+            << RingSize << " frames behind" << std::endl;
+    }
+
+    out.unsetf(std::ios_base::floatfield);
+    out << std::setprecision(6);
+}
+
+bool FrameProfiler::WriteCsv(const std::string &path) const
+{
+    std::ofstream csv(path.c_str());
+    if (!csv)
+        return false;
+
+    csv << "frame";
+    for (int s = 0; s < StageCount; s++)
+        csv << ",cpu_" << StageNames[s] << "_ms";
+    for (int s = 0; s < StageCount; s++)
+        csv << ",gpu_" << StageNames[s] << "_ms";
+    csv << "\n";
+
+    csv << std::fixed << std::setprecision(4);
+
+    // stages that weren't timed are left empty
+    for (const FrameTiming &timing : completed) {
+        csv << timing.frame;
+        for (int s = 0; s < StageCount; s++) {
+            csv << ",";
+            if (timing.cpuMs[s] >= 0.0)
+                csv << timing.cpuMs[s];
+        }
+        for (int s = 0; s < StageCount; s++) {
+            csv << ",";
+            if (timing.gpuMs[s] >= 0.0)
+                csv << timing.gpuMs[s];
+        }
+        csv << "\n";
+    }
+
+    return static_cast<bool>(csv);
+}
+
+void FrameProfiler::Destroy()
+{
+    if (gpuTimers) {
+        for (int i = 0; i < RingSize; i++) {
+            for (int s = 0; s < StageCount; s++)
+                ring[i].queries[s].Reset();
+        }
+    }
+
+    gpuTimers = false;
+    inFlight = 0;
+}
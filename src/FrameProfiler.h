@@ -0,0 +1,130 @@
+//============================================================================
+// Name        : FrameProfiler.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Per-frame CPU and GPU timing of the render loop stages.
+//
+//               The render loop is split into stages, clear, cull (when
+//               there is a ChunkCuller), draw and swap, and we time each
+//               of them twice:
+//               - on the CPU, which tells us how long it took to submit
+//                 the commands to the driver.
+//               - on the GPU, with GL_TIME_ELAPSED queries, which tells us
+//                 how long it took the GPU to execute them.
+//
+//               Asking for a query result right after the query ends would
+//               stall the CPU until the GPU catches up, which defeats the
+//               purpose.  So we keep a ring of query sets, one per frame
+//               in flight, and read a frame's results several frames later,
+//               only once the GPU says they are available.
+//
+//               Timer queries need GL_ARB_timer_query (core in 3.3), or
+//               GL_EXT_timer_query on older drivers.  Without either, we
+//               still collect the CPU side.
+//
+//============================================================================
+
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "GLHandle.h"
+
+class FrameProfiler {
+public:
+    enum Stage {
+        StageClear = 0,
+        StageCull,
+        StageDraw,
+        StageSwap,
+        StageCount
+    };
+
+    // a disabled profiler does nothing, cheaply
+    explicit FrameProfiler(bool enabled);
+
+    // must be called with a current context, after GLLoaderInit()
+    void Init();
+
+    void BeginFrame();
+    void BeginStage(Stage stage);
+    void EndStage();
+    void EndFrame();
+
+    // Collect the frames that are still in flight, waiting on the GPU if
+    // we have to.  Only meant to be called once, when we are done rendering.
+    void Finish();
+
+    bool Enabled() const { return enabled; }
+    bool HasGpuTimers() const { return gpuTimers; }
+
+    // rolling histograms of the most recent frames, per stage
+    void Report(std::ostream &out) const;
+
+    // one line per completed frame, stage times in milliseconds
+    bool WriteCsv(const std::string &path) const;
+
+    // Deletes the query objects.  The context needs to be current,
+    // so we don't leave this to the destructor.
+    void Destroy();
+
+private:
+    FrameProfiler(const FrameProfiler &);
+    FrameProfiler &operator=(const FrameProfiler &);
+
+    typedef std::chrono::steady_clock Clock;
+
+    // results are read this many frames late
+    static const int RingSize = 4;
+
+    // the histograms only look at the most recent frames
+    static const int WindowSize = 240;
+
+    struct FrameTiming {
+        long long frame;
+        double cpuMs[StageCount];
+        double gpuMs[StageCount];
+    };
+
+    struct FrameSlot {
+        GLQuery queries[StageCount];
+        bool used[StageCount];
+        bool pending;
+        FrameTiming timing;
+    };
+
+    // read the oldest frames in flight, if the GPU is done with them
+    void Collect(bool wait);
+    bool SlotAvailable(const FrameSlot &slot) const;
+    void Record(FrameSlot &slot);
+
+    GLuint64 QueryResult(GLuint query) const;
+
+    bool enabled;
+    bool gpuTimers;
+    bool useExtTimerQuery;
+
+    FrameSlot ring[RingSize];
+    int current;
+    int oldest;
+    int inFlight;
+
+    long long frameNumber;
+    long long droppedFrames;
+
+    Stage activeStage;
+    bool stageActive;
+    Clock::time_point stageStart;
+
+    std::vector<FrameTiming> completed;
+};
+
+#endif // FRAME_PROFILER_H
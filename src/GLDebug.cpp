@@ -0,0 +1,133 @@
+//============================================================================
+// Name        : GLDebug.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Gets OpenGL's errors and warnings into the DebugLog.
+//
+//============================================================================
+
+#include "DebugLog.h"
+#include "GLDebug.h"
+
+// glGetError() keeps one flag per kind of error, so there are only so
+// many to read before it says GL_NO_ERROR
+static const int MaxErrors = 8;
+
+static bool HasDebugOutput()
+{
+    return GLL_KHR_debug || GLL_VERSION_4_3;
+}
+
+static const char *SourceName(GLenum source)
+{
+    switch (source) {
+    case GL_DEBUG_SOURCE_API:               return "API";
+    case GL_DEBUG_SOURCE_WINDOW_SYSTEM:     return "window system";
+    case GL_DEBUG_SOURCE_SHADER_COMPILER:   return "shader compiler";
+    case GL_DEBUG_SOURCE_THIRD_PARTY:       return "third party";
+    case GL_DEBUG_SOURCE_APPLICATION:       return "application";
+    default:                                return "other";
+    }
+}
+
+static const char *TypeName(GLenum type)
+{
+    switch (type) {
+    case GL_DEBUG_TYPE_ERROR:               return "error";
+    case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "deprecated";
+    case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  return "undefined behavior";
+    case GL_DEBUG_TYPE_PORTABILITY:         return "portability";
+    case GL_DEBUG_TYPE_PERFORMANCE:         return "performance";
+    default:                                return "message";
+    }
+}
+
+static const char *SeverityName(GLenum severity)
+{
+    switch (severity) {
+    case GL_DEBUG_SEVERITY_HIGH:            return "high";
+    case GL_DEBUG_SEVERITY_MEDIUM:          return "medium";
+    case GL_DEBUG_SEVERITY_LOW:             return "low";
+    default:                                return "notification";
+    }
+}
+
+static const char *ErrorName(GLenum error)
+{
+    switch (error) {
+    case GL_INVALID_ENUM:                   return "GL_INVALID_ENUM";
+    case GL_INVALID_VALUE:                  return "GL_INVALID_VALUE";
+    case GL_INVALID_OPERATION:              return "GL_INVALID_OPERATION";
+    case GL_INVALID_FRAMEBUFFER_OPERATION:
+        return "GL_INVALID_FRAMEBUFFER_OPERATION";
+    case GL_OUT_OF_MEMORY:                  return "GL_OUT_OF_MEMORY";
+    case GL_STACK_UNDERFLOW:                return "GL_STACK_UNDERFLOW";
+    case GL_STACK_OVERFLOW:                 return "GL_STACK_OVERFLOW";
+    default:                                return "unknown error";
+    }
+}
+
+// Note: this can be called on any thread, even one of the driver's, so it
+//       only ever logs
+static void GLAPIENTRY DebugMessage(GLenum source, GLenum type, GLuint id,
+                                    GLenum severity, GLsizei length,
+                                    const GLchar *message, const void *)
+{
+    Log("GL %s (%s, %s severity, id %u): %.*s", TypeName(type),
+        SourceName(source), SeverityName(severity), id,
+        static_cast<int>(length), message);
+}
+
+bool EnableGLDebugOutput()
+{
+    if (!HasDebugOutput())
+        return false;
+
+    glDebugMessageCallback(DebugMessage, nullptr);
+
+    // The notifications are mostly the driver saying what it is up to, and
+    // the compiler's errors are in the info log, which we print anyway
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE,
+                          GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr,
+                          GL_FALSE);
+    glDebugMessageControl(GL_DEBUG_SOURCE_SHADER_COMPILER, GL_DONT_CARE,
+                          GL_DONT_CARE, 0, nullptr, GL_FALSE);
+
+    // A release build only wants to hear about real trouble.  The driver's
+    // performance hints come in at any severity, and would land in the
+    // middle of the benchmark reports.
+#ifdef NDEBUG
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_LOW,
+                          0, nullptr, GL_FALSE);
+    glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_PERFORMANCE,
+                          GL_DONT_CARE, 0, nullptr, GL_FALSE);
+#else
+    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+#endif
+
+    glEnable(GL_DEBUG_OUTPUT);
+    return true;
+}
+
+void CheckGLErrors(const char *where, const char *file, int line)
+{
+    // Note: if our callback is on, it has already told us, as each one
+    //       happened.  A debug context starts with debug output on, but
+    //       without a callback, which doesn't count.
+    if (HasDebugOutput() && glIsEnabled(GL_DEBUG_OUTPUT)) {
+        GLvoid *callback = nullptr;
+        glGetPointerv(GL_DEBUG_CALLBACK_FUNCTION, &callback);
+        if (callback == reinterpret_cast<GLvoid *>(DebugMessage))
+            return;
+    }
+
+    for (int i = 0; i < MaxErrors; i++) {
+        GLenum error = glGetError();
+        if (error == GL_NO_ERROR)
+            break;
+
+        Log("GL error %s (0x%04X) in %s, %s:%d", ErrorName(error), error,
+            where, file, line);
+    }
+}
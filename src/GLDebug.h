@@ -0,0 +1,47 @@
+//============================================================================
+// Name        : GLDebug.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Gets OpenGL's errors and warnings into the DebugLog.
+//
+//               With GL_KHR_debug (or OpenGL 4.3), the driver tells us
+//               itself: a callback gets every error, and any performance
+//               warnings, with a message that says what went wrong, as it
+//               happens.  We ask for a debug context in debug builds, so
+//               there is more to hear, and make the callback synchronous,
+//               so a breakpoint in it stops inside the call that caused it.
+//               Release builds keep the callback, but only for the errors
+//               and the more severe warnings, and none of the performance
+//               hints, which are for whoever is profiling a debug build.
+//
+//               Without it, CHECK_GL_ERRORS() polls glGetError() at a few
+//               points, like the end of each frame.  glGetError() can stall
+//               a threaded driver, so the macro compiles to nothing in a
+//               release build (NDEBUG).
+//
+//               Debug output belongs to a context, so each context turns
+//               it on for itself, once it is current.
+//
+//============================================================================
+
+#ifndef GL_DEBUG_H
+#define GL_DEBUG_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+// Send the current context's debug messages to the log.  Returns false,
+// leaving it to CHECK_GL_ERRORS(), if the driver doesn't have KHR_debug.
+bool EnableGLDebugOutput();
+
+// Log any errors glGetError() has, unless debug output has already told us
+void CheckGLErrors(const char *where, const char *file, int line);
+
+#ifdef NDEBUG
+#define CHECK_GL_ERRORS(where) ((void)0)
+#else
+#define CHECK_GL_ERRORS(where) CheckGLErrors(where, __FILE__, __LINE__)
+#endif
+
+#endif // GL_DEBUG_H
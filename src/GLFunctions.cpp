@@ -0,0 +1,1076 @@
+//============================================================================
+// Name        : GLFunctions.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : The OpenGL functions, versions and extensions we use.
+//
+//               Written by tools/GenerateGLFunctions.py, from our sources
+//               and glext.h, so don't edit it.  See GLLoader.h.
+//
+//============================================================================
+
+#include "GLLoader.h"
+
+bool GLL_VERSION_2_1 = false;
+bool GLL_VERSION_3_0 = false;
+bool GLL_VERSION_3_1 = false;
+bool GLL_VERSION_3_2 = false;
+bool GLL_VERSION_3_3 = false;
+bool GLL_VERSION_4_1 = false;
+bool GLL_VERSION_4_3 = false;
+bool GLL_ARB_draw_instanced = false;
+bool GLL_ARB_framebuffer_object = false;
+bool GLL_ARB_get_program_binary = false;
+bool GLL_ARB_half_float_vertex = false;
+bool GLL_ARB_instanced_arrays = false;
+bool GLL_ARB_map_buffer_range = false;
+bool GLL_ARB_parallel_shader_compile = false;
+bool GLL_ARB_pixel_buffer_object = false;
+bool GLL_ARB_sync = false;
+bool GLL_ARB_timer_query = false;
+bool GLL_EXT_framebuffer_object = false;
+bool GLL_EXT_timer_query = false;
+bool GLL_KHR_debug = false;
+bool GLL_KHR_parallel_shader_compile = false;
+
+const GLLoaderVersionFlag GLLoaderVersions[] = {
+    {2, 1, &GLL_VERSION_2_1},
+    {3, 0, &GLL_VERSION_3_0},
+    {3, 1, &GLL_VERSION_3_1},
+    {3, 2, &GLL_VERSION_3_2},
+    {3, 3, &GLL_VERSION_3_3},
+    {4, 1, &GLL_VERSION_4_1},
+    {4, 3, &GLL_VERSION_4_3},
+};
+
+const int GLLoaderVersionCount = 7;
+
+const GLLoaderExtensionFlag GLLoaderExtensions[] = {
+    {"GL_ARB_draw_instanced", &GLL_ARB_draw_instanced},
+    {"GL_ARB_framebuffer_object", &GLL_ARB_framebuffer_object},
+    {"GL_ARB_get_program_binary", &GLL_ARB_get_program_binary},
+    {"GL_ARB_half_float_vertex", &GLL_ARB_half_float_vertex},
+    {"GL_ARB_instanced_arrays", &GLL_ARB_instanced_arrays},
+    {"GL_ARB_map_buffer_range", &GLL_ARB_map_buffer_range},
+    {"GL_ARB_parallel_shader_compile", &GLL_ARB_parallel_shader_compile},
+    {"GL_ARB_pixel_buffer_object", &GLL_ARB_pixel_buffer_object},
+    {"GL_ARB_sync", &GLL_ARB_sync},
+    {"GL_ARB_timer_query", &GLL_ARB_timer_query},
+    {"GL_EXT_framebuffer_object", &GLL_EXT_framebuffer_object},
+    {"GL_EXT_timer_query", &GLL_EXT_timer_query},
+    {"GL_KHR_debug", &GLL_KHR_debug},
+    {"GL_KHR_parallel_shader_compile", &GLL_KHR_parallel_shader_compile},
+};
+
+const int GLLoaderExtensionCount = 14;
+
+const int GLLoaderFunctionCount = 79;
+
+// Each pointer starts out at a stub that looks the function up, keeps it,
+// and passes the call on.
+
+static void APIENTRY Lazy_glActiveTexture(GLenum texture)
+{
+    gll_glActiveTexture = reinterpret_cast<GLLPROC_glActiveTexture>(
+        GLLoaderResolve("glActiveTexture"));
+    gll_glActiveTexture(texture);
+}
+
+GLLPROC_glActiveTexture gll_glActiveTexture = Lazy_glActiveTexture;
+
+static void APIENTRY Lazy_glAttachShader(GLuint program, GLuint shader)
+{
+    gll_glAttachShader = reinterpret_cast<GLLPROC_glAttachShader>(
+        GLLoaderResolve("glAttachShader"));
+    gll_glAttachShader(program, shader);
+}
+
+GLLPROC_glAttachShader gll_glAttachShader = Lazy_glAttachShader;
+
+static void APIENTRY Lazy_glBeginQuery(GLenum target, GLuint id)
+{
+    gll_glBeginQuery = reinterpret_cast<GLLPROC_glBeginQuery>(
+        GLLoaderResolve("glBeginQuery"));
+    gll_glBeginQuery(target, id);
+}
+
+GLLPROC_glBeginQuery gll_glBeginQuery = Lazy_glBeginQuery;
+
+static void APIENTRY Lazy_glBindAttribLocation(GLuint program, GLuint index,
+    const GLchar *name)
+{
+    gll_glBindAttribLocation = reinterpret_cast<GLLPROC_glBindAttribLocation>(
+        GLLoaderResolve("glBindAttribLocation"));
+    gll_glBindAttribLocation(program, index, name);
+}
+
+GLLPROC_glBindAttribLocation gll_glBindAttribLocation =
+    Lazy_glBindAttribLocation;
+
+static void APIENTRY Lazy_glBindBuffer(GLenum target, GLuint buffer)
+{
+    gll_glBindBuffer = reinterpret_cast<GLLPROC_glBindBuffer>(
+        GLLoaderResolve("glBindBuffer"));
+    gll_glBindBuffer(target, buffer);
+}
+
+GLLPROC_glBindBuffer gll_glBindBuffer = Lazy_glBindBuffer;
+
+static void APIENTRY Lazy_glBindBufferRange(GLenum target, GLuint index,
+    GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    gll_glBindBufferRange = reinterpret_cast<GLLPROC_glBindBufferRange>(
+        GLLoaderResolve("glBindBufferRange"));
+    gll_glBindBufferRange(target, index, buffer, offset, size);
+}
+
+GLLPROC_glBindBufferRange gll_glBindBufferRange = Lazy_glBindBufferRange;
+
+static void APIENTRY Lazy_glBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    gll_glBindFramebuffer = reinterpret_cast<GLLPROC_glBindFramebuffer>(
+        GLLoaderResolve("glBindFramebuffer"));
+    gll_glBindFramebuffer(target, framebuffer);
+}
+
+GLLPROC_glBindFramebuffer gll_glBindFramebuffer = Lazy_glBindFramebuffer;
+
+static void APIENTRY Lazy_glBindFramebufferEXT(GLenum target,
+    GLuint framebuffer)
+{
+    gll_glBindFramebufferEXT = reinterpret_cast<GLLPROC_glBindFramebufferEXT>(
+        GLLoaderResolve("glBindFramebufferEXT"));
+    gll_glBindFramebufferEXT(target, framebuffer);
+}
+
+GLLPROC_glBindFramebufferEXT gll_glBindFramebufferEXT =
+    Lazy_glBindFramebufferEXT;
+
+static void APIENTRY Lazy_glBindRenderbuffer(GLenum target,
+    GLuint renderbuffer)
+{
+    gll_glBindRenderbuffer = reinterpret_cast<GLLPROC_glBindRenderbuffer>(
+        GLLoaderResolve("glBindRenderbuffer"));
+    gll_glBindRenderbuffer(target, renderbuffer);
+}
+
+GLLPROC_glBindRenderbuffer gll_glBindRenderbuffer = Lazy_glBindRenderbuffer;
+
+static void APIENTRY Lazy_glBindRenderbufferEXT(GLenum target,
+    GLuint renderbuffer)
+{
+    gll_glBindRenderbufferEXT =
+        reinterpret_cast<GLLPROC_glBindRenderbufferEXT>(
+            GLLoaderResolve("glBindRenderbufferEXT"));
+    gll_glBindRenderbufferEXT(target, renderbuffer);
+}
+
+GLLPROC_glBindRenderbufferEXT gll_glBindRenderbufferEXT =
+    Lazy_glBindRenderbufferEXT;
+
+static void APIENTRY Lazy_glBindVertexArray(GLuint array)
+{
+    gll_glBindVertexArray = reinterpret_cast<GLLPROC_glBindVertexArray>(
+        GLLoaderResolve("glBindVertexArray"));
+    gll_glBindVertexArray(array);
+}
+
+GLLPROC_glBindVertexArray gll_glBindVertexArray = Lazy_glBindVertexArray;
+
+static void APIENTRY Lazy_glBlitFramebuffer(GLint srcX0, GLint srcY0,
+    GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1,
+    GLint dstY1, GLbitfield mask, GLenum filter)
+{
+    gll_glBlitFramebuffer = reinterpret_cast<GLLPROC_glBlitFramebuffer>(
+        GLLoaderResolve("glBlitFramebuffer"));
+    gll_glBlitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1,
+        dstY1, mask, filter);
+}
+
+GLLPROC_glBlitFramebuffer gll_glBlitFramebuffer = Lazy_glBlitFramebuffer;
+
+static void APIENTRY Lazy_glBufferData(GLenum target, GLsizeiptr size,
+    const void *data, GLenum usage)
+{
+    gll_glBufferData = reinterpret_cast<GLLPROC_glBufferData>(
+        GLLoaderResolve("glBufferData"));
+    gll_glBufferData(target, size, data, usage);
+}
+
+GLLPROC_glBufferData gll_glBufferData = Lazy_glBufferData;
+
+static void APIENTRY Lazy_glBufferSubData(GLenum target, GLintptr offset,
+    GLsizeiptr size, const void *data)
+{
+    gll_glBufferSubData = reinterpret_cast<GLLPROC_glBufferSubData>(
+        GLLoaderResolve("glBufferSubData"));
+    gll_glBufferSubData(target, offset, size, data);
+}
+
+GLLPROC_glBufferSubData gll_glBufferSubData = Lazy_glBufferSubData;
+
+static GLenum APIENTRY Lazy_glCheckFramebufferStatus(GLenum target)
+{
+    gll_glCheckFramebufferStatus =
+        reinterpret_cast<GLLPROC_glCheckFramebufferStatus>(
+            GLLoaderResolve("glCheckFramebufferStatus"));
+    return gll_glCheckFramebufferStatus(target);
+}
+
+GLLPROC_glCheckFramebufferStatus gll_glCheckFramebufferStatus =
+    Lazy_glCheckFramebufferStatus;
+
+static GLenum APIENTRY Lazy_glCheckFramebufferStatusEXT(GLenum target)
+{
+    gll_glCheckFramebufferStatusEXT =
+        reinterpret_cast<GLLPROC_glCheckFramebufferStatusEXT>(
+            GLLoaderResolve("glCheckFramebufferStatusEXT"));
+    return gll_glCheckFramebufferStatusEXT(target);
+}
+
+GLLPROC_glCheckFramebufferStatusEXT gll_glCheckFramebufferStatusEXT =
+    Lazy_glCheckFramebufferStatusEXT;
+
+static GLenum APIENTRY Lazy_glClientWaitSync(GLsync sync, GLbitfield flags,
+    GLuint64 timeout)
+{
+    gll_glClientWaitSync = reinterpret_cast<GLLPROC_glClientWaitSync>(
+        GLLoaderResolve("glClientWaitSync"));
+    return gll_glClientWaitSync(sync, flags, timeout);
+}
+
+GLLPROC_glClientWaitSync gll_glClientWaitSync = Lazy_glClientWaitSync;
+
+static void APIENTRY Lazy_glCompileShader(GLuint shader)
+{
+    gll_glCompileShader = reinterpret_cast<GLLPROC_glCompileShader>(
+        GLLoaderResolve("glCompileShader"));
+    gll_glCompileShader(shader);
+}
+
+GLLPROC_glCompileShader gll_glCompileShader = Lazy_glCompileShader;
+
+static GLuint APIENTRY Lazy_glCreateProgram()
+{
+    gll_glCreateProgram = reinterpret_cast<GLLPROC_glCreateProgram>(
+        GLLoaderResolve("glCreateProgram"));
+    return gll_glCreateProgram();
+}
+
+GLLPROC_glCreateProgram gll_glCreateProgram = Lazy_glCreateProgram;
+
+static GLuint APIENTRY Lazy_glCreateShader(GLenum type)
+{
+    gll_glCreateShader = reinterpret_cast<GLLPROC_glCreateShader>(
+        GLLoaderResolve("glCreateShader"));
+    return gll_glCreateShader(type);
+}
+
+GLLPROC_glCreateShader gll_glCreateShader = Lazy_glCreateShader;
+
+static void APIENTRY Lazy_glDebugMessageCallback(GLDEBUGPROC callback,
+    const void *userParam)
+{
+    gll_glDebugMessageCallback =
+        reinterpret_cast<GLLPROC_glDebugMessageCallback>(
+            GLLoaderResolve("glDebugMessageCallback"));
+    gll_glDebugMessageCallback(callback, userParam);
+}
+
+GLLPROC_glDebugMessageCallback gll_glDebugMessageCallback =
+    Lazy_glDebugMessageCallback;
+
+static void APIENTRY Lazy_glDebugMessageControl(GLenum source, GLenum type,
+    GLenum severity, GLsizei count, const GLuint *ids, GLboolean enabled)
+{
+    gll_glDebugMessageControl =
+        reinterpret_cast<GLLPROC_glDebugMessageControl>(
+            GLLoaderResolve("glDebugMessageControl"));
+    gll_glDebugMessageControl(source, type, severity, count, ids, enabled);
+}
+
+GLLPROC_glDebugMessageControl gll_glDebugMessageControl =
+    Lazy_glDebugMessageControl;
+
+static void APIENTRY Lazy_glDeleteBuffers(GLsizei n, const GLuint *buffers)
+{
+    gll_glDeleteBuffers = reinterpret_cast<GLLPROC_glDeleteBuffers>(
+        GLLoaderResolve("glDeleteBuffers"));
+    gll_glDeleteBuffers(n, buffers);
+}
+
+GLLPROC_glDeleteBuffers gll_glDeleteBuffers = Lazy_glDeleteBuffers;
+
+static void APIENTRY Lazy_glDeleteFramebuffers(GLsizei n,
+    const GLuint *framebuffers)
+{
+    gll_glDeleteFramebuffers = reinterpret_cast<GLLPROC_glDeleteFramebuffers>(
+        GLLoaderResolve("glDeleteFramebuffers"));
+    gll_glDeleteFramebuffers(n, framebuffers);
+}
+
+GLLPROC_glDeleteFramebuffers gll_glDeleteFramebuffers =
+    Lazy_glDeleteFramebuffers;
+
+static void APIENTRY Lazy_glDeleteFramebuffersEXT(GLsizei n,
+    const GLuint *framebuffers)
+{
+    gll_glDeleteFramebuffersEXT =
+        reinterpret_cast<GLLPROC_glDeleteFramebuffersEXT>(
+            GLLoaderResolve("glDeleteFramebuffersEXT"));
+    gll_glDeleteFramebuffersEXT(n, framebuffers);
+}
+
+GLLPROC_glDeleteFramebuffersEXT gll_glDeleteFramebuffersEXT =
+    Lazy_glDeleteFramebuffersEXT;
+
+static void APIENTRY Lazy_glDeleteProgram(GLuint program)
+{
+    gll_glDeleteProgram = reinterpret_cast<GLLPROC_glDeleteProgram>(
+        GLLoaderResolve("glDeleteProgram"));
+    gll_glDeleteProgram(program);
+}
+
+GLLPROC_glDeleteProgram gll_glDeleteProgram = Lazy_glDeleteProgram;
+
+static void APIENTRY Lazy_glDeleteQueries(GLsizei n, const GLuint *ids)
+{
+    gll_glDeleteQueries = reinterpret_cast<GLLPROC_glDeleteQueries>(
+        GLLoaderResolve("glDeleteQueries"));
+    gll_glDeleteQueries(n, ids);
+}
+
+GLLPROC_glDeleteQueries gll_glDeleteQueries = Lazy_glDeleteQueries;
+
+static void APIENTRY Lazy_glDeleteRenderbuffers(GLsizei n,
+    const GLuint *renderbuffers)
+{
+    gll_glDeleteRenderbuffers =
+        reinterpret_cast<GLLPROC_glDeleteRenderbuffers>(
+            GLLoaderResolve("glDeleteRenderbuffers"));
+    gll_glDeleteRenderbuffers(n, renderbuffers);
+}
+
+GLLPROC_glDeleteRenderbuffers gll_glDeleteRenderbuffers =
+    Lazy_glDeleteRenderbuffers;
+
+static void APIENTRY Lazy_glDeleteRenderbuffersEXT(GLsizei n,
+    const GLuint *renderbuffers)
+{
+    gll_glDeleteRenderbuffersEXT =
+        reinterpret_cast<GLLPROC_glDeleteRenderbuffersEXT>(
+            GLLoaderResolve("glDeleteRenderbuffersEXT"));
+    gll_glDeleteRenderbuffersEXT(n, renderbuffers);
+}
+
+GLLPROC_glDeleteRenderbuffersEXT gll_glDeleteRenderbuffersEXT =
+    Lazy_glDeleteRenderbuffersEXT;
+
+static void APIENTRY Lazy_glDeleteShader(GLuint shader)
+{
+    gll_glDeleteShader = reinterpret_cast<GLLPROC_glDeleteShader>(
+        GLLoaderResolve("glDeleteShader"));
+    gll_glDeleteShader(shader);
+}
+
+GLLPROC_glDeleteShader gll_glDeleteShader = Lazy_glDeleteShader;
+
+static void APIENTRY Lazy_glDeleteSync(GLsync sync)
+{
+    gll_glDeleteSync = reinterpret_cast<GLLPROC_glDeleteSync>(
+        GLLoaderResolve("glDeleteSync"));
+    gll_glDeleteSync(sync);
+}
+
+GLLPROC_glDeleteSync gll_glDeleteSync = Lazy_glDeleteSync;
+
+static void APIENTRY Lazy_glDeleteVertexArrays(GLsizei n, const GLuint *arrays)
+{
+    gll_glDeleteVertexArrays = reinterpret_cast<GLLPROC_glDeleteVertexArrays>(
+        GLLoaderResolve("glDeleteVertexArrays"));
+    gll_glDeleteVertexArrays(n, arrays);
+}
+
+GLLPROC_glDeleteVertexArrays gll_glDeleteVertexArrays =
+    Lazy_glDeleteVertexArrays;
+
+static void APIENTRY Lazy_glDrawArraysInstanced(GLenum mode, GLint first,
+    GLsizei count, GLsizei instancecount)
+{
+    gll_glDrawArraysInstanced =
+        reinterpret_cast<GLLPROC_glDrawArraysInstanced>(
+            GLLoaderResolve("glDrawArraysInstanced"));
+    gll_glDrawArraysInstanced(mode, first, count, instancecount);
+}
+
+GLLPROC_glDrawArraysInstanced gll_glDrawArraysInstanced =
+    Lazy_glDrawArraysInstanced;
+
+static void APIENTRY Lazy_glDrawArraysInstancedARB(GLenum mode, GLint first,
+    GLsizei count, GLsizei primcount)
+{
+    gll_glDrawArraysInstancedARB =
+        reinterpret_cast<GLLPROC_glDrawArraysInstancedARB>(
+            GLLoaderResolve("glDrawArraysInstancedARB"));
+    gll_glDrawArraysInstancedARB(mode, first, count, primcount);
+}
+
+GLLPROC_glDrawArraysInstancedARB gll_glDrawArraysInstancedARB =
+    Lazy_glDrawArraysInstancedARB;
+
+static void APIENTRY Lazy_glEnableVertexAttribArray(GLuint index)
+{
+    gll_glEnableVertexAttribArray =
+        reinterpret_cast<GLLPROC_glEnableVertexAttribArray>(
+            GLLoaderResolve("glEnableVertexAttribArray"));
+    gll_glEnableVertexAttribArray(index);
+}
+
+GLLPROC_glEnableVertexAttribArray gll_glEnableVertexAttribArray =
+    Lazy_glEnableVertexAttribArray;
+
+static void APIENTRY Lazy_glEndQuery(GLenum target)
+{
+    gll_glEndQuery = reinterpret_cast<GLLPROC_glEndQuery>(
+        GLLoaderResolve("glEndQuery"));
+    gll_glEndQuery(target);
+}
+
+GLLPROC_glEndQuery gll_glEndQuery = Lazy_glEndQuery;
+
+static GLsync APIENTRY Lazy_glFenceSync(GLenum condition, GLbitfield flags)
+{
+    gll_glFenceSync = reinterpret_cast<GLLPROC_glFenceSync>(
+        GLLoaderResolve("glFenceSync"));
+    return gll_glFenceSync(condition, flags);
+}
+
+GLLPROC_glFenceSync gll_glFenceSync = Lazy_glFenceSync;
+
+static void APIENTRY Lazy_glFramebufferRenderbuffer(GLenum target,
+    GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+{
+    gll_glFramebufferRenderbuffer =
+        reinterpret_cast<GLLPROC_glFramebufferRenderbuffer>(
+            GLLoaderResolve("glFramebufferRenderbuffer"));
+    gll_glFramebufferRenderbuffer(target, attachment, renderbuffertarget,
+        renderbuffer);
+}
+
+GLLPROC_glFramebufferRenderbuffer gll_glFramebufferRenderbuffer =
+    Lazy_glFramebufferRenderbuffer;
+
+static void APIENTRY Lazy_glFramebufferRenderbufferEXT(GLenum target,
+    GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+{
+    gll_glFramebufferRenderbufferEXT =
+        reinterpret_cast<GLLPROC_glFramebufferRenderbufferEXT>(
+            GLLoaderResolve("glFramebufferRenderbufferEXT"));
+    gll_glFramebufferRenderbufferEXT(target, attachment, renderbuffertarget,
+        renderbuffer);
+}
+
+GLLPROC_glFramebufferRenderbufferEXT gll_glFramebufferRenderbufferEXT =
+    Lazy_glFramebufferRenderbufferEXT;
+
+static void APIENTRY Lazy_glGenBuffers(GLsizei n, GLuint *buffers)
+{
+    gll_glGenBuffers = reinterpret_cast<GLLPROC_glGenBuffers>(
+        GLLoaderResolve("glGenBuffers"));
+    gll_glGenBuffers(n, buffers);
+}
+
+GLLPROC_glGenBuffers gll_glGenBuffers = Lazy_glGenBuffers;
+
+static void APIENTRY Lazy_glGenFramebuffers(GLsizei n, GLuint *framebuffers)
+{
+    gll_glGenFramebuffers = reinterpret_cast<GLLPROC_glGenFramebuffers>(
+        GLLoaderResolve("glGenFramebuffers"));
+    gll_glGenFramebuffers(n, framebuffers);
+}
+
+GLLPROC_glGenFramebuffers gll_glGenFramebuffers = Lazy_glGenFramebuffers;
+
+static void APIENTRY Lazy_glGenFramebuffersEXT(GLsizei n, GLuint *framebuffers)
+{
+    gll_glGenFramebuffersEXT = reinterpret_cast<GLLPROC_glGenFramebuffersEXT>(
+        GLLoaderResolve("glGenFramebuffersEXT"));
+    gll_glGenFramebuffersEXT(n, framebuffers);
+}
+
+GLLPROC_glGenFramebuffersEXT gll_glGenFramebuffersEXT =
+    Lazy_glGenFramebuffersEXT;
+
+static void APIENTRY Lazy_glGenQueries(GLsizei n, GLuint *ids)
+{
+    gll_glGenQueries = reinterpret_cast<GLLPROC_glGenQueries>(
+        GLLoaderResolve("glGenQueries"));
+    gll_glGenQueries(n, ids);
+}
+
+GLLPROC_glGenQueries gll_glGenQueries = Lazy_glGenQueries;
+
+static void APIENTRY Lazy_glGenRenderbuffers(GLsizei n, GLuint *renderbuffers)
+{
+    gll_glGenRenderbuffers = reinterpret_cast<GLLPROC_glGenRenderbuffers>(
+        GLLoaderResolve("glGenRenderbuffers"));
+    gll_glGenRenderbuffers(n, renderbuffers);
+}
+
+GLLPROC_glGenRenderbuffers gll_glGenRenderbuffers = Lazy_glGenRenderbuffers;
+
+static void APIENTRY Lazy_glGenRenderbuffersEXT(GLsizei n,
+    GLuint *renderbuffers)
+{
+    gll_glGenRenderbuffersEXT =
+        reinterpret_cast<GLLPROC_glGenRenderbuffersEXT>(
+            GLLoaderResolve("glGenRenderbuffersEXT"));
+    gll_glGenRenderbuffersEXT(n, renderbuffers);
+}
+
+GLLPROC_glGenRenderbuffersEXT gll_glGenRenderbuffersEXT =
+    Lazy_glGenRenderbuffersEXT;
+
+static void APIENTRY Lazy_glGenVertexArrays(GLsizei n, GLuint *arrays)
+{
+    gll_glGenVertexArrays = reinterpret_cast<GLLPROC_glGenVertexArrays>(
+        GLLoaderResolve("glGenVertexArrays"));
+    gll_glGenVertexArrays(n, arrays);
+}
+
+GLLPROC_glGenVertexArrays gll_glGenVertexArrays = Lazy_glGenVertexArrays;
+
+static void APIENTRY Lazy_glGetBufferParameteriv(GLenum target, GLenum pname,
+    GLint *params)
+{
+    gll_glGetBufferParameteriv =
+        reinterpret_cast<GLLPROC_glGetBufferParameteriv>(
+            GLLoaderResolve("glGetBufferParameteriv"));
+    gll_glGetBufferParameteriv(target, pname, params);
+}
+
+GLLPROC_glGetBufferParameteriv gll_glGetBufferParameteriv =
+    Lazy_glGetBufferParameteriv;
+
+static void APIENTRY Lazy_glGetBufferSubData(GLenum target, GLintptr offset,
+    GLsizeiptr size, void *data)
+{
+    gll_glGetBufferSubData = reinterpret_cast<GLLPROC_glGetBufferSubData>(
+        GLLoaderResolve("glGetBufferSubData"));
+    gll_glGetBufferSubData(target, offset, size, data);
+}
+
+GLLPROC_glGetBufferSubData gll_glGetBufferSubData = Lazy_glGetBufferSubData;
+
+static void APIENTRY Lazy_glGetProgramBinary(GLuint program, GLsizei bufSize,
+    GLsizei *length, GLenum *binaryFormat, void *binary)
+{
+    gll_glGetProgramBinary = reinterpret_cast<GLLPROC_glGetProgramBinary>(
+        GLLoaderResolve("glGetProgramBinary"));
+    gll_glGetProgramBinary(program, bufSize, length, binaryFormat, binary);
+}
+
+GLLPROC_glGetProgramBinary gll_glGetProgramBinary = Lazy_glGetProgramBinary;
+
+static void APIENTRY Lazy_glGetProgramInfoLog(GLuint program, GLsizei bufSize,
+    GLsizei *length, GLchar *infoLog)
+{
+    gll_glGetProgramInfoLog = reinterpret_cast<GLLPROC_glGetProgramInfoLog>(
+        GLLoaderResolve("glGetProgramInfoLog"));
+    gll_glGetProgramInfoLog(program, bufSize, length, infoLog);
+}
+
+GLLPROC_glGetProgramInfoLog gll_glGetProgramInfoLog = Lazy_glGetProgramInfoLog;
+
+static void APIENTRY Lazy_glGetProgramiv(GLuint program, GLenum pname,
+    GLint *params)
+{
+    gll_glGetProgramiv = reinterpret_cast<GLLPROC_glGetProgramiv>(
+        GLLoaderResolve("glGetProgramiv"));
+    gll_glGetProgramiv(program, pname, params);
+}
+
+GLLPROC_glGetProgramiv gll_glGetProgramiv = Lazy_glGetProgramiv;
+
+static void APIENTRY Lazy_glGetQueryObjectiv(GLuint id, GLenum pname,
+    GLint *params)
+{
+    gll_glGetQueryObjectiv = reinterpret_cast<GLLPROC_glGetQueryObjectiv>(
+        GLLoaderResolve("glGetQueryObjectiv"));
+    gll_glGetQueryObjectiv(id, pname, params);
+}
+
+GLLPROC_glGetQueryObjectiv gll_glGetQueryObjectiv = Lazy_glGetQueryObjectiv;
+
+static void APIENTRY Lazy_glGetQueryObjectui64v(GLuint id, GLenum pname,
+    GLuint64 *params)
+{
+    gll_glGetQueryObjectui64v =
+        reinterpret_cast<GLLPROC_glGetQueryObjectui64v>(
+            GLLoaderResolve("glGetQueryObjectui64v"));
+    gll_glGetQueryObjectui64v(id, pname, params);
+}
+
+GLLPROC_glGetQueryObjectui64v gll_glGetQueryObjectui64v =
+    Lazy_glGetQueryObjectui64v;
+
+static void APIENTRY Lazy_glGetQueryObjectui64vEXT(GLuint id, GLenum pname,
+    GLuint64 *params)
+{
+    gll_glGetQueryObjectui64vEXT =
+        reinterpret_cast<GLLPROC_glGetQueryObjectui64vEXT>(
+            GLLoaderResolve("glGetQueryObjectui64vEXT"));
+    gll_glGetQueryObjectui64vEXT(id, pname, params);
+}
+
+GLLPROC_glGetQueryObjectui64vEXT gll_glGetQueryObjectui64vEXT =
+    Lazy_glGetQueryObjectui64vEXT;
+
+static void APIENTRY Lazy_glGetShaderInfoLog(GLuint shader, GLsizei bufSize,
+    GLsizei *length, GLchar *infoLog)
+{
+    gll_glGetShaderInfoLog = reinterpret_cast<GLLPROC_glGetShaderInfoLog>(
+        GLLoaderResolve("glGetShaderInfoLog"));
+    gll_glGetShaderInfoLog(shader, bufSize, length, infoLog);
+}
+
+GLLPROC_glGetShaderInfoLog gll_glGetShaderInfoLog = Lazy_glGetShaderInfoLog;
+
+static void APIENTRY Lazy_glGetShaderiv(GLuint shader, GLenum pname,
+    GLint *params)
+{
+    gll_glGetShaderiv = reinterpret_cast<GLLPROC_glGetShaderiv>(
+        GLLoaderResolve("glGetShaderiv"));
+    gll_glGetShaderiv(shader, pname, params);
+}
+
+GLLPROC_glGetShaderiv gll_glGetShaderiv = Lazy_glGetShaderiv;
+
+static GLuint APIENTRY Lazy_glGetUniformBlockIndex(GLuint program,
+    const GLchar *uniformBlockName)
+{
+    gll_glGetUniformBlockIndex =
+        reinterpret_cast<GLLPROC_glGetUniformBlockIndex>(
+            GLLoaderResolve("glGetUniformBlockIndex"));
+    return gll_glGetUniformBlockIndex(program, uniformBlockName);
+}
+
+GLLPROC_glGetUniformBlockIndex gll_glGetUniformBlockIndex =
+    Lazy_glGetUniformBlockIndex;
+
+static GLint APIENTRY Lazy_glGetUniformLocation(GLuint program,
+    const GLchar *name)
+{
+    gll_glGetUniformLocation = reinterpret_cast<GLLPROC_glGetUniformLocation>(
+        GLLoaderResolve("glGetUniformLocation"));
+    return gll_glGetUniformLocation(program, name);
+}
+
+GLLPROC_glGetUniformLocation gll_glGetUniformLocation =
+    Lazy_glGetUniformLocation;
+
+static void APIENTRY Lazy_glLinkProgram(GLuint program)
+{
+    gll_glLinkProgram = reinterpret_cast<GLLPROC_glLinkProgram>(
+        GLLoaderResolve("glLinkProgram"));
+    gll_glLinkProgram(program);
+}
+
+GLLPROC_glLinkProgram gll_glLinkProgram = Lazy_glLinkProgram;
+
+static void * APIENTRY Lazy_glMapBuffer(GLenum target, GLenum access)
+{
+    gll_glMapBuffer = reinterpret_cast<GLLPROC_glMapBuffer>(
+        GLLoaderResolve("glMapBuffer"));
+    return gll_glMapBuffer(target, access);
+}
+
+GLLPROC_glMapBuffer gll_glMapBuffer = Lazy_glMapBuffer;
+
+static void * APIENTRY Lazy_glMapBufferRange(GLenum target, GLintptr offset,
+    GLsizeiptr length, GLbitfield access)
+{
+    gll_glMapBufferRange = reinterpret_cast<GLLPROC_glMapBufferRange>(
+        GLLoaderResolve("glMapBufferRange"));
+    return gll_glMapBufferRange(target, offset, length, access);
+}
+
+GLLPROC_glMapBufferRange gll_glMapBufferRange = Lazy_glMapBufferRange;
+
+static void APIENTRY Lazy_glMaxShaderCompilerThreadsARB(GLuint count)
+{
+    gll_glMaxShaderCompilerThreadsARB =
+        reinterpret_cast<GLLPROC_glMaxShaderCompilerThreadsARB>(
+            GLLoaderResolve("glMaxShaderCompilerThreadsARB"));
+    gll_glMaxShaderCompilerThreadsARB(count);
+}
+
+GLLPROC_glMaxShaderCompilerThreadsARB gll_glMaxShaderCompilerThreadsARB =
+    Lazy_glMaxShaderCompilerThreadsARB;
+
+static void APIENTRY Lazy_glMaxShaderCompilerThreadsKHR(GLuint count)
+{
+    gll_glMaxShaderCompilerThreadsKHR =
+        reinterpret_cast<GLLPROC_glMaxShaderCompilerThreadsKHR>(
+            GLLoaderResolve("glMaxShaderCompilerThreadsKHR"));
+    gll_glMaxShaderCompilerThreadsKHR(count);
+}
+
+GLLPROC_glMaxShaderCompilerThreadsKHR gll_glMaxShaderCompilerThreadsKHR =
+    Lazy_glMaxShaderCompilerThreadsKHR;
+
+static void APIENTRY Lazy_glProgramBinary(GLuint program, GLenum binaryFormat,
+    const void *binary, GLsizei length)
+{
+    gll_glProgramBinary = reinterpret_cast<GLLPROC_glProgramBinary>(
+        GLLoaderResolve("glProgramBinary"));
+    gll_glProgramBinary(program, binaryFormat, binary, length);
+}
+
+GLLPROC_glProgramBinary gll_glProgramBinary = Lazy_glProgramBinary;
+
+static void APIENTRY Lazy_glProgramParameteri(GLuint program, GLenum pname,
+    GLint value)
+{
+    gll_glProgramParameteri = reinterpret_cast<GLLPROC_glProgramParameteri>(
+        GLLoaderResolve("glProgramParameteri"));
+    gll_glProgramParameteri(program, pname, value);
+}
+
+GLLPROC_glProgramParameteri gll_glProgramParameteri = Lazy_glProgramParameteri;
+
+static void APIENTRY Lazy_glQueryCounter(GLuint id, GLenum target)
+{
+    gll_glQueryCounter = reinterpret_cast<GLLPROC_glQueryCounter>(
+        GLLoaderResolve("glQueryCounter"));
+    gll_glQueryCounter(id, target);
+}
+
+GLLPROC_glQueryCounter gll_glQueryCounter = Lazy_glQueryCounter;
+
+static void APIENTRY Lazy_glRenderbufferStorage(GLenum target,
+    GLenum internalformat, GLsizei width, GLsizei height)
+{
+    gll_glRenderbufferStorage =
+        reinterpret_cast<GLLPROC_glRenderbufferStorage>(
+            GLLoaderResolve("glRenderbufferStorage"));
+    gll_glRenderbufferStorage(target, internalformat, width, height);
+}
+
+GLLPROC_glRenderbufferStorage gll_glRenderbufferStorage =
+    Lazy_glRenderbufferStorage;
+
+static void APIENTRY Lazy_glRenderbufferStorageEXT(GLenum target,
+    GLenum internalformat, GLsizei width, GLsizei height)
+{
+    gll_glRenderbufferStorageEXT =
+        reinterpret_cast<GLLPROC_glRenderbufferStorageEXT>(
+            GLLoaderResolve("glRenderbufferStorageEXT"));
+    gll_glRenderbufferStorageEXT(target, internalformat, width, height);
+}
+
+GLLPROC_glRenderbufferStorageEXT gll_glRenderbufferStorageEXT =
+    Lazy_glRenderbufferStorageEXT;
+
+static void APIENTRY Lazy_glShaderSource(GLuint shader, GLsizei count,
+    const GLchar *const*string, const GLint *length)
+{
+    gll_glShaderSource = reinterpret_cast<GLLPROC_glShaderSource>(
+        GLLoaderResolve("glShaderSource"));
+    gll_glShaderSource(shader, count, string, length);
+}
+
+GLLPROC_glShaderSource gll_glShaderSource = Lazy_glShaderSource;
+
+static void APIENTRY Lazy_glTexBuffer(GLenum target, GLenum internalformat,
+    GLuint buffer)
+{
+    gll_glTexBuffer = reinterpret_cast<GLLPROC_glTexBuffer>(
+        GLLoaderResolve("glTexBuffer"));
+    gll_glTexBuffer(target, internalformat, buffer);
+}
+
+GLLPROC_glTexBuffer gll_glTexBuffer = Lazy_glTexBuffer;
+
+static void APIENTRY Lazy_glUniform1i(GLint location, GLint v0)
+{
+    gll_glUniform1i = reinterpret_cast<GLLPROC_glUniform1i>(
+        GLLoaderResolve("glUniform1i"));
+    gll_glUniform1i(location, v0);
+}
+
+GLLPROC_glUniform1i gll_glUniform1i = Lazy_glUniform1i;
+
+static void APIENTRY Lazy_glUniform4fv(GLint location, GLsizei count,
+    const GLfloat *value)
+{
+    gll_glUniform4fv = reinterpret_cast<GLLPROC_glUniform4fv>(
+        GLLoaderResolve("glUniform4fv"));
+    gll_glUniform4fv(location, count, value);
+}
+
+GLLPROC_glUniform4fv gll_glUniform4fv = Lazy_glUniform4fv;
+
+static void APIENTRY Lazy_glUniformBlockBinding(GLuint program,
+    GLuint uniformBlockIndex, GLuint uniformBlockBinding)
+{
+    gll_glUniformBlockBinding =
+        reinterpret_cast<GLLPROC_glUniformBlockBinding>(
+            GLLoaderResolve("glUniformBlockBinding"));
+    gll_glUniformBlockBinding(program, uniformBlockIndex, uniformBlockBinding);
+}
+
+GLLPROC_glUniformBlockBinding gll_glUniformBlockBinding =
+    Lazy_glUniformBlockBinding;
+
+static GLboolean APIENTRY Lazy_glUnmapBuffer(GLenum target)
+{
+    gll_glUnmapBuffer = reinterpret_cast<GLLPROC_glUnmapBuffer>(
+        GLLoaderResolve("glUnmapBuffer"));
+    return gll_glUnmapBuffer(target);
+}
+
+GLLPROC_glUnmapBuffer gll_glUnmapBuffer = Lazy_glUnmapBuffer;
+
+static void APIENTRY Lazy_glUseProgram(GLuint program)
+{
+    gll_glUseProgram = reinterpret_cast<GLLPROC_glUseProgram>(
+        GLLoaderResolve("glUseProgram"));
+    gll_glUseProgram(program);
+}
+
+GLLPROC_glUseProgram gll_glUseProgram = Lazy_glUseProgram;
+
+static void APIENTRY Lazy_glVertexAttrib4f(GLuint index, GLfloat x, GLfloat y,
+    GLfloat z, GLfloat w)
+{
+    gll_glVertexAttrib4f = reinterpret_cast<GLLPROC_glVertexAttrib4f>(
+        GLLoaderResolve("glVertexAttrib4f"));
+    gll_glVertexAttrib4f(index, x, y, z, w);
+}
+
+GLLPROC_glVertexAttrib4f gll_glVertexAttrib4f = Lazy_glVertexAttrib4f;
+
+static void APIENTRY Lazy_glVertexAttribDivisor(GLuint index, GLuint divisor)
+{
+    gll_glVertexAttribDivisor =
+        reinterpret_cast<GLLPROC_glVertexAttribDivisor>(
+            GLLoaderResolve("glVertexAttribDivisor"));
+    gll_glVertexAttribDivisor(index, divisor);
+}
+
+GLLPROC_glVertexAttribDivisor gll_glVertexAttribDivisor =
+    Lazy_glVertexAttribDivisor;
+
+static void APIENTRY Lazy_glVertexAttribDivisorARB(GLuint index,
+    GLuint divisor)
+{
+    gll_glVertexAttribDivisorARB =
+        reinterpret_cast<GLLPROC_glVertexAttribDivisorARB>(
+            GLLoaderResolve("glVertexAttribDivisorARB"));
+    gll_glVertexAttribDivisorARB(index, divisor);
+}
+
+GLLPROC_glVertexAttribDivisorARB gll_glVertexAttribDivisorARB =
+    Lazy_glVertexAttribDivisorARB;
+
+static void APIENTRY Lazy_glVertexAttribPointer(GLuint index, GLint size,
+    GLenum type, GLboolean normalized, GLsizei stride, const void *pointer)
+{
+    gll_glVertexAttribPointer =
+        reinterpret_cast<GLLPROC_glVertexAttribPointer>(
+            GLLoaderResolve("glVertexAttribPointer"));
+    gll_glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+}
+
+GLLPROC_glVertexAttribPointer gll_glVertexAttribPointer =
+    Lazy_glVertexAttribPointer;
+
+void GLLoaderResolveAll()
+{
+    gll_glActiveTexture = reinterpret_cast<GLLPROC_glActiveTexture>(
+        GLLoaderResolve("glActiveTexture"));
+    gll_glAttachShader = reinterpret_cast<GLLPROC_glAttachShader>(
+        GLLoaderResolve("glAttachShader"));
+    gll_glBeginQuery = reinterpret_cast<GLLPROC_glBeginQuery>(
+        GLLoaderResolve("glBeginQuery"));
+    gll_glBindAttribLocation = reinterpret_cast<GLLPROC_glBindAttribLocation>(
+        GLLoaderResolve("glBindAttribLocation"));
+    gll_glBindBuffer = reinterpret_cast<GLLPROC_glBindBuffer>(
+        GLLoaderResolve("glBindBuffer"));
+    gll_glBindBufferRange = reinterpret_cast<GLLPROC_glBindBufferRange>(
+        GLLoaderResolve("glBindBufferRange"));
+    gll_glBindFramebuffer = reinterpret_cast<GLLPROC_glBindFramebuffer>(
+        GLLoaderResolve("glBindFramebuffer"));
+    gll_glBindFramebufferEXT = reinterpret_cast<GLLPROC_glBindFramebufferEXT>(
+        GLLoaderResolve("glBindFramebufferEXT"));
+    gll_glBindRenderbuffer = reinterpret_cast<GLLPROC_glBindRenderbuffer>(
+        GLLoaderResolve("glBindRenderbuffer"));
+    gll_glBindRenderbufferEXT =
+        reinterpret_cast<GLLPROC_glBindRenderbufferEXT>(
+            GLLoaderResolve("glBindRenderbufferEXT"));
+    gll_glBindVertexArray = reinterpret_cast<GLLPROC_glBindVertexArray>(
+        GLLoaderResolve("glBindVertexArray"));
+    gll_glBlitFramebuffer = reinterpret_cast<GLLPROC_glBlitFramebuffer>(
+        GLLoaderResolve("glBlitFramebuffer"));
+    gll_glBufferData = reinterpret_cast<GLLPROC_glBufferData>(
+        GLLoaderResolve("glBufferData"));
+    gll_glBufferSubData = reinterpret_cast<GLLPROC_glBufferSubData>(
+        GLLoaderResolve("glBufferSubData"));
+    gll_glCheckFramebufferStatus =
+        reinterpret_cast<GLLPROC_glCheckFramebufferStatus>(
+            GLLoaderResolve("glCheckFramebufferStatus"));
+    gll_glCheckFramebufferStatusEXT =
+        reinterpret_cast<GLLPROC_glCheckFramebufferStatusEXT>(
+            GLLoaderResolve("glCheckFramebufferStatusEXT"));
+    gll_glClientWaitSync = reinterpret_cast<GLLPROC_glClientWaitSync>(
+        GLLoaderResolve("glClientWaitSync"));
+    gll_glCompileShader = reinterpret_cast<GLLPROC_glCompileShader>(
+        GLLoaderResolve("glCompileShader"));
+    gll_glCreateProgram = reinterpret_cast<GLLPROC_glCreateProgram>(
+        GLLoaderResolve("glCreateProgram"));
+    gll_glCreateShader = reinterpret_cast<GLLPROC_glCreateShader>(
+        GLLoaderResolve("glCreateShader"));
+    gll_glDebugMessageCallback =
+        reinterpret_cast<GLLPROC_glDebugMessageCallback>(
+            GLLoaderResolve("glDebugMessageCallback"));
+    gll_glDebugMessageControl =
+        reinterpret_cast<GLLPROC_glDebugMessageControl>(
+            GLLoaderResolve("glDebugMessageControl"));
+    gll_glDeleteBuffers = reinterpret_cast<GLLPROC_glDeleteBuffers>(
+        GLLoaderResolve("glDeleteBuffers"));
+    gll_glDeleteFramebuffers = reinterpret_cast<GLLPROC_glDeleteFramebuffers>(
+        GLLoaderResolve("glDeleteFramebuffers"));
+    gll_glDeleteFramebuffersEXT =
+        reinterpret_cast<GLLPROC_glDeleteFramebuffersEXT>(
+            GLLoaderResolve("glDeleteFramebuffersEXT"));
+    gll_glDeleteProgram = reinterpret_cast<GLLPROC_glDeleteProgram>(
+        GLLoaderResolve("glDeleteProgram"));
+    gll_glDeleteQueries = reinterpret_cast<GLLPROC_glDeleteQueries>(
+        GLLoaderResolve("glDeleteQueries"));
+    gll_glDeleteRenderbuffers =
+        reinterpret_cast<GLLPROC_glDeleteRenderbuffers>(
+            GLLoaderResolve("glDeleteRenderbuffers"));
+    gll_glDeleteRenderbuffersEXT =
+        reinterpret_cast<GLLPROC_glDeleteRenderbuffersEXT>(
+            GLLoaderResolve("glDeleteRenderbuffersEXT"));
+    gll_glDeleteShader = reinterpret_cast<GLLPROC_glDeleteShader>(
+        GLLoaderResolve("glDeleteShader"));
+    gll_glDeleteSync = reinterpret_cast<GLLPROC_glDeleteSync>(
+        GLLoaderResolve("glDeleteSync"));
+    gll_glDeleteVertexArrays = reinterpret_cast<GLLPROC_glDeleteVertexArrays>(
+        GLLoaderResolve("glDeleteVertexArrays"));
+    gll_glDrawArraysInstanced =
+        reinterpret_cast<GLLPROC_glDrawArraysInstanced>(
+            GLLoaderResolve("glDrawArraysInstanced"));
+    gll_glDrawArraysInstancedARB =
+        reinterpret_cast<GLLPROC_glDrawArraysInstancedARB>(
+            GLLoaderResolve("glDrawArraysInstancedARB"));
+    gll_glEnableVertexAttribArray =
+        reinterpret_cast<GLLPROC_glEnableVertexAttribArray>(
+            GLLoaderResolve("glEnableVertexAttribArray"));
+    gll_glEndQuery = reinterpret_cast<GLLPROC_glEndQuery>(
+        GLLoaderResolve("glEndQuery"));
+    gll_glFenceSync = reinterpret_cast<GLLPROC_glFenceSync>(
+        GLLoaderResolve("glFenceSync"));
+    gll_glFramebufferRenderbuffer =
+        reinterpret_cast<GLLPROC_glFramebufferRenderbuffer>(
+            GLLoaderResolve("glFramebufferRenderbuffer"));
+    gll_glFramebufferRenderbufferEXT =
+        reinterpret_cast<GLLPROC_glFramebufferRenderbufferEXT>(
+            GLLoaderResolve("glFramebufferRenderbufferEXT"));
+    gll_glGenBuffers = reinterpret_cast<GLLPROC_glGenBuffers>(
+        GLLoaderResolve("glGenBuffers"));
+    gll_glGenFramebuffers = reinterpret_cast<GLLPROC_glGenFramebuffers>(
+        GLLoaderResolve("glGenFramebuffers"));
+    gll_glGenFramebuffersEXT = reinterpret_cast<GLLPROC_glGenFramebuffersEXT>(
+        GLLoaderResolve("glGenFramebuffersEXT"));
+    gll_glGenQueries = reinterpret_cast<GLLPROC_glGenQueries>(
+        GLLoaderResolve("glGenQueries"));
+    gll_glGenRenderbuffers = reinterpret_cast<GLLPROC_glGenRenderbuffers>(
+        GLLoaderResolve("glGenRenderbuffers"));
+    gll_glGenRenderbuffersEXT =
+        reinterpret_cast<GLLPROC_glGenRenderbuffersEXT>(
+            GLLoaderResolve("glGenRenderbuffersEXT"));
+    gll_glGenVertexArrays = reinterpret_cast<GLLPROC_glGenVertexArrays>(
+        GLLoaderResolve("glGenVertexArrays"));
+    gll_glGetBufferParameteriv =
+        reinterpret_cast<GLLPROC_glGetBufferParameteriv>(
+            GLLoaderResolve("glGetBufferParameteriv"));
+    gll_glGetBufferSubData = reinterpret_cast<GLLPROC_glGetBufferSubData>(
+        GLLoaderResolve("glGetBufferSubData"));
+    gll_glGetProgramBinary = reinterpret_cast<GLLPROC_glGetProgramBinary>(
+        GLLoaderResolve("glGetProgramBinary"));
+    gll_glGetProgramInfoLog = reinterpret_cast<GLLPROC_glGetProgramInfoLog>(
+        GLLoaderResolve("glGetProgramInfoLog"));
+    gll_glGetProgramiv = reinterpret_cast<GLLPROC_glGetProgramiv>(
+        GLLoaderResolve("glGetProgramiv"));
+    gll_glGetQueryObjectiv = reinterpret_cast<GLLPROC_glGetQueryObjectiv>(
+        GLLoaderResolve("glGetQueryObjectiv"));
+    gll_glGetQueryObjectui64v =
+        reinterpret_cast<GLLPROC_glGetQueryObjectui64v>(
+            GLLoaderResolve("glGetQueryObjectui64v"));
+    gll_glGetQueryObjectui64vEXT =
+        reinterpret_cast<GLLPROC_glGetQueryObjectui64vEXT>(
+            GLLoaderResolve("glGetQueryObjectui64vEXT"));
+    gll_glGetShaderInfoLog = reinterpret_cast<GLLPROC_glGetShaderInfoLog>(
+        GLLoaderResolve("glGetShaderInfoLog"));
+    gll_glGetShaderiv = reinterpret_cast<GLLPROC_glGetShaderiv>(
+        GLLoaderResolve("glGetShaderiv"));
+    gll_glGetUniformBlockIndex =
+        reinterpret_cast<GLLPROC_glGetUniformBlockIndex>(
+            GLLoaderResolve("glGetUniformBlockIndex"));
+    gll_glGetUniformLocation = reinterpret_cast<GLLPROC_glGetUniformLocation>(
+        GLLoaderResolve("glGetUniformLocation"));
+    gll_glLinkProgram = reinterpret_cast<GLLPROC_glLinkProgram>(
+        GLLoaderResolve("glLinkProgram"));
+    gll_glMapBuffer = reinterpret_cast<GLLPROC_glMapBuffer>(
+        GLLoaderResolve("glMapBuffer"));
+    gll_glMapBufferRange = reinterpret_cast<GLLPROC_glMapBufferRange>(
+        GLLoaderResolve("glMapBufferRange"));
+    gll_glMaxShaderCompilerThreadsARB =
+        reinterpret_cast<GLLPROC_glMaxShaderCompilerThreadsARB>(
+            GLLoaderResolve("glMaxShaderCompilerThreadsARB"));
+    gll_glMaxShaderCompilerThreadsKHR =
+        reinterpret_cast<GLLPROC_glMaxShaderCompilerThreadsKHR>(
+            GLLoaderResolve("glMaxShaderCompilerThreadsKHR"));
+    gll_glProgramBinary = reinterpret_cast<GLLPROC_glProgramBinary>(
+        GLLoaderResolve("glProgramBinary"));
+    gll_glProgramParameteri = reinterpret_cast<GLLPROC_glProgramParameteri>(
+        GLLoaderResolve("glProgramParameteri"));
+    gll_glQueryCounter = reinterpret_cast<GLLPROC_glQueryCounter>(
+        GLLoaderResolve("glQueryCounter"));
+    gll_glRenderbufferStorage =
+        reinterpret_cast<GLLPROC_glRenderbufferStorage>(
+            GLLoaderResolve("glRenderbufferStorage"));
+    gll_glRenderbufferStorageEXT =
+        reinterpret_cast<GLLPROC_glRenderbufferStorageEXT>(
+            GLLoaderResolve("glRenderbufferStorageEXT"));
+    gll_glShaderSource = reinterpret_cast<GLLPROC_glShaderSource>(
+        GLLoaderResolve("glShaderSource"));
+    gll_glTexBuffer = reinterpret_cast<GLLPROC_glTexBuffer>(
+        GLLoaderResolve("glTexBuffer"));
+    gll_glUniform1i = reinterpret_cast<GLLPROC_glUniform1i>(
+        GLLoaderResolve("glUniform1i"));
+    gll_glUniform4fv = reinterpret_cast<GLLPROC_glUniform4fv>(
+        GLLoaderResolve("glUniform4fv"));
+    gll_glUniformBlockBinding =
+        reinterpret_cast<GLLPROC_glUniformBlockBinding>(
+            GLLoaderResolve("glUniformBlockBinding"));
+    gll_glUnmapBuffer = reinterpret_cast<GLLPROC_glUnmapBuffer>(
+        GLLoaderResolve("glUnmapBuffer"));
+    gll_glUseProgram = reinterpret_cast<GLLPROC_glUseProgram>(
+        GLLoaderResolve("glUseProgram"));
+    gll_glVertexAttrib4f = reinterpret_cast<GLLPROC_glVertexAttrib4f>(
+        GLLoaderResolve("glVertexAttrib4f"));
+    gll_glVertexAttribDivisor =
+        reinterpret_cast<GLLPROC_glVertexAttribDivisor>(
+            GLLoaderResolve("glVertexAttribDivisor"));
+    gll_glVertexAttribDivisorARB =
+        reinterpret_cast<GLLPROC_glVertexAttribDivisorARB>(
+            GLLoaderResolve("glVertexAttribDivisorARB"));
+    gll_glVertexAttribPointer =
+        reinterpret_cast<GLLPROC_glVertexAttribPointer>(
+            GLLoaderResolve("glVertexAttribPointer"));
+}
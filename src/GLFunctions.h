@@ -0,0 +1,434 @@
+//============================================================================
+// Name        : GLFunctions.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : The OpenGL functions, versions and extensions we use.
+//
+//               Written by tools/GenerateGLFunctions.py, from our sources
+//               and glext.h, so don't edit it.  See GLLoader.h.
+//
+//============================================================================
+
+#ifndef GL_FUNCTIONS_H
+#define GL_FUNCTIONS_H
+
+// for GLLoader.cpp
+struct GLLoaderVersionFlag {
+    int major;
+    int minor;
+    bool *supported;
+};
+
+struct GLLoaderExtensionFlag {
+    const char *name;
+    bool *supported;
+};
+
+extern const GLLoaderVersionFlag GLLoaderVersions[];
+extern const int GLLoaderVersionCount;
+extern const GLLoaderExtensionFlag GLLoaderExtensions[];
+extern const int GLLoaderExtensionCount;
+extern const int GLLoaderFunctionCount;
+
+// look up every function now, rather than on its first call
+void GLLoaderResolveAll();
+
+// the versions we check for, set by GLLoaderInit()
+extern bool GLL_VERSION_2_1;
+extern bool GLL_VERSION_3_0;
+extern bool GLL_VERSION_3_1;
+extern bool GLL_VERSION_3_2;
+extern bool GLL_VERSION_3_3;
+extern bool GLL_VERSION_4_1;
+extern bool GLL_VERSION_4_3;
+
+// the extensions we check for
+extern bool GLL_ARB_draw_instanced;
+extern bool GLL_ARB_framebuffer_object;
+extern bool GLL_ARB_get_program_binary;
+extern bool GLL_ARB_half_float_vertex;
+extern bool GLL_ARB_instanced_arrays;
+extern bool GLL_ARB_map_buffer_range;
+extern bool GLL_ARB_parallel_shader_compile;
+extern bool GLL_ARB_pixel_buffer_object;
+extern bool GLL_ARB_sync;
+extern bool GLL_ARB_timer_query;
+extern bool GLL_EXT_framebuffer_object;
+extern bool GLL_EXT_timer_query;
+extern bool GLL_KHR_debug;
+extern bool GLL_KHR_parallel_shader_compile;
+
+// the functions we call
+typedef void (APIENTRYP GLLPROC_glActiveTexture)(GLenum texture);
+extern GLLPROC_glActiveTexture gll_glActiveTexture;
+#define glActiveTexture gll_glActiveTexture
+
+typedef void (APIENTRYP GLLPROC_glAttachShader)(GLuint program, GLuint shader);
+extern GLLPROC_glAttachShader gll_glAttachShader;
+#define glAttachShader gll_glAttachShader
+
+typedef void (APIENTRYP GLLPROC_glBeginQuery)(GLenum target, GLuint id);
+extern GLLPROC_glBeginQuery gll_glBeginQuery;
+#define glBeginQuery gll_glBeginQuery
+
+typedef void (APIENTRYP GLLPROC_glBindAttribLocation)(GLuint program,
+    GLuint index, const GLchar *name);
+extern GLLPROC_glBindAttribLocation gll_glBindAttribLocation;
+#define glBindAttribLocation gll_glBindAttribLocation
+
+typedef void (APIENTRYP GLLPROC_glBindBuffer)(GLenum target, GLuint buffer);
+extern GLLPROC_glBindBuffer gll_glBindBuffer;
+#define glBindBuffer gll_glBindBuffer
+
+typedef void (APIENTRYP GLLPROC_glBindBufferRange)(GLenum target, GLuint index,
+    GLuint buffer, GLintptr offset, GLsizeiptr size);
+extern GLLPROC_glBindBufferRange gll_glBindBufferRange;
+#define glBindBufferRange gll_glBindBufferRange
+
+typedef void (APIENTRYP GLLPROC_glBindFramebuffer)(GLenum target,
+    GLuint framebuffer);
+extern GLLPROC_glBindFramebuffer gll_glBindFramebuffer;
+#define glBindFramebuffer gll_glBindFramebuffer
+
+typedef void (APIENTRYP GLLPROC_glBindFramebufferEXT)(GLenum target,
+    GLuint framebuffer);
+extern GLLPROC_glBindFramebufferEXT gll_glBindFramebufferEXT;
+#define glBindFramebufferEXT gll_glBindFramebufferEXT
+
+typedef void (APIENTRYP GLLPROC_glBindRenderbuffer)(GLenum target,
+    GLuint renderbuffer);
+extern GLLPROC_glBindRenderbuffer gll_glBindRenderbuffer;
+#define glBindRenderbuffer gll_glBindRenderbuffer
+
+typedef void (APIENTRYP GLLPROC_glBindRenderbufferEXT)(GLenum target,
+    GLuint renderbuffer);
+extern GLLPROC_glBindRenderbufferEXT gll_glBindRenderbufferEXT;
+#define glBindRenderbufferEXT gll_glBindRenderbufferEXT
+
+typedef void (APIENTRYP GLLPROC_glBindVertexArray)(GLuint array);
+extern GLLPROC_glBindVertexArray gll_glBindVertexArray;
+#define glBindVertexArray gll_glBindVertexArray
+
+typedef void (APIENTRYP GLLPROC_glBlitFramebuffer)(GLint srcX0, GLint srcY0,
+    GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1,
+    GLint dstY1, GLbitfield mask, GLenum filter);
+extern GLLPROC_glBlitFramebuffer gll_glBlitFramebuffer;
+#define glBlitFramebuffer gll_glBlitFramebuffer
+
+typedef void (APIENTRYP GLLPROC_glBufferData)(GLenum target, GLsizeiptr size,
+    const void *data, GLenum usage);
+extern GLLPROC_glBufferData gll_glBufferData;
+#define glBufferData gll_glBufferData
+
+typedef void (APIENTRYP GLLPROC_glBufferSubData)(GLenum target,
+    GLintptr offset, GLsizeiptr size, const void *data);
+extern GLLPROC_glBufferSubData gll_glBufferSubData;
+#define glBufferSubData gll_glBufferSubData
+
+typedef GLenum (APIENTRYP GLLPROC_glCheckFramebufferStatus)(GLenum target);
+extern GLLPROC_glCheckFramebufferStatus gll_glCheckFramebufferStatus;
+#define glCheckFramebufferStatus gll_glCheckFramebufferStatus
+
+typedef GLenum (APIENTRYP GLLPROC_glCheckFramebufferStatusEXT)(GLenum target);
+extern GLLPROC_glCheckFramebufferStatusEXT gll_glCheckFramebufferStatusEXT;
+#define glCheckFramebufferStatusEXT gll_glCheckFramebufferStatusEXT
+
+typedef GLenum (APIENTRYP GLLPROC_glClientWaitSync)(GLsync sync,
+    GLbitfield flags, GLuint64 timeout);
+extern GLLPROC_glClientWaitSync gll_glClientWaitSync;
+#define glClientWaitSync gll_glClientWaitSync
+
+typedef void (APIENTRYP GLLPROC_glCompileShader)(GLuint shader);
+extern GLLPROC_glCompileShader gll_glCompileShader;
+#define glCompileShader gll_glCompileShader
+
+typedef GLuint (APIENTRYP GLLPROC_glCreateProgram)(void);
+extern GLLPROC_glCreateProgram gll_glCreateProgram;
+#define glCreateProgram gll_glCreateProgram
+
+typedef GLuint (APIENTRYP GLLPROC_glCreateShader)(GLenum type);
+extern GLLPROC_glCreateShader gll_glCreateShader;
+#define glCreateShader gll_glCreateShader
+
+typedef void (APIENTRYP GLLPROC_glDebugMessageCallback)(GLDEBUGPROC callback,
+    const void *userParam);
+extern GLLPROC_glDebugMessageCallback gll_glDebugMessageCallback;
+#define glDebugMessageCallback gll_glDebugMessageCallback
+
+typedef void (APIENTRYP GLLPROC_glDebugMessageControl)(GLenum source,
+    GLenum type, GLenum severity, GLsizei count, const GLuint *ids,
+    GLboolean enabled);
+extern GLLPROC_glDebugMessageControl gll_glDebugMessageControl;
+#define glDebugMessageControl gll_glDebugMessageControl
+
+typedef void (APIENTRYP GLLPROC_glDeleteBuffers)(GLsizei n,
+    const GLuint *buffers);
+extern GLLPROC_glDeleteBuffers gll_glDeleteBuffers;
+#define glDeleteBuffers gll_glDeleteBuffers
+
+typedef void (APIENTRYP GLLPROC_glDeleteFramebuffers)(GLsizei n,
+    const GLuint *framebuffers);
+extern GLLPROC_glDeleteFramebuffers gll_glDeleteFramebuffers;
+#define glDeleteFramebuffers gll_glDeleteFramebuffers
+
+typedef void (APIENTRYP GLLPROC_glDeleteFramebuffersEXT)(GLsizei n,
+    const GLuint *framebuffers);
+extern GLLPROC_glDeleteFramebuffersEXT gll_glDeleteFramebuffersEXT;
+#define glDeleteFramebuffersEXT gll_glDeleteFramebuffersEXT
+
+typedef void (APIENTRYP GLLPROC_glDeleteProgram)(GLuint program);
+extern GLLPROC_glDeleteProgram gll_glDeleteProgram;
+#define glDeleteProgram gll_glDeleteProgram
+
+typedef void (APIENTRYP GLLPROC_glDeleteQueries)(GLsizei n, const GLuint *ids);
+extern GLLPROC_glDeleteQueries gll_glDeleteQueries;
+#define glDeleteQueries gll_glDeleteQueries
+
+typedef void (APIENTRYP GLLPROC_glDeleteRenderbuffers)(GLsizei n,
+    const GLuint *renderbuffers);
+extern GLLPROC_glDeleteRenderbuffers gll_glDeleteRenderbuffers;
+#define glDeleteRenderbuffers gll_glDeleteRenderbuffers
+
+typedef void (APIENTRYP GLLPROC_glDeleteRenderbuffersEXT)(GLsizei n,
+    const GLuint *renderbuffers);
+extern GLLPROC_glDeleteRenderbuffersEXT gll_glDeleteRenderbuffersEXT;
+#define glDeleteRenderbuffersEXT gll_glDeleteRenderbuffersEXT
+
+typedef void (APIENTRYP GLLPROC_glDeleteShader)(GLuint shader);
+extern GLLPROC_glDeleteShader gll_glDeleteShader;
+#define glDeleteShader gll_glDeleteShader
+
+typedef void (APIENTRYP GLLPROC_glDeleteSync)(GLsync sync);
+extern GLLPROC_glDeleteSync gll_glDeleteSync;
+#define glDeleteSync gll_glDeleteSync
+
+typedef void (APIENTRYP GLLPROC_glDeleteVertexArrays)(GLsizei n,
+    const GLuint *arrays);
+extern GLLPROC_glDeleteVertexArrays gll_glDeleteVertexArrays;
+#define glDeleteVertexArrays gll_glDeleteVertexArrays
+
+typedef void (APIENTRYP GLLPROC_glDrawArraysInstanced)(GLenum mode,
+    GLint first, GLsizei count, GLsizei instancecount);
+extern GLLPROC_glDrawArraysInstanced gll_glDrawArraysInstanced;
+#define glDrawArraysInstanced gll_glDrawArraysInstanced
+
+typedef void (APIENTRYP GLLPROC_glDrawArraysInstancedARB)(GLenum mode,
+    GLint first, GLsizei count, GLsizei primcount);
+extern GLLPROC_glDrawArraysInstancedARB gll_glDrawArraysInstancedARB;
+#define glDrawArraysInstancedARB gll_glDrawArraysInstancedARB
+
+typedef void (APIENTRYP GLLPROC_glEnableVertexAttribArray)(GLuint index);
+extern GLLPROC_glEnableVertexAttribArray gll_glEnableVertexAttribArray;
+#define glEnableVertexAttribArray gll_glEnableVertexAttribArray
+
+typedef void (APIENTRYP GLLPROC_glEndQuery)(GLenum target);
+extern GLLPROC_glEndQuery gll_glEndQuery;
+#define glEndQuery gll_glEndQuery
+
+typedef GLsync (APIENTRYP GLLPROC_glFenceSync)(GLenum condition,
+    GLbitfield flags);
+extern GLLPROC_glFenceSync gll_glFenceSync;
+#define glFenceSync gll_glFenceSync
+
+typedef void (APIENTRYP GLLPROC_glFramebufferRenderbuffer)(GLenum target,
+    GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer);
+extern GLLPROC_glFramebufferRenderbuffer gll_glFramebufferRenderbuffer;
+#define glFramebufferRenderbuffer gll_glFramebufferRenderbuffer
+
+typedef void (APIENTRYP GLLPROC_glFramebufferRenderbufferEXT)(GLenum target,
+    GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer);
+extern GLLPROC_glFramebufferRenderbufferEXT gll_glFramebufferRenderbufferEXT;
+#define glFramebufferRenderbufferEXT gll_glFramebufferRenderbufferEXT
+
+typedef void (APIENTRYP GLLPROC_glGenBuffers)(GLsizei n, GLuint *buffers);
+extern GLLPROC_glGenBuffers gll_glGenBuffers;
+#define glGenBuffers gll_glGenBuffers
+
+typedef void (APIENTRYP GLLPROC_glGenFramebuffers)(GLsizei n,
+    GLuint *framebuffers);
+extern GLLPROC_glGenFramebuffers gll_glGenFramebuffers;
+#define glGenFramebuffers gll_glGenFramebuffers
+
+typedef void (APIENTRYP GLLPROC_glGenFramebuffersEXT)(GLsizei n,
+    GLuint *framebuffers);
+extern GLLPROC_glGenFramebuffersEXT gll_glGenFramebuffersEXT;
+#define glGenFramebuffersEXT gll_glGenFramebuffersEXT
+
+typedef void (APIENTRYP GLLPROC_glGenQueries)(GLsizei n, GLuint *ids);
+extern GLLPROC_glGenQueries gll_glGenQueries;
+#define glGenQueries gll_glGenQueries
+
+typedef void (APIENTRYP GLLPROC_glGenRenderbuffers)(GLsizei n,
+    GLuint *renderbuffers);
+extern GLLPROC_glGenRenderbuffers gll_glGenRenderbuffers;
+#define glGenRenderbuffers gll_glGenRenderbuffers
+
+typedef void (APIENTRYP GLLPROC_glGenRenderbuffersEXT)(GLsizei n,
+    GLuint *renderbuffers);
+extern GLLPROC_glGenRenderbuffersEXT gll_glGenRenderbuffersEXT;
+#define glGenRenderbuffersEXT gll_glGenRenderbuffersEXT
+
+typedef void (APIENTRYP GLLPROC_glGenVertexArrays)(GLsizei n, GLuint *arrays);
+extern GLLPROC_glGenVertexArrays gll_glGenVertexArrays;
+#define glGenVertexArrays gll_glGenVertexArrays
+
+typedef void (APIENTRYP GLLPROC_glGetBufferParameteriv)(GLenum target,
+    GLenum pname, GLint *params);
+extern GLLPROC_glGetBufferParameteriv gll_glGetBufferParameteriv;
+#define glGetBufferParameteriv gll_glGetBufferParameteriv
+
+typedef void (APIENTRYP GLLPROC_glGetBufferSubData)(GLenum target,
+    GLintptr offset, GLsizeiptr size, void *data);
+extern GLLPROC_glGetBufferSubData gll_glGetBufferSubData;
+#define glGetBufferSubData gll_glGetBufferSubData
+
+typedef void (APIENTRYP GLLPROC_glGetProgramBinary)(GLuint program,
+    GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+extern GLLPROC_glGetProgramBinary gll_glGetProgramBinary;
+#define glGetProgramBinary gll_glGetProgramBinary
+
+typedef void (APIENTRYP GLLPROC_glGetProgramInfoLog)(GLuint program,
+    GLsizei bufSize, GLsizei *length, GLchar *infoLog);
+extern GLLPROC_glGetProgramInfoLog gll_glGetProgramInfoLog;
+#define glGetProgramInfoLog gll_glGetProgramInfoLog
+
+typedef void (APIENTRYP GLLPROC_glGetProgramiv)(GLuint program, GLenum pname,
+    GLint *params);
+extern GLLPROC_glGetProgramiv gll_glGetProgramiv;
+#define glGetProgramiv gll_glGetProgramiv
+
+typedef void (APIENTRYP GLLPROC_glGetQueryObjectiv)(GLuint id, GLenum pname,
+    GLint *params);
+extern GLLPROC_glGetQueryObjectiv gll_glGetQueryObjectiv;
+#define glGetQueryObjectiv gll_glGetQueryObjectiv
+
+typedef void (APIENTRYP GLLPROC_glGetQueryObjectui64v)(GLuint id, GLenum pname,
+    GLuint64 *params);
+extern GLLPROC_glGetQueryObjectui64v gll_glGetQueryObjectui64v;
+#define glGetQueryObjectui64v gll_glGetQueryObjectui64v
+
+typedef void (APIENTRYP GLLPROC_glGetQueryObjectui64vEXT)(GLuint id,
+    GLenum pname, GLuint64 *params);
+extern GLLPROC_glGetQueryObjectui64vEXT gll_glGetQueryObjectui64vEXT;
+#define glGetQueryObjectui64vEXT gll_glGetQueryObjectui64vEXT
+
+typedef void (APIENTRYP GLLPROC_glGetShaderInfoLog)(GLuint shader,
+    GLsizei bufSize, GLsizei *length, GLchar *infoLog);
+extern GLLPROC_glGetShaderInfoLog gll_glGetShaderInfoLog;
+#define glGetShaderInfoLog gll_glGetShaderInfoLog
+
+typedef void (APIENTRYP GLLPROC_glGetShaderiv)(GLuint shader, GLenum pname,
+    GLint *params);
+extern GLLPROC_glGetShaderiv gll_glGetShaderiv;
+#define glGetShaderiv gll_glGetShaderiv
+
+typedef GLuint (APIENTRYP GLLPROC_glGetUniformBlockIndex)(GLuint program,
+    const GLchar *uniformBlockName);
+extern GLLPROC_glGetUniformBlockIndex gll_glGetUniformBlockIndex;
+#define glGetUniformBlockIndex gll_glGetUniformBlockIndex
+
+typedef GLint (APIENTRYP GLLPROC_glGetUniformLocation)(GLuint program,
+    const GLchar *name);
+extern GLLPROC_glGetUniformLocation gll_glGetUniformLocation;
+#define glGetUniformLocation gll_glGetUniformLocation
+
+typedef void (APIENTRYP GLLPROC_glLinkProgram)(GLuint program);
+extern GLLPROC_glLinkProgram gll_glLinkProgram;
+#define glLinkProgram gll_glLinkProgram
+
+typedef void * (APIENTRYP GLLPROC_glMapBuffer)(GLenum target, GLenum access);
+extern GLLPROC_glMapBuffer gll_glMapBuffer;
+#define glMapBuffer gll_glMapBuffer
+
+typedef void * (APIENTRYP GLLPROC_glMapBufferRange)(GLenum target,
+    GLintptr offset, GLsizeiptr length, GLbitfield access);
+extern GLLPROC_glMapBufferRange gll_glMapBufferRange;
+#define glMapBufferRange gll_glMapBufferRange
+
+typedef void (APIENTRYP GLLPROC_glMaxShaderCompilerThreadsARB)(GLuint count);
+extern GLLPROC_glMaxShaderCompilerThreadsARB gll_glMaxShaderCompilerThreadsARB;
+#define glMaxShaderCompilerThreadsARB gll_glMaxShaderCompilerThreadsARB
+
+typedef void (APIENTRYP GLLPROC_glMaxShaderCompilerThreadsKHR)(GLuint count);
+extern GLLPROC_glMaxShaderCompilerThreadsKHR gll_glMaxShaderCompilerThreadsKHR;
+#define glMaxShaderCompilerThreadsKHR gll_glMaxShaderCompilerThreadsKHR
+
+typedef void (APIENTRYP GLLPROC_glProgramBinary)(GLuint program,
+    GLenum binaryFormat, const void *binary, GLsizei length);
+extern GLLPROC_glProgramBinary gll_glProgramBinary;
+#define glProgramBinary gll_glProgramBinary
+
+typedef void (APIENTRYP GLLPROC_glProgramParameteri)(GLuint program,
+    GLenum pname, GLint value);
+extern GLLPROC_glProgramParameteri gll_glProgramParameteri;
+#define glProgramParameteri gll_glProgramParameteri
+
+typedef void (APIENTRYP GLLPROC_glQueryCounter)(GLuint id, GLenum target);
+extern GLLPROC_glQueryCounter gll_glQueryCounter;
+#define glQueryCounter gll_glQueryCounter
+
+typedef void (APIENTRYP GLLPROC_glRenderbufferStorage)(GLenum target,
+    GLenum internalformat, GLsizei width, GLsizei height);
+extern GLLPROC_glRenderbufferStorage gll_glRenderbufferStorage;
+#define glRenderbufferStorage gll_glRenderbufferStorage
+
+typedef void (APIENTRYP GLLPROC_glRenderbufferStorageEXT)(GLenum target,
+    GLenum internalformat, GLsizei width, GLsizei height);
+extern GLLPROC_glRenderbufferStorageEXT gll_glRenderbufferStorageEXT;
+#define glRenderbufferStorageEXT gll_glRenderbufferStorageEXT
+
+typedef void (APIENTRYP GLLPROC_glShaderSource)(GLuint shader, GLsizei count,
+    const GLchar *const*string, const GLint *length);
+extern GLLPROC_glShaderSource gll_glShaderSource;
+#define glShaderSource gll_glShaderSource
+
+typedef void (APIENTRYP GLLPROC_glTexBuffer)(GLenum target,
+    GLenum internalformat, GLuint buffer);
+extern GLLPROC_glTexBuffer gll_glTexBuffer;
+#define glTexBuffer gll_glTexBuffer
+
+typedef void (APIENTRYP GLLPROC_glUniform1i)(GLint location, GLint v0);
+extern GLLPROC_glUniform1i gll_glUniform1i;
+#define glUniform1i gll_glUniform1i
+
+typedef void (APIENTRYP GLLPROC_glUniform4fv)(GLint location, GLsizei count,
+    const GLfloat *value);
+extern GLLPROC_glUniform4fv gll_glUniform4fv;
+#define glUniform4fv gll_glUniform4fv
+
+typedef void (APIENTRYP GLLPROC_glUniformBlockBinding)(GLuint program,
+    GLuint uniformBlockIndex, GLuint uniformBlockBinding);
+extern GLLPROC_glUniformBlockBinding gll_glUniformBlockBinding;
+#define glUniformBlockBinding gll_glUniformBlockBinding
+
+typedef GLboolean (APIENTRYP GLLPROC_glUnmapBuffer)(GLenum target);
+extern GLLPROC_glUnmapBuffer gll_glUnmapBuffer;
+#define glUnmapBuffer gll_glUnmapBuffer
+
+typedef void (APIENTRYP GLLPROC_glUseProgram)(GLuint program);
+extern GLLPROC_glUseProgram gll_glUseProgram;
+#define glUseProgram gll_glUseProgram
+
+typedef void (APIENTRYP GLLPROC_glVertexAttrib4f)(GLuint index, GLfloat x,
+    GLfloat y, GLfloat z, GLfloat w);
+extern GLLPROC_glVertexAttrib4f gll_glVertexAttrib4f;
+#define glVertexAttrib4f gll_glVertexAttrib4f
+
+typedef void (APIENTRYP GLLPROC_glVertexAttribDivisor)(GLuint index,
+    GLuint divisor);
+extern GLLPROC_glVertexAttribDivisor gll_glVertexAttribDivisor;
+#define glVertexAttribDivisor gll_glVertexAttribDivisor
+
+typedef void (APIENTRYP GLLPROC_glVertexAttribDivisorARB)(GLuint index,
+    GLuint divisor);
+extern GLLPROC_glVertexAttribDivisorARB gll_glVertexAttribDivisorARB;
+#define glVertexAttribDivisorARB gll_glVertexAttribDivisorARB
+
+typedef void (APIENTRYP GLLPROC_glVertexAttribPointer)(GLuint index,
+    GLint size, GLenum type, GLboolean normalized, GLsizei stride,
+    const void *pointer);
+extern GLLPROC_glVertexAttribPointer gll_glVertexAttribPointer;
+#define glVertexAttribPointer gll_glVertexAttribPointer
+
+#endif // GL_FUNCTIONS_H
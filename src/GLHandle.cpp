@@ -0,0 +1,244 @@
+//============================================================================
+// Name        : GLHandle.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Creating and deleting the objects behind our GL handles,
+//               and the benchmark that shows what the handles cost.
+//
+//============================================================================
+
+#include <chrono>
+#include <iomanip>
+#include <utility>
+#include <vector>
+
+#include "GLHandle.h"
+#include "GLStateCache.h"
+
+GLuint GLProgramTraits::Create()
+{
+    return glCreateProgram();
+}
+
+void GLProgramTraits::Destroy(GLuint name)
+{
+    GLStateCache::Current().DeleteProgram(name);
+}
+
+void GLShaderTraits::Destroy(GLuint name)
+{
+    glDeleteShader(name);
+}
+
+GLuint GLBufferTraits::Create()
+{
+    GLuint name = 0;
+    glGenBuffers(1, &name);
+    return name;
+}
+
+void GLBufferTraits::Destroy(GLuint name)
+{
+    GLStateCache::Current().DeleteBuffer(name);
+}
+
+GLuint GLVertexArrayTraits::Create()
+{
+    GLuint name = 0;
+    glGenVertexArrays(1, &name);
+    return name;
+}
+
+void GLVertexArrayTraits::Destroy(GLuint name)
+{
+    GLStateCache::Current().DeleteVertexArray(name);
+}
+
+GLuint GLTextureTraits::Create()
+{
+    GLuint name = 0;
+    glGenTextures(1, &name);
+    return name;
+}
+
+void GLTextureTraits::Destroy(GLuint name)
+{
+    glDeleteTextures(1, &name);
+}
+
+GLuint GLQueryTraits::Create()
+{
+    GLuint name = 0;
+    glGenQueries(1, &name);
+    return name;
+}
+
+void GLQueryTraits::Destroy(GLuint name)
+{
+    glDeleteQueries(1, &name);
+}
+
+// the core (or ARB) framebuffer objects, rather than the EXT ones
+static bool CoreFramebuffers()
+{
+    return GLL_VERSION_3_0 || GLL_ARB_framebuffer_object;
+}
+
+GLuint GLFramebufferTraits::Create()
+{
+    GLuint name = 0;
+    if (CoreFramebuffers())
+        glGenFramebuffers(1, &name);
+    else
+        glGenFramebuffersEXT(1, &name);
+    return name;
+}
+
+void GLFramebufferTraits::Destroy(GLuint name)
+{
+    if (CoreFramebuffers())
+        glDeleteFramebuffers(1, &name);
+    else
+        glDeleteFramebuffersEXT(1, &name);
+}
+
+GLuint GLRenderbufferTraits::Create()
+{
+    GLuint name = 0;
+    if (CoreFramebuffers())
+        glGenRenderbuffers(1, &name);
+    else
+        glGenRenderbuffersEXT(1, &name);
+    return name;
+}
+
+void GLRenderbufferTraits::Destroy(GLuint name)
+{
+    if (CoreFramebuffers())
+        glDeleteRenderbuffers(1, &name);
+    else
+        glDeleteRenderbuffersEXT(1, &name);
+}
+
+// the fastest of a few runs, in nanoseconds per operation
+template <typename Function>
+static double BestOf(int runs, long long operations, Function function)
+{
+    typedef std::chrono::steady_clock Clock;
+    double best = 0.0;
+
+    for (int run = 0; run < runs; run++) {
+        Clock::time_point start = Clock::now();
+        function();
+        std::chrono::duration<double, std::nano> elapsed =
+            Clock::now() - start;
+
+        double perOperation = elapsed.count() / operations;
+        if (run == 0 || perOperation < best)
+            best = perOperation;
+    }
+
+    return best;
+}
+
+static void ReportRow(std::ostream &out, const char *name, double bareNs,
+                      double handleNs)
+{
+    out << "    " << std::left << std::setw(16) << name << std::right
+        << std::setw(10) << bareNs << std::setw(10) << handleNs
+        << std::setw(10) << handleNs / bareNs << std::endl;
+}
+
+void GLHandleBenchmark(std::ostream &out)
+{
+    const int runs = 5;
+    const int objects = 10000;
+    const long long binds = 1000000;
+
+    GLStateCache &state = GLStateCache::Current();
+
+    out << "GL handles: " << sizeof(GLuint) << " byte names, handles of "
+        << sizeof(GLProgram) << "/" << sizeof(GLShader) << "/"
+        << sizeof(GLBuffer) << "/" << sizeof(GLVertexArray)
+        << " bytes (program/shader/buffer/vertex array), best of " << runs
+        << " runs" << std::endl
+        << "    operation       bare ns  handle ns     ratio" << std::endl
+        << std::fixed << std::setprecision(2);
+
+    // Create and delete buffers one at a time, the way a scene's objects
+    // come and go
+    double bareCreate = BestOf(runs, objects, [&]() {
+        for (int i = 0; i < objects; i++) {
+            GLuint buffer = 0;
+            glGenBuffers(1, &buffer);
+            state.DeleteBuffer(buffer);
+        }
+    });
+
+    double handleCreate = BestOf(runs, objects, [&]() {
+        for (int i = 0; i < objects; i++) {
+            GLBuffer buffer = GLBuffer::Create();
+        }
+    });
+
+    ReportRow(out, "create/delete", bareCreate, handleCreate);
+
+    // Bind two buffers in turn, so the state cache passes every bind on
+    GLuint bareBuffers[2] = {GLBufferTraits::Create(),
+                             GLBufferTraits::Create()};
+    GLBuffer handleBuffers[2] = {GLBuffer::Create(), GLBuffer::Create()};
+
+    double bareBind = BestOf(runs, binds, [&]() {
+        for (long long i = 0; i < binds; i++)
+            state.BindBuffer(GL_ARRAY_BUFFER, bareBuffers[i & 1]);
+    });
+
+    double handleBind = BestOf(runs, binds, [&]() {
+        for (long long i = 0; i < binds; i++)
+            state.BindBuffer(GL_ARRAY_BUFFER, handleBuffers[i & 1].Get());
+    });
+
+    ReportRow(out, "bind", bareBind, handleBind);
+
+    state.BindBuffer(GL_ARRAY_BUFFER, 0);
+    state.DeleteBuffer(bareBuffers[0]);
+    state.DeleteBuffer(bareBuffers[1]);
+    handleBuffers[0].Reset();
+    handleBuffers[1].Reset();
+
+    // Grow a vector of objects one at a time, without reserving, so it
+    // copies (or moves) everything over every time it reallocates, and
+    // then hand them all back
+    std::vector<GLuint> barePool(objects);
+    std::vector<GLBuffer> handlePool(objects);
+    for (int i = 0; i < objects; i++) {
+        barePool[i] = GLBufferTraits::Create();
+        handlePool[i] = GLBuffer::Create();
+    }
+
+    double bareGrow = BestOf(runs, objects, [&]() {
+        std::vector<GLuint> grown;
+        for (int i = 0; i < objects; i++)
+            grown.push_back(barePool[i]);
+        for (int i = 0; i < objects; i++)
+            barePool[i] = grown[i];
+    });
+
+    double handleGrow = BestOf(runs, objects, [&]() {
+        std::vector<GLBuffer> grown;
+        for (int i = 0; i < objects; i++)
+            grown.push_back(std::move(handlePool[i]));
+        for (int i = 0; i < objects; i++)
+            handlePool[i] = std::move(grown[i]);
+    });
+
+    ReportRow(out, "vector growth", bareGrow, handleGrow);
+
+    for (int i = 0; i < objects; i++)
+        state.DeleteBuffer(barePool[i]);
+    handlePool.clear();
+
+    out.unsetf(std::ios_base::floatfield);
+    out << std::setprecision(6);
+}
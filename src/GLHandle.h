@@ -0,0 +1,191 @@
+//============================================================================
+// Name        : GLHandle.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Owning handles for OpenGL objects, that delete the object
+//               when they go away.
+//
+//               OpenGL hands us a bare GLuint name for every program,
+//               shader, buffer, vertex array, query and framebuffer, and
+//               it is up to us to remember to delete it, once, and with the
+//               right call.  The demos used to do that by hand, at the end
+//               of main(), and HelloTriangle forgot its shader program
+//               altogether.
+//
+//               A GLHandle holds one name and nothing else, so it is the
+//               same size as the GLuint, and Get() is the same load.  It
+//               can be moved, which hands the object over and leaves the
+//               old handle empty, but it can't be copied, since two
+//               handles would delete the same object twice.  So a handle
+//               can go into a std::vector, or be returned from a function,
+//               and the object is still deleted exactly once.
+//
+//               Programs, vertex arrays and buffers are deleted through
+//               the state cache, which has to know when a bound object
+//               goes away.  Framebuffers and renderbuffers use the EXT
+//               entry points on a driver that only has those, the same
+//               way the HeadlessContext decides.
+//
+//               Note: a handle has to be emptied (Reset()) while its
+//                     context is still current.  Anything left after the
+//                     context is destroyed is deleted into thin air.
+//
+//               GLHandleBenchmark() times creating, deleting, binding and
+//               moving objects through the handles against the bare names
+//               doing the same thing.
+//
+//============================================================================
+
+#ifndef GL_HANDLE_H
+#define GL_HANDLE_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <ostream>
+#include <type_traits>
+
+// How each kind of object is created and deleted
+struct GLProgramTraits {
+    static GLuint Create();
+    static void Destroy(GLuint name);
+};
+
+// Note: there is no Create(), a shader needs its type, so use
+//       GLShader(glCreateShader(type))
+struct GLShaderTraits {
+    static void Destroy(GLuint name);
+};
+
+struct GLBufferTraits {
+    static GLuint Create();
+    static void Destroy(GLuint name);
+};
+
+struct GLVertexArrayTraits {
+    static GLuint Create();
+    static void Destroy(GLuint name);
+};
+
+// Note: the state cache doesn't track textures, so they are deleted
+//       directly
+struct GLTextureTraits {
+    static GLuint Create();
+    static void Destroy(GLuint name);
+};
+
+// Note: queries have no state cache either
+struct GLQueryTraits {
+    static GLuint Create();
+    static void Destroy(GLuint name);
+};
+
+struct GLFramebufferTraits {
+    static GLuint Create();
+    static void Destroy(GLuint name);
+};
+
+struct GLRenderbufferTraits {
+    static GLuint Create();
+    static void Destroy(GLuint name);
+};
+
+template <typename Traits>
+class GLHandle {
+public:
+    GLHandle() : name(0) {}
+
+    // take ownership of an object that was created elsewhere
+    explicit GLHandle(GLuint name) : name(name) {}
+
+    GLHandle(GLHandle &&other) noexcept
+        : name(other.name)
+    {
+        other.name = 0;
+    }
+
+    GLHandle &operator=(GLHandle &&other) noexcept
+    {
+        if (this != &other) {
+            Reset(other.name);
+            other.name = 0;
+        }
+        return *this;
+    }
+
+    ~GLHandle() { Reset(); }
+
+    // a new object
+    static GLHandle Create() { return GLHandle(Traits::Create()); }
+
+    GLuint Get() const { return name; }
+    explicit operator bool() const { return name != 0; }
+
+    // give up ownership, without deleting the object
+    GLuint Release()
+    {
+        GLuint released = name;
+        name = 0;
+        return released;
+    }
+
+    // delete the object we hold, if any, and hold replacement instead
+    void Reset(GLuint replacement = 0)
+    {
+        if (name != 0 && name != replacement)
+            Traits::Destroy(name);
+        name = replacement;
+    }
+
+private:
+    GLHandle(const GLHandle &);
+    GLHandle &operator=(const GLHandle &);
+
+    GLuint name;
+};
+
+typedef GLHandle<GLProgramTraits> GLProgram;
+typedef GLHandle<GLShaderTraits> GLShader;
+typedef GLHandle<GLBufferTraits> GLBuffer;
+typedef GLHandle<GLVertexArrayTraits> GLVertexArray;
+typedef GLHandle<GLTextureTraits> GLTexture;
+typedef GLHandle<GLQueryTraits> GLQuery;
+typedef GLHandle<GLFramebufferTraits> GLFramebuffer;
+typedef GLHandle<GLRenderbufferTraits> GLRenderbuffer;
+
+// The handles cost no extra bytes over the bare names, and their moves
+// can't throw, so a std::vector that grows moves them rather than copying.
+// Note: it still moves them one at a time, and then runs each old handle's
+//       destructor, where a vector of GLuints just memmove()s them, so
+//       growing one is several times slower (--handle-benchmark's "vector
+//       growth").  It is a few nanoseconds a handle; reserve() a vector of
+//       them that grows in a hot loop.
+static_assert(sizeof(GLProgram) == sizeof(GLuint),
+              "GLProgram should be the size of a GLuint");
+static_assert(sizeof(GLShader) == sizeof(GLuint),
+              "GLShader should be the size of a GLuint");
+static_assert(sizeof(GLBuffer) == sizeof(GLuint),
+              "GLBuffer should be the size of a GLuint");
+static_assert(sizeof(GLVertexArray) == sizeof(GLuint),
+              "GLVertexArray should be the size of a GLuint");
+static_assert(sizeof(GLTexture) == sizeof(GLuint),
+              "GLTexture should be the size of a GLuint");
+static_assert(sizeof(GLQuery) == sizeof(GLuint),
+              "GLQuery should be the size of a GLuint");
+static_assert(sizeof(GLFramebuffer) == sizeof(GLuint),
+              "GLFramebuffer should be the size of a GLuint");
+static_assert(sizeof(GLRenderbuffer) == sizeof(GLuint),
+              "GLRenderbuffer should be the size of a GLuint");
+static_assert(std::is_nothrow_move_constructible<GLBuffer>::value &&
+              std::is_nothrow_move_assignable<GLBuffer>::value,
+              "GLBuffer should move without throwing");
+static_assert(!std::is_copy_constructible<GLBuffer>::value &&
+              !std::is_copy_assignable<GLBuffer>::value,
+              "GLBuffer should not be copyable");
+
+// Time creating and deleting, binding, and moving buffers around in a
+// std::vector, with handles and with bare names.  Needs a current context.
+void GLHandleBenchmark(std::ostream &out);
+
+#endif // GL_HANDLE_H
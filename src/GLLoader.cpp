@@ -0,0 +1,161 @@
+//============================================================================
+// Name        : GLLoader.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Loads the OpenGL functions we call, and nothing else.
+//
+//============================================================================
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+
+#include "DebugLog.h"
+#include "GLLoader.h"
+
+static GLLoaderProc procAddress = nullptr;
+static bool lazyLoading = false;
+
+static std::atomic<int> resolved(0);
+static std::atomic<int> missing(0);
+static std::atomic<long long> resolveNs(0);
+static double initMs = 0.0;
+
+// Note: "OpenGL ES 3.2 Mesa" as well as "4.5 (Compatibility Profile) Mesa"
+static bool ParseVersion(const char *version, int &major, int &minor)
+{
+    while (*version != '\0' && (*version < '0' || *version > '9'))
+        version++;
+
+    return std::sscanf(version, "%d.%d", &major, &minor) == 2;
+}
+
+// set the flag of one of the extensions we check for, if it is that
+static void FindExtension(const char *name, size_t length)
+{
+    for (int i = 0; i < GLLoaderExtensionCount; i++) {
+        const char *wanted = GLLoaderExtensions[i].name;
+        if (std::strncmp(wanted, name, length) == 0 &&
+                wanted[length] == '\0') {
+            *GLLoaderExtensions[i].supported = true;
+            return;
+        }
+    }
+}
+
+static void FindExtensions(int major)
+{
+    // Note: a core profile only has them one at a time.  Looking this up
+    //       is part of GLLoaderInit(), not one of the functions we call.
+    if (major >= 3) {
+        PFNGLGETSTRINGIPROC getStringi =
+            reinterpret_cast<PFNGLGETSTRINGIPROC>(
+                procAddress("glGetStringi"));
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+        for (GLint i = 0; getStringi != nullptr && i < count; i++) {
+            const char *name = reinterpret_cast<const char *>(
+                getStringi(GL_EXTENSIONS, i));
+            if (name != nullptr)
+                FindExtension(name, std::strlen(name));
+        }
+        return;
+    }
+
+    const char *names = reinterpret_cast<const char *>(
+        glGetString(GL_EXTENSIONS));
+
+    while (names != nullptr && *names != '\0') {
+        const char *end = std::strchr(names, ' ');
+        if (end == nullptr)
+            end = names + std::strlen(names);
+
+        if (end > names)
+            FindExtension(names, end - names);
+
+        names = *end == ' ' ? end + 1 : end;
+    }
+}
+
+bool GLLoaderInit(GLLoaderProc getProcAddress, bool lazy)
+{
+    std::chrono::steady_clock::time_point begin =
+        std::chrono::steady_clock::now();
+
+    procAddress = getProcAddress;
+    lazyLoading = lazy;
+
+    // Note: glGetString() is 1.0, so it is always there, but without a
+    //       current context it returns nothing
+    const char *version = reinterpret_cast<const char *>(
+        glGetString(GL_VERSION));
+    int major = 0;
+    int minor = 0;
+
+    if (version == nullptr || !ParseVersion(version, major, minor)) {
+        Log("Can't load OpenGL functions without a current context");
+        return false;
+    }
+
+    for (int i = 0; i < GLLoaderVersionCount; i++) {
+        const GLLoaderVersionFlag &flag = GLLoaderVersions[i];
+        *flag.supported = major > flag.major ||
+                          (major == flag.major && minor >= flag.minor);
+    }
+
+    FindExtensions(major);
+
+    if (!lazy)
+        GLLoaderResolveAll();
+
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - begin;
+    initMs = elapsed.count();
+
+    return true;
+}
+
+GLLoaderFunction GLLoaderResolve(const char *name)
+{
+    std::chrono::steady_clock::time_point begin =
+        std::chrono::steady_clock::now();
+
+    GLLoaderFunction function = procAddress != nullptr ?
+                                procAddress(name) : nullptr;
+
+    resolveNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+
+    if (function != nullptr) {
+        resolved++;
+    }
+    else {
+        // Note: only fatal if it is called, and we check the flags first
+        missing++;
+    }
+
+    return function;
+}
+
+void GLLoaderReport(std::ostream &out)
+{
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    out << std::fixed << std::setprecision(3);
+    out << "GL loader (" << (lazyLoading ? "lazy" : "batch") << "): "
+        << resolved << " of " << GLLoaderFunctionCount
+        << " functions looked up";
+    if (missing > 0)
+        out << ", " << missing << " missing";
+    out << ", in " << resolveNs / 1000000.0 << " ms; "
+        << "GLLoaderInit() took " << initMs << " ms"
+        << std::endl;
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,58 @@
+//============================================================================
+// Name        : GLLoader.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Loads the OpenGL functions we call, and nothing else.
+//
+//               glewInit() looked up every function in every extension
+//               it knows about, a few thousand of them, and made as many
+//               trips through the driver's lookup, before we could draw
+//               anything.  We call about seventy.  The script in
+//               tools/GenerateGLFunctions.py finds out which, from our
+//               sources, and writes GLFunctions.h and GLFunctions.cpp: a
+//               pointer for each one, a macro that sends the call through
+//               it, and a flag for each version and extension we check for.
+//
+//               GLLoaderInit() reads the version, and the extensions, in
+//               one go.  The functions it can look up all at once (batch),
+//               or leave to the first call of each (lazy): every pointer
+//               starts out at a stub that looks its function up, keeps it,
+//               and passes the call on.
+//
+//               OpenGL 1.1 and older is linked against directly, like it
+//               always was.
+//
+//               Note: lazy lookups can happen on any thread with a current
+//                     context, like the shader reloader's.  Two of them at
+//                     once both store the same pointer, which is harmless
+//                     on anything we run on, but batch is the default.
+//
+//============================================================================
+
+#ifndef GL_LOADER_H
+#define GL_LOADER_H
+
+#include <ostream>
+
+// Note: without GL_GLEXT_PROTOTYPES, glext.h only has the types and the
+//       enums, which is all we want from it
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+// what eglGetProcAddress() and glfwGetProcAddress() return, and take
+typedef void (*GLLoaderFunction)();
+typedef GLLoaderFunction (*GLLoaderProc)(const char *name);
+
+// Needs a current context.  Returns false if there isn't one.
+bool GLLoaderInit(GLLoaderProc getProcAddress, bool lazy);
+
+// Look up one function, for the generated code, and count it
+GLLoaderFunction GLLoaderResolve(const char *name);
+
+// how many functions were looked up, and how long that took
+void GLLoaderReport(std::ostream &out);
+
+#include "GLFunctions.h"
+
+#endif // GL_LOADER_H
@@ -0,0 +1,221 @@
+//============================================================================
+// Name        : GLStateCache.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Remembers the OpenGL state that we last set, so that we
+//               can skip calls that wouldn't change anything.
+//
+//============================================================================
+
+#include <iomanip>
+
+#include "GLStateCache.h"
+
+static const char *CallNames[GLStateCache::CallCount] = {
+    "glClearColor", "glUseProgram", "glBindVertexArray", "glBindBuffer"
+};
+
+static thread_local GLStateCache *currentCache = nullptr;
+
+GLStateCache::GLStateCache()
+    : enabled(true),
+      frames(0)
+{
+    for (int c = 0; c < CallCount; c++) {
+        submitted[c] = elided[c] = 0;
+        totalSubmitted[c] = totalElided[c] = 0;
+    }
+
+    Invalidate();
+}
+
+GLStateCache &GLStateCache::Current()
+{
+    if (currentCache == nullptr) {
+        static thread_local GLStateCache defaultCache;
+        currentCache = &defaultCache;
+    }
+
+    return *currentCache;
+}
+
+void GLStateCache::SetCurrent(GLStateCache *cache)
+{
+    currentCache = cache;
+}
+
+void GLStateCache::SetEnabled(bool value)
+{
+    enabled = value;
+    Invalidate();
+}
+
+bool GLStateCache::Changed(Call call, bool same)
+{
+    if (enabled && same) {
+        elided[call]++;
+        return false;
+    }
+
+    submitted[call]++;
+    return true;
+}
+
+void GLStateCache::ClearColor(GLfloat red, GLfloat green, GLfloat blue,
+                              GLfloat alpha)
+{
+    bool same = clearColorKnown &&
+                clearColor[0] == red && clearColor[1] == green &&
+                clearColor[2] == blue && clearColor[3] == alpha;
+
+    if (Changed(CallClearColor, same)) {
+        glClearColor(red, green, blue, alpha);
+
+        clearColor[0] = red;
+        clearColor[1] = green;
+        clearColor[2] = blue;
+        clearColor[3] = alpha;
+        clearColorKnown = true;
+    }
+}
+
+void GLStateCache::UseProgram(GLuint value)
+{
+    if (Changed(CallUseProgram, program == value)) {
+        glUseProgram(value);
+        program = value;
+    }
+}
+
+void GLStateCache::BindVertexArray(GLuint value)
+{
+    if (Changed(CallBindVertexArray, vertexArray == value)) {
+        glBindVertexArray(value);
+        vertexArray = value;
+
+        // the element buffer binding is part of the vertex array
+        elementBuffer = Unknown;
+    }
+}
+
+void GLStateCache::BindBuffer(GLenum target, GLuint buffer)
+{
+    GLuint *binding = nullptr;
+
+    if (target == GL_ARRAY_BUFFER)
+        binding = &arrayBuffer;
+    else if (target == GL_ELEMENT_ARRAY_BUFFER)
+        binding = &elementBuffer;
+
+    if (binding == nullptr) {
+        submitted[CallBindBuffer]++;
+        glBindBuffer(target, buffer);
+    }
+    else if (Changed(CallBindBuffer, *binding == buffer)) {
+        glBindBuffer(target, buffer);
+        *binding = buffer;
+    }
+}
+
+void GLStateCache::DeleteProgram(GLuint value)
+{
+    // Note: a program that is in use is only flagged for deletion, and it
+    //       stays current, so there is nothing to forget here.
+    glDeleteProgram(value);
+}
+
+void GLStateCache::DeleteVertexArray(GLuint value)
+{
+    if (value != 0 && vertexArray == value) {
+        vertexArray = 0;
+        elementBuffer = Unknown;
+    }
+
+    glDeleteVertexArrays(1, &value);
+}
+
+void GLStateCache::DeleteBuffer(GLuint buffer)
+{
+    if (buffer != 0 && arrayBuffer == buffer)
+        arrayBuffer = 0;
+    if (buffer != 0 && elementBuffer == buffer)
+        elementBuffer = 0;
+
+    glDeleteBuffers(1, &buffer);
+}
+
+void GLStateCache::Invalidate()
+{
+    clearColorKnown = false;
+    for (int i = 0; i < 4; i++)
+        clearColor[i] = 0.0f;
+
+    program = Unknown;
+    vertexArray = Unknown;
+    arrayBuffer = Unknown;
+    elementBuffer = Unknown;
+}
+
+void GLStateCache::EndFrame()
+{
+    for (int c = 0; c < CallCount; c++) {
+        totalSubmitted[c] += submitted[c];
+        totalElided[c] += elided[c];
+        submitted[c] = elided[c] = 0;
+    }
+
+    frames++;
+}
+
+long long GLStateCache::SubmittedThisFrame() const
+{
+    long long total = 0;
+    for (int c = 0; c < CallCount; c++)
+        total += submitted[c];
+    return total;
+}
+
+long long GLStateCache::ElidedThisFrame() const
+{
+    long long total = 0;
+    for (int c = 0; c < CallCount; c++)
+        total += elided[c];
+    return total;
+}
+
+void GLStateCache::Report(std::ostream &out) const
+{
+    if (frames == 0)
+        return;
+
+    out << std::fixed << std::setprecision(2)
+        << "GL state calls per frame over " << frames << " frames"
+        << (enabled ? "" : " (cache disabled)") << std::endl
+        << "    call                submitted    elided" << std::endl;
+
+    long long allSubmitted = 0;
+    long long allElided = 0;
+
+    for (int c = 0; c < CallCount; c++) {
+        out << "    " << std::left << std::setw(18) << CallNames[c]
+            << std::right
+            << std::setw(11) << static_cast<double>(totalSubmitted[c]) / frames
+            << std::setw(10) << static_cast<double>(totalElided[c]) / frames
+            << std::endl;
+
+        allSubmitted += totalSubmitted[c];
+        allElided += totalElided[c];
+    }
+
+    long long all = allSubmitted + allElided;
+    double saved = (all > 0) ? 100.0 * allElided / all : 0.0;
+
+    out << "    " << std::left << std::setw(18) << "total" << std::right
+        << std::setw(11) << static_cast<double>(allSubmitted) / frames
+        << std::setw(10) << static_cast<double>(allElided) / frames
+        << "   (" << saved << "% of the calls avoided)" << std::endl;
+
+    out.unsetf(std::ios_base::floatfield);
+    out << std::setprecision(6);
+}
@@ -0,0 +1,109 @@
+//============================================================================
+// Name        : GLStateCache.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Remembers the OpenGL state that we last set, so that we
+//               can skip calls that wouldn't change anything.
+//
+//               Every frame, the render loop sets the clear color, the
+//               program and the vertex array, even though they are almost
+//               always the same as last frame.  Each of those calls costs
+//               CPU time in the driver, whether it changes anything or not.
+//               So all our binds and uses go through here instead, and we
+//               only pass the ones that change something on to OpenGL.
+//
+//               We count the calls that were passed on (submitted) and the
+//               ones we skipped (elided), per frame, so we can see how much
+//               driver overhead we saved.
+//
+//               The cache only knows about the changes made through it.
+//               Anything that changes the state behind its back (e.g.
+//               setting up buffers with glBindBuffer() directly) needs to
+//               be followed by Invalidate().
+//
+//               OpenGL state belongs to a context, and a context is current
+//               on one thread, so each thread has its own current cache.
+//
+//============================================================================
+
+#ifndef GL_STATE_CACHE_H
+#define GL_STATE_CACHE_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <ostream>
+
+class GLStateCache {
+public:
+    enum Call {
+        CallClearColor = 0,
+        CallUseProgram,
+        CallBindVertexArray,
+        CallBindBuffer,
+        CallCount
+    };
+
+    GLStateCache();
+
+    // The cache for the context that is current on this thread.
+    // If SetCurrent() was never called, each thread gets a default one.
+    static GLStateCache &Current();
+    static void SetCurrent(GLStateCache *cache);
+
+    // A disabled cache passes every call straight through, which is only
+    // useful for measuring what the cache saves.
+    void SetEnabled(bool enabled);
+
+    void ClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vertexArray);
+
+    // GL_ARRAY_BUFFER, or GL_ELEMENT_ARRAY_BUFFER (which belongs to the
+    // bound vertex array).  Other targets are passed straight through.
+    void BindBuffer(GLenum target, GLuint buffer);
+
+    // Deleting a bound object unbinds it, so the cache has to know
+    void DeleteProgram(GLuint program);
+    void DeleteVertexArray(GLuint vertexArray);
+    void DeleteBuffer(GLuint buffer);
+
+    // forget everything we know, after someone else changed the state
+    void Invalidate();
+
+    // roll this frame's counts into the totals
+    void EndFrame();
+
+    long long SubmittedThisFrame() const;
+    long long ElidedThisFrame() const;
+
+    void Report(std::ostream &out) const;
+
+private:
+    GLStateCache(const GLStateCache &);
+    GLStateCache &operator=(const GLStateCache &);
+
+    // we can't know what was bound before we started, or after someone
+    // went around us, so the first call always goes through
+    static const GLuint Unknown = 0xFFFFFFFF;
+
+    // count the call, and return true if it needs to go to OpenGL
+    bool Changed(Call call, bool same);
+
+    bool enabled;
+    bool clearColorKnown;
+    GLfloat clearColor[4];
+    GLuint program;
+    GLuint vertexArray;
+    GLuint arrayBuffer;
+    GLuint elementBuffer;
+
+    long long submitted[CallCount];
+    long long elided[CallCount];
+    long long totalSubmitted[CallCount];
+    long long totalElided[CallCount];
+    long long frames;
+};
+
+#endif // GL_STATE_CACHE_H
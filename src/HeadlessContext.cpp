@@ -0,0 +1,325 @@
+//============================================================================
+// Name        : HeadlessContext.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : EGL surfaceless context plus an offscreen framebuffer.
+//
+//============================================================================
+
+#include <cstring>
+
+#include "DebugLog.h"
+#include "HeadlessContext.h"
+
+#include <EGL/eglext.h>
+
+// A debug build asks for a debug context, so that GL_KHR_debug has more
+// to say, if EGL can give us one
+static EGLContext CreateContext(EGLDisplay display, EGLConfig config,
+                                EGLContext shared)
+{
+#ifndef NDEBUG
+    const char *extensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (extensions != nullptr &&
+            std::strstr(extensions, "EGL_KHR_create_context")) {
+        const EGLint debugAttribs[] = {
+            EGL_CONTEXT_FLAGS_KHR, EGL_CONTEXT_OPENGL_DEBUG_BIT_KHR,
+            EGL_NONE
+        };
+
+        EGLContext context = eglCreateContext(display, config, shared,
+                                              debugAttribs);
+        if (context != EGL_NO_CONTEXT)
+            return context;
+    }
+#endif
+
+    return eglCreateContext(display, config, shared, nullptr);
+}
+
+HeadlessContext::HeadlessContext()
+    : display(EGL_NO_DISPLAY),
+      config(nullptr),
+      context(EGL_NO_CONTEXT),
+      ownsDisplay(false),
+      useExtFramebuffer(false),
+      width(0),
+      height(0)
+{
+}
+
+HeadlessContext::~HeadlessContext()
+{
+    Destroy();
+}
+
+bool HeadlessContext::Create()
+{
+    // We would prefer the surfaceless platform, since it doesn't go
+    // looking for an X server.  If the client library doesn't know about
+    // it, the default display is the next best thing.
+    const char *clientExtensions = eglQueryString(EGL_NO_DISPLAY,
+                                                  EGL_EXTENSIONS);
+
+    if (clientExtensions != nullptr &&
+            std::strstr(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)
+                eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+        if (getPlatformDisplay != nullptr) {
+            display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+                                         EGL_DEFAULT_DISPLAY, nullptr);
+        }
+    }
+
+    if (display == EGL_NO_DISPLAY) {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    EGLint major, minor;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+        Log("Failed to initialize EGL");
+        display = EGL_NO_DISPLAY;
+        return false;
+    }
+    else {
+        ownsDisplay = true;
+        Log("Initialized EGL %d.%d...", major, minor);
+    }
+
+    const char *displayExtensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (displayExtensions == nullptr ||
+            !std::strstr(displayExtensions, "EGL_KHR_surfaceless_context")) {
+        Log("EGL does not support surfaceless contexts");
+        Destroy();
+        return false;
+    }
+
+    // We want the same kind of context that GLFW would give us,
+    // which is desktop OpenGL, not OpenGL ES.
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        Log("EGL does not support desktop OpenGL");
+        Destroy();
+        return false;
+    }
+
+    // Note: we never render to an EGL surface, so any config that can do
+    //       desktop OpenGL will do.  Some drivers don't expose one at all
+    //       on the surfaceless platform, but will still give us a context
+    //       without a config (EGL_KHR_no_config_context).
+    const EGLint configAttribs[] = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                                    EGL_NONE};
+    EGLint numConfigs = 0;
+    eglChooseConfig(display, configAttribs, &config, 1, &numConfigs);
+    if (numConfigs == 0)
+        config = nullptr;
+
+    context = CreateContext(display, config, EGL_NO_CONTEXT);
+
+    if (context == EGL_NO_CONTEXT) {
+        Log("Failed to create EGL context");
+        Destroy();
+        return false;
+    }
+
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        Log("Failed to make the EGL context current");
+        Destroy();
+        return false;
+    }
+
+    Log("Created headless EGL context");
+    return true;
+}
+
+bool HeadlessContext::CreateFramebuffer(int fbWidth, int fbHeight)
+{
+    if (GLL_VERSION_3_0 || GLL_ARB_framebuffer_object) {
+        useExtFramebuffer = false;
+    }
+    else if (GLL_EXT_framebuffer_object) {
+        useExtFramebuffer = true;
+    }
+    else {
+        Log("No framebuffer object support, can't render offscreen");
+        return false;
+    }
+
+    // Note: resizing only needs new storage, and the framebuffer's
+    //       attachment follows it
+    if (framebuffer) {
+        if (fbWidth == width && fbHeight == height)
+            return true;
+
+        width = fbWidth;
+        height = fbHeight;
+
+        if (useExtFramebuffer) {
+            glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, colorBuffer.Get());
+            glRenderbufferStorageEXT(GL_RENDERBUFFER_EXT, GL_RGBA8,
+                                     width, height);
+            glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, 0);
+        }
+        else {
+            glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer.Get());
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+            glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        }
+
+        return true;
+    }
+
+    width = fbWidth;
+    height = fbHeight;
+
+    GLenum status;
+
+    if (useExtFramebuffer) {
+        colorBuffer = GLRenderbuffer::Create();
+        glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, colorBuffer.Get());
+        glRenderbufferStorageEXT(GL_RENDERBUFFER_EXT, GL_RGBA8,
+                                 width, height);
+
+        framebuffer = GLFramebuffer::Create();
+        glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, framebuffer.Get());
+        glFramebufferRenderbufferEXT(GL_FRAMEBUFFER_EXT,
+                                     GL_COLOR_ATTACHMENT0_EXT,
+                                     GL_RENDERBUFFER_EXT,
+                                     colorBuffer.Get());
+
+        status = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT);
+    }
+    else {
+        colorBuffer = GLRenderbuffer::Create();
+        glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer.Get());
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+        framebuffer = GLFramebuffer::Create();
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.Get());
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                  GL_RENDERBUFFER, colorBuffer.Get());
+
+        status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    }
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        Log("Offscreen framebuffer is incomplete: 0x%x", status);
+        return false;
+    }
+
+    // There is no window system framebuffer, so we need to say where
+    // the color output goes.
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+
+    Log("Created %dx%d offscreen framebuffer", width, height);
+    return true;
+}
+
+bool HeadlessContext::CreateShared(const HeadlessContext &shared)
+{
+    return CreateOnDisplay(shared, shared.context);
+}
+
+bool HeadlessContext::CreateSeparate(const HeadlessContext &other)
+{
+    return CreateOnDisplay(other, EGL_NO_CONTEXT);
+}
+
+bool HeadlessContext::CreateOnDisplay(const HeadlessContext &other,
+                                      EGLContext shareWith)
+{
+    display = other.display;
+    config = other.config;
+    ownsDisplay = false;
+
+    // Note: the API is bound per thread, and this may be a new one
+    if (display == EGL_NO_DISPLAY || !eglBindAPI(EGL_OPENGL_API)) {
+        Log("Failed to share the headless context's display");
+        display = EGL_NO_DISPLAY;
+        return false;
+    }
+
+    context = CreateContext(display, config, shareWith);
+
+    if (context == EGL_NO_CONTEXT) {
+        Log("Failed to create %s EGL context",
+            shareWith != EGL_NO_CONTEXT ? "a shared" : "another");
+        display = EGL_NO_DISPLAY;
+        return false;
+    }
+
+    return true;
+}
+
+bool HeadlessContext::MakeCurrent()
+{
+    eglBindAPI(EGL_OPENGL_API);
+
+    return eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                          context) == EGL_TRUE;
+}
+
+void HeadlessContext::ReleaseCurrent()
+{
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+}
+
+void HeadlessContext::DeleteFramebuffer()
+{
+    EGLDisplay previousDisplay = eglGetCurrentDisplay();
+    EGLContext previous = eglGetCurrentContext();
+    EGLSurface previousDraw = eglGetCurrentSurface(EGL_DRAW);
+    EGLSurface previousRead = eglGetCurrentSurface(EGL_READ);
+
+    if (previous != context &&
+        !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        // Note: it is current on another thread, so the objects go when
+        //       the context does
+        Log("Can't make the headless context current to delete its "
+            "framebuffer");
+        framebuffer.Release();
+        colorBuffer.Release();
+        return;
+    }
+
+    framebuffer.Reset();
+    colorBuffer.Reset();
+
+    if (previous == context)
+        return;
+
+    if (previous != EGL_NO_CONTEXT)
+        eglMakeCurrent(previousDisplay, previousDraw, previousRead, previous);
+    else
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                       EGL_NO_CONTEXT);
+}
+
+void HeadlessContext::Destroy()
+{
+    if (context != EGL_NO_CONTEXT) {
+        // The GL objects belong to our context, so it has to be current
+        // when we delete them.  If it isn't, we borrow this thread for it,
+        // and give back whatever was current.
+        if (framebuffer || colorBuffer)
+            DeleteFramebuffer();
+
+        // Note: a shared context may be destroyed from a thread where
+        //       some other context is current, which it should keep
+        if (eglGetCurrentContext() == context) {
+            eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                           EGL_NO_CONTEXT);
+        }
+        eglDestroyContext(display, context);
+        context = EGL_NO_CONTEXT;
+    }
+
+    if (display != EGL_NO_DISPLAY && ownsDisplay)
+        eglTerminate(display);
+
+    display = EGL_NO_DISPLAY;
+    ownsDisplay = false;
+}
@@ -0,0 +1,106 @@
+//============================================================================
+// Name        : HeadlessContext.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : An OpenGL context that doesn't need a window.
+//
+//               Our build boxes have no display and no GPU, so glfwInit()
+//               or glfwCreateWindow() will fail there.  Instead we ask EGL
+//               for a surfaceless context (EGL_MESA_platform_surfaceless),
+//               which Mesa's llvmpipe driver is happy to give us, and we
+//               render into a framebuffer object instead of a window.
+//
+//               Usage is in two steps, because we can't create the
+//               framebuffer object until the GL loader has the entry
+//               points, and it can't get them until there is a current
+//               context:
+//               - Create() the context and make it current
+//               - GLLoaderInit()
+//               - CreateFramebuffer() and render away
+//
+//               CreateShared() makes a second context on the same display,
+//               sharing the first one's objects, for a worker thread to
+//               build them on.  It has no framebuffer, and isn't current
+//               anywhere until that thread calls MakeCurrent().
+//               CreateSeparate() is the same, but shares nothing, for a
+//               worker that renders on its own, like the batch jobs' (see
+//               DemoJobs.h).
+//
+//============================================================================
+
+#ifndef HEADLESS_CONTEXT_H
+#define HEADLESS_CONTEXT_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+// EGL
+#include <EGL/egl.h>
+
+#include "GLHandle.h"
+
+class HeadlessContext {
+public:
+    HeadlessContext();
+    ~HeadlessContext();
+
+    // Initialize EGL and make a desktop OpenGL context current on the
+    // calling thread.
+    bool Create();
+
+    // Create a framebuffer object with a single RGBA color attachment,
+    // and leave it bound as the draw framebuffer.  Calling it again
+    // resizes the one we have.
+    bool CreateFramebuffer(int width, int height);
+
+    // Make a context that shares shared's objects, without making it
+    // current.  shared must outlive it.
+    bool CreateShared(const HeadlessContext &shared);
+
+    // Make a context of its own on other's display, sharing no objects,
+    // without making it current.  other must outlive it.
+    bool CreateSeparate(const HeadlessContext &other);
+
+    // make the context current on the calling thread, or let go of it
+    bool MakeCurrent();
+    void ReleaseCurrent();
+
+    // Delete the framebuffer and the context.  The context doesn't have to
+    // be current: it is made current on this thread for the deletes, if it
+    // isn't current anywhere else.
+    void Destroy();
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+    // the framebuffer object we render into, in place of a window's
+    GLuint Framebuffer() const { return framebuffer.Get(); }
+
+private:
+    // we own these, so no copying
+    HeadlessContext(const HeadlessContext &);
+    HeadlessContext &operator=(const HeadlessContext &);
+
+    // another context on other's display, sharing shareWith's objects
+    bool CreateOnDisplay(const HeadlessContext &other, EGLContext shareWith);
+
+    // delete the framebuffer object, with our context current
+    void DeleteFramebuffer();
+
+    EGLDisplay display;
+    EGLConfig config;       // or nullptr, for EGL_KHR_no_config_context
+    EGLContext context;
+    bool ownsDisplay;       // a shared context's display is the other's
+
+    // Note: legacy OpenGL 2.1 drivers may only have the EXT version of
+    //       framebuffer objects, in which case we use those entry points.
+    bool useExtFramebuffer;
+    GLFramebuffer framebuffer;
+    GLRenderbuffer colorBuffer;
+
+    int width;
+    int height;
+};
+
+#endif // HEADLESS_CONTEXT_H
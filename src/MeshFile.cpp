@@ -0,0 +1,614 @@
+//============================================================================
+// Name        : MeshFile.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Writes and loads our binary mesh files, through mmap().
+//
+//============================================================================
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "MeshFile.h"
+#include "DebugLog.h"
+#include "MeshGenerator.h"
+
+static const char Magic[8] = {'H', 'T', 'M', 'E', 'S', 'H', '\r', '\n'};
+static const uint32_t Version = 1;
+
+// where the blocks start, and what they are padded to
+static const uint64_t BlockAlignment = 4096;
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static bool LittleEndian()
+{
+    uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+// the size of one component, for the types a mesh file may use
+static uint32_t ComponentSize(uint32_t type)
+{
+    switch (type) {
+    case GL_FLOAT:
+        return 4;
+    case GL_HALF_FLOAT:
+        return 2;
+    case GL_UNSIGNED_BYTE:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static uint32_t IndexSize(uint32_t type)
+{
+    switch (type) {
+    case GL_UNSIGNED_SHORT:
+        return 2;
+    case GL_UNSIGNED_INT:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+// A page aligned mapping around part of a file.
+// Note: mmap() wants an offset that is a multiple of the page size, which
+//       isn't always 4096, so we map from the page the range starts in.
+struct MappedRange {
+    void *base;
+    size_t baseSize;
+    const char *data;
+};
+
+static bool MapRange(int fd, uint64_t offset, uint64_t size, bool sequential,
+                     MappedRange &range)
+{
+    uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t start = offset / pageSize * pageSize;
+
+    range.baseSize = static_cast<size_t>(offset - start + size);
+    range.base = mmap(nullptr, range.baseSize, PROT_READ, MAP_SHARED, fd,
+                      static_cast<off_t>(start));
+
+    if (range.base == MAP_FAILED) {
+        Log("Failed to map %llu bytes of a mesh file: %s",
+            static_cast<unsigned long long>(size), std::strerror(errno));
+        return false;
+    }
+
+    // we read it once, front to back, so read ahead as far as it likes
+    if (sequential)
+        madvise(range.base, range.baseSize, MADV_SEQUENTIAL);
+
+    range.data = static_cast<const char *>(range.base) + (offset - start);
+    return true;
+}
+
+static void UnmapRange(MappedRange &range)
+{
+    munmap(range.base, range.baseSize);
+}
+
+// pread() all of it, or fail
+static bool ReadFully(int fd, void *data, uint64_t size, uint64_t offset)
+{
+    char *out = static_cast<char *>(data);
+
+    while (size > 0) {
+        ssize_t got = pread(fd, out, static_cast<size_t>(size),
+                            static_cast<off_t>(offset));
+        if (got <= 0) {
+            if (got < 0 && errno == EINTR)
+                continue;
+            return false;
+        }
+
+        out += got;
+        offset += static_cast<uint64_t>(got);
+        size -= static_cast<uint64_t>(got);
+    }
+
+    return true;
+}
+
+MeshFile::MeshFile()
+    : fd(-1),
+      writable(false),
+      mapping(nullptr),
+      mappingSize(0),
+      vertices(nullptr),
+      indices(nullptr),
+      uploadMode(UploadAuto),
+      chunkSize(DefaultChunkSize)
+{
+    std::memset(&header, 0, sizeof(header));
+}
+
+MeshFile::~MeshFile()
+{
+    Close();
+}
+
+bool MeshFile::Open(const std::string &path)
+{
+    Close();
+
+    if (!LittleEndian()) {
+        Log("Mesh files are little endian, and this machine isn't");
+        return false;
+    }
+
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        Log("Failed to open mesh file %s: %s", path.c_str(),
+            std::strerror(errno));
+        return false;
+    }
+
+    struct stat info;
+    bool valid = fstat(fd, &info) == 0 &&
+                 ReadFully(fd, &header, sizeof(header), 0) &&
+                 std::memcmp(header.magic, Magic, sizeof(Magic)) == 0;
+
+    if (!valid) {
+        Log("%s is not a mesh file", path.c_str());
+        Close();
+        return false;
+    }
+
+    uint64_t fileSize = static_cast<uint64_t>(info.st_size);
+    uint64_t indexSize = IndexSize(header.indexType);
+
+    // Note: the counts are checked by dividing, so that a corrupt count
+    //       can't overflow the multiplication and sneak past.
+    valid = header.version == Version &&
+            header.headerSize == sizeof(MeshFileHeader) &&
+            header.attributeCount >= 1 &&
+            header.attributeCount <= MaxAttributes &&
+            header.vertexStride > 0 &&
+            (header.indexType == 0 || indexSize > 0) &&
+            (header.indexType != 0 || header.indexCount == 0) &&
+            header.vertexOffset % BlockAlignment == 0 &&
+            header.indexOffset % BlockAlignment == 0 &&
+            header.vertexOffset >= sizeof(MeshFileHeader) +
+                                   header.attributeCount *
+                                   sizeof(MeshFileAttribute) &&
+            header.vertexOffset <= fileSize &&
+            header.indexOffset <= fileSize &&
+            header.vertexCount <= (fileSize - header.vertexOffset) /
+                                  header.vertexStride &&
+            (indexSize == 0 ||
+             header.indexCount <= (fileSize - header.indexOffset) / indexSize);
+
+    if (!valid) {
+        Log("Mesh file %s has a bad header", path.c_str());
+        Close();
+        return false;
+    }
+
+    MeshFileAttribute table[MaxAttributes];
+    if (!ReadFully(fd, table, header.attributeCount * sizeof(table[0]),
+                   sizeof(header))) {
+        Log("Mesh file %s is cut short", path.c_str());
+        Close();
+        return false;
+    }
+
+    for (uint32_t i = 0; i < header.attributeCount; i++) {
+        const MeshFileAttribute &entry = table[i];
+        uint32_t size = ComponentSize(entry.type) * entry.components;
+
+        if (entry.components < 1 || entry.components > 4 || size == 0 ||
+            entry.offset + size > header.vertexStride) {
+            Log("Mesh file %s has a bad vertex attribute", path.c_str());
+            Close();
+            return false;
+        }
+
+        std::memcpy(names[i], entry.name, sizeof(names[i]));
+        names[i][sizeof(names[i]) - 1] = '\0';
+
+        VertexAttribute &attribute = attributes[i];
+        attribute.location = entry.location;
+        attribute.name = names[i];
+        attribute.components = static_cast<GLint>(entry.components);
+        attribute.type = entry.type;
+        attribute.normalized = entry.normalized ? GL_TRUE : GL_FALSE;
+        attribute.offset = entry.offset;
+    }
+
+    return true;
+}
+
+bool MeshFile::Create(const std::string &path, const VertexFormat &format,
+                      long long vertexCount, long long indexCount,
+                      GLenum indexType)
+{
+    Close();
+
+    if (!LittleEndian()) {
+        Log("Mesh files are little endian, and this machine isn't");
+        return false;
+    }
+
+    if (format.AttributeCount() > MaxAttributes || vertexCount < 0 ||
+        indexCount < 0 || (indexCount > 0 && IndexSize(indexType) == 0)) {
+        Log("Can't make a mesh file with that layout");
+        return false;
+    }
+
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.headerSize = sizeof(MeshFileHeader);
+    header.vertexStride = static_cast<uint32_t>(format.Stride());
+    header.attributeCount = static_cast<uint32_t>(format.AttributeCount());
+    header.indexType = indexCount > 0 ? indexType : 0;
+    header.reserved = 0;
+    header.vertexCount = static_cast<uint64_t>(vertexCount);
+    header.indexCount = static_cast<uint64_t>(indexCount);
+
+    uint64_t vertexBytes = header.vertexCount * header.vertexStride;
+    uint64_t indexBytes = header.indexCount * IndexSize(header.indexType);
+
+    header.vertexOffset = AlignUp(sizeof(MeshFileHeader) +
+                                  header.attributeCount *
+                                  sizeof(MeshFileAttribute),
+                                  BlockAlignment);
+    header.indexOffset = AlignUp(header.vertexOffset + vertexBytes,
+                                 BlockAlignment);
+
+    uint64_t fileSize = header.indexOffset + indexBytes;
+
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        Log("Failed to create mesh file %s: %s", path.c_str(),
+            std::strerror(errno));
+        return false;
+    }
+
+    writable = true;
+
+    // Note: the file is sparse until the mesh is written into it
+    if (ftruncate(fd, static_cast<off_t>(fileSize)) != 0) {
+        Log("Failed to size mesh file %s: %s", path.c_str(),
+            std::strerror(errno));
+        Close();
+        return false;
+    }
+
+    mappingSize = static_cast<size_t>(fileSize);
+    mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                   fd, 0);
+
+    if (mapping == MAP_FAILED) {
+        Log("Failed to map mesh file %s: %s", path.c_str(),
+            std::strerror(errno));
+        mapping = nullptr;
+        Close();
+        return false;
+    }
+
+    char *bytes = static_cast<char *>(mapping);
+    std::memcpy(bytes, &header, sizeof(header));
+
+    MeshFileAttribute *table =
+        reinterpret_cast<MeshFileAttribute *>(bytes + sizeof(header));
+
+    for (int i = 0; i < format.AttributeCount(); i++) {
+        const VertexAttribute &attribute = format.Attributes()[i];
+        MeshFileAttribute entry;
+        std::memset(&entry, 0, sizeof(entry));
+
+        entry.location = attribute.location;
+        entry.components = static_cast<uint32_t>(attribute.components);
+        entry.type = attribute.type;
+        entry.normalized = attribute.normalized ? 1 : 0;
+        entry.offset = static_cast<uint32_t>(attribute.offset);
+        std::strncpy(entry.name, attribute.name, sizeof(entry.name) - 1);
+
+        std::memcpy(&table[i], &entry, sizeof(entry));
+    }
+
+    vertices = bytes + header.vertexOffset;
+    indices = header.indexCount > 0 ? bytes + header.indexOffset : nullptr;
+
+    return true;
+}
+
+void MeshFile::Close()
+{
+    if (mapping != nullptr) {
+        munmap(mapping, mappingSize);
+        mapping = nullptr;
+        mappingSize = 0;
+    }
+
+    vertices = nullptr;
+    indices = nullptr;
+
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+
+    writable = false;
+}
+
+VertexFormat MeshFile::Format() const
+{
+    return VertexFormat::Of(attributes,
+                            static_cast<int>(header.attributeCount),
+                            static_cast<GLsizei>(header.vertexStride));
+}
+
+bool MeshFile::UploadVertices(GLenum usage) const
+{
+    return UploadBlock(GL_ARRAY_BUFFER, header.vertexOffset,
+                       header.vertexCount * header.vertexStride, usage);
+}
+
+bool MeshFile::UploadIndices(GLenum usage) const
+{
+    return UploadBlock(GL_ELEMENT_ARRAY_BUFFER, header.indexOffset,
+                       header.indexCount * IndexSize(header.indexType),
+                       usage);
+}
+
+bool MeshFile::UploadBlock(GLenum target, uint64_t offset, uint64_t size,
+                           GLenum usage) const
+{
+    if (fd < 0 || writable) {
+        Log("Only an opened mesh file can be uploaded");
+        return false;
+    }
+
+    if (size == 0) {
+        glBufferData(target, 0, NULL, usage);
+        return true;
+    }
+
+    UploadMode mode = uploadMode;
+    if (mode == UploadAuto) {
+        mode = size > static_cast<uint64_t>(chunkSize) ?
+               UploadStreamed : UploadMapped;
+    }
+
+    if (mode == UploadRead) {
+        // the way a loader usually does it, for comparison
+        std::vector<char> data(static_cast<size_t>(size));
+
+        if (!ReadFully(fd, data.data(), size, offset)) {
+            Log("Failed to read a mesh file");
+            return false;
+        }
+
+        glBufferData(target, static_cast<GLsizeiptr>(size), data.data(),
+                     usage);
+        return true;
+    }
+
+    // Note: glBufferData() and glBufferSubData() are done with our memory
+    //       when they return, so the pages can be unmapped right after.
+    if (mode == UploadMapped) {
+        MappedRange range;
+        if (!MapRange(fd, offset, size, true, range))
+            return false;
+
+        glBufferData(target, static_cast<GLsizeiptr>(size), range.data,
+                     usage);
+
+        UnmapRange(range);
+        return true;
+    }
+
+    glBufferData(target, static_cast<GLsizeiptr>(size), NULL, usage);
+
+    uint64_t chunk = static_cast<uint64_t>(chunkSize);
+
+    for (uint64_t done = 0; done < size; done += chunk) {
+        uint64_t length = std::min(chunk, size - done);
+
+        MappedRange range;
+        if (!MapRange(fd, offset + done, length, true, range))
+            return false;
+
+        glBufferSubData(target, static_cast<GLintptr>(done),
+                        static_cast<GLsizeiptr>(length), range.data);
+
+        UnmapRange(range);
+    }
+
+    return true;
+}
+
+const char *MeshFile::UploadModeName(UploadMode mode)
+{
+    switch (mode) {
+    case UploadMapped:
+        return "mapped";
+    case UploadStreamed:
+        return "streamed";
+    case UploadRead:
+        return "read";
+    default:
+        return "auto";
+    }
+}
+
+// A line of /proc/self/status, in bytes, or -1 where there isn't one
+static long long ProcessStatus(const char *field)
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    size_t length = std::strlen(field);
+
+    while (std::getline(status, line)) {
+        if (line.compare(0, length, field) == 0 && line.size() > length &&
+            line[length] == ':') {
+            return std::atoll(line.c_str() + length + 1) * 1024;
+        }
+    }
+
+    return -1;
+}
+
+// Start measuring the peak resident memory (VmHWM) from here, which
+// Linux lets us do through clear_refs
+static bool ResetPeakResident()
+{
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5" << std::endl;
+    return clearRefs.good();
+}
+
+// Write the file out, and drop it from the page cache, so that the next
+// load has to come from the disk.
+static void DropFromPageCache(const std::string &path)
+{
+#ifdef POSIX_FADV_DONTNEED
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+void MeshFile::Benchmark(std::ostream &out, const std::string &directory)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const int sizesMB[] = {16, 64, 256, 1024};
+    const UploadMode modes[] = {UploadRead, UploadMapped, UploadStreamed};
+    const int columns = 1024;
+
+    const GLfloat colors[] = {1.f, 0.f, 0.f,
+                              0.f, 1.f, 0.f,
+                              0.f, 0.f, 1.f};
+    const MeshPatch patch = MeshGenerator::RectanglePatch(-1.0f, -1.0f,
+                                                          1.0f, 1.0f,
+                                                          colors);
+    const std::string path = directory + "/mesh_benchmark.mesh";
+
+    bool measureResident = ResetPeakResident() &&
+                           ProcessStatus("VmHWM") >= 0;
+
+    // Note: a driver that keeps buffers in system memory, like llvmpipe,
+    //       adds the buffer itself to our resident memory, so we show what
+    //       the load took beyond that, too.
+    out << "Loading meshes from " << path << ", out of the page cache"
+        << std::endl
+        << "      MB  mode       open ms  upload ms      MB/s  "
+           "peak RSS +MB  beyond buffer" << std::endl;
+
+    MeshGenerator generator;
+    GLuint buffer;
+    glGenBuffers(1, &buffer);
+
+    for (size_t s = 0; s < sizeof(sizesMB) / sizeof(sizesMB[0]); s++) {
+        // a grid of 1024 columns, as many rows as fit
+        long long bytes = static_cast<long long>(sizesMB[s]) << 20;
+        int rows = static_cast<int>(bytes / static_cast<long long>(
+                                        sizeof(ColorVertex)) /
+                                    MeshGenerator::GridVertexCount(columns,
+                                                                   1));
+        long long vertexCount = MeshGenerator::GridVertexCount(columns, rows);
+
+        MeshFile writer;
+        if (!writer.Create(path, VertexFormat::ColorVertexFormat(),
+                           vertexCount)) {
+            break;
+        }
+
+        generator.GenerateGrid(patch, columns, rows,
+                               static_cast<ColorVertex *>(writer.Vertices()));
+        writer.Close();
+
+        for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+            DropFromPageCache(path);
+
+            if (measureResident)
+                ResetPeakResident();
+            long long residentBefore = ProcessStatus("VmRSS");
+
+            Clock::time_point start = Clock::now();
+
+            MeshFile mesh;
+            bool loaded = mesh.Open(path);
+            Clock::time_point opened = Clock::now();
+
+            mesh.SetUploadMode(modes[m]);
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            loaded = loaded && mesh.UploadVertices(GL_STATIC_DRAW);
+            glFinish();
+
+            Clock::time_point uploaded = Clock::now();
+            long long residentPeak = ProcessStatus("VmHWM");
+
+            std::chrono::duration<double, std::milli> openTime =
+                opened - start;
+            std::chrono::duration<double, std::milli> uploadTime =
+                uploaded - opened;
+            double megabytes = vertexCount * sizeof(ColorVertex) /
+                               (1024.0 * 1024.0);
+
+            out << std::fixed << std::setprecision(0) << std::setw(8)
+                << megabytes << "  " << std::left << std::setw(9)
+                << UploadModeName(modes[m]) << std::right
+                << std::setprecision(3) << std::setw(9) << openTime.count()
+                << std::setprecision(1) << std::setw(11)
+                << uploadTime.count() << std::setprecision(0)
+                << std::setw(10) << megabytes * 1000.0 / uploadTime.count();
+
+            if (!loaded) {
+                out << "  failed";
+            }
+            else if (measureResident && residentBefore >= 0) {
+                double grown = (residentPeak - residentBefore) /
+                               (1024.0 * 1024.0);
+                out << std::setw(11) << grown << std::setw(14)
+                    << std::max(0.0, grown - megabytes);
+            }
+            else {
+                out << std::setw(11) << "n/a" << std::setw(14) << "n/a";
+            }
+            out << std::endl;
+
+            // let the driver free the storage before the next one
+            glBufferData(GL_ARRAY_BUFFER, 0, NULL, GL_STATIC_DRAW);
+            glFinish();
+        }
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDeleteBuffers(1, &buffer);
+    std::remove(path.c_str());
+
+    out.unsetf(std::ios_base::floatfield);
+    out << std::setprecision(6);
+}
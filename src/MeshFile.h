@@ -0,0 +1,157 @@
+//============================================================================
+// Name        : MeshFile.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : A simple binary mesh file, and a loader that uploads it
+//               without copying it into our own memory first.
+//
+//               Until now every vertex came from an array in the source.
+//               A mesh file holds, in little endian order:
+//               - a 64 byte header (MeshFileHeader): magic, version, how
+//                 many vertices and indices, and where their blocks are
+//               - a table of vertex attributes (MeshFileAttribute), the
+//                 same things a VERTEX_ATTRIBUTE() entry describes
+//               - the vertex block, interleaved vertices exactly as the GPU
+//                 reads them
+//               - the index block, 16 or 32 bit indices, if there are any
+//
+//               Both blocks start on a 4096 byte boundary, so that we can
+//               map them on their own, page aligned.  Loading a mesh is:
+//               - map the block with mmap(), and hand the mapped pages
+//                 straight to glBufferData(), so the driver reads them from
+//                 the page cache, with no read() into a buffer of ours
+//               - or, for blocks bigger than the chunk size (64 MB by
+//                 default), allocate the buffer with glBufferData(NULL) and
+//                 map, upload with glBufferSubData() and unmap one chunk at
+//                 a time, so that only one chunk is ever resident on our
+//                 side.  That works for files bigger than RAM, too.
+//
+//               The same mapping works the other way round: Create()
+//               sizes a new file and maps its blocks, so a MeshGenerator can
+//               write the vertices straight into it.
+//
+//               Benchmark() loads meshes of growing size with read(), with
+//               one mapping, and in chunks, and reports how long each took
+//               and how much our resident memory grew.
+//
+//============================================================================
+
+#ifndef MESH_FILE_H
+#define MESH_FILE_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "VertexLayout.h"
+
+struct MeshFileHeader {
+    char magic[8];              // "HTMESH\r\n"
+    uint32_t version;
+    uint32_t headerSize;        // sizeof(MeshFileHeader)
+    uint32_t vertexStride;
+    uint32_t attributeCount;
+    uint32_t indexType;         // GL_UNSIGNED_SHORT, GL_UNSIGNED_INT or 0
+    uint32_t reserved;
+    uint64_t vertexCount;
+    uint64_t vertexOffset;      // from the start of the file
+    uint64_t indexCount;
+    uint64_t indexOffset;
+};
+
+struct MeshFileAttribute {
+    uint32_t location;
+    uint32_t components;
+    uint32_t type;
+    uint32_t normalized;
+    uint32_t offset;
+    char name[28];              // zero terminated
+};
+
+static_assert(sizeof(MeshFileHeader) == 64,
+              "MeshFileHeader should be 64 bytes");
+static_assert(sizeof(MeshFileAttribute) == 48,
+              "MeshFileAttribute should be 48 bytes");
+
+class MeshFile {
+public:
+    enum UploadMode {
+        UploadAuto = 0,     // mapped, or streamed if the block is big
+        UploadMapped,       // map the whole block, one glBufferData()
+        UploadStreamed,     // map and upload one chunk at a time
+        UploadRead          // read() into memory first, the old way
+    };
+
+    static const int MaxAttributes = 8;
+    static const GLsizeiptr DefaultChunkSize = 64 * 1024 * 1024;
+
+    MeshFile();
+    ~MeshFile();
+
+    // Read and check the header of an existing file.
+    // Nothing else is read until the blocks are uploaded.
+    bool Open(const std::string &path);
+
+    // Make a new file for vertexCount vertices of this format, and
+    // indexCount indices of indexType (0 for none), and map its blocks,
+    // for Vertices() and Indices().  Close() writes it out.
+    bool Create(const std::string &path, const VertexFormat &format,
+                long long vertexCount, long long indexCount = 0,
+                GLenum indexType = 0);
+
+    // the blocks of a created file, to write the mesh into
+    void *Vertices() { return vertices; }
+    void *Indices() { return indices; }
+
+    void Close();
+
+    void SetUploadMode(UploadMode mode) { uploadMode = mode; }
+    void SetChunkSize(GLsizeiptr size) { chunkSize = size; }
+
+    // Upload the vertices into the buffer bound to GL_ARRAY_BUFFER, and
+    // the indices into the one bound to GL_ELEMENT_ARRAY_BUFFER.
+    bool UploadVertices(GLenum usage) const;
+    bool UploadIndices(GLenum usage) const;
+
+    // the layout of an opened file's vertices
+    VertexFormat Format() const;
+
+    long long VertexCount() const { return header.vertexCount; }
+    long long IndexCount() const { return header.indexCount; }
+    GLenum IndexType() const { return header.indexType; }
+
+    static const char *UploadModeName(UploadMode mode);
+
+    // Write meshes of growing size to files in directory, load each of
+    // them every way we can, and report the times and memory use.
+    // Needs a current context.
+    static void Benchmark(std::ostream &out, const std::string &directory);
+
+private:
+    MeshFile(const MeshFile &);
+    MeshFile &operator=(const MeshFile &);
+
+    bool UploadBlock(GLenum target, uint64_t offset, uint64_t size,
+                     GLenum usage) const;
+
+    int fd;
+    bool writable;
+    MeshFileHeader header;
+    VertexAttribute attributes[MaxAttributes];
+    char names[MaxAttributes][sizeof(MeshFileAttribute::name)];
+
+    // the mapping of a created file
+    void *mapping;
+    size_t mappingSize;
+    void *vertices;
+    void *indices;
+
+    UploadMode uploadMode;
+    GLsizeiptr chunkSize;
+};
+
+#endif // MESH_FILE_H
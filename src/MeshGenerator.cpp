@@ -0,0 +1,711 @@
+//============================================================================
+// Name        : MeshGenerator.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Generates big meshes on the CPU, with scalar, SSE and AVX2
+//               kernels, spread over every core.
+//
+//============================================================================
+
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+#include "MeshGenerator.h"
+#include "DebugLog.h"
+
+// The SIMD kernels are compiled for their instruction sets with target
+// attributes, rather than build flags, so the rest of the program still
+// runs on any x86 CPU.  Anywhere else, we only have the scalar kernel.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MESH_GENERATOR_X86 1
+#include <immintrin.h>
+#endif
+
+// The triangles in a row of the lattice point up or down.  These are the
+// (i, j) offsets of their corners, from the lattice point they start at.
+static const int UpCorners[6] = {0, 0, 1, 0, 0, 1};
+static const int DownCorners[6] = {1, 0, 1, 1, 0, 1};
+
+// each thread takes this many rows at a time
+static const int RowsPerTask = 8;
+
+// count triangles along row j, triangle k starting at lattice point (k, j)
+struct RowJob {
+    const MeshPatch *patch;
+    GLfloat uScale;
+    GLfloat vScale;
+    int j;
+    int count;
+    const int *corners;
+    ColorVertex *out;
+    bool stream;
+};
+
+typedef void (*RowKernel)(const RowJob &job);
+
+struct MeshGenerator::Shape {
+    const MeshPatch *patch;
+    GLfloat uScale;
+    GLfloat vScale;
+    int rows;
+    int columns;
+    bool triangle;   // each row is one triangle shorter than the last
+};
+
+// Triangles k = first .. count - 1 of a row, one vertex at a time.
+// Note: the SIMD kernels do exactly the same sums, in the same order, so
+//       that they come out with exactly the same results.
+static void WriteRowScalar(const RowJob &job, int first)
+{
+    const MeshPatch &p = *job.patch;
+
+    for (int k = first; k < job.count; k++) {
+        for (int c = 0; c < 3; c++) {
+            GLfloat u = static_cast<GLfloat>(k + job.corners[c * 2]) *
+                        job.uScale;
+            GLfloat v = static_cast<GLfloat>(job.j + job.corners[c * 2 + 1]) *
+                        job.vScale;
+
+            ColorVertex &vertex = job.out[k * 3 + c];
+
+            for (int a = 0; a < 3; a++) {
+                GLfloat vPart = v * p.vAxis[a];
+                vertex.position[a] = (p.origin[a] + u * p.uAxis[a]) + vPart;
+            }
+
+            for (int a = 0; a < 4; a++) {
+                GLfloat vPart = v * p.vColor[a];
+                vertex.color[a] = ToUNorm8((p.color[a] + u * p.uColor[a]) +
+                                           vPart);
+            }
+        }
+    }
+}
+
+static void WriteRowScalar(const RowJob &job)
+{
+    WriteRowScalar(job, 0);
+}
+
+#ifdef MESH_GENERATOR_X86
+
+__attribute__((target("sse2")))
+static void StoreVertexSSE(ColorVertex *out, __m128 vertex, bool stream)
+{
+    if (stream)
+        _mm_stream_ps(reinterpret_cast<float *>(out), vertex);
+    else
+        _mm_storeu_ps(reinterpret_cast<float *>(out), vertex);
+}
+
+// 4 triangles at a time: work out one corner of each, as 4 lanes of x, y,
+// z and packed color, then transpose them into 4 vertices.
+__attribute__((target("sse2")))
+static void WriteRowSSE(const RowJob &job)
+{
+    const MeshPatch &p = *job.patch;
+    const __m128i lanes = _mm_set_epi32(3, 2, 1, 0);
+    const __m128 uScale = _mm_set1_ps(job.uScale);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(255.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    int k = 0;
+    for (; k + 4 <= job.count; k += 4) {
+        for (int c = 0; c < 3; c++) {
+            __m128i i = _mm_add_epi32(_mm_set1_epi32(k + job.corners[c * 2]),
+                                      lanes);
+            __m128 u = _mm_mul_ps(_mm_cvtepi32_ps(i), uScale);
+            GLfloat v = static_cast<GLfloat>(job.j + job.corners[c * 2 + 1]) *
+                        job.vScale;
+
+            __m128 position[3];
+            for (int a = 0; a < 3; a++) {
+                position[a] = _mm_add_ps(
+                                  _mm_add_ps(_mm_set1_ps(p.origin[a]),
+                                             _mm_mul_ps(u, _mm_set1_ps(
+                                                            p.uAxis[a]))),
+                                  _mm_set1_ps(v * p.vAxis[a]));
+            }
+
+            // each channel becomes a byte, in little endian RGBA order
+            __m128i rgba = _mm_setzero_si128();
+            for (int a = 0; a < 4; a++) {
+                __m128 channel = _mm_add_ps(
+                                     _mm_add_ps(_mm_set1_ps(p.color[a]),
+                                                _mm_mul_ps(u, _mm_set1_ps(
+                                                               p.uColor[a]))),
+                                     _mm_set1_ps(v * p.vColor[a]));
+                channel = _mm_min_ps(_mm_max_ps(channel, zero), one);
+
+                __m128i bytes = _mm_cvttps_epi32(
+                                    _mm_add_ps(_mm_mul_ps(channel, scale),
+                                               half));
+                rgba = _mm_or_si128(rgba,
+                                    _mm_sll_epi32(bytes,
+                                                  _mm_cvtsi32_si128(8 * a)));
+            }
+
+            __m128 x = position[0];
+            __m128 y = position[1];
+            __m128 z = position[2];
+            __m128 w = _mm_castsi128_ps(rgba);
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+
+            ColorVertex *out = job.out + k * 3 + c;
+            StoreVertexSSE(out, x, job.stream);
+            StoreVertexSSE(out + 3, y, job.stream);
+            StoreVertexSSE(out + 6, z, job.stream);
+            StoreVertexSSE(out + 9, w, job.stream);
+        }
+    }
+
+    WriteRowScalar(job, k);
+}
+
+// The same, 8 triangles at a time
+__attribute__((target("avx2")))
+static void WriteRowAVX2(const RowJob &job)
+{
+    const MeshPatch &p = *job.patch;
+    const __m256i lanes = _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    const __m256 uScale = _mm256_set1_ps(job.uScale);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 scale = _mm256_set1_ps(255.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+
+    int k = 0;
+    for (; k + 8 <= job.count; k += 8) {
+        for (int c = 0; c < 3; c++) {
+            __m256i i = _mm256_add_epi32(
+                            _mm256_set1_epi32(k + job.corners[c * 2]), lanes);
+            __m256 u = _mm256_mul_ps(_mm256_cvtepi32_ps(i), uScale);
+            GLfloat v = static_cast<GLfloat>(job.j + job.corners[c * 2 + 1]) *
+                        job.vScale;
+
+            __m256 position[3];
+            for (int a = 0; a < 3; a++) {
+                position[a] = _mm256_add_ps(
+                                  _mm256_add_ps(_mm256_set1_ps(p.origin[a]),
+                                                _mm256_mul_ps(u,
+                                                    _mm256_set1_ps(
+                                                        p.uAxis[a]))),
+                                  _mm256_set1_ps(v * p.vAxis[a]));
+            }
+
+            __m256i rgba = _mm256_setzero_si256();
+            for (int a = 0; a < 4; a++) {
+                __m256 channel = _mm256_add_ps(
+                                     _mm256_add_ps(_mm256_set1_ps(p.color[a]),
+                                                   _mm256_mul_ps(u,
+                                                       _mm256_set1_ps(
+                                                           p.uColor[a]))),
+                                     _mm256_set1_ps(v * p.vColor[a]));
+                channel = _mm256_min_ps(_mm256_max_ps(channel, zero), one);
+
+                __m256i bytes = _mm256_cvttps_epi32(
+                                    _mm256_add_ps(_mm256_mul_ps(channel,
+                                                                scale),
+                                                  half));
+                rgba = _mm256_or_si256(rgba,
+                                       _mm256_sll_epi32(bytes,
+                                           _mm_cvtsi32_si128(8 * a)));
+            }
+
+            // Transpose within each 128 bit half, which leaves vertex n
+            // in the low half of one register and vertex n + 4 in the high
+            __m256 w = _mm256_castsi256_ps(rgba);
+            __m256 xy0 = _mm256_unpacklo_ps(position[0], position[1]);
+            __m256 xy1 = _mm256_unpackhi_ps(position[0], position[1]);
+            __m256 zw0 = _mm256_unpacklo_ps(position[2], w);
+            __m256 zw1 = _mm256_unpackhi_ps(position[2], w);
+
+            __m256 vertices[4];
+            vertices[0] = _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(1, 0, 1, 0));
+            vertices[1] = _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(3, 2, 3, 2));
+            vertices[2] = _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(1, 0, 1, 0));
+            vertices[3] = _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(3, 2, 3, 2));
+
+            ColorVertex *out = job.out + k * 3 + c;
+            for (int n = 0; n < 4; n++) {
+                __m128 low = _mm256_castps256_ps128(vertices[n]);
+                __m128 high = _mm256_extractf128_ps(vertices[n], 1);
+
+                if (job.stream) {
+                    _mm_stream_ps(reinterpret_cast<float *>(out + n * 3),
+                                  low);
+                    _mm_stream_ps(reinterpret_cast<float *>(out + (n + 4) * 3),
+                                  high);
+                }
+                else {
+                    _mm_storeu_ps(reinterpret_cast<float *>(out + n * 3),
+                                  low);
+                    _mm_storeu_ps(reinterpret_cast<float *>(out + (n + 4) * 3),
+                                  high);
+                }
+            }
+        }
+    }
+
+    WriteRowScalar(job, k);
+}
+
+// streaming stores aren't ordered with anything else until this
+__attribute__((target("sse2")))
+static void StoreFence()
+{
+    _mm_sfence();
+}
+
+#else
+
+static void StoreFence()
+{
+}
+
+#endif // MESH_GENERATOR_X86
+
+static RowKernel KernelFunction(MeshGenerator::Kernel kernel)
+{
+#ifdef MESH_GENERATOR_X86
+    if (kernel == MeshGenerator::KernelAVX2)
+        return WriteRowAVX2;
+    if (kernel == MeshGenerator::KernelSSE)
+        return WriteRowSSE;
+#endif
+
+    return WriteRowScalar;
+}
+
+MeshGenerator::MeshGenerator()
+    : kernel(KernelScalar),
+      threads(1)
+{
+    SetKernel(KernelAuto);
+    SetThreads(0);
+}
+
+bool MeshGenerator::KernelSupported(Kernel kernel)
+{
+    switch (kernel) {
+    case KernelScalar:
+        return true;
+#ifdef MESH_GENERATOR_X86
+    case KernelSSE:
+        return __builtin_cpu_supports("sse2");
+    case KernelAVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+const char *MeshGenerator::KernelName(Kernel kernel)
+{
+    switch (kernel) {
+    case KernelScalar:
+        return "scalar";
+    case KernelSSE:
+        return "sse";
+    case KernelAVX2:
+        return "avx2";
+    default:
+        return "auto";
+    }
+}
+
+void MeshGenerator::SetKernel(Kernel requested)
+{
+    if (requested != KernelAuto && KernelSupported(requested)) {
+        kernel = requested;
+        return;
+    }
+
+    if (requested != KernelAuto) {
+        Log("The %s mesh generator isn't supported by this CPU",
+            KernelName(requested));
+    }
+
+    if (KernelSupported(KernelAVX2))
+        kernel = KernelAVX2;
+    else if (KernelSupported(KernelSSE))
+        kernel = KernelSSE;
+    else
+        kernel = KernelScalar;
+}
+
+void MeshGenerator::SetThreads(int count)
+{
+    if (count <= 0) {
+        count = static_cast<int>(std::thread::hardware_concurrency());
+        if (count <= 0)
+            count = 1;
+    }
+
+    threads = count;
+}
+
+MeshPatch MeshGenerator::TrianglePatch(const GLfloat positions[9],
+                                       const GLfloat colors[9])
+{
+    MeshPatch patch;
+
+    for (int a = 0; a < 3; a++) {
+        patch.origin[a] = positions[a];
+        patch.uAxis[a] = positions[3 + a] - positions[a];
+        patch.vAxis[a] = positions[6 + a] - positions[a];
+
+        patch.color[a] = colors[a];
+        patch.uColor[a] = colors[3 + a] - colors[a];
+        patch.vColor[a] = colors[6 + a] - colors[a];
+    }
+
+    patch.color[3] = 1.0f;
+    patch.uColor[3] = patch.vColor[3] = 0.0f;
+
+    return patch;
+}
+
+MeshPatch MeshGenerator::RectanglePatch(GLfloat left, GLfloat bottom,
+                                        GLfloat right, GLfloat top,
+                                        const GLfloat colors[9])
+{
+    const GLfloat corners[9] = {left, bottom, 0.0f,
+                                right, bottom, 0.0f,
+                                left, top, 0.0f};
+
+    return TrianglePatch(corners, colors);
+}
+
+long long MeshGenerator::TriangleVertexCount(int subdivisions)
+{
+    long long n = subdivisions;
+    return 3 * n * n;
+}
+
+long long MeshGenerator::GridVertexCount(int columns, int rows)
+{
+    return 6 * static_cast<long long>(columns) * rows;
+}
+
+MeshGenerator::Shape MeshGenerator::TriangleShape(const MeshPatch &patch,
+                                                  int subdivisions)
+{
+    Shape shape;
+    shape.patch = &patch;
+    shape.uScale = 1.0f / subdivisions;
+    shape.vScale = 1.0f / subdivisions;
+    shape.rows = subdivisions;
+    shape.columns = subdivisions;
+    shape.triangle = true;
+
+    return shape;
+}
+
+MeshGenerator::Shape MeshGenerator::GridShape(const MeshPatch &patch,
+                                              int columns, int rows)
+{
+    Shape shape;
+    shape.patch = &patch;
+    shape.uScale = 1.0f / columns;
+    shape.vScale = 1.0f / rows;
+    shape.rows = rows;
+    shape.columns = columns;
+    shape.triangle = false;
+
+    return shape;
+}
+
+void MeshGenerator::GenerateTriangle(const MeshPatch &patch,
+                                     int subdivisions,
+                                     ColorVertex *out) const
+{
+    Generate(TriangleShape(patch, subdivisions), out);
+}
+
+void MeshGenerator::GenerateGrid(const MeshPatch &patch, int columns,
+                                 int rows, ColorVertex *out) const
+{
+    Generate(GridShape(patch, columns, rows), out);
+}
+
+bool MeshGenerator::UploadTriangle(const MeshPatch &patch, int subdivisions,
+                                   GLenum usage) const
+{
+    return Upload(TriangleShape(patch, subdivisions),
+                  TriangleVertexCount(subdivisions), usage);
+}
+
+bool MeshGenerator::UploadGrid(const MeshPatch &patch, int columns, int rows,
+                               GLenum usage) const
+{
+    return Upload(GridShape(patch, columns, rows),
+                  GridVertexCount(columns, rows), usage);
+}
+
+// Map the whole buffer bound to GL_ARRAY_BUFFER, telling the driver that
+// we don't care what was in it, if we have a way to.
+static void *MapForWriting(GLsizeiptr bytes)
+{
+    if (GLL_VERSION_3_0 || GLL_ARB_map_buffer_range) {
+        return glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes,
+                                GL_MAP_WRITE_BIT |
+                                GL_MAP_INVALIDATE_BUFFER_BIT);
+    }
+
+    return glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
+}
+
+bool MeshGenerator::Upload(const Shape &shape, long long vertexCount,
+                           GLenum usage) const
+{
+    GLsizeiptr bytes = static_cast<GLsizeiptr>(vertexCount *
+                                               sizeof(ColorVertex));
+
+    glBufferData(GL_ARRAY_BUFFER, bytes, NULL, usage);
+
+    // Note: the contents of a mapped buffer can be lost before we unmap
+    //       it (on a mode switch, say), and then we have to write them
+    //       again.  It should never happen twice in a row.
+    for (int attempt = 0; attempt < 3; attempt++) {
+        void *mapped = MapForWriting(bytes);
+
+        if (mapped == nullptr) {
+            Log("Failed to map a %lld byte vertex buffer",
+                static_cast<long long>(bytes));
+            return false;
+        }
+
+        Generate(shape, static_cast<ColorVertex *>(mapped));
+
+        if (glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE)
+            return true;
+    }
+
+    Log("Lost the contents of the vertex buffer while filling it");
+    return false;
+}
+
+void MeshGenerator::Generate(const Shape &shape, ColorVertex *out) const
+{
+    RowKernel rowKernel = KernelFunction(kernel);
+
+    // Note: every vertex is 16 bytes, so if the first one is aligned for
+    //       a streaming store, they all are.
+    bool stream = kernel != KernelScalar &&
+                  reinterpret_cast<uintptr_t>(out) % 16 == 0;
+
+    std::atomic<int> nextRow(0);
+
+    auto work = [&]() {
+        for (;;) {
+            int first = nextRow.fetch_add(RowsPerTask);
+            if (first >= shape.rows)
+                break;
+
+            int last = std::min(first + RowsPerTask, shape.rows);
+
+            for (int r = first; r < last; r++) {
+                // In a subdivided triangle, row r has n - r triangles
+                // pointing up, and one less pointing down, so it starts
+                // r * (2n - r) triangles in.  A grid's are all the same.
+                long long n = shape.columns;
+                long long start = shape.triangle ? r * (2 * n - r) : r * 2 * n;
+                int up = shape.triangle ? shape.columns - r : shape.columns;
+                int down = shape.triangle ? up - 1 : shape.columns;
+
+                RowJob job;
+                job.patch = shape.patch;
+                job.uScale = shape.uScale;
+                job.vScale = shape.vScale;
+                job.j = r;
+                job.stream = stream;
+
+                job.count = up;
+                job.corners = UpCorners;
+                job.out = out + start * 3;
+                rowKernel(job);
+
+                job.count = down;
+                job.corners = DownCorners;
+                job.out = out + (start + up) * 3;
+                rowKernel(job);
+            }
+        }
+
+        if (stream)
+            StoreFence();
+    };
+
+    int rowTasks = (shape.rows + RowsPerTask - 1) / RowsPerTask;
+    int count = std::max(1, std::min(threads, rowTasks));
+
+    // this thread does its share too
+    std::vector<std::thread> workers;
+    for (int t = 1; t < count; t++)
+        workers.push_back(std::thread(work));
+
+    work();
+
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+}
+
+// the fastest of a few runs, in milliseconds
+template <typename Function>
+static double BestOf(int runs, Function function)
+{
+    typedef std::chrono::steady_clock Clock;
+    double best = 0.0;
+
+    for (int run = 0; run < runs; run++) {
+        Clock::time_point start = Clock::now();
+        function();
+        std::chrono::duration<double, std::milli> elapsed =
+            Clock::now() - start;
+
+        if (run == 0 || elapsed.count() < best)
+            best = elapsed.count();
+    }
+
+    return best;
+}
+
+void MeshGenerator::Benchmark(std::ostream &out, int subdivisions,
+                              bool mapBuffers)
+{
+    const GLfloat positions[] = {-0.5f, -0.5f, 0.0f,
+                                 0.5f, -0.5f, 0.0f,
+                                 0.0f,  0.5f, 0.0f};
+    const GLfloat colors[] = {1.f, 0.f, 0.f,
+                              0.f, 1.f, 0.f,
+                              0.f, 0.f, 1.f};
+    const MeshPatch patch = TrianglePatch(positions, colors);
+    const int runs = 5;
+
+    long long vertexCount = TriangleVertexCount(subdivisions);
+    size_t bytes = static_cast<size_t>(vertexCount) * sizeof(ColorVertex);
+
+    // everything is checked against the plain C++ version
+    std::vector<ColorVertex> reference(static_cast<size_t>(vertexCount));
+    std::vector<ColorVertex> memory(static_cast<size_t>(vertexCount));
+
+    MeshGenerator scalar;
+    scalar.SetKernel(KernelScalar);
+    scalar.SetThreads(1);
+    scalar.GenerateTriangle(patch, subdivisions, reference.data());
+
+    GLuint buffer = 0;
+
+    if (mapBuffers) {
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), NULL,
+                     GL_DYNAMIC_DRAW);
+    }
+
+    MeshGenerator all;
+    int cores = all.Threads();
+
+    out << "Generating a triangle with " << subdivisions << " subdivisions, "
+        << vertexCount << " vertices, " << std::fixed << std::setprecision(1)
+        << bytes / 1.0e6 << " MB, best of " << runs << " runs" << std::endl
+        << "    kernel  threads  target        ms   Mvertices/s     GB/s"
+           "  matches" << std::endl;
+
+    const Kernel kernels[] = {KernelScalar, KernelSSE, KernelAVX2};
+
+    for (int k = 0; k < 3; k++) {
+        if (!KernelSupported(kernels[k]))
+            continue;
+
+        for (int t = 0; t < 2; t++) {
+            int threadCount = (t == 0) ? 1 : cores;
+            if (t == 1 && cores == 1)
+                break;
+
+            MeshGenerator generator;
+            generator.SetKernel(kernels[k]);
+            generator.SetThreads(threadCount);
+
+            for (int target = 0; target < (mapBuffers ? 2 : 1); target++) {
+                bool matches = true;
+                double ms;
+
+                if (target == 0) {
+                    std::memset(memory.data(), 0, bytes);
+
+                    ms = BestOf(runs, [&]() {
+                        generator.GenerateTriangle(patch, subdivisions,
+                                                   memory.data());
+                    });
+
+                    matches = std::memcmp(memory.data(), reference.data(),
+                                          bytes) == 0;
+                }
+                else {
+                    // Map, fill and unmap, the way we upload a mesh
+                    ms = BestOf(runs, [&]() {
+                        void *mapped = MapForWriting(
+                                           static_cast<GLsizeiptr>(bytes));
+
+                        if (mapped == nullptr) {
+                            matches = false;
+                            return;
+                        }
+
+                        generator.GenerateTriangle(
+                            patch, subdivisions,
+                            static_cast<ColorVertex *>(mapped));
+
+                        if (glUnmapBuffer(GL_ARRAY_BUFFER) != GL_TRUE)
+                            matches = false;
+                    });
+
+                    if (matches) {
+                        std::memset(memory.data(), 0, bytes);
+                        glGetBufferSubData(GL_ARRAY_BUFFER, 0,
+                                           static_cast<GLsizeiptr>(bytes),
+                                           memory.data());
+                        matches = std::memcmp(memory.data(),
+                                              reference.data(), bytes) == 0;
+                    }
+                }
+
+                out << "    " << std::left << std::setw(8)
+                    << KernelName(kernels[k]) << std::right << std::setw(7)
+                    << threadCount << "  " << std::left << std::setw(8)
+                    << (target == 0 ? "memory" : "mapped") << std::right
+                    << std::setprecision(2) << std::setw(10) << ms
+                    << std::setprecision(1) << std::setw(14)
+                    << vertexCount / (ms * 1000.0)
+                    << std::setprecision(2) << std::setw(9)
+                    << bytes / (ms * 1.0e6)
+                    << std::setw(9) << (matches ? "yes" : "NO")
+                    << std::endl;
+            }
+        }
+    }
+
+    if (buffer != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glDeleteBuffers(1, &buffer);
+    }
+
+    out.unsetf(std::ios_base::floatfield);
+    out << std::setprecision(6);
+}
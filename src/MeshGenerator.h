@@ -0,0 +1,131 @@
+//============================================================================
+// Name        : MeshGenerator.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Generates big meshes on the CPU, straight into a mapped
+//               vertex buffer.
+//
+//               Our triangle is a hand written array of 3 vertices.  To
+//               push millions of vertices through the pipeline, we need to
+//               make them, so there are two shapes:
+//               - the triangle, subdivided n times along each edge into n*n
+//                 little triangles, with the corner colors blended across
+//                 it (so it looks just like the original, only heavier)
+//               - a grid of columns x rows cells, two triangles per cell,
+//                 with a color gradient across it
+//
+//               Both are rows of triangles on a lattice, and every vertex
+//               is an affine function of its lattice coordinates (u, v),
+//               for its position and for its color.  That makes them easy
+//               to vectorize: an SSE kernel works out 4 vertices at a time,
+//               and an AVX2 one 8, with a plain C++ kernel for everything
+//               else.  The kernel is picked at run time, from what the CPU
+//               says it supports, so the build doesn't need any special
+//               flags.  Every kernel gives exactly the same bytes.
+//
+//               The rows are shared out between threads, one per core,
+//               and since we know where each row starts, every thread
+//               writes its rows straight into the destination, which can
+//               be a mapped buffer.  The SIMD kernels use streaming stores
+//               there, which don't read the (write combined, uncached)
+//               memory first.
+//
+//============================================================================
+
+#ifndef MESH_GENERATOR_H
+#define MESH_GENERATOR_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <ostream>
+
+#include "VertexLayout.h"
+
+// How lattice coordinates (u, v), from 0 to 1, map to a vertex:
+//     position = origin + u * uAxis + v * vAxis
+//     color = color + u * uColor + v * vColor
+struct MeshPatch {
+    GLfloat origin[3];
+    GLfloat uAxis[3];
+    GLfloat vAxis[3];
+    GLfloat color[4];
+    GLfloat uColor[4];
+    GLfloat vColor[4];
+};
+
+class MeshGenerator {
+public:
+    enum Kernel {
+        KernelAuto = 0,  // the best one the CPU supports
+        KernelScalar,
+        KernelSSE,
+        KernelAVX2
+    };
+
+    MeshGenerator();
+
+    // Falls back to the best supported kernel if this one isn't
+    void SetKernel(Kernel kernel);
+
+    // 0 means one per core
+    void SetThreads(int threads);
+
+    Kernel ActiveKernel() const { return kernel; }
+    int Threads() const { return threads; }
+
+    // The patch for a triangle with these corners (3 floats each) and
+    // corner colors (RGB, 3 floats each).  A is at (0, 0), B at (1, 0) and
+    // C at (0, 1).
+    static MeshPatch TrianglePatch(const GLfloat positions[9],
+                                   const GLfloat colors[9]);
+
+    // The patch for a rectangle from (left, bottom) to (right, top), with
+    // the given colors at the bottom left, bottom right and top left
+    static MeshPatch RectanglePatch(GLfloat left, GLfloat bottom,
+                                    GLfloat right, GLfloat top,
+                                    const GLfloat colors[9]);
+
+    static long long TriangleVertexCount(int subdivisions);
+    static long long GridVertexCount(int columns, int rows);
+
+    // Write the vertices of a triangle list to out, which must have room
+    // for TriangleVertexCount() or GridVertexCount() of them.
+    void GenerateTriangle(const MeshPatch &patch, int subdivisions,
+                          ColorVertex *out) const;
+    void GenerateGrid(const MeshPatch &patch, int columns, int rows,
+                      ColorVertex *out) const;
+
+    // The same, straight into the buffer bound to GL_ARRAY_BUFFER, which
+    // is reallocated to fit, mapped, filled and unmapped.
+    // Returns false if the buffer couldn't be mapped or filled.
+    bool UploadTriangle(const MeshPatch &patch, int subdivisions,
+                        GLenum usage) const;
+    bool UploadGrid(const MeshPatch &patch, int columns, int rows,
+                    GLenum usage) const;
+
+    static bool KernelSupported(Kernel kernel);
+    static const char *KernelName(Kernel kernel);
+
+    // Time every kernel on 1 thread and on every core, for a triangle with
+    // this many subdivisions, into system memory and, if mapBuffers is set
+    // (which needs a current context), into a mapped vertex buffer.
+    static void Benchmark(std::ostream &out, int subdivisions,
+                          bool mapBuffers);
+
+private:
+    struct Shape;
+
+    void Generate(const Shape &shape, ColorVertex *out) const;
+    bool Upload(const Shape &shape, long long vertexCount,
+                GLenum usage) const;
+
+    static Shape TriangleShape(const MeshPatch &patch, int subdivisions);
+    static Shape GridShape(const MeshPatch &patch, int columns, int rows);
+
+    Kernel kernel;
+    int threads;
+};
+
+#endif // MESH_GENERATOR_H
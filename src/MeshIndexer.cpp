@@ -0,0 +1,319 @@
+//============================================================================
+// Name        : MeshIndexer.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Welds a triangle list into an indexed mesh, and reorders it
+//               for the vertex cache, with Tipsify.
+//
+//============================================================================
+
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <unordered_map>
+
+#include "MeshIndexer.h"
+
+// A vertex's 16 bytes, compared and hashed as they are, so vertices that
+// were worked out the same way weld, and anything else doesn't
+struct VertexKey {
+    uint64_t low;
+    uint64_t high;
+
+    bool operator==(const VertexKey &other) const
+    {
+        return low == other.low && high == other.high;
+    }
+};
+
+struct VertexKeyHash {
+    size_t operator()(const VertexKey &key) const
+    {
+        uint64_t hash = key.low * 0x9E3779B97F4A7C15ull;
+        hash ^= key.high + 0x7F4A7C159E3779B9ull + (hash << 6) + (hash >> 2);
+        return static_cast<size_t>(hash ^ (hash >> 32));
+    }
+};
+
+static_assert(sizeof(VertexKey) == sizeof(ColorVertex),
+              "A VertexKey should be exactly one ColorVertex");
+
+MeshIndexer::MeshIndexer()
+    : triangleVertices(0),
+      order(OrderNone),
+      cacheSize(DefaultCacheSize),
+      weldMs(0.0),
+      optimizeMs(0.0),
+      weldedRatio(0.0),
+      optimizedRatio(0.0)
+{
+}
+
+void MeshIndexer::Weld(const ColorVertex *triangles, long long count)
+{
+    std::chrono::steady_clock::time_point begin =
+        std::chrono::steady_clock::now();
+
+    triangleVertices = count;
+    vertices.clear();
+    indices.clear();
+    indices.reserve(static_cast<size_t>(count));
+
+    // Note: a lattice shares most vertices 6 ways, so this is plenty
+    std::unordered_map<VertexKey, GLuint, VertexKeyHash> seen;
+    seen.reserve(static_cast<size_t>(count / 4 + 16));
+
+    for (long long i = 0; i < count; i++) {
+        VertexKey key;
+        std::memcpy(&key, &triangles[i], sizeof(key));
+
+        std::pair<std::unordered_map<VertexKey, GLuint,
+                                     VertexKeyHash>::iterator, bool>
+            inserted = seen.insert(std::make_pair(
+                           key, static_cast<GLuint>(vertices.size())));
+
+        if (inserted.second)
+            vertices.push_back(triangles[i]);
+
+        indices.push_back(inserted.first->second);
+    }
+
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - begin;
+    weldMs = elapsed.count();
+}
+
+void MeshIndexer::Optimize(Order newOrder, int newCacheSize)
+{
+    order = newOrder;
+    cacheSize = newCacheSize > 0 ? newCacheSize : DefaultCacheSize;
+
+    weldedRatio = CacheMissRatio(cacheSize);
+
+    std::chrono::steady_clock::time_point begin =
+        std::chrono::steady_clock::now();
+
+    if (order == OrderTipsify) {
+        Tipsify(cacheSize);
+        RenumberVertices();
+    }
+
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - begin;
+    optimizeMs = elapsed.count();
+
+    optimizedRatio = CacheMissRatio(cacheSize);
+}
+
+GLenum MeshIndexer::IndexType() const
+{
+    return vertices.size() <= 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+void MeshIndexer::WriteIndices(void *out) const
+{
+    if (IndexType() == GL_UNSIGNED_INT) {
+        std::memcpy(out, indices.data(), indices.size() * sizeof(GLuint));
+        return;
+    }
+
+    GLushort *shorts = static_cast<GLushort *>(out);
+    for (size_t i = 0; i < indices.size(); i++)
+        shorts[i] = static_cast<GLushort>(indices[i]);
+}
+
+void MeshIndexer::Upload(GLenum usage) const
+{
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(ColorVertex),
+                 vertices.data(), usage);
+
+    if (IndexType() == GL_UNSIGNED_INT) {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint),
+                     indices.data(), usage);
+        return;
+    }
+
+    std::vector<GLushort> shorts(indices.size());
+    WriteIndices(shorts.data());
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, shorts.size() * sizeof(GLushort),
+                 shorts.data(), usage);
+}
+
+const char *MeshIndexer::OrderName(Order order)
+{
+    switch (order) {
+    case OrderTipsify:
+        return "tipsify";
+    case OrderNone:
+    default:
+        return "none";
+    }
+}
+
+double MeshIndexer::CacheMissRatio(int size) const
+{
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return 0.0;
+
+    // A vertex is in the cache if fewer than size others were shaded
+    // (missed) after it.  Everything starts out long gone.
+    std::vector<long long> shadedAt(vertices.size(), -1LL - size);
+    long long misses = 0;
+
+    for (size_t i = 0; i < indices.size(); i++) {
+        GLuint v = indices[i];
+        if (misses - shadedAt[v] > size) {
+            shadedAt[v] = misses;
+            misses++;
+        }
+    }
+
+    return static_cast<double>(misses) / triangleCount;
+}
+
+void MeshIndexer::Tipsify(int size)
+{
+    size_t vertexCount = vertices.size();
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return;
+
+    // the triangles around each vertex, vertex v's from
+    // adjacent[firstAdjacent[v]] up to adjacent[firstAdjacent[v + 1]]
+    std::vector<GLuint> firstAdjacent(vertexCount + 1, 0);
+    for (size_t i = 0; i < indices.size(); i++)
+        firstAdjacent[indices[i] + 1]++;
+    for (size_t v = 0; v < vertexCount; v++)
+        firstAdjacent[v + 1] += firstAdjacent[v];
+
+    std::vector<GLuint> adjacent(indices.size());
+    std::vector<GLuint> filled(firstAdjacent.begin(), firstAdjacent.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++)
+        adjacent[filled[indices[i]]++] = static_cast<GLuint>(i / 3);
+
+    // how many triangles around each vertex are still to come, and when
+    // it went into the cache, as a count of the vertices shaded before it
+    std::vector<int> live(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++)
+        live[v] = static_cast<int>(firstAdjacent[v + 1] - firstAdjacent[v]);
+
+    std::vector<long long> shadedAt(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+
+    std::vector<GLuint> deadEnds;       // recent vertices, to fall back on
+    std::vector<GLuint> candidates;     // the vertices of the last fan
+    std::vector<GLuint> reordered;
+    reordered.reserve(indices.size());
+
+    long long time = size + 1;
+    size_t cursor = 0;                  // the last resort, in input order
+    long long fan = 0;
+
+    while (fan >= 0) {
+        // emit every triangle left around the fanning vertex
+        candidates.clear();
+
+        for (GLuint a = firstAdjacent[fan]; a < firstAdjacent[fan + 1]; a++) {
+            GLuint t = adjacent[a];
+            if (emitted[t])
+                continue;
+
+            for (int c = 0; c < 3; c++) {
+                GLuint v = indices[t * 3 + c];
+
+                reordered.push_back(v);
+                deadEnds.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+
+                if (time - shadedAt[v] > size)
+                    shadedAt[v] = time++;
+            }
+
+            emitted[t] = true;
+        }
+
+        // Fan around the candidate that will still be in the cache when
+        // its own fan is done, and has been in it the longest; that is
+        // the one that would drop out first.
+        fan = -1;
+        long long best = -1;
+
+        for (size_t i = 0; i < candidates.size(); i++) {
+            GLuint v = candidates[i];
+            if (live[v] <= 0)
+                continue;
+
+            long long priority = 0;
+            if (time - shadedAt[v] + 2 * live[v] <= size)
+                priority = time - shadedAt[v];
+
+            if (priority > best) {
+                best = priority;
+                fan = v;
+            }
+        }
+
+        // Note: a dead end, nothing around us is left, so we go back to
+        //       the most recent vertex that has something left, or else
+        //       the next one in the input.
+        while (fan < 0 && !deadEnds.empty()) {
+            GLuint v = deadEnds.back();
+            deadEnds.pop_back();
+            if (live[v] > 0)
+                fan = v;
+        }
+
+        while (fan < 0 && cursor < vertexCount) {
+            if (live[cursor] > 0)
+                fan = static_cast<long long>(cursor);
+            cursor++;
+        }
+    }
+
+    indices.swap(reordered);
+}
+
+void MeshIndexer::RenumberVertices()
+{
+    std::vector<GLuint> renumbered(vertices.size(), UINT_MAX);
+    std::vector<ColorVertex> ordered;
+    ordered.reserve(vertices.size());
+
+    for (size_t i = 0; i < indices.size(); i++) {
+        GLuint &v = indices[i];
+
+        if (renumbered[v] == UINT_MAX) {
+            renumbered[v] = static_cast<GLuint>(ordered.size());
+            ordered.push_back(vertices[v]);
+        }
+
+        v = renumbered[v];
+    }
+
+    vertices.swap(ordered);
+}
+
+void MeshIndexer::Report(std::ostream &out) const
+{
+    out << std::fixed << std::setprecision(3)
+        << "Indexed mesh: " << triangleVertices << " vertices welded to "
+        << vertices.size() << " in " << weldMs << " ms, "
+        << (IndexType() == GL_UNSIGNED_INT ? 32 : 16) << " bit indices"
+        << std::endl
+        << "    ACMR with a " << cacheSize << " vertex cache: 3.000 "
+        << "unindexed, " << weldedRatio << " indexed";
+
+    if (order != OrderNone) {
+        out << ", " << optimizedRatio << " after " << OrderName(order)
+            << " (" << optimizeMs << " ms)";
+    }
+    out << std::endl;
+
+    out.unsetf(std::ios_base::floatfield);
+    out << std::setprecision(6);
+}
@@ -0,0 +1,111 @@
+//============================================================================
+// Name        : MeshIndexer.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Turns a generated triangle list into an indexed mesh, in an
+//               order that suits the GPU's vertex cache.
+//
+//               The MeshGenerator writes every triangle with its own 3
+//               vertices, for glDrawArrays().  On a lattice nearly every
+//               vertex is shared by 6 triangles, so it is stored, fetched
+//               and run through the vertex shader 6 times over.
+//
+//               Weld() finds the identical vertices, keeps one of each,
+//               and makes an index list that points at them, which is
+//               drawn with glDrawElements(), in 16 bit indices if there
+//               are few enough vertices, and 32 bit ones if not.
+//
+//               An index only saves shading a vertex again if the vertex
+//               is still in the post-transform cache, a small FIFO of the
+//               last vertices shaded.  The generator's order is row by
+//               row, and a row of a big mesh is far longer than the cache,
+//               so each vertex is shaded once on its own row, and again
+//               on the next one.  Optimize() reorders the triangles with
+//               Tipsify (Sander, Nehab and Barczak, "Fast Triangle
+//               Reordering for Vertex Locality and Reduced Overdraw",
+//               2007): it fans around one vertex at a time, and moves on to
+//               the neighbour that is most likely still in the cache.  The
+//               vertices are then renumbered in the order they are first
+//               used, so the fetches walk through the vertex buffer.
+//
+//               The average cache miss ratio (ACMR) is the number of
+//               vertices shaded per triangle, with a FIFO cache of the
+//               given size: 3 for a plain triangle list, and 0.5 at best
+//               for a big lattice.  Report() gives it before and after.
+//               This all runs once, before the first frame, or once for
+//               good with --save-mesh.
+//
+//============================================================================
+
+#ifndef MESH_INDEXER_H
+#define MESH_INDEXER_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <ostream>
+#include <vector>
+
+#include "VertexLayout.h"
+
+class MeshIndexer {
+public:
+    enum Order {
+        OrderNone = 0,      // the order the triangles came in
+        OrderTipsify
+    };
+
+    static const int DefaultCacheSize = 16;
+
+    MeshIndexer();
+
+    // Keep one of each distinct vertex of the triangle list, and index
+    // them, in the same triangle order.
+    void Weld(const ColorVertex *triangles, long long count);
+
+    // Reorder the triangles for a vertex cache of cacheSize vertices, and
+    // the vertices in the order they are first used
+    void Optimize(Order order, int cacheSize);
+
+    const std::vector<ColorVertex> &Vertices() const { return vertices; }
+    long long VertexCount() const { return vertices.size(); }
+    long long IndexCount() const { return indices.size(); }
+
+    // GL_UNSIGNED_SHORT if every index fits in 16 bits, or GL_UNSIGNED_INT
+    GLenum IndexType() const;
+
+    // write the indices to out, as IndexType()
+    void WriteIndices(void *out) const;
+
+    // Upload the vertices into the buffer bound to GL_ARRAY_BUFFER, and
+    // the indices into the one bound to GL_ELEMENT_ARRAY_BUFFER
+    void Upload(GLenum usage) const;
+
+    static const char *OrderName(Order order);
+
+    void Report(std::ostream &out) const;
+
+private:
+    MeshIndexer(const MeshIndexer &);
+    MeshIndexer &operator=(const MeshIndexer &);
+
+    // vertices shaded per triangle, with a FIFO cache of cacheSize
+    double CacheMissRatio(int cacheSize) const;
+
+    void Tipsify(int cacheSize);
+    void RenumberVertices();
+
+    std::vector<ColorVertex> vertices;
+    std::vector<GLuint> indices;
+
+    long long triangleVertices;     // in the list we were given
+    Order order;
+    int cacheSize;
+    double weldMs;
+    double optimizeMs;
+    double weldedRatio;             // ACMR in the triangle list's order
+    double optimizedRatio;
+};
+
+#endif // MESH_INDEXER_H
@@ -0,0 +1,109 @@
+//============================================================================
+// Name        : MpscQueue.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : A fixed size, lock-free queue for any number of producer
+//               threads and exactly one consumer thread.
+//
+//               Unlike the SpscQueue, producers race each other for the
+//               tail, so each one claims a slot with a compare and swap
+//               first, and only then fills it in.  Each slot has a
+//               sequence number that says whose turn it is: it equals the
+//               index a producer may claim it at, index + 1 once the item
+//               is in, and index + Capacity once the consumer has taken it,
+//               which is the next producer's turn, one lap later.  So a
+//               producer that claimed a slot but hasn't filled it yet only
+//               holds up the consumer, never another producer, and nobody
+//               ever locks.
+//
+//               The indexes only ever count up, and wrap around the ring
+//               with a mask, as in the SpscQueue.
+//
+//============================================================================
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+template <typename T, size_t Capacity>
+class MpscQueue {
+public:
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "MpscQueue capacity must be a power of two");
+
+    MpscQueue()
+        : head(0),
+          tail(0)
+    {
+        for (size_t i = 0; i < Capacity; i++)
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // Any thread.  Returns false, without waiting, if the queue is full.
+    bool Push(const T &item)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        Slot *slot;
+
+        for (;;) {
+            slot = &slots[t & Mask];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+
+            if (sequence == t) {
+                // our turn, if no other producer gets there first
+                if (tail.compare_exchange_weak(t, t + 1,
+                                               std::memory_order_relaxed))
+                    break;
+            }
+            else if (sequence < t) {
+                // still a lap behind: the consumer hasn't taken it yet
+                return false;
+            }
+            else {
+                // another producer claimed it, try the next one
+                t = tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->item = item;
+        slot->sequence.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only.  Returns false, without waiting, if the queue is
+    // empty, or the oldest item is still being filled in.
+    bool Pop(T &item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        Slot &slot = slots[h & Mask];
+
+        if (slot.sequence.load(std::memory_order_acquire) != h + 1)
+            return false;
+
+        item = slot.item;
+        slot.sequence.store(h + Capacity, std::memory_order_release);
+        head.store(h + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    MpscQueue(const MpscQueue &);
+    MpscQueue &operator=(const MpscQueue &);
+
+    static const size_t Mask = Capacity - 1;
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    // Note: as in the SpscQueue, the indexes get a cache line each
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+    alignas(64) Slot slots[Capacity];
+};
+
+#endif // MPSC_QUEUE_H
@@ -0,0 +1,174 @@
+//============================================================================
+// Name        : Pipeline.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : A shader program, a vertex array and its buffers, drawn
+//               together.
+//
+//============================================================================
+
+#include <utility>
+
+#include "Pipeline.h"
+#include "GLStateCache.h"
+
+Pipeline::Pipeline()
+    : count(0),
+      indexType(0),
+      stride(0),
+      viewLocation(-1),
+      shared(nullptr)
+{
+    view[0] = view[1] = 1.0f;
+    view[2] = view[3] = 0.0f;
+}
+
+void Pipeline::Create()
+{
+    vertexArray = GLVertexArray::Create();
+    vertexBuffer = GLBuffer::Create();
+}
+
+void Pipeline::SetProgram(GLProgram &&program)
+{
+    this->program = std::move(program);
+
+    viewLocation = this->program ?
+                   glGetUniformLocation(this->program.Get(), "view") : -1;
+}
+
+void Pipeline::CreateView(const Pipeline &viewed)
+{
+    shared = &viewed;
+    viewLocation = viewed.viewLocation;
+    vertexArray = GLVertexArray::Create();
+
+    // Note: this is behind the state cache's back, like all our setup
+    glBindVertexArray(vertexArray.Get());
+    glBindBuffer(GL_ARRAY_BUFFER, viewed.VertexBuffer());
+
+    viewed.Format().PointAttributes();
+    viewed.Format().EnableAttributes();
+
+    // the index buffer binding is part of the vertex array, so it stays
+    if (viewed.IndexBuffer() != 0)
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, viewed.IndexBuffer());
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+GLuint Pipeline::CreateIndexBuffer()
+{
+    if (!indexBuffer)
+        indexBuffer = GLBuffer::Create();
+
+    return indexBuffer.Get();
+}
+
+void Pipeline::SetCount(GLsizei count, GLenum indexType)
+{
+    this->count = count;
+    this->indexType = indexType;
+}
+
+void Pipeline::SetFormat(const VertexFormat &format)
+{
+    attributes.assign(format.Attributes(),
+                      format.Attributes() + format.AttributeCount());
+    for (size_t i = 0; i < attributes.size(); i++)
+        attributes[i].name = nullptr;
+
+    stride = format.Stride();
+}
+
+VertexFormat Pipeline::Format() const
+{
+    return VertexFormat::Of(attributes.data(),
+                            static_cast<int>(attributes.size()), stride);
+}
+
+void Pipeline::SetView(const GLfloat newView[4])
+{
+    for (int i = 0; i < 4; i++)
+        view[i] = newView[i];
+}
+
+GLuint Pipeline::Program() const
+{
+    return shared != nullptr ? shared->Program() : program.Get();
+}
+
+GLuint Pipeline::VertexBuffer() const
+{
+    return shared != nullptr ? shared->VertexBuffer() : vertexBuffer.Get();
+}
+
+GLuint Pipeline::IndexBuffer() const
+{
+    return shared != nullptr ? shared->IndexBuffer() : indexBuffer.Get();
+}
+
+GLsizei Pipeline::Count() const
+{
+    return shared != nullptr ? shared->Count() : count;
+}
+
+GLenum Pipeline::IndexType() const
+{
+    return shared != nullptr ? shared->IndexType() : indexType;
+}
+
+void Pipeline::Bind() const
+{
+    GLStateCache &state = GLStateCache::Current();
+
+    state.UseProgram(Program());
+    state.BindVertexArray(vertexArray.Get());
+
+    // Note: the program may be shared with other contexts, which set
+    //       their own views, so we set ours every time
+    if (viewLocation >= 0)
+        glUniform4fv(viewLocation, 1, view);
+
+    // Note: we used to unbind the vertex array after drawing, to prevent
+    //       strange bugs.  The state cache knows what is bound, so we
+    //       leave it, and don't pay to bind it again next frame.
+}
+
+void Pipeline::DrawRange(GLint first, GLsizei rangeCount) const
+{
+    GLenum type = IndexType();
+
+    if (type != 0) {
+        GLintptr offset = static_cast<GLintptr>(first) *
+                          (type == GL_UNSIGNED_SHORT ? 2 : 4);
+        glDrawElements(GL_TRIANGLES, rangeCount, type,
+                       reinterpret_cast<const GLvoid *>(offset));
+    }
+    else {
+        glDrawArrays(GL_TRIANGLES, first, rangeCount);
+    }
+}
+
+void Pipeline::Draw() const
+{
+    Bind();
+    DrawRange(0, Count());
+}
+
+void Pipeline::Destroy()
+{
+    program.Reset();
+    vertexArray.Reset();
+    vertexBuffer.Reset();
+    indexBuffer.Reset();
+
+    count = 0;
+    indexType = 0;
+    attributes.clear();
+    stride = 0;
+    viewLocation = -1;
+    shared = nullptr;
+}
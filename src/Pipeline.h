@@ -0,0 +1,118 @@
+//============================================================================
+// Name        : Pipeline.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Everything one draw call needs: the shader program, the
+//               vertex array, and the buffers it reads from.
+//
+//               The demos each used to keep a handful of GLuints for this,
+//               bind them by hand every frame, and delete them (or not) at
+//               the end of main().  A Pipeline owns them all, as GLHandles,
+//               and draws with them through the state cache, with
+//               glDrawElements() if it has an index buffer, and
+//               glDrawArrays() if it doesn't.
+//
+//               The vertex array and vertex buffer are made by Create(),
+//               and the index buffer only when somebody asks for it.  The
+//               program is usually still being compiled by then, so it is
+//               handed over later, with SetProgram().
+//
+//               Contexts that share objects share programs and buffers,
+//               but not vertex arrays.  So another window's context draws
+//               the same geometry through a view, made by CreateView(),
+//               which owns only a vertex array of its own, pointed into the
+//               buffers of the pipeline it views, with the same format.
+//
+//============================================================================
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <vector>
+
+#include "GLHandle.h"
+#include "VertexLayout.h"
+
+class Pipeline {
+public:
+    Pipeline();
+
+    // make the vertex array and the vertex buffer.  Needs a context.
+    void Create();
+
+    // A view of shared, for another context that shares its objects: a
+    // vertex array of our own, set up like shared's.  Needs the other
+    // context current, and shared set up completely, with its format.
+    // shared must outlive the view.
+    void CreateView(const Pipeline &shared);
+
+    void SetProgram(GLProgram &&program);
+
+    // The index buffer, which is made the first time it is asked for.
+    // Note: bind it while the vertex array is bound, since the index
+    //       buffer binding is part of the vertex array.
+    GLuint CreateIndexBuffer();
+
+    // what Draw() draws: count vertices, or count indices of indexType
+    // (GL_UNSIGNED_SHORT or GL_UNSIGNED_INT) if indexType isn't 0
+    void SetCount(GLsizei count, GLenum indexType = 0);
+
+    // remember the layout of the vertex buffer, for the views
+    void SetFormat(const VertexFormat &format);
+    VertexFormat Format() const;
+
+    // The 2D view transform, for programs with a "uniform vec4 view":
+    // scale in xy, then offset in zw.  The default is {1, 1, 0, 0}.
+    void SetView(const GLfloat view[4]);
+    const GLfloat *View() const { return view; }
+
+    // a view's program and buffers are the ones it views
+    GLuint Program() const;
+    GLuint VertexArray() const { return vertexArray.Get(); }
+    GLuint VertexBuffer() const;
+    GLuint IndexBuffer() const;
+    GLsizei Count() const;
+    GLenum IndexType() const;
+
+    // Use the program and bind the vertex array, through the state cache,
+    // and set the view
+    void Bind() const;
+
+    // Draw count vertices (or indices) from first on, once bound
+    void DrawRange(GLint first, GLsizei count) const;
+
+    // Bind(), and draw everything
+    void Draw() const;
+
+    // delete everything, while the context is still current
+    void Destroy();
+
+private:
+    Pipeline(const Pipeline &);
+    Pipeline &operator=(const Pipeline &);
+
+    GLProgram program;
+    GLVertexArray vertexArray;
+    GLBuffer vertexBuffer;
+    GLBuffer indexBuffer;
+
+    GLsizei count;
+    GLenum indexType;
+
+    // Note: the attribute names are dropped, they only matter before
+    //       linking, and may not outlive the format they came from
+    std::vector<VertexAttribute> attributes;
+    GLsizei stride;
+
+    GLfloat view[4];
+    GLint viewLocation;     // -1 if the program has no view
+
+    // the pipeline we view, or nullptr
+    const Pipeline *shared;
+};
+
+#endif // PIPELINE_H
@@ -0,0 +1,439 @@
+//============================================================================
+// Name        : ProgramCache.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Builds our shader programs, keeping the linked binaries
+//               on disk so that the next launch can skip compiling them.
+//
+//============================================================================
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "DebugLog.h"
+#include "FileUtil.h"
+#include "ProgramCache.h"
+
+// every cache file starts with this, followed by the binary itself
+struct CacheFileHeader {
+    char magic[4];
+    unsigned int version;
+    unsigned int binaryFormat;
+    unsigned int binaryLength;
+};
+
+static const char CacheMagic[4] = {'H', 'T', 'P', 'B'};
+static const unsigned int CacheVersion = 1;
+
+// 64 bit FNV-1a, which is plenty to tell our handful of programs apart
+static unsigned long long HashBytes(unsigned long long hash,
+                                    const void *data, size_t size)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+// hash a string, including its terminator, so that "ab" + "c"
+// doesn't hash the same as "a" + "bc"
+static unsigned long long HashString(unsigned long long hash, const char *text)
+{
+    if (text == nullptr)
+        text = "";
+
+    return HashBytes(hash, text, std::strlen(text) + 1);
+}
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// Log a shader's or a program's info log, however long the driver made it
+static void LogInfoLog(GLuint object, bool program)
+{
+    GLint length = 0;
+    if (program)
+        glGetProgramiv(object, GL_INFO_LOG_LENGTH, &length);
+    else
+        glGetShaderiv(object, GL_INFO_LOG_LENGTH, &length);
+
+    if (length <= 1)
+        return;
+
+    std::vector<GLchar> infoLog(length);
+    if (program)
+        glGetProgramInfoLog(object, length, nullptr, infoLog.data());
+    else
+        glGetShaderInfoLog(object, length, nullptr, infoLog.data());
+
+    LogText(infoLog.data());
+}
+
+ProgramCache::ProgramCache(const std::string &directory)
+    : directory(directory),
+      checkedSupport(false),
+      supported(false),
+      sequential(false),
+      checkedParallel(false),
+      parallelCompile(false),
+      waitMs(0.0)
+{
+}
+
+void ProgramCache::SetSequential(bool value)
+{
+    sequential = value;
+}
+
+void ProgramCache::EnableParallelCompile()
+{
+    if (checkedParallel)
+        return;
+
+    checkedParallel = true;
+
+    // Let the driver use as many compiler threads as it likes
+    if (GLL_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        parallelCompile = true;
+    }
+    else if (GLL_ARB_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+        parallelCompile = true;
+    }
+}
+
+std::string ProgramCache::DefaultDirectory()
+{
+    const char *cacheHome = std::getenv("XDG_CACHE_HOME");
+    if (cacheHome != nullptr && cacheHome[0] != '\0')
+        return std::string(cacheHome) + "/hello_triangle";
+
+    const char *home = std::getenv("HOME");
+    if (home != nullptr && home[0] != '\0')
+        return std::string(home) + "/.cache/hello_triangle";
+
+    // nowhere sensible to put it
+    return std::string();
+}
+
+bool ProgramCache::Supported()
+{
+    // we can't ask until there is a context, so we ask the first time
+    // we build a program.
+    if (!checkedSupport) {
+        checkedSupport = true;
+
+        if (!directory.empty() &&
+                (GLL_VERSION_4_1 || GLL_ARB_get_program_binary)) {
+            GLint formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+            supported = formats > 0 && MakeDirectories(directory);
+        }
+
+        if (!directory.empty() && !supported) {
+            Log("Program binaries are not supported here, "
+                "shaders will always be compiled");
+        }
+    }
+
+    return supported;
+}
+
+std::string ProgramCache::CachePath(const GLchar *vertexSource,
+                                    const GLchar *fragmentSource,
+                                    const AttributeBinding *attributes,
+                                    int attributeCount) const
+{
+    unsigned long long hash = 14695981039346656037ULL;
+
+    hash = HashString(hash, vertexSource);
+    hash = HashString(hash, fragmentSource);
+
+    for (int i = 0; i < attributeCount; i++) {
+        hash = HashBytes(hash, &attributes[i].location, sizeof(GLuint));
+        hash = HashString(hash, attributes[i].name);
+    }
+
+    hash = HashString(hash, (const char *)glGetString(GL_VENDOR));
+    hash = HashString(hash, (const char *)glGetString(GL_RENDERER));
+    hash = HashString(hash, (const char *)glGetString(GL_VERSION));
+
+    std::ostringstream path;
+    path << directory << "/" << std::hex << std::setw(16)
+         << std::setfill('0') << hash << ".bin";
+
+    return path.str();
+}
+
+GLuint ProgramCache::LoadBinary(const std::string &path)
+{
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file)
+        return 0;
+
+    CacheFileHeader header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        return 0;
+
+    if (std::memcmp(header.magic, CacheMagic, sizeof(CacheMagic)) != 0 ||
+            header.version != CacheVersion || header.binaryLength == 0)
+        return 0;
+
+    std::vector<char> binary(header.binaryLength);
+    if (!file.read(binary.data(), binary.size()))
+        return 0;
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, header.binaryFormat, binary.data(),
+                    static_cast<GLsizei>(binary.size()));
+
+    // The driver can turn the binary down for any reason it likes, e.g.
+    // it was updated in place without the version string changing.
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    return program;
+}
+
+void ProgramCache::SaveBinary(const std::string &path, GLuint program)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    CacheFileHeader header;
+    std::memcpy(header.magic, CacheMagic, sizeof(CacheMagic));
+    header.version = CacheVersion;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+    header.binaryFormat = format;
+    header.binaryLength = static_cast<unsigned int>(length);
+
+    // Write to a temporary file first, and rename it into place, so that
+    // a second instance starting up never reads half a binary.
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath.c_str(), std::ios::binary);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(binary.data(), binary.size());
+
+        if (!file) {
+            std::remove(tempPath.c_str());
+            return;
+        }
+    }
+
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0)
+        std::remove(tempPath.c_str());
+}
+
+int ProgramCache::Submit(const char *name,
+                         const GLchar *vertexSource,
+                         const GLchar *fragmentSource,
+                         const AttributeBinding *attributes,
+                         int attributeCount)
+{
+    PendingProgram request;
+    request.name = name;
+    request.program = 0;
+    request.fromCache = false;
+    request.finished = false;
+    request.submitted = Clock::now();
+
+    if (Supported()) {
+        request.path = CachePath(vertexSource, fragmentSource,
+                                 attributes, attributeCount);
+        request.program = LoadBinary(request.path);
+        request.fromCache = request.program != 0;
+    }
+
+    if (!request.fromCache) {
+        if (!sequential)
+            EnableParallelCompile();
+
+        // Note: some drivers compile right here, in glLinkProgram(), so
+        //       this counts as time spent waiting on the compiler too.
+        Clock::time_point submitStart = Clock::now();
+        SubmitCompile(request, vertexSource, fragmentSource,
+                      attributes, attributeCount, !request.path.empty());
+        waitMs += MillisecondsSince(submitStart);
+    }
+
+    pending.push_back(std::move(request));
+    int handle = static_cast<int>(pending.size()) - 1;
+
+    // the old way, everything finished before we move on
+    if (sequential)
+        Wait(handle);
+
+    return handle;
+}
+
+bool ProgramCache::Ready(int handle)
+{
+    PendingProgram &request = pending[handle];
+
+    if (request.finished || request.fromCache)
+        return true;
+
+    if (!parallelCompile)
+        return false;
+
+    // Note: GL_COMPLETION_STATUS_ARB has the same value
+    GLint complete = GL_FALSE;
+    glGetProgramiv(request.program, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete == GL_TRUE;
+}
+
+GLuint ProgramCache::Wait(int handle)
+{
+    PendingProgram &request = pending[handle];
+
+    if (request.finished)
+        return request.program;
+
+    request.finished = true;
+
+    Clock::time_point waitStart = Clock::now();
+    bool success = request.fromCache || CheckCompile(request);
+    waitMs += MillisecondsSince(waitStart);
+
+    if (!success) {
+        request.program = 0;
+        return 0;
+    }
+
+    if (request.fromCache) {
+        Log("Program '%s': cache hit, loaded in %g ms",
+            request.name.c_str(), MillisecondsSince(request.submitted));
+    }
+    else {
+        if (!request.path.empty())
+            SaveBinary(request.path, request.program);
+
+        Log("Program '%s': %s%s %g ms", request.name.c_str(),
+            request.path.empty() ? "" : "cache miss, ",
+            sequential ? "compiled in" : "ready after",
+            MillisecondsSince(request.submitted));
+    }
+
+    return request.program;
+}
+
+GLuint ProgramCache::BuildProgram(const char *name,
+                                  const GLchar *vertexSource,
+                                  const GLchar *fragmentSource,
+                                  const AttributeBinding *attributes,
+                                  int attributeCount)
+{
+    return Wait(Submit(name, vertexSource, fragmentSource,
+                       attributes, attributeCount));
+}
+
+void ProgramCache::SubmitCompile(PendingProgram &request,
+                                 const GLchar *vertexSource,
+                                 const GLchar *fragmentSource,
+                                 const AttributeBinding *attributes,
+                                 int attributeCount,
+                                 bool retrievable)
+{
+    // setup a basic vertex shader
+    request.vertexShader = GLShader(glCreateShader(GL_VERTEX_SHADER));
+    glShaderSource(request.vertexShader.Get(), 1, &vertexSource, NULL);
+    glCompileShader(request.vertexShader.Get());
+
+    // setup a basic fragment shader
+    request.fragmentShader = GLShader(glCreateShader(GL_FRAGMENT_SHADER));
+    glShaderSource(request.fragmentShader.Get(), 1, &fragmentSource, NULL);
+    glCompileShader(request.fragmentShader.Get());
+
+    // attach our shaders to a shader program
+    // Note: we don't check the compile status here, that would wait for
+    //       the compiler.  A failed compile shows up as a failed link.
+    GLuint program = glCreateProgram();
+
+    for (int i = 0; i < attributeCount; i++) {
+        glBindAttribLocation(program, attributes[i].location,
+                             attributes[i].name);
+    }
+
+    // ask the driver to keep the binary around, so that we can save it
+    if (retrievable) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                            GL_TRUE);
+    }
+
+    glAttachShader(program, request.vertexShader.Get());
+    glAttachShader(program, request.fragmentShader.Get());
+    glLinkProgram(program);
+
+    request.program = program;
+}
+
+bool ProgramCache::CheckCompile(PendingProgram &request)
+{
+    GLint linked;
+    GLint success;
+
+    // this is where we wait for the compiler, if it isn't done yet
+    glGetProgramiv(request.program, GL_LINK_STATUS, &linked);
+
+    if (!linked) {
+        // find out which stage went wrong
+        glGetShaderiv(request.vertexShader.Get(), GL_COMPILE_STATUS,
+                      &success);
+        if(!success) {
+            Log("ERROR::SHADER::VERTEX::COMPILATION_FAILED");
+            LogInfoLog(request.vertexShader.Get(), false);
+        }
+
+        glGetShaderiv(request.fragmentShader.Get(), GL_COMPILE_STATUS,
+                      &success);
+        if(!success) {
+            Log("ERROR::SHADER::FRAGMENT::COMPILATION_FAILED");
+            LogInfoLog(request.fragmentShader.Get(), false);
+        }
+
+        Log("ERROR::SHADER::PROGRAM::LINKING_FAILED");
+        LogInfoLog(request.program, true);
+    }
+
+    // once we have linked in our shaders,
+    // we don't need the local instances anymore.
+    request.vertexShader.Reset();
+    request.fragmentShader.Reset();
+
+    if (!linked) {
+        glDeleteProgram(request.program);
+        request.program = 0;
+        return false;
+    }
+
+    return true;
+}
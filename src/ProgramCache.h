@@ -0,0 +1,142 @@
+//============================================================================
+// Name        : ProgramCache.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Builds our shader programs, keeping the linked binaries
+//               on disk so that the next launch can skip compiling them.
+//
+//               With GL_ARB_get_program_binary (core in 4.1), once a
+//               program is linked we can ask the driver for the binary
+//               and save it.  Next time, glProgramBinary() hands it back,
+//               and there is nothing to compile or link.
+//
+//               The cache file name is a hash of the shader sources, the
+//               attribute bindings, and GL_VENDOR/GL_RENDERER/GL_VERSION,
+//               so a new driver or a different GPU never sees an old
+//               binary.  Even so, the driver is allowed to reject a binary
+//               at any time, in which case we quietly compile from source
+//               and replace it.
+//
+//               Programs that aren't in the cache are built in two steps.
+//               Submit() hands the sources to the driver and asks for the
+//               link, but doesn't ask how it went, and Wait() checks the
+//               status later.  Asking for GL_COMPILE_STATUS right after
+//               glCompileShader() would make us sit and wait for the
+//               compiler, so in between, we can create our buffers.  With
+//               GL_KHR_parallel_shader_compile, the driver compiles on its
+//               own threads, and we can ask GL_COMPLETION_STATUS_KHR whether
+//               a program is done without waiting for it.
+//
+//============================================================================
+
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "GLHandle.h"
+
+// Note: using OGL 3.3 or higher, we could put location information inside
+//       the GLSL code.  But Macs use OGL 3.2 and Linux can vary widely,
+//       so we bind our attribute locations before linking.
+struct AttributeBinding {
+    GLuint location;
+    const char *name;
+};
+
+class ProgramCache {
+public:
+    // An empty directory turns the cache off, and every program is
+    // compiled from source.
+    explicit ProgramCache(const std::string &directory);
+
+    // The directory we use when the user doesn't give us one:
+    // $XDG_CACHE_HOME/hello_triangle, or ~/.cache/hello_triangle
+    static std::string DefaultDirectory();
+
+    // Sequential mode builds each program completely in Submit(), the way
+    // we always used to, which is handy for comparing startup times.
+    void SetSequential(bool sequential);
+
+    // Start building a program, and return a handle for Wait().
+    // Must be called with a current context, after GLLoaderInit().
+    int Submit(const char *name,
+               const GLchar *vertexSource,
+               const GLchar *fragmentSource,
+               const AttributeBinding *attributes,
+               int attributeCount);
+
+    // True if Wait() would not block.  Without
+    // GL_KHR_parallel_shader_compile, we can't tell, so we say no.
+    bool Ready(int handle);
+
+    // Finish building a program.  Returns 0, after printing the info log,
+    // if the program could not be compiled or linked.
+    GLuint Wait(int handle);
+
+    // Submit() and Wait() in one go
+    GLuint BuildProgram(const char *name,
+                        const GLchar *vertexSource,
+                        const GLchar *fragmentSource,
+                        const AttributeBinding *attributes,
+                        int attributeCount);
+
+    // how long we spent blocked on the compiler, in Submit() or Wait(),
+    // in milliseconds
+    double WaitMilliseconds() const { return waitMs; }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct PendingProgram {
+        std::string name;
+        std::string path;
+        GLShader vertexShader;
+        GLShader fragmentShader;
+        GLuint program;
+        bool fromCache;
+        bool finished;
+        Clock::time_point submitted;
+    };
+
+    bool Supported();
+    void EnableParallelCompile();
+
+    // submit the compile and link, without asking how they went
+    static void SubmitCompile(PendingProgram &pending,
+                              const GLchar *vertexSource,
+                              const GLchar *fragmentSource,
+                              const AttributeBinding *attributes,
+                              int attributeCount,
+                              bool retrievable);
+
+    // now ask, and print the info logs if something went wrong
+    static bool CheckCompile(PendingProgram &pending);
+
+    std::string CachePath(const GLchar *vertexSource,
+                          const GLchar *fragmentSource,
+                          const AttributeBinding *attributes,
+                          int attributeCount) const;
+
+    GLuint LoadBinary(const std::string &path);
+    void SaveBinary(const std::string &path, GLuint program);
+
+    std::string directory;
+    bool checkedSupport;
+    bool supported;
+
+    bool sequential;
+    bool checkedParallel;
+    bool parallelCompile;
+
+    std::vector<PendingProgram> pending;
+    double waitMs;
+};
+
+#endif // PROGRAM_CACHE_H
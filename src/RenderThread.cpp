@@ -0,0 +1,303 @@
+//============================================================================
+// Name        : RenderThread.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Runs the render loop on its own thread, fed with state
+//               changes from the main thread through a lock-free queue.
+//
+//============================================================================
+
+#include <algorithm>
+#include <iomanip>
+
+#include "FrameBenchmark.h"
+#include "RenderThread.h"
+
+RenderThread::RenderThread()
+    : window(nullptr),
+      pacer(nullptr),
+      stateCache(nullptr),
+      redrawRequested(false),
+      running(false),
+      threaded(false),
+      posts(0),
+      dropped(0),
+      maxDepth(0),
+      depthTotal(0),
+      frames(0),
+      longestFrameMs(0.0)
+{
+    posted.width = posted.height = 0;
+    posted.paused = false;
+    initial = posted;
+}
+
+bool RenderThread::Start(GLFWwindow *renderWindow,
+                         const RenderState &state,
+                         FrameFunction frameFunction,
+                         FramePacer &framePacer)
+{
+    if (running)
+        return false;
+
+    window = renderWindow;
+    drawFrame = frameFunction;
+    pacer = &framePacer;
+    posted = initial = state;
+
+    // The state cache belongs with the context, so it moves threads with it
+    stateCache = &GLStateCache::Current();
+
+    // a context can only be current on one thread at a time
+    glfwMakeContextCurrent(nullptr);
+
+    running = true;
+    threaded = true;
+    thread = std::thread(&RenderThread::Run, this);
+
+    return true;
+}
+
+void RenderThread::RunOnMainThread(GLFWwindow *renderWindow,
+                                   const RenderState &state,
+                                   FrameFunction frameFunction,
+                                   FramePacer &framePacer)
+{
+    window = renderWindow;
+    posted = initial = state;
+
+    RenderState current = state;
+    bool dirty = true;
+
+    framePacer.Init();
+    framePacer.Begin();
+    Clock::time_point lastFrame = Clock::now();
+
+    while (!glfwWindowShouldClose(window)) {
+        // check input events(kbd, mouse, etc.)
+        // Note: while we are in here, nobody is rendering
+        if (framePacer.OnDemand() && !dirty && !redrawRequested) {
+            glfwWaitEvents();
+            lastFrame = Clock::now();
+        }
+        else {
+            glfwPollEvents();
+        }
+
+        dirty = dirty || redrawRequested;
+        redrawRequested = false;
+
+        if (framePacer.OnDemand() && !dirty)
+            continue;
+
+        Apply(current, posted);
+        current = posted;
+
+        framePacer.WaitForFrame(true);
+
+        dirty = frameFunction(current);
+        FrameDone(lastFrame);
+        framePacer.FrameDone();
+    }
+
+    framePacer.End();
+}
+
+bool RenderThread::Post(const RenderState &state)
+{
+    posted = state;
+
+    if (!running) {
+        redrawRequested = true;
+        return true;
+    }
+
+    Command command;
+    command.type = Command::CommandState;
+    command.state = state;
+    command.posted = Clock::now();
+
+    return Send(command);
+}
+
+void RenderThread::RequestRedraw()
+{
+    if (!running) {
+        redrawRequested = true;
+        return;
+    }
+
+    Command command;
+    command.type = Command::CommandRedraw;
+    command.state = posted;
+    command.posted = Clock::now();
+
+    Send(command);
+}
+
+bool RenderThread::Send(const Command &command)
+{
+    posts++;
+
+    if (!queue.Push(command)) {
+        dropped++;
+        return false;
+    }
+
+    // Note: taking the lock, even for nothing, means the render thread is
+    //       either not waiting yet (and will see the command), or already
+    //       waiting (and will get the notify), never in between.
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    wake.notify_one();
+
+    return true;
+}
+
+void RenderThread::Stop()
+{
+    if (!running)
+        return;
+
+    Command command;
+    command.type = Command::CommandQuit;
+    command.state = posted;
+    command.posted = Clock::now();
+
+    // we can't drop this one, so wait for room
+    while (!queue.Push(command))
+        std::this_thread::yield();
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    wake.notify_one();
+
+    thread.join();
+    running = false;
+
+    glfwMakeContextCurrent(window);
+}
+
+void RenderThread::Apply(const RenderState &previous, const RenderState &next)
+{
+    if (next.width != previous.width || next.height != previous.height)
+        glViewport(0, 0, next.width, next.height);
+}
+
+void RenderThread::Run()
+{
+    glfwMakeContextCurrent(window);
+    GLStateCache::SetCurrent(stateCache);
+
+    RenderState state = initial;
+    bool dirty = true;
+
+    pacer->Init();
+    pacer->Begin();
+    Clock::time_point lastFrame = Clock::now();
+
+    for (;;) {
+        if (pacer->OnDemand() && !dirty) {
+            WaitForCommand();
+            lastFrame = Clock::now();
+        }
+
+        if (!Drain(state, dirty))
+            break;
+
+        if (pacer->OnDemand() && !dirty)
+            continue;
+
+        pacer->WaitForFrame(false);
+
+        dirty = drawFrame(state);
+        FrameDone(lastFrame);
+        pacer->FrameDone();
+    }
+
+    pacer->End();
+
+    // let the main thread have the context back
+    GLStateCache::SetCurrent(nullptr);
+    glfwMakeContextCurrent(nullptr);
+}
+
+void RenderThread::FrameDone(Clock::time_point &lastFrame)
+{
+    Clock::time_point now = Clock::now();
+    std::chrono::duration<double, std::milli> elapsed = now - lastFrame;
+    lastFrame = now;
+
+    frames++;
+    if (frames > 1 && elapsed.count() > longestFrameMs)
+        longestFrameMs = elapsed.count();
+}
+
+void RenderThread::WaitForCommand()
+{
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    wake.wait(lock, [this]() { return queue.Size() > 0; });
+}
+
+bool RenderThread::Drain(RenderState &state, bool &dirty)
+{
+    size_t depth = queue.Size();
+    depthTotal += depth;
+    if (depth > maxDepth)
+        maxDepth = depth;
+
+    Command command;
+    while (queue.Pop(command)) {
+        std::chrono::duration<double, std::milli> latency =
+            Clock::now() - command.posted;
+        latencies.push_back(latency.count());
+
+        if (command.type == Command::CommandQuit)
+            return false;
+
+        Apply(state, command.state);
+        state = command.state;
+        dirty = true;
+    }
+
+    return true;
+}
+
+void RenderThread::Report(std::ostream &out) const
+{
+    if (frames == 0)
+        return;
+
+    std::vector<double> sorted(latencies);
+    std::sort(sorted.begin(), sorted.end());
+
+    double meanLatency = 0.0;
+    for (size_t i = 0; i < sorted.size(); i++)
+        meanLatency += sorted[i];
+    if (!sorted.empty())
+        meanLatency /= sorted.size();
+
+    out << std::fixed << std::setprecision(3)
+        << (threaded ? "Render thread: " : "Main thread: ") << frames
+        << " frames, longest frame " << longestFrameMs << " ms" << std::endl;
+
+    if (!threaded) {
+        out.unsetf(std::ios_base::floatfield);
+        out << std::setprecision(6);
+        return;
+    }
+
+    out << "    " << posts << " commands posted, " << dropped
+        << " dropped, queue depth " << maxDepth << " max, "
+        << static_cast<double>(depthTotal) / frames << " mean" << std::endl
+        << "    command latency " << meanLatency << " ms mean, "
+        << Percentile(sorted, 99.0) << " ms p99, "
+        << (sorted.empty() ? 0.0 : sorted.back()) << " ms max"
+        << std::endl;
+
+    out.unsetf(std::ios_base::floatfield);
+    out << std::setprecision(6);
+}
@@ -0,0 +1,168 @@
+//============================================================================
+// Name        : RenderThread.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Runs the render loop on its own thread, so that the main
+//               thread is free to handle window events.
+//
+//               GLFW wants its events handled on the main thread, and
+//               used to share it with all our rendering, so a slow event
+//               (a window move, a burst of input) held up the next frame.
+//               Now the render thread owns the GL context and draws as
+//               fast as it is allowed to, while the main thread sits in
+//               glfwWaitEvents().
+//
+//               The main thread never touches GL.  When something changes,
+//               it posts a snapshot of the new state through a lock-free
+//               single producer, single consumer queue, and the render
+//               thread picks it up before its next frame.  We keep track
+//               of how deep the queue gets, and how long each snapshot
+//               waited, to check that input is picked up promptly.
+//
+//               When the FramePacer says frames are on demand, the render
+//               thread sleeps until something is posted.  The queue itself
+//               never blocks, so a condition variable wakes it up.
+//
+//============================================================================
+
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+// GLFW
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include "FramePacer.h"
+#include "GLStateCache.h"
+#include "SpscQueue.h"
+
+// Everything the main thread tells the render thread about
+struct RenderState {
+    int width;
+    int height;
+    bool paused;
+};
+
+class RenderThread {
+public:
+    // Draws one frame, including the swap.  Returns true if the scene is
+    // animated, and the next frame will be different even if nothing
+    // is posted.
+    typedef std::function<bool(const RenderState &)> FrameFunction;
+
+    RenderThread();
+
+    // Must be called on the main thread, with the window's context current.
+    // The context moves to the render thread, which calls drawFrame when
+    // the pacer says so, until Stop() is called.
+    bool Start(GLFWwindow *window, const RenderState &initial,
+               FrameFunction drawFrame, FramePacer &pacer);
+
+    // The old way, for comparison: render on this thread, polling for
+    // events between frames, until the window should close.
+    void RunOnMainThread(GLFWwindow *window, const RenderState &initial,
+                         FrameFunction drawFrame, FramePacer &pacer);
+
+    // Main thread only.  Queue a new state for the render thread.
+    // Without a render thread, the state is just remembered, and picked
+    // up before the next frame.
+    // Returns false if the queue was full, and the state was dropped.
+    bool Post(const RenderState &state);
+
+    // Main thread only.  Draw a frame even though nothing changed,
+    // e.g. when the window has to be repainted.
+    void RequestRedraw();
+
+    // Main thread only.  Wait for the render thread to finish its frame
+    // and exit, and make the context current on this thread again.
+    void Stop();
+
+    bool Running() const { return running; }
+
+    // the last state given to Start() or Post()
+    const RenderState &PostedState() const { return posted; }
+
+    // Set the viewport, if the size changed between two states.
+    // Needs a current context.
+    static void Apply(const RenderState &previous, const RenderState &next);
+
+    // call after Stop(), or RunOnMainThread()
+    void Report(std::ostream &out) const;
+
+private:
+    RenderThread(const RenderThread &);
+    RenderThread &operator=(const RenderThread &);
+
+    typedef std::chrono::steady_clock Clock;
+
+    struct Command {
+        enum Type {
+            CommandState = 0,
+            CommandRedraw,
+            CommandQuit
+        };
+
+        Type type;
+        RenderState state;
+        Clock::time_point posted;
+    };
+
+    // Note: commands only come with input, so this is plenty, and if the
+    //       render thread falls this far behind we'd rather drop some.
+    static const size_t QueueCapacity = 64;
+
+    void Run();
+
+    // main thread: queue a command, and wake the render thread
+    bool Send(const Command &command);
+
+    // render thread: sleep until there is something in the queue
+    void WaitForCommand();
+
+    // time the frame that just finished
+    void FrameDone(Clock::time_point &lastFrame);
+
+    // render thread: apply everything in the queue, and return false on
+    // a quit command.  dirty is set if anything asks for a new frame.
+    bool Drain(RenderState &state, bool &dirty);
+
+    GLFWwindow *window;
+    FrameFunction drawFrame;
+    FramePacer *pacer;
+    GLStateCache *stateCache;
+    std::thread thread;
+    SpscQueue<Command, QueueCapacity> queue;
+
+    // only used to sleep on, never to protect the queue
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+
+    // only touched on the main thread
+    RenderState posted;
+    bool redrawRequested;
+    bool running;
+    bool threaded;
+    long long posts;
+    long long dropped;
+
+    // only touched on the render thread, until it has been joined
+    RenderState initial;
+    std::vector<double> latencies;
+    size_t maxDepth;
+    long long depthTotal;
+    long long frames;
+    double longestFrameMs;
+};
+
+#endif // RENDER_THREAD_H
@@ -0,0 +1,375 @@
+//============================================================================
+// Name        : ShaderReloader.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Loads a demo's shaders from files, and swaps in a new
+//               program whenever they change.
+//
+//============================================================================
+
+#include <iostream>
+using std::endl;
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "DebugLog.h"
+#include "FileUtil.h"
+#include "GLDebug.h"
+#include "ShaderReloader.h"
+
+// how long the files have to stay quiet before we build, since an editor
+// may write a file in several goes, or both files one after the other
+static const int QuietMilliseconds = 50;
+
+// how often the worker looks up from poll() to see if it should stop
+static const int PollMilliseconds = 100;
+
+static double MillisecondsBetween(std::chrono::steady_clock::time_point from,
+                                  std::chrono::steady_clock::time_point to)
+{
+    std::chrono::duration<double, std::milli> elapsed = to - from;
+    return elapsed.count();
+}
+
+ShaderReloader::ShaderReloader()
+    : watchFd(-1),
+      stopping(false),
+      building(false),
+      ready(0),
+      rebuilds(0),
+      failures(0),
+      buildMsTotal(0.0),
+      longestBuildMs(0.0),
+      swaps(0),
+      swapLatencyMsTotal(0.0),
+      inFrame(false),
+      reloading(false),
+      settleFrames(0),
+      reloadFrames(0),
+      longestReloadFrameMs(0.0),
+      longestFrameMs(0.0)
+{
+}
+
+ShaderReloader::~ShaderReloader()
+{
+    // Note: without a context we can only stop the thread; Stop() should
+    //       have been called while there was one.
+    stopping = true;
+    if (worker.joinable())
+        worker.join();
+
+    if (watchFd >= 0)
+        close(watchFd);
+}
+
+bool ShaderReloader::ReadFile(const std::string &path, std::string &text)
+{
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in)
+        return false;
+
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    text = contents.str();
+    return true;
+}
+
+bool ShaderReloader::WriteFile(const std::string &path,
+                               const std::string &text)
+{
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    out << text;
+    return static_cast<bool>(out);
+}
+
+bool ShaderReloader::Load(const std::string &directory,
+                          const std::string &name,
+                          const GLchar *vertexSource,
+                          const GLchar *fragmentSource)
+{
+    this->name = name;
+    this->directory = directory;
+    vertexPath = directory + "/" + name + ".vert";
+    fragmentPath = directory + "/" + name + ".frag";
+
+    if (!MakeDirectories(directory)) {
+        Log("Could not create the shader directory %s", directory.c_str());
+        return false;
+    }
+
+    // the first time, start from the shaders we were built with
+    std::string text;
+    if (!ReadFile(vertexPath, text) && !WriteFile(vertexPath, vertexSource)) {
+        Log("Could not write %s", vertexPath.c_str());
+        return false;
+    }
+
+    if (!ReadFile(fragmentPath, text)
+            && !WriteFile(fragmentPath, fragmentSource)) {
+        Log("Could not write %s", fragmentPath.c_str());
+        return false;
+    }
+
+    if (!ReadFile(vertexPath, this->vertexSource)
+            || !ReadFile(fragmentPath, this->fragmentSource)) {
+        Log("Could not read the shaders in %s", directory.c_str());
+        return false;
+    }
+
+    Log("Shaders: %s, %s", vertexPath.c_str(), fragmentPath.c_str());
+    return true;
+}
+
+bool ShaderReloader::Start(const std::vector<AttributeBinding> &attributes,
+                           MakeCurrentFunction makeCurrent,
+                           ReleaseFunction release,
+                           NotifyFunction notify)
+{
+    watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watchFd < 0) {
+        Log("inotify_init1 failed: %s", std::strerror(errno));
+        return false;
+    }
+
+    // Note: we watch the directory, not the files, since editors often
+    //       save by writing a new file and renaming it over the old one.
+    if (inotify_add_watch(watchFd, directory.c_str(),
+                          IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        Log("Could not watch %s: %s", directory.c_str(),
+            std::strerror(errno));
+        close(watchFd);
+        watchFd = -1;
+        return false;
+    }
+
+    this->attributes = attributes;
+    this->makeCurrent = makeCurrent;
+    this->release = release;
+    this->notify = notify;
+
+    stopping = false;
+    worker = std::thread(&ShaderReloader::Watch, this);
+    return true;
+}
+
+bool ShaderReloader::ReadEvents()
+{
+    // Note: inotify events are aligned like this, see inotify(7)
+    char buffer[4096]
+        __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool ours = false;
+
+    for (;;) {
+        ssize_t length = read(watchFd, buffer, sizeof(buffer));
+        if (length <= 0)
+            break;
+
+        for (char *at = buffer; at < buffer + length; ) {
+            const struct inotify_event *event =
+                reinterpret_cast<const struct inotify_event *>(at);
+
+            if (event->len > 0) {
+                std::string file(event->name);
+                if (file == name + ".vert" || file == name + ".frag")
+                    ours = true;
+            }
+
+            at += sizeof(struct inotify_event) + event->len;
+        }
+    }
+
+    return ours;
+}
+
+void ShaderReloader::Watch()
+{
+    if (!makeCurrent()) {
+        Log("The shader reloader has no context, so it is off");
+        return;
+    }
+
+    // the compiler's complaints are what we are here for
+    EnableGLDebugOutput();
+
+    struct pollfd watched;
+    watched.fd = watchFd;
+    watched.events = POLLIN;
+
+    bool dirty = false;
+
+    while (!stopping) {
+        // wait for a change, and then for things to go quiet again
+        int timeout = dirty ? QuietMilliseconds : PollMilliseconds;
+        watched.revents = 0;
+        int result = poll(&watched, 1, timeout);
+
+        if (result > 0 && ReadEvents()) {
+            changed = Clock::now();
+            dirty = true;
+            continue;
+        }
+
+        if (result == 0 && dirty) {
+            dirty = false;
+            Rebuild();
+        }
+    }
+
+    release();
+}
+
+bool ShaderReloader::Rebuild()
+{
+    building = true;
+    notify();
+
+    Clock::time_point begin = Clock::now();
+
+    std::string vertexText;
+    std::string fragmentText;
+    GLuint program = 0;
+
+    if (!ReadFile(vertexPath, vertexText)
+            || !ReadFile(fragmentPath, fragmentText)) {
+        Log("Could not read the shaders in %s", directory.c_str());
+    } else {
+        // Note: straight from source, there's no point caching binaries of
+        //       a shader that is being edited
+        ProgramCache compiler("");
+        program = compiler.BuildProgram(name.c_str(), vertexText.c_str(),
+                                        fragmentText.c_str(),
+                                        attributes.data(),
+                                        static_cast<int>(attributes.size()));
+    }
+
+    if (program == 0) {
+        Log("Shader reload failed, keeping the old program");
+        failures++;
+        building = false;
+        notify();
+        return false;
+    }
+
+    // The render thread must not use the program before the driver is
+    // done with it, on our context.  Without sync objects in GL 2.1,
+    // glFinish() is the way to be sure.
+    glFinish();
+
+    double buildMs = MillisecondsBetween(begin, Clock::now());
+    buildMsTotal += buildMs;
+    longestBuildMs = std::max(longestBuildMs, buildMs);
+    rebuilds++;
+
+    {
+        std::lock_guard<std::mutex> lock(readyMutex);
+        readyChanged = changed;
+    }
+
+    // a program that was never swapped in is simply replaced
+    GLuint stale = ready.exchange(program);
+    if (stale != 0)
+        glDeleteProgram(stale);
+
+    Log("Shaders reloaded in %.3f ms", buildMs);
+
+    building = false;
+    notify();
+    return true;
+}
+
+void ShaderReloader::Poll(Pipeline &pipeline)
+{
+    Clock::time_point now = Clock::now();
+    frameStart = now;
+    inFrame = true;
+
+    // the frame counts as part of a reload if one is under way
+    reloading = building;
+
+    GLuint program = ready.exchange(0);
+    if (program != 0) {
+        pipeline.SetProgram(GLProgram(program));
+
+        Clock::time_point changedAt;
+        {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            changedAt = readyChanged;
+        }
+
+        swapLatencyMsTotal += MillisecondsBetween(changedAt, now);
+        swaps++;
+
+        settleFrames = SettleFrames;
+        reloading = true;
+    } else if (settleFrames > 0) {
+        settleFrames--;
+        reloading = true;
+    }
+}
+
+void ShaderReloader::FrameDone()
+{
+    if (!inFrame)
+        return;
+
+    inFrame = false;
+    double frameMs = MillisecondsBetween(frameStart, Clock::now());
+
+    if (reloading) {
+        longestReloadFrameMs = std::max(longestReloadFrameMs, frameMs);
+        reloadFrames++;
+    } else {
+        longestFrameMs = std::max(longestFrameMs, frameMs);
+    }
+}
+
+void ShaderReloader::Stop()
+{
+    stopping = true;
+    if (worker.joinable())
+        worker.join();
+
+    if (watchFd >= 0) {
+        close(watchFd);
+        watchFd = -1;
+    }
+
+    GLuint program = ready.exchange(0);
+    if (program != 0)
+        glDeleteProgram(program);
+}
+
+void ShaderReloader::Report(std::ostream &out) const
+{
+    out << std::fixed << std::setprecision(3)
+        << "Shader reloads: " << rebuilds << " built, " << failures
+        << " failed, " << swaps << " swapped in" << endl;
+
+    if (rebuilds > 0) {
+        out << "    build: mean " << buildMsTotal / rebuilds << " ms, max "
+            << longestBuildMs << " ms" << endl;
+    }
+
+    if (swaps > 0) {
+        out << "    change to swap: mean " << swapLatencyMsTotal / swaps
+            << " ms" << endl;
+    }
+
+    out << "    longest frame: " << longestReloadFrameMs
+        << " ms during reloads (" << reloadFrames << " frames), "
+        << longestFrameMs << " ms otherwise" << endl;
+
+    out.unsetf(std::ios_base::floatfield);
+    out << std::setprecision(6);
+}
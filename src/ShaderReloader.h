@@ -0,0 +1,152 @@
+//============================================================================
+// Name        : ShaderReloader.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Loads a demo's shaders from files, and swaps in a new
+//               program whenever they change, without stalling a frame.
+//
+//               Our shaders are string literals, so trying out a change
+//               means a rebuild and a restart.  With a shader directory,
+//               Load() reads them from <name>.vert and <name>.frag in it
+//               instead (writing the built-in ones there first, if they
+//               aren't there yet), and Start() watches the directory with
+//               inotify.
+//
+//               Compiling and linking can take longer than a frame, so it
+//               mustn't happen on the render thread.  The watcher is a
+//               worker thread with a context of its own, which shares
+//               objects with the render context, so the program it links
+//               is usable there.  It waits until the driver has finished
+//               with it (glFinish()), and only then hands it over.  The
+//               render thread checks for it once a frame, in Poll(), and
+//               swaps it into the pipeline between two frames.  A program
+//               that doesn't compile or link is never handed over: its
+//               info log is printed, and the old program stays.
+//
+//               Report() gives the longest frame, from Poll() to
+//               FrameDone(), while a reload was in flight, up to a few
+//               frames after the swap, next to the longest frame otherwise,
+//               so that a hitch would show.
+//
+//============================================================================
+
+#ifndef SHADER_RELOADER_H
+#define SHADER_RELOADER_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Pipeline.h"
+#include "ProgramCache.h"
+
+class ShaderReloader {
+public:
+    // the worker's context, made current on it, and let go of at the end
+    typedef std::function<bool()> MakeCurrentFunction;
+    typedef std::function<void()> ReleaseFunction;
+
+    // called on the worker when a reload starts, and when it is ready
+    typedef std::function<void()> NotifyFunction;
+
+    ShaderReloader();
+    ~ShaderReloader();
+
+    // Read directory/name.vert and directory/name.frag, writing the given
+    // sources to them first if they don't exist.  Returns false, after
+    // saying why, if they can't be read or written.
+    bool Load(const std::string &directory, const std::string &name,
+              const GLchar *vertexSource, const GLchar *fragmentSource);
+
+    // what Load() read, for the first build
+    const GLchar *VertexSource() const { return vertexSource.c_str(); }
+    const GLchar *FragmentSource() const { return fragmentSource.c_str(); }
+
+    // Start watching the files, on a worker thread, which builds the
+    // programs with these attribute bindings.  The names must outlive us.
+    bool Start(const std::vector<AttributeBinding> &attributes,
+               MakeCurrentFunction makeCurrent, ReleaseFunction release,
+               NotifyFunction notify);
+
+    // Render thread, before each frame: swap in a newly built program
+    void Poll(Pipeline &pipeline);
+
+    // Render thread, once the frame is finished or swapped, for timing it
+    void FrameDone();
+
+    // true while a reload is being built, or waiting to be swapped in
+    bool Pending() const { return building || ready.load() != 0; }
+
+    // stop watching, and delete a program that was never swapped in.
+    // Needs a context that shares the programs.
+    void Stop();
+
+    void Report(std::ostream &out) const;
+
+private:
+    ShaderReloader(const ShaderReloader &);
+    ShaderReloader &operator=(const ShaderReloader &);
+
+    typedef std::chrono::steady_clock Clock;
+
+    // frames after a swap that still count as part of the reload
+    static const int SettleFrames = 3;
+
+    void Watch();
+    bool ReadEvents();      // true if one of our files changed
+    bool Rebuild();
+
+    static bool ReadFile(const std::string &path, std::string &text);
+    static bool WriteFile(const std::string &path, const std::string &text);
+
+    std::string name;
+    std::string directory;
+    std::string vertexPath;
+    std::string fragmentPath;
+    std::string vertexSource;
+    std::string fragmentSource;
+
+    std::vector<AttributeBinding> attributes;
+    MakeCurrentFunction makeCurrent;
+    ReleaseFunction release;
+    NotifyFunction notify;
+
+    std::thread worker;
+    int watchFd;
+    std::atomic<bool> stopping;
+    std::atomic<bool> building;
+    std::atomic<GLuint> ready;
+
+    // the worker's statistics, read by Report() after Stop()
+    Clock::time_point changed;  // when the files last changed
+    long long rebuilds;
+    long long failures;
+    double buildMsTotal;
+    double longestBuildMs;
+
+    // guards the time of the change waiting to be swapped in
+    std::mutex readyMutex;
+    Clock::time_point readyChanged;
+
+    // the render thread's
+    long long swaps;
+    double swapLatencyMsTotal;
+    Clock::time_point frameStart;
+    bool inFrame;           // Poll() was called, and FrameDone() wasn't
+    bool reloading;         // the frame under way is part of a reload
+    int settleFrames;
+    long long reloadFrames;
+    double longestReloadFrameMs;
+    double longestFrameMs;
+};
+
+#endif // SHADER_RELOADER_H
@@ -0,0 +1,973 @@
+//============================================================================
+// Name        : SoftwareRasterizer.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Draws our triangles on the CPU, in tiles, with scalar, SSE
+//               and AVX2 kernels, spread over every core.
+//
+//============================================================================
+
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+#include "FrameBenchmark.h"
+#include "SoftwareRasterizer.h"
+
+// The SIMD kernels are compiled for their instruction sets with target
+// attributes, rather than build flags, as in the MeshGenerator.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SOFTWARE_RASTERIZER_X86 1
+#include <immintrin.h>
+#endif
+
+// vertices are snapped to 1/16th of a pixel
+static const int SubpixelBits = 4;
+static const int Subpixels = 1 << SubpixelBits;
+
+// How far outside the screen a triangle may reach before it is clipped.
+// With MaxSize, every snapped coordinate stays under 2^17 subpixels, every
+// edge step under 2^18, and an edge function changes by less than 2^29
+// across a tile, so edge values clamped to 2^30 keep their sign, and fit
+// in 32 bits.
+static const int GuardBand = 2048;
+static const int64_t EdgeLimit = 1LL << 30;
+
+// triangles per setup task, at the least
+static const long long TrianglesPerRun = 4096;
+
+// A span of pixels in one row of a tile, for a kernel to test and shade
+struct SpanJob {
+    uint32_t *out;
+    int count;
+    int32_t edge[3];        // the edge functions at the first pixel
+    int32_t step[3];        // and how much they change per pixel
+    bool flat;
+    uint32_t color;         // if flat
+    GLfloat start[4];       // if not, the color at the first pixel
+    GLfloat delta[4];       // and how much it changes per pixel
+};
+
+typedef void (*SpanKernel)(const SpanJob &job);
+
+// Note: rounded to nearest even, in the SSE rounding mode, which is what
+//       Mesa does too: 0.3 clears to 76, not 77
+uint32_t SoftwareRasterizer::PackColor(const GLfloat color[4])
+{
+    uint32_t packed = 0;
+
+    for (int i = 0; i < 4; i++) {
+        GLfloat v = std::min(std::max(color[i], 0.0f), 1.0f);
+        packed |= static_cast<uint32_t>(std::lrint(v * 255.0f)) << (i * 8);
+    }
+
+    return packed;
+}
+
+// Note: every kernel works the colors out in the same order, a multiply
+//       and then an add, so they round the same way
+static void DrawSpanScalar(const SpanJob &job, int k)
+{
+    for (; k < job.count; k++) {
+        int32_t e0 = job.edge[0] + job.step[0] * k;
+        int32_t e1 = job.edge[1] + job.step[1] * k;
+        int32_t e2 = job.edge[2] + job.step[2] * k;
+
+        if ((e0 | e1 | e2) < 0)
+            continue;
+
+        if (job.flat) {
+            job.out[k] = job.color;
+            continue;
+        }
+
+        GLfloat color[4];
+        for (int i = 0; i < 4; i++)
+            color[i] = job.start[i] + job.delta[i] * static_cast<GLfloat>(k);
+
+        job.out[k] = SoftwareRasterizer::PackColor(color);
+    }
+}
+
+static void DrawSpanScalar(const SpanJob &job)
+{
+    DrawSpanScalar(job, 0);
+}
+
+#ifdef SOFTWARE_RASTERIZER_X86
+
+// 4 pixels at a time: the edge functions as 4 lanes each, and the mask of
+// the pixels inside all three
+__attribute__((target("sse2")))
+static void DrawSpanSSE(const SpanJob &job)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lanes = _mm_set_epi32(3, 2, 1, 0);
+    const __m128 zeroColor = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(255.0f);
+
+    __m128i edge[3];
+    __m128i step[3];
+    for (int i = 0; i < 3; i++) {
+        edge[i] = _mm_add_epi32(_mm_set1_epi32(job.edge[i]),
+                                _mm_set_epi32(3 * job.step[i],
+                                              2 * job.step[i],
+                                              job.step[i], 0));
+        step[i] = _mm_set1_epi32(4 * job.step[i]);
+    }
+
+    int k = 0;
+    for (; k + 4 <= job.count; k += 4) {
+        __m128i inside = _mm_or_si128(_mm_or_si128(edge[0], edge[1]),
+                                      edge[2]);
+        __m128i outside = _mm_cmpgt_epi32(zero, inside);
+
+        for (int i = 0; i < 3; i++)
+            edge[i] = _mm_add_epi32(edge[i], step[i]);
+
+        if (_mm_movemask_epi8(outside) == 0xFFFF)
+            continue;
+
+        __m128i color;
+        if (job.flat) {
+            color = _mm_set1_epi32(static_cast<int>(job.color));
+        }
+        else {
+            __m128 index = _mm_cvtepi32_ps(
+                               _mm_add_epi32(_mm_set1_epi32(k), lanes));
+            color = zero;
+
+            for (int i = 0; i < 4; i++) {
+                __m128 value = _mm_add_ps(_mm_set1_ps(job.start[i]),
+                                          _mm_mul_ps(_mm_set1_ps(job.delta[i]),
+                                                     index));
+                value = _mm_min_ps(_mm_max_ps(value, zeroColor), one);
+                __m128i channel = _mm_cvtps_epi32(_mm_mul_ps(value, scale));
+                color = _mm_or_si128(color,
+                                     _mm_slli_epi32(channel, i * 8));
+            }
+        }
+
+        __m128i *out = reinterpret_cast<__m128i *>(job.out + k);
+        __m128i old = _mm_loadu_si128(out);
+        _mm_storeu_si128(out, _mm_or_si128(_mm_and_si128(outside, old),
+                                           _mm_andnot_si128(outside, color)));
+    }
+
+    DrawSpanScalar(job, k);
+}
+
+// 8 pixels at a time, written with a masked store
+__attribute__((target("avx2")))
+static void DrawSpanAVX2(const SpanJob &job)
+{
+    const __m256i minusOne = _mm256_set1_epi32(-1);
+    const __m256i lanes = _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    const __m256 zeroColor = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 scale = _mm256_set1_ps(255.0f);
+
+    __m256i edge[3];
+    __m256i step[3];
+    for (int i = 0; i < 3; i++) {
+        edge[i] = _mm256_add_epi32(_mm256_set1_epi32(job.edge[i]),
+                                   _mm256_mullo_epi32(
+                                       _mm256_set1_epi32(job.step[i]),
+                                       lanes));
+        step[i] = _mm256_set1_epi32(8 * job.step[i]);
+    }
+
+    int k = 0;
+    for (; k + 8 <= job.count; k += 8) {
+        __m256i inside = _mm256_or_si256(_mm256_or_si256(edge[0], edge[1]),
+                                         edge[2]);
+        __m256i covered = _mm256_cmpgt_epi32(inside, minusOne);
+
+        for (int i = 0; i < 3; i++)
+            edge[i] = _mm256_add_epi32(edge[i], step[i]);
+
+        if (_mm256_testz_si256(covered, covered))
+            continue;
+
+        __m256i color;
+        if (job.flat) {
+            color = _mm256_set1_epi32(static_cast<int>(job.color));
+        }
+        else {
+            __m256 index = _mm256_cvtepi32_ps(
+                               _mm256_add_epi32(_mm256_set1_epi32(k), lanes));
+            color = _mm256_setzero_si256();
+
+            for (int i = 0; i < 4; i++) {
+                __m256 value = _mm256_add_ps(
+                    _mm256_set1_ps(job.start[i]),
+                    _mm256_mul_ps(_mm256_set1_ps(job.delta[i]), index));
+                value = _mm256_min_ps(_mm256_max_ps(value, zeroColor), one);
+                __m256i channel = _mm256_cvtps_epi32(
+                    _mm256_mul_ps(value, scale));
+                color = _mm256_or_si256(color,
+                                        _mm256_slli_epi32(channel, i * 8));
+            }
+        }
+
+        _mm256_maskstore_epi32(reinterpret_cast<int *>(job.out + k),
+                               covered, color);
+    }
+
+    DrawSpanScalar(job, k);
+}
+
+#endif // SOFTWARE_RASTERIZER_X86
+
+static SpanKernel KernelFunction(SoftwareRasterizer::Kernel kernel)
+{
+#ifdef SOFTWARE_RASTERIZER_X86
+    if (kernel == SoftwareRasterizer::KernelAVX2)
+        return DrawSpanAVX2;
+    if (kernel == SoftwareRasterizer::KernelSSE)
+        return DrawSpanSSE;
+#endif
+
+    return DrawSpanScalar;
+}
+
+static int64_t ClampEdge(int64_t value)
+{
+    return std::min(std::max(value, -EdgeLimit), EdgeLimit);
+}
+
+// Clip a polygon against one side of the guard band, keeping the points
+// where sign * (coordinate - limit) <= 0
+static int ClipPolygon(const GLfloat *inX, const GLfloat *inY, int count,
+                       bool alongX, GLfloat limit, GLfloat sign,
+                       GLfloat *outX, GLfloat *outY)
+{
+    int written = 0;
+
+    for (int i = 0; i < count; i++) {
+        int j = (i + 1) % count;
+        GLfloat di = sign * ((alongX ? inX[i] : inY[i]) - limit);
+        GLfloat dj = sign * ((alongX ? inX[j] : inY[j]) - limit);
+
+        if (di <= 0.0f) {
+            outX[written] = inX[i];
+            outY[written] = inY[i];
+            written++;
+        }
+
+        if ((di <= 0.0f) != (dj <= 0.0f)) {
+            GLfloat t = di / (di - dj);
+            outX[written] = inX[i] + t * (inX[j] - inX[i]);
+            outY[written] = inY[i] + t * (inY[j] - inY[i]);
+            written++;
+        }
+    }
+
+    return written;
+}
+
+SoftwareRasterizer::SoftwareRasterizer()
+    : kernel(KernelScalar),
+      threadCount(1),
+      width(0),
+      height(0),
+      stride(0),
+      tilesX(0),
+      tilesY(0),
+      clearColor(0),
+      flat(false),
+      flatColor(0),
+      vertices(nullptr),
+      taskNumber(0),
+      stopping(false),
+      taskFunction(nullptr),
+      taskCount(0),
+      nextTask(0),
+      finishedTasks(0)
+{
+    view[0] = view[1] = 1.0f;
+    view[2] = view[3] = 0.0f;
+
+    SetKernel(KernelAuto);
+    SetThreads(0);
+}
+
+SoftwareRasterizer::~SoftwareRasterizer()
+{
+    Destroy();
+}
+
+bool SoftwareRasterizer::KernelSupported(Kernel kernel)
+{
+    switch (kernel) {
+    case KernelScalar:
+        return true;
+#ifdef SOFTWARE_RASTERIZER_X86
+    case KernelSSE:
+        return __builtin_cpu_supports("sse2");
+    case KernelAVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+const char *SoftwareRasterizer::KernelName(Kernel kernel)
+{
+    switch (kernel) {
+    case KernelScalar:
+        return "scalar";
+    case KernelSSE:
+        return "sse";
+    case KernelAVX2:
+        return "avx2";
+    default:
+        return "auto";
+    }
+}
+
+void SoftwareRasterizer::SetKernel(Kernel requested)
+{
+    if (requested != KernelAuto && KernelSupported(requested)) {
+        kernel = requested;
+        return;
+    }
+
+    if (requested != KernelAuto) {
+        cout << "The " << KernelName(requested) << " rasterizer kernel "
+             << "isn't supported by this CPU" << endl;
+    }
+
+    if (KernelSupported(KernelAVX2))
+        kernel = KernelAVX2;
+    else if (KernelSupported(KernelSSE))
+        kernel = KernelSSE;
+    else
+        kernel = KernelScalar;
+}
+
+void SoftwareRasterizer::SetThreads(int count)
+{
+    if (count <= 0) {
+        count = static_cast<int>(std::thread::hardware_concurrency());
+        if (count <= 0)
+            count = 1;
+    }
+
+    threadCount = count;
+}
+
+bool SoftwareRasterizer::Create(int newWidth, int newHeight)
+{
+    if (newWidth <= 0 || newHeight <= 0 ||
+        newWidth > MaxSize || newHeight > MaxSize) {
+        cout << "The software rasterizer can't draw " << newWidth << "x"
+             << newHeight << " pixels, " << MaxSize << "x" << MaxSize
+             << " at most" << endl;
+        return false;
+    }
+
+    Destroy();
+
+    width = newWidth;
+    height = newHeight;
+    tilesX = (width + TileSize - 1) / TileSize;
+    tilesY = (height + TileSize - 1) / TileSize;
+
+    // Note: whole tiles, so a kernel never needs to check where a row ends
+    stride = tilesX * TileSize;
+    pixels.assign(static_cast<size_t>(stride) * tilesY * TileSize, 0);
+
+    for (int i = 1; i < threadCount; i++)
+        workers.push_back(std::thread(&SoftwareRasterizer::WorkerLoop,
+                                      this));
+
+    return true;
+}
+
+void SoftwareRasterizer::Destroy()
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (size_t i = 0; i < workers.size(); i++)
+        workers[i].join();
+    workers.clear();
+
+    stopping = false;
+}
+
+void SoftwareRasterizer::SetClearColor(const GLfloat color[4])
+{
+    clearColor = PackColor(color);
+}
+
+void SoftwareRasterizer::SetFlatColor(const GLfloat *color)
+{
+    flat = color != nullptr;
+    if (flat)
+        flatColor = PackColor(color);
+}
+
+void SoftwareRasterizer::SetView(const GLfloat newView[4])
+{
+    for (int i = 0; i < 4; i++)
+        view[i] = newView[i];
+}
+
+void SoftwareRasterizer::Render(const ColorVertex *newVertices,
+                                long long count)
+{
+    std::chrono::steady_clock::time_point begin =
+        std::chrono::steady_clock::now();
+
+    vertices = newVertices;
+
+    long long triangles = count / 3;
+    long long runCount = (triangles + TrianglesPerRun - 1) / TrianglesPerRun;
+    runCount = std::max(1LL, std::min(runCount, 4LL * threadCount));
+
+    if (runs.size() != static_cast<size_t>(runCount))
+        runs.resize(static_cast<size_t>(runCount));
+
+    for (long long r = 0; r < runCount; r++) {
+        Run &run = runs[r];
+        run.first = triangles * r / runCount;
+        run.count = triangles * (r + 1) / runCount - run.first;
+        run.bins.resize(static_cast<size_t>(tilesX) * tilesY);
+    }
+
+    RunTasks(&SoftwareRasterizer::SetUpRun, static_cast<int>(runCount));
+
+    std::chrono::steady_clock::time_point binned =
+        std::chrono::steady_clock::now();
+
+    RunTasks(&SoftwareRasterizer::DrawTile, tilesX * tilesY);
+
+    std::chrono::steady_clock::time_point end =
+        std::chrono::steady_clock::now();
+
+    FrameStats stats;
+    stats.binMs = std::chrono::duration<double, std::milli>(
+                      binned - begin).count();
+    stats.rasterMs = std::chrono::duration<double, std::milli>(
+                         end - binned).count();
+    stats.triangles = 0;
+    stats.binned = 0;
+
+    for (size_t r = 0; r < runs.size(); r++) {
+        stats.triangles += runs[r].triangles.size();
+        for (size_t t = 0; t < runs[r].bins.size(); t++)
+            stats.binned += runs[r].bins[t].size();
+    }
+
+    frames.push_back(stats);
+}
+
+void SoftwareRasterizer::SetUpRun(int task)
+{
+    Run &run = runs[task];
+
+    run.triangles.clear();
+    for (size_t t = 0; t < run.bins.size(); t++)
+        run.bins[t].clear();
+
+    const ColorVertex *in = vertices + run.first * 3;
+    for (long long i = 0; i < run.count; i++)
+        SetUp(in + i * 3, run);
+}
+
+void SoftwareRasterizer::SetUp(const ColorVertex *in, Run &run) const
+{
+    // the vertex shader's view, then the viewport, the way GL does it
+    GLfloat halfWidth = 0.5f * width;
+    GLfloat halfHeight = 0.5f * height;
+    GLfloat x[3];
+    GLfloat y[3];
+
+    for (int v = 0; v < 3; v++) {
+        GLfloat clipX = in[v].position[0] * view[0] + view[2];
+        GLfloat clipY = in[v].position[1] * view[1] + view[3];
+        x[v] = clipX * halfWidth + halfWidth;
+        y[v] = clipY * halfHeight + halfHeight;
+    }
+
+    GLfloat minX = std::min(x[0], std::min(x[1], x[2]));
+    GLfloat maxX = std::max(x[0], std::max(x[1], x[2]));
+    GLfloat minY = std::min(y[0], std::min(y[1], y[2]));
+    GLfloat maxY = std::max(y[0], std::max(y[1], y[2]));
+
+    // nowhere near the screen
+    if (maxX < 0.0f || maxY < 0.0f || minX > width || minY > height)
+        return;
+
+    // The color planes come from the whole triangle, so that clipping
+    // only changes which pixels are covered
+    Triangle colors;
+    colors.originX = x[0];
+    colors.originY = y[0];
+
+    double x1 = static_cast<double>(x[1]) - x[0];
+    double y1 = static_cast<double>(y[1]) - y[0];
+    double x2 = static_cast<double>(x[2]) - x[0];
+    double y2 = static_cast<double>(y[2]) - y[0];
+    double area = x1 * y2 - x2 * y1;
+
+    if (area == 0.0)
+        return;
+
+    for (int i = 0; i < 4; i++) {
+        double c0 = in[0].color[i].value / 255.0;
+        double c1 = in[1].color[i].value / 255.0 - c0;
+        double c2 = in[2].color[i].value / 255.0 - c0;
+
+        colors.color[i] = static_cast<GLfloat>(c0);
+        colors.colorDx[i] = static_cast<GLfloat>((c1 * y2 - c2 * y1) / area);
+        colors.colorDy[i] = static_cast<GLfloat>((c2 * x1 - c1 * x2) / area);
+    }
+
+    GLfloat left = static_cast<GLfloat>(-GuardBand);
+    GLfloat bottom = static_cast<GLfloat>(-GuardBand);
+    GLfloat right = static_cast<GLfloat>(width + GuardBand);
+    GLfloat top = static_cast<GLfloat>(height + GuardBand);
+
+    if (minX >= left && maxX <= right && minY >= bottom && maxY <= top) {
+        AddTriangle(x, y, colors, run);
+        return;
+    }
+
+    // Clip to the guard band, and draw the polygon that is left as a fan
+    GLfloat polygonX[2][8];
+    GLfloat polygonY[2][8];
+    int count = 3;
+
+    for (int v = 0; v < 3; v++) {
+        polygonX[0][v] = x[v];
+        polygonY[0][v] = y[v];
+    }
+
+    count = ClipPolygon(polygonX[0], polygonY[0], count, true, left, -1.0f,
+                        polygonX[1], polygonY[1]);
+    count = ClipPolygon(polygonX[1], polygonY[1], count, true, right, 1.0f,
+                        polygonX[0], polygonY[0]);
+    count = ClipPolygon(polygonX[0], polygonY[0], count, false, bottom,
+                        -1.0f, polygonX[1], polygonY[1]);
+    count = ClipPolygon(polygonX[1], polygonY[1], count, false, top, 1.0f,
+                        polygonX[0], polygonY[0]);
+
+    for (int v = 1; v + 1 < count; v++) {
+        const GLfloat fanX[3] = {polygonX[0][0], polygonX[0][v],
+                                 polygonX[0][v + 1]};
+        const GLfloat fanY[3] = {polygonY[0][0], polygonY[0][v],
+                                 polygonY[0][v + 1]};
+        AddTriangle(fanX, fanY, colors, run);
+    }
+}
+
+void SoftwareRasterizer::AddTriangle(const GLfloat x[3], const GLfloat y[3],
+                                     const Triangle &colors, Run &run) const
+{
+    int64_t sx[3];
+    int64_t sy[3];
+
+    for (int v = 0; v < 3; v++) {
+        sx[v] = static_cast<int64_t>(std::lrint(x[v] * Subpixels));
+        sy[v] = static_cast<int64_t>(std::lrint(y[v] * Subpixels));
+    }
+
+    // counter clockwise, with y up, whichever way it came in
+    int64_t area = (sx[1] - sx[0]) * (sy[2] - sy[0]) -
+                   (sx[2] - sx[0]) * (sy[1] - sy[0]);
+    if (area == 0)
+        return;
+
+    if (area < 0) {
+        std::swap(sx[1], sx[2]);
+        std::swap(sy[1], sy[2]);
+    }
+
+    // The pixel centers inside the snapped bounding box
+    int64_t lowX = std::min(sx[0], std::min(sx[1], sx[2]));
+    int64_t highX = std::max(sx[0], std::max(sx[1], sx[2]));
+    int64_t lowY = std::min(sy[0], std::min(sy[1], sy[2]));
+    int64_t highY = std::max(sy[0], std::max(sy[1], sy[2]));
+    const int64_t center = Subpixels / 2;
+
+    Triangle triangle = colors;
+    triangle.minX = static_cast<int>(std::max<int64_t>(
+        0, (lowX - center + Subpixels - 1) >> SubpixelBits));
+    triangle.minY = static_cast<int>(std::max<int64_t>(
+        0, (lowY - center + Subpixels - 1) >> SubpixelBits));
+    triangle.maxX = static_cast<int>(std::min<int64_t>(
+        width - 1, (highX - center) >> SubpixelBits));
+    triangle.maxY = static_cast<int>(std::min<int64_t>(
+        height - 1, (highY - center) >> SubpixelBits));
+
+    if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+        return;
+
+    for (int e = 0; e < 3; e++) {
+        int from = e;
+        int to = (e + 1) % 3;
+
+        int64_t a = sy[from] - sy[to];
+        int64_t b = sx[to] - sx[from];
+        triangle.a[e] = static_cast<int32_t>(a);
+        triangle.b[e] = static_cast<int32_t>(b);
+        triangle.c[e] = -(a * sx[from] + b * sy[from]);
+
+        // Fill rule: a pixel center right on an edge is only drawn if it
+        // is a left edge, or a horizontal edge at the bottom.  That is the
+        // top-left rule with y down, and, with our y up, what llvmpipe
+        // does in a framebuffer object.
+        if (!(a > 0 || (a == 0 && b > 0)))
+            triangle.c[e] -= 1;
+    }
+
+    run.triangles.push_back(triangle);
+    Bin(run, static_cast<int>(run.triangles.size() - 1));
+}
+
+void SoftwareRasterizer::Bin(Run &run, int index) const
+{
+    const Triangle &triangle = run.triangles[index];
+
+    for (int ty = triangle.minY / TileSize; ty <= triangle.maxY / TileSize;
+         ty++) {
+        for (int tx = triangle.minX / TileSize;
+             tx <= triangle.maxX / TileSize; tx++)
+            run.bins[ty * tilesX + tx].push_back(index);
+    }
+}
+
+void SoftwareRasterizer::DrawTile(int task)
+{
+    int tileX = task % tilesX;
+    int tileY = task / tilesX;
+
+    for (int y = tileY * TileSize; y < (tileY + 1) * TileSize; y++) {
+        uint32_t *row = pixels.data() + static_cast<size_t>(y) * stride +
+                        tileX * TileSize;
+        std::fill(row, row + TileSize, clearColor);
+    }
+
+    for (size_t r = 0; r < runs.size(); r++) {
+        const Run &run = runs[r];
+        const std::vector<int> &bin = run.bins[task];
+
+        for (size_t i = 0; i < bin.size(); i++)
+            DrawTriangle(run.triangles[bin[i]], tileX, tileY);
+    }
+}
+
+void SoftwareRasterizer::DrawTriangle(const Triangle &triangle, int tileX,
+                                      int tileY)
+{
+    int left = tileX * TileSize;
+    int bottom = tileY * TileSize;
+
+    int firstX = std::max(triangle.minX, left);
+    int lastX = std::min(triangle.maxX, left + TileSize - 1);
+    int firstY = std::max(triangle.minY, bottom);
+    int lastY = std::min(triangle.maxY, bottom + TileSize - 1);
+
+    if (firstX > lastX || firstY > lastY)
+        return;
+
+    // Whole groups of 8 pixels, which the tile always has room for, and
+    // the edge functions mask off the ones outside
+    firstX &= ~7;
+    lastX |= 7;
+
+    SpanKernel kernelFunction = KernelFunction(kernel);
+
+    SpanJob job;
+    job.count = lastX - firstX + 1;
+    job.flat = flat;
+    job.color = flatColor;
+
+    for (int e = 0; e < 3; e++)
+        job.step[e] = triangle.a[e] * Subpixels;
+
+    const int64_t centerX = static_cast<int64_t>(firstX) * Subpixels +
+                            Subpixels / 2;
+
+    for (int y = firstY; y <= lastY; y++) {
+        const int64_t centerY = static_cast<int64_t>(y) * Subpixels +
+                                Subpixels / 2;
+
+        for (int e = 0; e < 3; e++) {
+            job.edge[e] = static_cast<int32_t>(ClampEdge(
+                triangle.a[e] * centerX + triangle.b[e] * centerY +
+                triangle.c[e]));
+        }
+
+        if (!flat) {
+            double dx = firstX + 0.5 - triangle.originX;
+            double dy = y + 0.5 - triangle.originY;
+
+            for (int i = 0; i < 4; i++) {
+                job.start[i] = static_cast<GLfloat>(
+                    triangle.color[i] + dx * triangle.colorDx[i] +
+                    dy * triangle.colorDy[i]);
+                job.delta[i] = triangle.colorDx[i];
+            }
+        }
+
+        job.out = pixels.data() + static_cast<size_t>(y) * stride + firstX;
+        kernelFunction(job);
+    }
+}
+
+void SoftwareRasterizer::RunTasks(TaskFunction function, int count)
+{
+    // Note: the task is written before the counters are reset, and the
+    //       atomics order it for the workers
+    taskFunction = function;
+    taskCount = count;
+    finishedTasks.store(0);
+    nextTask.store(0);
+
+    if (!workers.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            taskNumber++;
+        }
+        wake.notify_all();
+    }
+
+    Work();
+    while (finishedTasks.load() < count)
+        std::this_thread::yield();
+}
+
+void SoftwareRasterizer::Work()
+{
+    for (;;) {
+        int task = nextTask.fetch_add(1);
+        if (task >= taskCount)
+            break;
+
+        (this->*taskFunction)(task);
+
+        finishedTasks.fetch_add(1);
+    }
+}
+
+void SoftwareRasterizer::WorkerLoop()
+{
+    long long seen = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait(lock, [&]() {
+                return stopping || taskNumber != seen;
+            });
+
+            if (stopping)
+                return;
+            seen = taskNumber;
+        }
+
+        Work();
+    }
+}
+
+bool SoftwareRasterizer::WritePPM(const std::string &path) const
+{
+    std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    file << "P6\n" << width << " " << height << "\n255\n";
+
+    std::vector<unsigned char> row(static_cast<size_t>(width) * 3);
+
+    for (int y = height - 1; y >= 0; y--) {
+        const uint32_t *in = Row(y);
+        for (int x = 0; x < width; x++) {
+            row[x * 3] = static_cast<unsigned char>(in[x]);
+            row[x * 3 + 1] = static_cast<unsigned char>(in[x] >> 8);
+            row[x * 3 + 2] = static_cast<unsigned char>(in[x] >> 16);
+        }
+
+        file.write(reinterpret_cast<const char *>(row.data()),
+                   static_cast<std::streamsize>(row.size()));
+    }
+
+    return file.good();
+}
+
+// 64 bit FNV-1a over the visible pixels, to tell whether two runs drew
+// the same thing
+static unsigned long long HashPixels(const SoftwareRasterizer &rasterizer)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+
+    for (int y = 0; y < rasterizer.Height(); y++) {
+        const unsigned char *bytes =
+            reinterpret_cast<const unsigned char *>(rasterizer.Row(y));
+
+        for (int i = 0; i < rasterizer.Width() * 4; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    return hash;
+}
+
+void SoftwareRasterizer::Benchmark(std::ostream &out, int width, int height,
+                                   int maxThreads,
+                                   const GLfloat clearColor[4],
+                                   const GLfloat *flatColor,
+                                   const GLfloat view[4],
+                                   const ColorVertex *vertices,
+                                   long long count)
+{
+    if (maxThreads <= 0) {
+        maxThreads = static_cast<int>(std::thread::hardware_concurrency());
+        if (maxThreads <= 0)
+            maxThreads = 1;
+    }
+
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    const Kernel kernels[] = {KernelScalar, KernelSSE, KernelAVX2};
+
+    out << "Software rasterizer benchmark: " << width << "x" << height
+        << ", " << count / 3 << " triangles, "
+        << std::thread::hardware_concurrency() << " cores" << endl;
+
+    unsigned long long reference = 0;
+    bool haveReference = false;
+    bool identical = true;
+
+    for (int k = 0; k < 3; k++) {
+        if (!KernelSupported(kernels[k]))
+            continue;
+
+        double singleThreadMs = 0.0;
+
+        for (size_t t = 0; t < threadCounts.size(); t++) {
+            SoftwareRasterizer rasterizer;
+            rasterizer.SetKernel(kernels[k]);
+            rasterizer.SetThreads(threadCounts[t]);
+            if (!rasterizer.Create(width, height))
+                return;
+
+            rasterizer.SetClearColor(clearColor);
+            rasterizer.SetFlatColor(flatColor);
+            rasterizer.SetView(view);
+
+            // one unmeasured frame, which we also check the pixels of
+            rasterizer.Render(vertices, count);
+
+            unsigned long long hash = HashPixels(rasterizer);
+            if (!haveReference) {
+                reference = hash;
+                haveReference = true;
+            }
+            bool same = hash == reference;
+            identical = identical && same;
+
+            // at least 5 frames, and at least half a second
+            std::chrono::steady_clock::time_point begin =
+                std::chrono::steady_clock::now();
+            double elapsedMs = 0.0;
+            int frameCount = 0;
+
+            while (frameCount < 5 || elapsedMs < 500.0) {
+                rasterizer.Render(vertices, count);
+                frameCount++;
+                elapsedMs = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - begin).count();
+            }
+
+            double frameMs = elapsedMs / frameCount;
+            if (t == 0)
+                singleThreadMs = frameMs;
+
+            out << std::fixed << std::setprecision(3)
+                << "    " << std::setw(6) << KernelName(kernels[k])
+                << std::setw(4) << threadCounts[t] << " threads: "
+                << std::setw(9) << frameMs << " ms/frame, "
+                << std::setprecision(1) << std::setw(8)
+                << width * static_cast<double>(height) / frameMs / 1000.0
+                << " Mpixels/s, " << std::setprecision(2)
+                << singleThreadMs / frameMs << "x"
+                << (same ? "" : ", DIFFERENT pixels") << endl;
+        }
+    }
+
+    out << "    every kernel and thread count drew "
+        << (identical ? "the same pixels" : "DIFFERENT pixels") << endl;
+
+    out.unsetf(std::ios_base::floatfield);
+    out << std::setprecision(6);
+}
+
+void SoftwareRasterizer::Report(std::ostream &out) const
+{
+    if (frames.empty())
+        return;
+
+    std::vector<double> binMs;
+    std::vector<double> rasterMs;
+    double totalMs = 0.0;
+    long long triangles = 0;
+    long long binned = 0;
+
+    for (size_t i = 0; i < frames.size(); i++) {
+        binMs.push_back(frames[i].binMs);
+        rasterMs.push_back(frames[i].rasterMs);
+        totalMs += frames[i].binMs + frames[i].rasterMs;
+        triangles += frames[i].triangles;
+        binned += frames[i].binned;
+    }
+
+    std::sort(binMs.begin(), binMs.end());
+    std::sort(rasterMs.begin(), rasterMs.end());
+
+    double count = static_cast<double>(frames.size());
+    double meanBinMs = 0.0;
+    double meanRasterMs = 0.0;
+    for (size_t i = 0; i < frames.size(); i++) {
+        meanBinMs += binMs[i] / count;
+        meanRasterMs += rasterMs[i] / count;
+    }
+
+    out << std::fixed << std::setprecision(3)
+        << "Software rasterizer: " << KernelName(kernel) << " kernel, "
+        << threadCount << " threads, " << tilesX * tilesY << " tiles of "
+        << TileSize << "x" << TileSize << ", " << frames.size()
+        << " frames" << endl
+        << "    set up and bin: mean " << meanBinMs << " ms, p99 "
+        << Percentile(binMs, 99.0) << " ms" << endl
+        << "    draw tiles: mean " << meanRasterMs << " ms, p99 "
+        << Percentile(rasterMs, 99.0) << " ms" << endl
+        << std::setprecision(1)
+        << "    " << triangles / count << " triangles a frame, in "
+        << binned / count << " tile bins, "
+        << width * static_cast<double>(height) * count / totalMs / 1000.0
+        << " Mpixels/s" << endl;
+
+    out.unsetf(std::ios_base::floatfield);
+    out << std::setprecision(6);
+}
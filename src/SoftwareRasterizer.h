@@ -0,0 +1,226 @@
+//============================================================================
+// Name        : SoftwareRasterizer.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Draws our triangles on the CPU, for machines that have no
+//               OpenGL at all.
+//
+//               It draws what our two shader pairs do, and nothing else:
+//               the triangles, moved by the same pan and zoom as the
+//               "view" uniform, filled either with one flat color (the
+//               HelloTriangle fragment shader) or with the vertex colors
+//               blended across them (HelloColorTriangle).  The framebuffer
+//               is 8 bit RGBA, bottom row first, the way glReadPixels()
+//               gives it, so the two can be compared byte for byte.
+//
+//               The screen is cut into 64x64 tiles.  Each frame, the
+//               triangles are set up and binned first: they are snapped to
+//               1/16th of a pixel, their edge functions are worked out,
+//               and each one is added to the bin of every tile its bounding
+//               box touches.  Then each tile is cleared and drawn on its
+//               own, with the triangles in its bin, in order.  A tile is
+//               small enough to stay in the cache, and no two threads ever
+//               write the same pixel, so the tiles are shared out between
+//               threads (one per core, kept between frames) through an
+//               atomic counter, like the MeshGenerator's rows.  Setting up
+//               and binning is shared out too, in runs of triangles, and
+//               every tile walks the runs in order.
+//
+//               Inside a tile, a pixel is covered if its center is inside
+//               all three edges, with GL's fill rule (left edges, and, with
+//               y up, bottom ones) so that a pixel on an edge shared by two
+//               triangles is drawn exactly once.
+//               The edge functions are integers, and step by a constant
+//               from one pixel to the next, so SSE2 tests and shades 4
+//               pixels at a time, and AVX2 8, picked at run time like the
+//               mesh generator's kernels.  Every kernel gives exactly the
+//               same pixels.
+//
+//               Triangles that reach far outside the screen (a big one,
+//               zoomed in on) are clipped to a guard band around it first,
+//               so the edge functions always fit in 32 bits.
+//
+//============================================================================
+
+#ifndef SOFTWARE_RASTERIZER_H
+#define SOFTWARE_RASTERIZER_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "VertexLayout.h"
+
+class SoftwareRasterizer {
+public:
+    enum Kernel {
+        KernelAuto = 0,  // the best one the CPU supports
+        KernelScalar,
+        KernelSSE,
+        KernelAVX2
+    };
+
+    static const int TileSize = 64;
+
+    // the largest framebuffer, in either direction
+    static const int MaxSize = 4096;
+
+    SoftwareRasterizer();
+    ~SoftwareRasterizer();
+
+    // Falls back to the best supported kernel if this one isn't
+    void SetKernel(Kernel kernel);
+
+    // threads to draw on, including the calling one, 0 for one per core.
+    // Call before Create().
+    void SetThreads(int count);
+
+    Kernel ActiveKernel() const { return kernel; }
+    int Threads() const { return threadCount; }
+
+    static bool KernelSupported(Kernel kernel);
+    static const char *KernelName(Kernel kernel);
+
+    // Allocate the framebuffer, and start the worker threads.  Returns
+    // false, after saying why, if the size is too big.
+    bool Create(int width, int height);
+
+    // stop the worker threads
+    void Destroy();
+
+    // What the clear fills the framebuffer with, RGBA from 0 to 1
+    void SetClearColor(const GLfloat color[4]);
+
+    // Fill every triangle with this color, like HelloTriangle's fragment
+    // shader, or with nullptr, blend the vertex colors across it
+    void SetFlatColor(const GLfloat *color);
+
+    // Scale in xy, then offset in zw, like the shaders' view uniform
+    void SetView(const GLfloat view[4]);
+
+    // Clear, and draw a triangle list of count vertices
+    void Render(const ColorVertex *vertices, long long count);
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+    // the pixels of row y, counting from the bottom, as R, G, B, A bytes
+    const uint32_t *Row(int y) const
+    {
+        return pixels.data() + static_cast<size_t>(y) * stride;
+    }
+
+    bool WritePPM(const std::string &path) const;
+
+    // an RGBA color from 0 to 1 as the framebuffer holds it, rounded the
+    // way Mesa rounds it
+    static uint32_t PackColor(const GLfloat color[4]);
+
+    // Render the triangles with every kernel, on 1, 2, 4... threads up to
+    // maxThreads (0 for one per core), and print the pixels per second of
+    // each, and whether they all drew the same pixels.
+    static void Benchmark(std::ostream &out, int width, int height,
+                          int maxThreads, const GLfloat clearColor[4],
+                          const GLfloat *flatColor, const GLfloat view[4],
+                          const ColorVertex *vertices, long long count);
+
+    void Report(std::ostream &out) const;
+
+private:
+    SoftwareRasterizer(const SoftwareRasterizer &);
+    SoftwareRasterizer &operator=(const SoftwareRasterizer &);
+
+    // A triangle, snapped to SubpixelBits of a pixel, with the edge
+    // functions E = a * x + b * y + c, in subpixels, which are 0 or more
+    // inside.  The colors are planes over the screen, in pixels.
+    struct Triangle {
+        int32_t a[3];
+        int32_t b[3];
+        int64_t c[3];
+        int minX;
+        int minY;
+        int maxX;           // the bounding box, in pixels, inclusive
+        int maxY;
+        GLfloat originX;    // where the color planes are measured from
+        GLfloat originY;
+        GLfloat color[4];
+        GLfloat colorDx[4];
+        GLfloat colorDy[4];
+    };
+
+    // a run of consecutive triangles, set up by one task, with the
+    // triangles in it that touch each tile
+    struct Run {
+        long long first;
+        long long count;
+        std::vector<Triangle> triangles;
+        std::vector<std::vector<int> > bins;
+    };
+
+    struct FrameStats {
+        double binMs;
+        double rasterMs;
+        long long triangles;    // set up, after clipping
+        long long binned;       // triangle and tile pairs
+    };
+
+    typedef void (SoftwareRasterizer::*TaskFunction)(int task);
+
+    void SetUp(const ColorVertex *in, Run &run) const;
+    void AddTriangle(const GLfloat x[3], const GLfloat y[3],
+                     const Triangle &colors, Run &run) const;
+    void Bin(Run &run, int index) const;
+    void SetUpRun(int task);
+    void DrawTile(int task);
+    void DrawTriangle(const Triangle &triangle, int tileX, int tileY);
+
+    // run count tasks on every thread, and wait for them
+    void RunTasks(TaskFunction function, int count);
+    void Work();
+    void WorkerLoop();
+
+    Kernel kernel;
+    int threadCount;
+
+    int width;
+    int height;
+    int stride;             // pixels per row, a whole number of tiles
+    int tilesX;
+    int tilesY;
+    std::vector<uint32_t> pixels;
+
+    uint32_t clearColor;
+    bool flat;
+    uint32_t flatColor;
+    GLfloat view[4];
+
+    // this frame's triangles
+    const ColorVertex *vertices;
+    std::vector<Run> runs;
+
+    // The workers wait for a new task number, and run the task function
+    // on the tasks they take from nextTask.  finishedTasks tells the
+    // calling thread when they are all done.
+    std::vector<std::thread> workers;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    long long taskNumber;
+    bool stopping;
+    TaskFunction taskFunction;
+    int taskCount;
+    std::atomic<int> nextTask;
+    std::atomic<int> finishedTasks;
+
+    std::vector<FrameStats> frames;
+};
+
+#endif // SOFTWARE_RASTERIZER_H
@@ -0,0 +1,86 @@
+//============================================================================
+// Name        : SpscQueue.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : A fixed size, lock-free queue for exactly one producer
+//               thread and one consumer thread.
+//
+//               The producer only ever writes the tail, and the consumer
+//               only ever writes the head, so neither has to lock, or wait
+//               on the other.  The release store of an index publishes the
+//               slot it covers, and the acquire load on the other side
+//               makes sure we see it.
+//
+//               The indexes only ever count up, and wrap around the ring
+//               with a mask, so full (tail - head == Capacity) and empty
+//               (tail == head) are never confused.
+//
+//============================================================================
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+template <typename T, size_t Capacity>
+class SpscQueue {
+public:
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+
+    SpscQueue()
+        : head(0),
+          tail(0)
+    {
+    }
+
+    // Producer only.  Returns false, without waiting, if the queue is full.
+    bool Push(const T &item)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+
+        if (t - head.load(std::memory_order_acquire) == Capacity)
+            return false;
+
+        items[t & Mask] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only.  Returns false, without waiting, if the queue is empty.
+    bool Pop(T &item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+
+        if (h == tail.load(std::memory_order_acquire))
+            return false;
+
+        item = items[h & Mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Only a snapshot: the other thread may change it straight away
+    size_t Size() const
+    {
+        size_t h = head.load(std::memory_order_acquire);
+        size_t t = tail.load(std::memory_order_acquire);
+        return t - h;
+    }
+
+private:
+    SpscQueue(const SpscQueue &);
+    SpscQueue &operator=(const SpscQueue &);
+
+    static const size_t Mask = Capacity - 1;
+
+    // Note: each index gets a cache line to itself, so the two threads
+    //       aren't fighting over one line every time they touch theirs.
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+    alignas(64) T items[Capacity];
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,161 @@
+//============================================================================
+// Name        : StartupTrace.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Times each step of getting to our first frame.
+//
+//============================================================================
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#include "StartupTrace.h"
+
+// Note: our names are plain, but a quote would still break the file
+static void WriteJsonString(std::ostream &out, const char *text)
+{
+    out << '"';
+    for (; *text != '\0'; text++) {
+        if (*text == '"' || *text == '\\')
+            out << '\\';
+        out << *text;
+    }
+    out << '"';
+}
+
+StartupTrace::StartupTrace(Clock::time_point start)
+    : start(start)
+{
+}
+
+void StartupTrace::Begin(const char *name)
+{
+    long long now = Now();
+    std::lock_guard<std::mutex> lock(mutex);
+
+    int thread = ThreadNumber();
+    std::vector<size_t> &stack = open[thread];
+
+    Phase phase = {name, now, now, thread, static_cast<int>(stack.size())};
+    stack.push_back(phases.size());
+    phases.push_back(phase);
+}
+
+void StartupTrace::End()
+{
+    long long now = Now();
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<size_t> &stack = open[ThreadNumber()];
+    if (stack.empty())
+        return;
+
+    phases[stack.back()].endUs = now;
+    stack.pop_back();
+}
+
+void StartupTrace::NameThread(const char *name)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    threadNames[ThreadNumber()] = name;
+}
+
+double StartupTrace::Milliseconds() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    long long endUs = 0;
+    for (size_t i = 0; i < phases.size(); i++)
+        endUs = std::max(endUs, phases[i].endUs);
+
+    return endUs / 1000.0;
+}
+
+bool StartupTrace::WriteJson(const std::string &path) const
+{
+    std::ofstream file(path.c_str());
+    if (!file)
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Note: "X" is a complete event, with its duration, and "M" names a
+    //       thread.  The times are in microseconds.
+    file << "{\"traceEvents\":[\n";
+
+    bool first = true;
+    for (std::map<int, const char *>::const_iterator name =
+             threadNames.begin(); name != threadNames.end(); ++name) {
+        file << (first ? "" : ",\n")
+             << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+             << name->first << ",\"args\":{\"name\":";
+        WriteJsonString(file, name->second);
+        file << "}}";
+        first = false;
+    }
+
+    for (size_t i = 0; i < phases.size(); i++) {
+        const Phase &phase = phases[i];
+
+        file << (first ? "" : ",\n") << "{\"name\":";
+        WriteJsonString(file, phase.name);
+        file << ",\"ph\":\"X\",\"ts\":" << phase.beginUs
+             << ",\"dur\":" << phase.endUs - phase.beginUs
+             << ",\"pid\":1,\"tid\":" << phase.thread << "}";
+        first = false;
+    }
+
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return static_cast<bool>(file);
+}
+
+void StartupTrace::Report(std::ostream &out) const
+{
+    double totalMs = Milliseconds();
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    out << std::fixed << std::setprecision(3);
+    out << "Startup phases (ms from start, ms taken):" << std::endl;
+
+    for (size_t i = 0; i < phases.size(); i++) {
+        const Phase &phase = phases[i];
+        std::string name = std::string(2 * phase.depth, ' ') + phase.name;
+
+        out << "    " << std::left << std::setw(28) << name << std::right
+            << std::setw(10) << phase.beginUs / 1000.0
+            << std::setw(10) << (phase.endUs - phase.beginUs) / 1000.0;
+        if (phase.thread != 1)
+            out << "  (thread " << phase.thread << ")";
+        out << std::endl;
+    }
+
+    out << "Time to first frame: " << totalMs << " ms" << std::endl;
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+int StartupTrace::ThreadNumber()
+{
+    std::thread::id id = std::this_thread::get_id();
+
+    std::map<std::thread::id, int>::iterator found = threads.find(id);
+    if (found != threads.end())
+        return found->second;
+
+    int number = static_cast<int>(threads.size()) + 1;
+    threads[id] = number;
+    return number;
+}
+
+long long StartupTrace::Now() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        Clock::now() - start).count();
+}
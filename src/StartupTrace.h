@@ -0,0 +1,79 @@
+//============================================================================
+// Name        : StartupTrace.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Times each step of getting to our first frame.
+//
+//               "Startup took 80 ms" doesn't say where the 80 ms went.
+//               Each step, from creating the context to the end of the
+//               first frame, is a phase: Begin() and End() on the thread
+//               that does it, nested in whatever phase that thread is in.
+//               They can be written out in the Chrome trace event format,
+//               for chrome://tracing or Perfetto, which lays them out on a
+//               timeline, a row per thread, or reported as a table.
+//
+//               Only a few dozen phases are ever recorded, so each one
+//               takes a lock, and nothing is done to make them cheap.
+//
+//============================================================================
+
+#ifndef STARTUP_TRACE_H
+#define STARTUP_TRACE_H
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class StartupTrace {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // every phase is timed from start, which is usually the start of main()
+    explicit StartupTrace(Clock::time_point start);
+
+    // Note: the names are kept, not copied, so they have to be literals
+    void Begin(const char *name);
+    void End();
+
+    // call it this, in the trace
+    void NameThread(const char *name);
+
+    // from the start to the end of the last phase
+    double Milliseconds() const;
+
+    bool WriteJson(const std::string &path) const;
+    void Report(std::ostream &out) const;
+
+private:
+    StartupTrace(const StartupTrace &);
+    StartupTrace &operator=(const StartupTrace &);
+
+    struct Phase {
+        const char *name;
+        long long beginUs;
+        long long endUs;
+        int thread;
+        int depth;
+    };
+
+    // our number for the calling thread, from 1 up
+    int ThreadNumber();
+    long long Now() const;
+
+    Clock::time_point start;
+
+    mutable std::mutex mutex;
+    std::vector<Phase> phases;
+    std::map<std::thread::id, int> threads;
+    std::map<int, const char *> threadNames;
+
+    // the phases each thread has begun but not ended, innermost last
+    std::map<int, std::vector<size_t> > open;
+};
+
+#endif // STARTUP_TRACE_H
@@ -0,0 +1,254 @@
+//============================================================================
+// Name        : StreamingBuffer.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : A ring of per-frame regions in one vertex buffer, for data
+//               that we generate on the CPU every frame.
+//
+//============================================================================
+
+#include <chrono>
+#include <iomanip>
+
+#include "StreamingBuffer.h"
+#include "DebugLog.h"
+#include "GLStateCache.h"
+
+StreamingBuffer::StreamingBuffer()
+    : strategy(StrategyOrphaned),
+      regionSize(0),
+      regionCount(0),
+      region(0),
+      regionUsed(0),
+      frameStarted(false),
+      frames(0),
+      totalBytes(0),
+      frameBytes(0),
+      maxFrameBytes(0),
+      waits(0),
+      waitMs(0.0),
+      maxWaitMs(0.0),
+      orphans(0)
+{
+    for (int i = 0; i < MaxRegions; i++)
+        fences[i] = 0;
+}
+
+const char *StreamingBuffer::StrategyName(Strategy strategy)
+{
+    switch (strategy) {
+    case StrategyFenced:
+        return "mapped ring with fences";
+    case StrategyRing:
+        return "mapped ring, invalidated on wrap";
+    default:
+        return "orphaned every frame";
+    }
+}
+
+bool StreamingBuffer::Create(GLsizeiptr size, int count)
+{
+    if (size <= 0 || count < 1 || count > MaxRegions) {
+        Log("Bad streaming buffer size");
+        return false;
+    }
+
+    bool mapRange = GLL_VERSION_3_0 || GLL_ARB_map_buffer_range;
+    bool fenceSync = GLL_VERSION_3_2 || GLL_ARB_sync;
+
+    if (mapRange && fenceSync) {
+        strategy = StrategyFenced;
+    }
+    else if (mapRange) {
+        strategy = StrategyRing;
+    }
+    else {
+        strategy = StrategyOrphaned;
+    }
+
+    regionSize = size;
+
+    // orphaning gives us fresh storage every frame, so one region will do
+    regionCount = (strategy == StrategyOrphaned) ? 1 : count;
+
+    GLStateCache &state = GLStateCache::Current();
+
+    buffer = GLBuffer::Create();
+    state.BindBuffer(GL_ARRAY_BUFFER, buffer.Get());
+    glBufferData(GL_ARRAY_BUFFER, regionSize * regionCount, NULL,
+                 GL_STREAM_DRAW);
+    state.BindBuffer(GL_ARRAY_BUFFER, 0);
+
+    Log("Streaming buffer: %d x %lld bytes, %s", regionCount,
+        static_cast<long long>(regionSize), StrategyName(strategy));
+
+    return true;
+}
+
+void *StreamingBuffer::Map(GLsizeiptr size, GLintptr &offset)
+{
+    GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, buffer.Get());
+
+    GLbitfield invalidate = GL_MAP_INVALIDATE_RANGE_BIT;
+
+    if (!frameStarted) {
+        frameStarted = true;
+
+        if (strategy == StrategyFenced) {
+            WaitForRegion(region);
+        }
+        else if (strategy == StrategyRing && region == 0 && frames > 0) {
+            // back at the start, let the driver give us new memory
+            invalidate = GL_MAP_INVALIDATE_BUFFER_BIT;
+            orphans++;
+        }
+        else if (strategy == StrategyOrphaned) {
+            glBufferData(GL_ARRAY_BUFFER, regionSize, NULL, GL_STREAM_DRAW);
+            orphans++;
+        }
+    }
+
+    if (regionUsed + size > regionSize) {
+        Log("Streaming buffer overflow, %lld bytes in a %lld byte region",
+            static_cast<long long>(regionUsed + size),
+            static_cast<long long>(regionSize));
+        return nullptr;
+    }
+
+    offset = region * regionSize + regionUsed;
+
+    void *data = nullptr;
+
+    if (strategy == StrategyOrphaned) {
+        // Note: the storage is new this frame, and we don't draw from it
+        //       until every Map() is done, so this doesn't wait on the GPU.
+        char *base = static_cast<char *>(glMapBuffer(GL_ARRAY_BUFFER,
+                                                     GL_WRITE_ONLY));
+        data = (base != nullptr) ? base + offset : nullptr;
+    }
+    else {
+        // We did our own synchronization, or the region was invalidated,
+        // so tell the driver not to do it for us.
+        data = glMapBufferRange(GL_ARRAY_BUFFER, offset, size,
+                                GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT |
+                                invalidate);
+    }
+
+    if (data == nullptr) {
+        Log("Failed to map the streaming buffer");
+        return nullptr;
+    }
+
+    regionUsed += size;
+    frameBytes += size;
+
+    return data;
+}
+
+void StreamingBuffer::Unmap()
+{
+    GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, buffer.Get());
+
+    if (glUnmapBuffer(GL_ARRAY_BUFFER) != GL_TRUE) {
+        // the data was lost, e.g. after a mode switch.  It will be right
+        // again next frame.
+        Log("Streaming buffer contents were lost");
+    }
+}
+
+void StreamingBuffer::EndFrame()
+{
+    if (!frameStarted)
+        return;
+
+    if (strategy == StrategyFenced) {
+        fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    region = (region + 1) % regionCount;
+    regionUsed = 0;
+    frameStarted = false;
+
+    frames++;
+    totalBytes += frameBytes;
+    if (frameBytes > maxFrameBytes)
+        maxFrameBytes = frameBytes;
+    frameBytes = 0;
+}
+
+void StreamingBuffer::WaitForRegion(int r)
+{
+    if (fences[r] == 0)
+        return;
+
+    // the common case, hopefully: the GPU finished with it long ago
+    GLenum result = glClientWaitSync(fences[r], 0, 0);
+
+    if (result == GL_TIMEOUT_EXPIRED) {
+        typedef std::chrono::steady_clock Clock;
+        Clock::time_point start = Clock::now();
+
+        // flush on the first try, or we could be waiting on commands
+        // that the GPU hasn't even been given yet.
+        GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        const GLuint64 oneMillisecond = 1000000;
+
+        do {
+            result = glClientWaitSync(fences[r], flags, oneMillisecond);
+            flags = 0;
+        } while (result == GL_TIMEOUT_EXPIRED);
+
+        std::chrono::duration<double, std::milli> elapsed =
+            Clock::now() - start;
+
+        waits++;
+        waitMs += elapsed.count();
+        if (elapsed.count() > maxWaitMs)
+            maxWaitMs = elapsed.count();
+    }
+
+    if (result == GL_WAIT_FAILED) {
+        Log("Waiting on a streaming buffer fence failed");
+    }
+
+    glDeleteSync(fences[r]);
+    fences[r] = 0;
+}
+
+void StreamingBuffer::Report(std::ostream &out) const
+{
+    double averageBytes = (frames > 0) ?
+                          static_cast<double>(totalBytes) / frames : 0.0;
+
+    out << std::fixed << std::setprecision(3)
+        << "Streaming buffer (" << StrategyName(strategy) << ")" << std::endl
+        << "    uploaded " << totalBytes / 1.0e6 << " MB over "
+        << frames << " frames, "
+        << averageBytes / 1.0e6 << " MB/frame average, "
+        << maxFrameBytes / 1.0e6 << " MB/frame max" << std::endl;
+
+    if (strategy == StrategyFenced) {
+        out << "    waited on the GPU " << waits << " times, "
+            << waitMs << " ms total, " << maxWaitMs << " ms max"
+            << std::endl;
+    }
+    else {
+        out << "    buffer orphaned " << orphans << " times" << std::endl;
+    }
+
+    out.unsetf(std::ios_base::floatfield);
+    out << std::setprecision(6);
+}
+
+void StreamingBuffer::Destroy()
+{
+    for (int i = 0; i < MaxRegions; i++) {
+        if (fences[i] != 0) {
+            glDeleteSync(fences[i]);
+            fences[i] = 0;
+        }
+    }
+
+    buffer.Reset();
+}
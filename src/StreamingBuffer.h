@@ -0,0 +1,109 @@
+//============================================================================
+// Name        : StreamingBuffer.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : A vertex buffer for data that we generate on the CPU every
+//               frame.
+//
+//               If we simply called glBufferSubData() on a buffer that the
+//               GPU is still drawing from, the driver would have to either
+//               wait for the GPU to finish or make a copy behind our backs.
+//               Instead, the buffer is split into a ring of regions, one per
+//               frame in flight (three by default), and each frame writes
+//               into the next region while the GPU reads the older ones.
+//
+//               How we keep from writing over data the GPU still needs
+//               depends on what the driver gives us:
+//               - Fenced: glMapBufferRange() with the unsynchronized and
+//                 invalidate range flags, and a fence (GL_ARB_sync) after
+//                 each frame, which we check before reusing its region.
+//               - Ring: glMapBufferRange() without fences.  We invalidate
+//                 the whole buffer each time the ring wraps around, which
+//                 lets the driver hand us fresh memory.
+//               - Orphaned: plain OpenGL 2.1.  We re-specify the buffer with
+//                 glBufferData(NULL) at the start of every frame, and the
+//                 driver gives us new storage while the GPU keeps the old.
+//
+//============================================================================
+
+#ifndef STREAMING_BUFFER_H
+#define STREAMING_BUFFER_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <ostream>
+
+#include "GLHandle.h"
+
+class StreamingBuffer {
+public:
+    enum Strategy {
+        StrategyFenced = 0,
+        StrategyRing,
+        StrategyOrphaned
+    };
+
+    static const int DefaultRegionCount = 3;
+
+    StreamingBuffer();
+
+    // regionSize is the most we will ever write in one frame.
+    // Must be called with a current context, after GLLoaderInit().
+    bool Create(GLsizeiptr regionSize,
+                int regionCount = DefaultRegionCount);
+
+    // Reserve size bytes in this frame's region, and return a pointer
+    // that we can write them to.  offset receives where the data will be
+    // in the buffer, for glVertexAttribPointer().
+    // The buffer is left bound to GL_ARRAY_BUFFER.
+    void *Map(GLsizeiptr size, GLintptr &offset);
+
+    // Must be called before drawing from the data that was written
+    void Unmap();
+
+    // Call once the frame's draw calls have been submitted
+    void EndFrame();
+
+    void Destroy();
+
+    GLuint Buffer() const { return buffer.Get(); }
+    Strategy ActiveStrategy() const { return strategy; }
+    static const char *StrategyName(Strategy strategy);
+
+    // bytes uploaded, and how often and how long we had to wait for the GPU
+    void Report(std::ostream &out) const;
+
+private:
+    StreamingBuffer(const StreamingBuffer &);
+    StreamingBuffer &operator=(const StreamingBuffer &);
+
+    static const int MaxRegions = 8;
+
+    // wait for the GPU to be done with a region, counting the stall
+    void WaitForRegion(int region);
+
+    Strategy strategy;
+    GLBuffer buffer;
+
+    GLsizeiptr regionSize;
+    int regionCount;
+    int region;
+    GLsizeiptr regionUsed;
+    bool frameStarted;
+
+    GLsync fences[MaxRegions];
+
+    // statistics
+    long long frames;
+    long long totalBytes;
+    long long frameBytes;
+    long long maxFrameBytes;
+    long long waits;
+    double waitMs;
+    double maxWaitMs;
+    long long orphans;
+};
+
+#endif // STREAMING_BUFFER_H
@@ -0,0 +1,823 @@
+//============================================================================
+// Name        : TriangleBatch.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Draws many copies of our triangle, instanced where the
+//               driver supports it, merged into one big buffer where not,
+//               or with their data in a uniform or texture buffer.
+//
+//============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "TriangleBatch.h"
+#include "DebugLog.h"
+#include "GLStateCache.h"
+
+// Both paths share the same shaders.  The merged path has already applied
+// the transform and the color on the CPU, so it disables the per-instance
+// arrays and leaves an identity transform and a white color in their place.
+static const GLchar *batchVertexShaderSource =
+    "#if __VERSION__ >= 140\n"
+    "    in vec3 position;\n"
+    "    in vec3 vertex_color;\n"
+    "    in vec4 instance_transform;\n"
+    "    in vec4 instance_color;\n"
+    "    out vec4 color;\n"
+    "#else\n"
+    "    attribute vec3 position;\n"
+    "    attribute vec3 vertex_color;\n"
+    "    attribute vec4 instance_transform;\n"
+    "    attribute vec4 instance_color;\n"
+    "    varying vec4 color;\n"
+    "#endif\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    // transform is (x offset, y offset, scale, rotation)\n"
+    "    float c = cos(instance_transform.w);\n"
+    "    float s = sin(instance_transform.w);\n"
+    "    vec2 rotated = mat2(c, s, -s, c) * position.xy;\n"
+    "\n"
+    "    color = vec4(vertex_color, 1.0) * instance_color;\n"
+    "    gl_Position = vec4(rotated * instance_transform.z +\n"
+    "                       instance_transform.xy,\n"
+    "                       position.z, 1.0);\n"
+    "}\n";
+
+static const GLchar *batchFragmentShaderSource =
+    "#if __VERSION__ >= 140\n"
+    "    in vec4 color;\n"
+    "    varying out vec4 out_color;\n"
+    "#else\n"
+    "    varying vec4 color;\n"
+    "#endif\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "#if __VERSION__ >= 140\n"
+    "    out_color = color;\n"
+    "#else\n"
+    "    gl_FragColor = color;\n"
+    "#endif\n"
+    "}\n";
+
+// The uniform and texture buffer paths read each copy's transform and
+// color from a buffer instead, as two vec4s, copy gl_InstanceID's.  A
+// texture buffer can be as big as we like, so the draw call's first copy
+// comes in a uniform, but a uniform block holds ObjectsPerBlock copies
+// (1024 vec4s), and each draw call binds the range of the buffer it needs.
+#define OBJECT_VERTEX_SHADER_BODY                                            \
+    "in vec3 position;\n"                                                    \
+    "in vec3 vertex_color;\n"                                                \
+    "out vec4 color;\n"                                                      \
+    "\n"                                                                     \
+    "#ifdef OBJECTS_IN_TEXTURE_BUFFER\n"                                     \
+    "uniform samplerBuffer objects;\n"                                       \
+    "uniform int first_object;\n"                                           \
+    "\n"                                                                     \
+    "vec4 ObjectData(int i)\n"                                               \
+    "{\n"                                                                    \
+    "    int object = first_object + gl_InstanceID;\n"                       \
+    "    return texelFetch(objects, object * 2 + i);\n"                      \
+    "}\n"                                                                    \
+    "#else\n"                                                                \
+    "layout(std140) uniform Objects {\n"                                     \
+    "    vec4 objects[1024];\n"                                              \
+    "};\n"                                                                   \
+    "\n"                                                                     \
+    "vec4 ObjectData(int i)\n"                                               \
+    "{\n"                                                                    \
+    "    return objects[gl_InstanceID * 2 + i];\n"                           \
+    "}\n"                                                                    \
+    "#endif\n"                                                               \
+    "\n"                                                                     \
+    "void main()\n"                                                          \
+    "{\n"                                                                    \
+    "    // transform is (x offset, y offset, scale, rotation)\n"            \
+    "    vec4 transform = ObjectData(0);\n"                                  \
+    "    float c = cos(transform.w);\n"                                      \
+    "    float s = sin(transform.w);\n"                                      \
+    "    vec2 rotated = mat2(c, s, -s, c) * position.xy;\n"                  \
+    "\n"                                                                     \
+    "    color = vec4(vertex_color, 1.0) * ObjectData(1);\n"                 \
+    "    gl_Position = vec4(rotated * transform.z + transform.xy,\n"         \
+    "                       position.z, 1.0);\n"                             \
+    "}\n"
+
+static const GLchar *uniformBufferVertexShaderSource =
+    "#version 140\n"
+    OBJECT_VERTEX_SHADER_BODY;
+
+static const GLchar *textureBufferVertexShaderSource =
+    "#version 140\n"
+    "#define OBJECTS_IN_TEXTURE_BUFFER\n"
+    OBJECT_VERTEX_SHADER_BODY;
+
+static const GLchar *objectFragmentShaderSource =
+    "#version 140\n"
+    "in vec4 color;\n"
+    "out vec4 out_color;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    out_color = color;\n"
+    "}\n";
+
+// where the uniform block is bound, and the buffer texture's unit
+static const GLuint ObjectBlockBinding = 0;
+static const GLint ObjectTextureUnit = 0;
+
+// attribute locations, bound before linking
+static const GLuint PositionLocation = 0;
+static const GLuint VertexColorLocation = 1;
+static const GLuint InstanceTransformLocation = 2;
+static const GLuint InstanceColorLocation = 3;
+
+// The merged buffer is filled this many triangles at a time, so we never
+// need a copy of the whole thing in system memory.
+static const long long MergeChunkSize = 65536;
+
+static const VertexAttribute instanceAttributes[] = {
+    VERTEX_ATTRIBUTE(TriangleBatch::Instance, transform,
+                     InstanceTransformLocation, "instance_transform"),
+    VERTEX_ATTRIBUTE(TriangleBatch::Instance, color,
+                     InstanceColorLocation, "instance_color")
+};
+
+// Note: this puts the position and color at PositionLocation and
+//       VertexColorLocation
+static const VertexFormat vertexFormat = VertexFormat::ColorVertexFormat();
+static const VertexFormat instanceFormat =
+    VertexFormat::Of<TriangleBatch::Instance>(instanceAttributes);
+
+// every merged or streamed vertex has its final position and color
+static const long long BytesPerTriangle = 3 * sizeof(TriangleBatch::Vertex);
+
+// one ObjectsPerBlock uniform block, as the shader declares it
+static const GLsizeiptr ObjectBlockBytes =
+    TriangleBatch::ObjectsPerBlock * sizeof(TriangleBatch::Instance);
+
+static_assert(sizeof(TriangleBatch::Instance) == 32,
+              "An Instance should be two std140 vec4s");
+
+// the streamed copies spin, and we pretend each frame takes this long,
+// so that a benchmark always renders the same sequence of frames.
+static const double StreamedFrameSeconds = 1.0 / 60.0;
+
+// a cheap, stateless hash, so that copy i always gets the same
+// rotation and color, no matter which chunk it was generated in.
+static GLfloat HashUnit(long long index, unsigned int salt)
+{
+    unsigned int x = static_cast<unsigned int>(index) * 0x9E3779B1u ^ salt;
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+
+    return (x & 0xFFFFFF) / static_cast<GLfloat>(0x1000000);
+}
+
+// Apply each copy's transform and color to the triangle on the CPU,
+// the same math as the vertex shader, writing 3 vertices per copy.
+static void WriteTriangles(const TriangleBatch::Instance *instances,
+                           long long count, const GLfloat positions[9],
+                           const GLfloat colors[9],
+                           TriangleBatch::Vertex *out)
+{
+    for (long long i = 0; i < count; i++) {
+        const TriangleBatch::Instance &instance = instances[i];
+        GLfloat c = std::cos(instance.transform[3]);
+        GLfloat s = std::sin(instance.transform[3]);
+        GLfloat scale = instance.transform[2];
+
+        for (int v = 0; v < 3; v++) {
+            GLfloat x = positions[v * 3];
+            GLfloat y = positions[v * 3 + 1];
+
+            out->position[0] = (c * x - s * y) * scale +
+                               instance.transform[0];
+            out->position[1] = (s * x + c * y) * scale +
+                               instance.transform[1];
+            out->position[2] = positions[v * 3 + 2];
+            out->color[0] = ToUNorm8(colors[v * 3] * instance.color[0]);
+            out->color[1] = ToUNorm8(colors[v * 3 + 1] * instance.color[1]);
+            out->color[2] = ToUNorm8(colors[v * 3 + 2] * instance.color[2]);
+            out->color[3] = ToUNorm8(1.0f);
+            out++;
+        }
+    }
+}
+
+TriangleBatch::TriangleBatch()
+    : mode(ModeMerged),
+      triangleCount(0),
+      batchSize(0),
+      gridColumns(1),
+      programHandle(-1),
+      animationFrames(0),
+      paused(false),
+      spinning(false),
+      firstObjectLocation(-1),
+      uploads(0),
+      uploadedBytes(0)
+{
+    for (int i = 0; i < 9; i++) {
+        basePositions[i] = 0.0f;
+        baseColors[i] = 0.0f;
+    }
+}
+
+bool TriangleBatch::InstancingSupported()
+{
+    bool divisor = GLL_VERSION_3_3 || GLL_ARB_instanced_arrays;
+    bool drawInstanced = GLL_VERSION_3_1 || GLL_ARB_draw_instanced;
+
+    return divisor && drawInstanced;
+}
+
+bool TriangleBatch::ObjectBuffersSupported()
+{
+    // Note: the shaders are GLSL 1.40, for gl_InstanceID, uniform blocks
+    //       and texelFetch() on a samplerBuffer, which is OpenGL 3.1
+    return GLL_VERSION_3_1;
+}
+
+const char *TriangleBatch::ModeName(Mode mode)
+{
+    switch (mode) {
+    case ModeInstanced:
+        return "instanced";
+    case ModeMerged:
+        return "merged";
+    case ModeStreamed:
+        return "streamed";
+    case ModeUniformBuffer:
+        return "uniform buffer";
+    case ModeTextureBuffer:
+        return "texture buffer";
+    default:
+        return "auto";
+    }
+}
+
+bool TriangleBatch::Create(ProgramCache &programCache,
+                           const GLfloat positions[9],
+                           const GLfloat colors[9],
+                           long long count, long long size,
+                           Mode requestedMode)
+{
+    if (requestedMode == ModeInstanced && !InstancingSupported()) {
+        Log("Instanced arrays are not supported by this platform");
+        return false;
+    }
+
+    bool objectMode = requestedMode == ModeUniformBuffer ||
+                      requestedMode == ModeTextureBuffer;
+
+    if (objectMode && !ObjectBuffersSupported()) {
+        // the same spinning copies, with GLSL 1.20 per-instance attributes
+        // if we have them, and on the CPU if we don't
+        requestedMode = InstancingSupported() ? ModeInstanced :
+                                                ModeStreamed;
+        Log("Uniform and texture buffers need OpenGL 3.1, falling back to "
+            "the %s path", ModeName(requestedMode));
+    }
+
+    if (requestedMode == ModeAuto) {
+        mode = InstancingSupported() ? ModeInstanced : ModeMerged;
+    }
+    else {
+        mode = requestedMode;
+    }
+
+    spinning = objectMode && mode != ModeStreamed;
+
+    triangleCount = count;
+    batchSize = (size <= 0 || size > count) ? count : size;
+
+    // a square grid, with just enough columns to fit everything
+    gridColumns = static_cast<int>(std::ceil(std::sqrt(
+                      static_cast<double>(triangleCount))));
+    if (gridColumns < 1)
+        gridColumns = 1;
+
+    // the driver compiles our shaders while we fill the buffers, and
+    // whatever the caller sets up after us
+    programHandle = SubmitProgram(programCache);
+
+    VAO = GLVertexArray::Create();
+    glBindVertexArray(VAO.Get());
+
+    if (mode == ModeInstanced) {
+        CreateInstancedBuffers(positions, colors);
+    }
+    else if (mode == ModeUniformBuffer || mode == ModeTextureBuffer) {
+        if (!CreateObjectBuffer(positions, colors)) {
+            WaitProgram(programCache);
+            return false;
+        }
+    }
+    else if (mode == ModeStreamed) {
+        if (!CreateStreamedBuffer(positions, colors)) {
+            WaitProgram(programCache);
+            return false;
+        }
+    }
+    else {
+        CreateMergedBuffer(positions, colors);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    Log("Drawing %lld triangles in %lld draw calls (%s)", triangleCount,
+        DrawCalls(), ModeName(mode));
+
+    return true;
+}
+
+bool TriangleBatch::ProgramReady(ProgramCache &programCache)
+{
+    return programHandle < 0 || programCache.Ready(programHandle);
+}
+
+bool TriangleBatch::WaitProgram(ProgramCache &programCache)
+{
+    if (programHandle < 0)
+        return static_cast<bool>(program);
+
+    program.Reset(programCache.Wait(programHandle));
+    programHandle = -1;
+
+    if (!program)
+        return false;
+
+    if (mode == ModeUniformBuffer || mode == ModeTextureBuffer)
+        BindObjectUniforms();
+
+    return true;
+}
+
+int TriangleBatch::SubmitProgram(ProgramCache &programCache)
+{
+    std::vector<AttributeBinding> attributes =
+        vertexFormat.AttributeBindings();
+
+    if (mode == ModeUniformBuffer) {
+        return programCache.Submit(
+                   "triangle_batch_uniform_buffer",
+                   uniformBufferVertexShaderSource,
+                   objectFragmentShaderSource,
+                   attributes.data(), static_cast<int>(attributes.size()));
+    }
+
+    if (mode == ModeTextureBuffer) {
+        return programCache.Submit(
+                   "triangle_batch_texture_buffer",
+                   textureBufferVertexShaderSource,
+                   objectFragmentShaderSource,
+                   attributes.data(), static_cast<int>(attributes.size()));
+    }
+
+    std::vector<AttributeBinding> instanceBindings =
+        instanceFormat.AttributeBindings();
+    attributes.insert(attributes.end(), instanceBindings.begin(),
+                      instanceBindings.end());
+
+    return programCache.Submit(
+               "triangle_batch",
+               batchVertexShaderSource, batchFragmentShaderSource,
+               attributes.data(), static_cast<int>(attributes.size()));
+}
+
+void TriangleBatch::CreateInstances(Instance *instances, long long first,
+                                    long long count) const
+{
+    // each copy sits in its own grid cell, filling the viewport
+    // from the top left, with a random rotation and color.
+    const GLfloat cell = 2.0f / gridColumns;
+    const GLfloat twoPi = 6.2831853f;
+
+    for (long long i = 0; i < count; i++) {
+        long long index = first + i;
+        long long column = index % gridColumns;
+        long long row = index / gridColumns;
+
+        Instance &instance = instances[i];
+        instance.transform[0] = -1.0f + cell * (column + 0.5f);
+        instance.transform[1] = 1.0f - cell * (row + 0.5f);
+        instance.transform[2] = cell * 0.9f;
+        instance.transform[3] = (triangleCount == 1) ? 0.0f :
+                                twoPi * HashUnit(index, 0x1234567u);
+
+        instance.color[0] = 0.4f + 0.6f * HashUnit(index, 0x2345678u);
+        instance.color[1] = 0.4f + 0.6f * HashUnit(index, 0x3456789u);
+        instance.color[2] = 0.4f + 0.6f * HashUnit(index, 0x456789Au);
+        instance.color[3] = 1.0f;
+    }
+}
+
+void TriangleBatch::SpinInstances(Instance *instances, long long first,
+                                  long long count, double seconds) const
+{
+    // each copy spins at its own rate, up to half a turn per second
+    for (long long i = 0; i < count; i++) {
+        GLfloat spin = (triangleCount == 1) ? 1.0f :
+                       3.1415927f * (2.0f * HashUnit(first + i,
+                                                     0x56789ABu) - 1.0f);
+        instances[i].transform[3] += static_cast<GLfloat>(spin * seconds);
+    }
+}
+
+double TriangleBatch::NextFrameSeconds()
+{
+    double seconds = animationFrames * StreamedFrameSeconds;
+    if (!paused)
+        animationFrames++;
+
+    return seconds;
+}
+
+void TriangleBatch::CreateTriangleBuffer(const GLfloat positions[9],
+                                         const GLfloat colors[9])
+{
+    // The triangle itself, interleaved position and color
+    Vertex vertices[3];
+    for (int v = 0; v < 3; v++) {
+        for (int c = 0; c < 3; c++) {
+            vertices[v].position[c] = positions[v * 3 + c];
+            vertices[v].color[c] = ToUNorm8(colors[v * 3 + c]);
+        }
+        vertices[v].color[3] = ToUNorm8(1.0f);
+    }
+
+    vertexVBO = GLBuffer::Create();
+    glBindBuffer(GL_ARRAY_BUFFER, vertexVBO.Get());
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices,
+                 GL_STATIC_DRAW);
+
+    vertexFormat.PointAttributes();
+    vertexFormat.EnableAttributes();
+}
+
+void TriangleBatch::CreateInstancedBuffers(const GLfloat positions[9],
+                                           const GLfloat colors[9])
+{
+    CreateTriangleBuffer(positions, colors);
+
+    // Then one transform and color per copy.  Spinning copies are
+    // uploaded again every frame, from objects.
+    std::vector<Instance> instances(static_cast<size_t>(triangleCount));
+    CreateInstances(instances.data(), 0, triangleCount);
+
+    instanceVBO = GLBuffer::Create();
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO.Get());
+    glBufferData(GL_ARRAY_BUFFER,
+                 static_cast<GLsizeiptr>(instances.size() * sizeof(Instance)),
+                 instances.data(),
+                 spinning ? GL_STREAM_DRAW : GL_STATIC_DRAW);
+
+    if (spinning)
+        objects.swap(instances);
+
+    instanceFormat.EnableAttributes();
+    PointInstanceAttributes(0);
+
+    // advance these attributes once per instance, not once per vertex
+    if (GLL_VERSION_3_3) {
+        glVertexAttribDivisor(InstanceTransformLocation, 1);
+        glVertexAttribDivisor(InstanceColorLocation, 1);
+    }
+    else {
+        glVertexAttribDivisorARB(InstanceTransformLocation, 1);
+        glVertexAttribDivisorARB(InstanceColorLocation, 1);
+    }
+}
+
+bool TriangleBatch::CreateObjectBuffer(const GLfloat positions[9],
+                                       const GLfloat colors[9])
+{
+    CreateTriangleBuffer(positions, colors);
+
+    // A uniform block may only start at a multiple of the offset
+    // alignment, so the copies per draw call are rounded down to that,
+    // and the buffer is padded so the last range is a whole block too.
+    size_t padding = 0;
+
+    if (mode == ModeUniformBuffer) {
+        GLint alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+        long long step = std::max(1LL, static_cast<long long>(alignment) /
+                                       static_cast<long long>(
+                                           sizeof(Instance)));
+        long long perDraw = std::min(batchSize,
+                                     static_cast<long long>(ObjectsPerBlock));
+        perDraw = std::max(step, perDraw / step * step);
+
+        if (perDraw > ObjectsPerBlock ||
+            (perDraw * sizeof(Instance)) % std::max(alignment, 1) != 0) {
+            Log("This uniform buffer alignment (%d bytes) doesn't suit our "
+                "uniform blocks", alignment);
+            return false;
+        }
+
+        batchSize = perDraw;
+        padding = ObjectsPerBlock;
+    }
+    else {
+        GLint maxTexels = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+
+        if (triangleCount * 2 > maxTexels) {
+            Log("A buffer texture can only hold %d copies here",
+                maxTexels / 2);
+            return false;
+        }
+    }
+
+    objects.assign(static_cast<size_t>(triangleCount) + padding,
+                   Instance());
+    CreateInstances(objects.data(), 0, triangleCount);
+
+    GLenum target = mode == ModeUniformBuffer ? GL_UNIFORM_BUFFER :
+                                                GL_TEXTURE_BUFFER;
+
+    objectBuffer = GLBuffer::Create();
+    glBindBuffer(target, objectBuffer.Get());
+    glBufferData(target,
+                 static_cast<GLsizeiptr>(objects.size() * sizeof(Instance)),
+                 objects.data(), GL_STREAM_DRAW);
+    glBindBuffer(target, 0);
+
+    // the buffer texture sees the buffer as RGBA float texels, two a copy
+    if (mode == ModeTextureBuffer) {
+        objectTexture = GLTexture::Create();
+        glBindTexture(GL_TEXTURE_BUFFER, objectTexture.Get());
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, objectBuffer.Get());
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+
+    return true;
+}
+
+void TriangleBatch::BindObjectUniforms()
+{
+    // Note: this is behind the state cache's back, like all our setup
+    GLuint name = program.Get();
+    glUseProgram(name);
+
+    if (mode == ModeUniformBuffer) {
+        glUniformBlockBinding(name, glGetUniformBlockIndex(name, "Objects"),
+                              ObjectBlockBinding);
+    }
+    else {
+        glUniform1i(glGetUniformLocation(name, "objects"),
+                    ObjectTextureUnit);
+        firstObjectLocation = glGetUniformLocation(name, "first_object");
+    }
+
+    glUseProgram(0);
+}
+
+void TriangleBatch::UploadObjects()
+{
+    double seconds = NextFrameSeconds();
+
+    CreateInstances(objects.data(), 0, triangleCount);
+    SpinInstances(objects.data(), 0, triangleCount, seconds);
+
+    // Note: a new glBufferData() lets the driver give us fresh storage,
+    //       instead of waiting for the last frame to finish with the old
+    GLenum target = GL_ARRAY_BUFFER;
+    GLuint buffer = instanceVBO.Get();
+
+    if (mode == ModeUniformBuffer) {
+        target = GL_UNIFORM_BUFFER;
+        buffer = objectBuffer.Get();
+    }
+    else if (mode == ModeTextureBuffer) {
+        target = GL_TEXTURE_BUFFER;
+        buffer = objectBuffer.Get();
+    }
+
+    GLsizeiptr bytes = static_cast<GLsizeiptr>(objects.size() *
+                                               sizeof(Instance));
+
+    GLStateCache::Current().BindBuffer(target, buffer);
+    glBufferData(target, bytes, objects.data(), GL_STREAM_DRAW);
+
+    uploads++;
+    uploadedBytes += bytes;
+}
+
+void TriangleBatch::CreateMergedBuffer(const GLfloat positions[9],
+                                       const GLfloat colors[9])
+{
+    vertexVBO = GLBuffer::Create();
+    glBindBuffer(GL_ARRAY_BUFFER, vertexVBO.Get());
+    glBufferData(GL_ARRAY_BUFFER,
+                 static_cast<GLsizeiptr>(triangleCount * BytesPerTriangle),
+                 NULL, GL_STATIC_DRAW);
+
+    long long chunkSize = std::min(MergeChunkSize, triangleCount);
+    std::vector<Instance> instances(static_cast<size_t>(chunkSize));
+    std::vector<Vertex> merged(static_cast<size_t>(chunkSize * 3));
+
+    for (long long first = 0; first < triangleCount; first += chunkSize) {
+        long long count = std::min(chunkSize, triangleCount - first);
+        CreateInstances(instances.data(), first, count);
+        WriteTriangles(instances.data(), count, positions, colors,
+                       merged.data());
+
+        glBufferSubData(GL_ARRAY_BUFFER,
+                        static_cast<GLintptr>(first * BytesPerTriangle),
+                        static_cast<GLsizeiptr>(count * BytesPerTriangle),
+                        merged.data());
+    }
+
+    vertexFormat.PointAttributes();
+    vertexFormat.EnableAttributes();
+
+    // Note: the per-instance attributes stay disabled here, and the
+    //       shader gets the constant values we set in Draw() instead.
+}
+
+bool TriangleBatch::CreateStreamedBuffer(const GLfloat positions[9],
+                                         const GLfloat colors[9])
+{
+    // we regenerate every copy every frame, from these
+    for (int i = 0; i < 9; i++) {
+        basePositions[i] = positions[i];
+        baseColors[i] = colors[i];
+    }
+
+    GLsizeiptr frameBytes = static_cast<GLsizeiptr>(
+                                triangleCount * BytesPerTriangle);
+
+    if (!stream.Create(frameBytes))
+        return false;
+
+    // Note: the attribute pointers move around the buffer from frame to
+    //       frame, so they are set in Draw().
+    vertexFormat.EnableAttributes();
+
+    return true;
+}
+
+bool TriangleBatch::StreamFrame()
+{
+    GLsizeiptr frameBytes = static_cast<GLsizeiptr>(
+                                triangleCount * BytesPerTriangle);
+    GLintptr offset = 0;
+
+    Vertex *out = static_cast<Vertex *>(stream.Map(frameBytes, offset));
+    if (out == nullptr)
+        return false;
+
+    double seconds = NextFrameSeconds();
+
+    long long chunkSize = std::min(MergeChunkSize, triangleCount);
+    std::vector<Instance> instances(static_cast<size_t>(chunkSize));
+
+    for (long long first = 0; first < triangleCount; first += chunkSize) {
+        long long count = std::min(chunkSize, triangleCount - first);
+        CreateInstances(instances.data(), first, count);
+        SpinInstances(instances.data(), first, count, seconds);
+
+        WriteTriangles(instances.data(), count, basePositions, baseColors,
+                       out + first * 3);
+    }
+
+    stream.Unmap();
+
+    // the buffer is still bound from Map()
+    vertexFormat.PointAttributes(offset);
+
+    return true;
+}
+
+void TriangleBatch::PointInstanceAttributes(long long firstInstance) const
+{
+    // Note: without GL_ARB_base_instance, the only way to start a batch
+    //       part way through the instance buffer is to move the pointers.
+    //       The instance buffer must be bound.
+    instanceFormat.PointAttributes(static_cast<GLintptr>(firstInstance) *
+                                   sizeof(Instance));
+}
+
+long long TriangleBatch::DrawCalls() const
+{
+    if (batchSize <= 0)
+        return 0;
+
+    return (triangleCount + batchSize - 1) / batchSize;
+}
+
+void TriangleBatch::Draw()
+{
+    GLStateCache &state = GLStateCache::Current();
+
+    state.UseProgram(program.Get());
+    state.BindVertexArray(VAO.Get());
+
+    // a streamed batch is regenerated on the CPU before every draw
+    if (mode == ModeStreamed && !StreamFrame())
+        return;
+
+    // spinning copies are uploaded once, for all the draw calls
+    if (spinning)
+        UploadObjects();
+
+    if (mode == ModeUniformBuffer || mode == ModeTextureBuffer) {
+        if (mode == ModeTextureBuffer) {
+            glActiveTexture(GL_TEXTURE0 + ObjectTextureUnit);
+            glBindTexture(GL_TEXTURE_BUFFER, objectTexture.Get());
+        }
+
+        for (long long first = 0; first < triangleCount; first += batchSize) {
+            GLsizei count = static_cast<GLsizei>(
+                                std::min(batchSize, triangleCount - first));
+
+            if (mode == ModeUniformBuffer) {
+                glBindBufferRange(GL_UNIFORM_BUFFER, ObjectBlockBinding,
+                                  objectBuffer.Get(),
+                                  static_cast<GLintptr>(first *
+                                                        sizeof(Instance)),
+                                  ObjectBlockBytes);
+            }
+            else {
+                glUniform1i(firstObjectLocation, static_cast<GLint>(first));
+            }
+
+            glDrawArraysInstanced(GL_TRIANGLES, 0, 3, count);
+        }
+    }
+    else if (mode == ModeInstanced) {
+        bool coreDrawInstanced = GLL_VERSION_3_1;
+        bool moveInstancePointers = DrawCalls() > 1;
+
+        if (moveInstancePointers)
+            state.BindBuffer(GL_ARRAY_BUFFER, instanceVBO.Get());
+
+        for (long long first = 0; first < triangleCount; first += batchSize) {
+            GLsizei count = static_cast<GLsizei>(
+                                std::min(batchSize, triangleCount - first));
+
+            if (moveInstancePointers)
+                PointInstanceAttributes(first);
+
+            if (coreDrawInstanced)
+                glDrawArraysInstanced(GL_TRIANGLES, 0, 3, count);
+            else
+                glDrawArraysInstancedARB(GL_TRIANGLES, 0, 3, count);
+        }
+    }
+    else {
+        // generic attribute values are not part of the VAO, so we set
+        // them every time, in case someone else changed them.
+        glVertexAttrib4f(InstanceTransformLocation, 0.0f, 0.0f, 1.0f, 0.0f);
+        glVertexAttrib4f(InstanceColorLocation, 1.0f, 1.0f, 1.0f, 1.0f);
+
+        for (long long first = 0; first < triangleCount; first += batchSize) {
+            long long count = std::min(batchSize, triangleCount - first);
+
+            glDrawArrays(GL_TRIANGLES, static_cast<GLint>(first * 3),
+                         static_cast<GLsizei>(count * 3));
+        }
+    }
+
+    if (mode == ModeStreamed)
+        stream.EndFrame();
+}
+
+void TriangleBatch::Report(std::ostream &out) const
+{
+    if (mode == ModeStreamed)
+        stream.Report(out);
+
+    if (spinning && uploads > 0) {
+        out << "Copy data: " << triangleCount << " copies, "
+            << uploadedBytes / uploads / 1024 << " KB uploaded in one call "
+            << "a frame, " << DrawCalls() << " draw calls a frame ("
+            << (mode == ModeInstanced ? "instance attributes" :
+                                        ModeName(mode)) << ")" << std::endl;
+    }
+}
+
+void TriangleBatch::Destroy()
+{
+    stream.Destroy();
+
+    VAO.Reset();
+    vertexVBO.Reset();
+    instanceVBO.Reset();
+    objectBuffer.Reset();
+    objectTexture.Reset();
+    program.Reset();
+}
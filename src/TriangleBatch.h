@@ -0,0 +1,187 @@
+//============================================================================
+// Name        : TriangleBatch.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Draws many copies of our triangle, each with its own
+//               transform and color.
+//
+//               There are two ways we can do this:
+//               - Instanced: the triangle's three vertices are stored once,
+//                 and a second buffer holds one transform and one color
+//                 per copy.  glVertexAttribDivisor() tells OpenGL to step
+//                 through that buffer once per instance instead of once per
+//                 vertex, and glDrawArraysInstanced() draws them all.
+//                 This needs GL_ARB_instanced_arrays (core in 3.3) and
+//                 GL_ARB_draw_instanced (core in 3.1).
+//               - Merged: on plain OpenGL 2.1, we transform every copy on
+//                 the CPU, once, and merge them all into one big vertex
+//                 buffer, which we then draw with glDrawArrays().
+//
+//               - Streamed: like merged, but the copies spin, so we
+//                 generate them again on the CPU every frame, and upload
+//                 them through a StreamingBuffer.
+//               - Uniform buffer and texture buffer: the copies spin too,
+//                 but only their transforms and colors are generated
+//                 again, into one buffer, uploaded with one call a frame.
+//                 The shader reads copy gl_InstanceID's out of it, as a
+//                 uniform block, or with texelFetch() from a buffer
+//                 texture.  However many distinct copies there are, a
+//                 frame is the same handful of calls, instead of a
+//                 glUniform*() for every one.  Both need GLSL 1.40 (OpenGL
+//                 3.1).  Without it, the copies fall back to the instanced
+//                 path's per-instance vertex attributes, which work on GLSL
+//                 1.20, uploaded the same way, once a frame.  A uniform
+//                 block only holds ObjectsPerBlock copies, so with more
+//                 than that, each draw call binds the next range of the
+//                 buffer.
+//
+//               Either way, the copies are drawn in batches of a given
+//               size, one draw call per batch.  One big batch measures the
+//               vertex throughput, and lots of small batches measure the
+//               draw call overhead.
+//
+//============================================================================
+
+#ifndef TRIANGLE_BATCH_H
+#define TRIANGLE_BATCH_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <ostream>
+#include <vector>
+
+#include "GLHandle.h"
+#include "ProgramCache.h"
+#include "StreamingBuffer.h"
+#include "VertexLayout.h"
+
+class TriangleBatch {
+public:
+    enum Mode {
+        ModeAuto = 0,   // instanced if we can, merged if we can't
+        ModeInstanced,
+        ModeMerged,
+        ModeStreamed,   // merged, but animated and uploaded every frame
+        ModeUniformBuffer,  // per-copy data read from a uniform block
+        ModeTextureBuffer   // per-copy data read from a buffer texture
+    };
+
+    // copies in one uniform block, which fits the 16 KB every uniform
+    // buffer implementation allows
+    static const int ObjectsPerBlock = 512;
+
+    // per-copy data, shared by all the paths
+    struct Instance {
+        GLfloat transform[4];  // x offset, y offset, scale, rotation
+        GLfloat color[4];
+    };
+
+    // a vertex of the triangle, or of a merged or streamed copy
+    typedef ColorVertex Vertex;
+
+    TriangleBatch();
+
+    // Build the shader program and buffers for triangleCount copies of the
+    // triangle, laid out in a grid that fills the viewport.
+    // positions holds 9 floats (3 vertices), colors holds 9 floats
+    // (one RGB color per vertex), which are modulated by the color of
+    // each copy.  A batchSize of 0 means everything in one draw call.
+    // Must be called with a current context, after GLLoaderInit().
+    // The program is left building, for WaitProgram() to finish.
+    bool Create(ProgramCache &programCache,
+                const GLfloat positions[9], const GLfloat colors[9],
+                long long triangleCount, long long batchSize,
+                Mode requestedMode);
+
+    // True if WaitProgram() would not block (see ProgramCache::Ready())
+    bool ProgramReady(ProgramCache &programCache);
+
+    // Finish building the program, before the first Draw().  Returns
+    // false if it could not be built.
+    bool WaitProgram(ProgramCache &programCache);
+
+    void Draw();
+
+    // a paused streamed batch stops spinning, but is still uploaded
+    void SetPaused(bool value) { paused = value; }
+
+    // true if the next frame will look different from this one
+    bool Animated() const
+    {
+        return (mode == ModeStreamed || spinning) && !paused;
+    }
+
+    // upload statistics, for a streamed or spinning batch
+    void Report(std::ostream &out) const;
+
+    // must be called with the context still current
+    void Destroy();
+
+    Mode ActiveMode() const { return mode; }
+    long long TriangleCount() const { return triangleCount; }
+    long long DrawCalls() const;
+
+    static bool InstancingSupported();
+
+    // uniform and texture buffers, and GLSL 1.40 to read them with
+    static bool ObjectBuffersSupported();
+    static const char *ModeName(Mode mode);
+
+private:
+    TriangleBatch(const TriangleBatch &);
+    TriangleBatch &operator=(const TriangleBatch &);
+
+    int SubmitProgram(ProgramCache &programCache);
+    void CreateInstances(Instance *instances, long long first,
+                         long long count) const;
+    void SpinInstances(Instance *instances, long long first,
+                       long long count, double seconds) const;
+    double NextFrameSeconds();
+    void CreateTriangleBuffer(const GLfloat positions[9],
+                              const GLfloat colors[9]);
+    void CreateInstancedBuffers(const GLfloat positions[9],
+                                const GLfloat colors[9]);
+    bool CreateObjectBuffer(const GLfloat positions[9],
+                            const GLfloat colors[9]);
+    void BindObjectUniforms();
+    void UploadObjects();
+    void CreateMergedBuffer(const GLfloat positions[9],
+                            const GLfloat colors[9]);
+    bool CreateStreamedBuffer(const GLfloat positions[9],
+                              const GLfloat colors[9]);
+    bool StreamFrame();
+    void PointInstanceAttributes(long long firstInstance) const;
+
+    Mode mode;
+    long long triangleCount;
+    long long batchSize;
+    int gridColumns;
+
+    GLProgram program;
+    int programHandle;      // still building, or -1
+    GLVertexArray VAO;
+    GLBuffer vertexVBO;
+    GLBuffer instanceVBO;
+
+    StreamingBuffer stream;
+    GLfloat basePositions[9];
+    GLfloat baseColors[9];
+    long long animationFrames;
+    bool paused;
+
+    // The spinning copies' transforms and colors, generated again every
+    // frame, and uploaded to objectBuffer (or the instance buffer, if we
+    // fell back to attributes).  A uniform buffer has a block's worth of
+    // padding at the end, so that every range we bind is a full block.
+    bool spinning;
+    std::vector<Instance> objects;
+    GLBuffer objectBuffer;
+    GLTexture objectTexture;
+    GLint firstObjectLocation;
+    long long uploads;
+    long long uploadedBytes;
+};
+
+#endif // TRIANGLE_BATCH_H
@@ -0,0 +1,175 @@
+//============================================================================
+// Name        : VertexLayout.cpp
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Describes a vertex struct to OpenGL, and converts floats to
+//               the compact types we store in vertices.
+//
+//============================================================================
+
+#include <cstring>
+
+#include "VertexLayout.h"
+
+HalfFloat ToHalfFloat(GLfloat value)
+{
+    unsigned int bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    unsigned int sign = (bits >> 16) & 0x8000u;
+    int exponent = static_cast<int>((bits >> 23) & 0xFFu) - 127 + 15;
+    unsigned int mantissa = bits & 0x7FFFFFu;
+
+    HalfFloat half;
+
+    if (((bits >> 23) & 0xFFu) == 0xFFu) {
+        // infinity stays infinity, and NaN stays NaN
+        half.bits = static_cast<GLushort>(sign | 0x7C00u |
+                                          (mantissa != 0 ? 0x200u : 0u));
+    }
+    else if (exponent >= 31) {
+        // too big, so clamp to the largest half, 65504
+        half.bits = static_cast<GLushort>(sign | 0x7BFFu);
+    }
+    else if (exponent <= 0) {
+        // too small for a normal half, so it becomes a denormal, or zero
+        if (exponent < -10) {
+            half.bits = static_cast<GLushort>(sign);
+        }
+        else {
+            mantissa |= 0x800000u;
+            unsigned int shift = static_cast<unsigned int>(14 - exponent);
+            unsigned int rounded = mantissa >> shift;
+            unsigned int remainder = mantissa & ((1u << shift) - 1u);
+            unsigned int halfway = 1u << (shift - 1u);
+
+            // round to nearest, ties to even
+            if (remainder > halfway ||
+                (remainder == halfway && (rounded & 1u) != 0))
+                rounded++;
+
+            half.bits = static_cast<GLushort>(sign | rounded);
+        }
+    }
+    else {
+        unsigned int rounded = (static_cast<unsigned int>(exponent) << 10) |
+                               (mantissa >> 13);
+        unsigned int remainder = mantissa & 0x1FFFu;
+
+        // round to nearest, ties to even.  A carry out of the mantissa
+        // correctly bumps the exponent, and at the top, clamps below.
+        if (remainder > 0x1000u ||
+            (remainder == 0x1000u && (rounded & 1u) != 0))
+            rounded++;
+
+        if (rounded >= 0x7C00u)
+            rounded = 0x7BFFu;
+
+        half.bits = static_cast<GLushort>(sign | rounded);
+    }
+
+    return half;
+}
+
+GLfloat FromHalfFloat(HalfFloat value)
+{
+    unsigned int sign = (value.bits & 0x8000u) << 16;
+    unsigned int exponent = (value.bits >> 10) & 0x1Fu;
+    unsigned int mantissa = value.bits & 0x3FFu;
+    unsigned int bits;
+
+    if (exponent == 0x1Fu) {
+        // infinity or NaN
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    }
+    else if (exponent != 0) {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+    else if (mantissa == 0) {
+        bits = sign;
+    }
+    else {
+        // a denormal half is a normal float, once the mantissa is shifted
+        // up to its leading one
+        exponent = 127 - 15 + 1;
+        while ((mantissa & 0x400u) == 0) {
+            mantissa <<= 1;
+            exponent--;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+    }
+
+    GLfloat result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+UNorm8 ToUNorm8(GLfloat value)
+{
+    UNorm8 unorm;
+
+    // Note: written this way round, NaN becomes 0
+    if (!(value > 0.0f))
+        unorm.value = 0;
+    else if (value >= 1.0f)
+        unorm.value = 255;
+    else
+        unorm.value = static_cast<GLubyte>(value * 255.0f + 0.5f);
+
+    return unorm;
+}
+
+bool HalfFloatSupported()
+{
+    return GLL_VERSION_3_0 || GLL_ARB_half_float_vertex;
+}
+
+VertexFormat VertexFormat::ColorVertexFormat()
+{
+    static const VertexAttribute attributes[] = {
+        VERTEX_ATTRIBUTE(ColorVertex, position, 0, "position"),
+        VERTEX_ATTRIBUTE(ColorVertex, color, 1, "vertex_color")
+    };
+
+    return Of<ColorVertex>(attributes);
+}
+
+VertexFormat::VertexFormat(const VertexAttribute *attributes, int count,
+                           GLsizei stride)
+    : attributes(attributes),
+      count(count),
+      stride(stride)
+{
+}
+
+std::vector<AttributeBinding> VertexFormat::AttributeBindings() const
+{
+    std::vector<AttributeBinding> bindings;
+
+    for (int i = 0; i < count; i++) {
+        AttributeBinding binding = {attributes[i].location,
+                                    attributes[i].name};
+        bindings.push_back(binding);
+    }
+
+    return bindings;
+}
+
+void VertexFormat::EnableAttributes() const
+{
+    for (int i = 0; i < count; i++)
+        glEnableVertexAttribArray(attributes[i].location);
+}
+
+void VertexFormat::PointAttributes(GLintptr offset) const
+{
+    for (int i = 0; i < count; i++) {
+        const VertexAttribute &attribute = attributes[i];
+        size_t start = static_cast<size_t>(offset) + attribute.offset;
+
+        glVertexAttribPointer(attribute.location, attribute.components,
+                              attribute.type, attribute.normalized,
+                              stride, (GLvoid*)start);
+    }
+}
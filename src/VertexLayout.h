@@ -0,0 +1,175 @@
+//============================================================================
+// Name        : VertexLayout.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : Describes a vertex struct to OpenGL, so that we don't
+//               have to spell out every glVertexAttribPointer() by hand.
+//
+//               We used to keep each attribute in its own buffer, as
+//               three floats per vertex.  Interleaving them in one buffer
+//               means one bind instead of several, and the GPU reads each
+//               vertex from one place.  Smaller types help even more:
+//               a half float position and a normalized unsigned byte color
+//               fit in 12 bytes, where floats took 24.
+//
+//               The vertex is a plain struct, and the layout is an array
+//               of VERTEX_ATTRIBUTE() entries naming its members:
+//
+//                   struct PackedVertex {
+//                       HalfFloat position[4];
+//                       UNorm8 color[4];
+//                   };
+//
+//                   static const VertexAttribute packedAttributes[] = {
+//                       VERTEX_ATTRIBUTE(PackedVertex, position, 0,
+//                                        "position"),
+//                       VERTEX_ATTRIBUTE(PackedVertex, color, 1,
+//                                        "vertex_color")
+//                   };
+//
+//               The number of components, the GL type, whether it is
+//               normalized, and the offset all come from the member's
+//               declaration, at compile time, so they can't drift apart.
+//               A member of a type OpenGL can't read won't compile.
+//
+//============================================================================
+
+#ifndef VERTEX_LAYOUT_H
+#define VERTEX_LAYOUT_H
+
+// OpenGL, through our loader
+#include "GLLoader.h"
+
+#include <cstddef>
+#include <vector>
+
+#include "ProgramCache.h"
+
+// A 16 bit float, for GL_HALF_FLOAT attributes.  This needs OpenGL 3.0 or
+// GL_ARB_half_float_vertex; see HalfFloatSupported().
+struct HalfFloat {
+    GLushort bits;
+};
+
+// An unsigned byte that the shader sees as 0.0 to 1.0
+struct UNorm8 {
+    GLubyte value;
+};
+
+static_assert(sizeof(HalfFloat) == 2, "HalfFloat must be 16 bits");
+static_assert(sizeof(UNorm8) == 1, "UNorm8 must be 8 bits");
+
+// round to the nearest representable value, clamping to the type's range
+HalfFloat ToHalfFloat(GLfloat value);
+UNorm8 ToUNorm8(GLfloat value);
+
+// and back, exactly
+GLfloat FromHalfFloat(HalfFloat value);
+
+bool HalfFloatSupported();
+
+// How OpenGL reads one component of each type.
+// Only the types declared here can be used in a vertex struct.
+template <typename T> struct ComponentTraits;
+
+template <> struct ComponentTraits<GLfloat> {
+    static const GLenum Type = GL_FLOAT;
+    static const GLboolean Normalized = GL_FALSE;
+};
+
+template <> struct ComponentTraits<HalfFloat> {
+    static const GLenum Type = GL_HALF_FLOAT;
+    static const GLboolean Normalized = GL_FALSE;
+};
+
+template <> struct ComponentTraits<UNorm8> {
+    static const GLenum Type = GL_UNSIGNED_BYTE;
+    static const GLboolean Normalized = GL_TRUE;
+};
+
+// Each attribute is an array of one to four components
+template <typename T> struct AttributeTraits;
+
+template <typename T, size_t N> struct AttributeTraits<T[N]> {
+    static_assert(N >= 1 && N <= 4,
+                  "a vertex attribute has one to four components");
+
+    static const GLint Components = static_cast<GLint>(N);
+    static const GLenum Type = ComponentTraits<T>::Type;
+    static const GLboolean Normalized = ComponentTraits<T>::Normalized;
+};
+
+struct VertexAttribute {
+    GLuint location;
+    const char *name;
+    GLint components;
+    GLenum type;
+    GLboolean normalized;
+    size_t offset;
+};
+
+#define VERTEX_ATTRIBUTE(Vertex, member, location, name)                     \
+    { location, name,                                                        \
+      AttributeTraits<decltype(Vertex::member)>::Components,                 \
+      AttributeTraits<decltype(Vertex::member)>::Type,                       \
+      AttributeTraits<decltype(Vertex::member)>::Normalized,                 \
+      offsetof(Vertex, member) }
+
+// A full float position and a byte per color channel, 16 bytes in all.
+// The copies in a TriangleBatch and our generated meshes can be tiny, so
+// the positions stay floats, but the colors don't need more than a byte.
+struct ColorVertex {
+    GLfloat position[3];
+    UNorm8 color[4];
+};
+
+static_assert(sizeof(ColorVertex) == 16, "ColorVertex should be 16 bytes");
+
+class VertexFormat {
+public:
+    // The format of a Vertex struct, from its attribute array.
+    // The array must outlive the format.
+    template <typename Vertex, size_t N>
+    static VertexFormat Of(const VertexAttribute (&attributes)[N])
+    {
+        return VertexFormat(attributes, static_cast<int>(N),
+                            static_cast<GLsizei>(sizeof(Vertex)));
+    }
+
+    // A format that is only known at run time, like a mesh file's.
+    // The attributes must outlive the format.
+    static VertexFormat Of(const VertexAttribute *attributes, int count,
+                           GLsizei stride)
+    {
+        return VertexFormat(attributes, count, stride);
+    }
+
+    // The format of a ColorVertex, with the position at location 0 and
+    // the color at location 1
+    static VertexFormat ColorVertexFormat();
+
+    // the locations to bind before linking, for ProgramCache::Submit()
+    std::vector<AttributeBinding> AttributeBindings() const;
+
+    // Enable every attribute in the bound vertex array
+    void EnableAttributes() const;
+
+    // Point every attribute into the buffer bound to GL_ARRAY_BUFFER,
+    // with the first vertex starting offset bytes in.
+    void PointAttributes(GLintptr offset = 0) const;
+
+    GLsizei Stride() const { return stride; }
+    const VertexAttribute *Attributes() const { return attributes; }
+    int AttributeCount() const { return count; }
+
+private:
+    VertexFormat(const VertexAttribute *attributes, int count,
+                 GLsizei stride);
+
+    const VertexAttribute *attributes;
+    int count;
+    GLsizei stride;
+};
+
+#endif // VERTEX_LAYOUT_H
@@ -0,0 +1,146 @@
+//============================================================================
+// Name        : WorkStealingDeque.h
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : A fixed size, lock-free deque of work for one owner thread,
+//               that any other thread can steal from.
+//
+//               Each worker takes its own work from the bottom, newest
+//               first, and a worker that has run out steals from the top
+//               of somebody else's, oldest first, so the two ends only
+//               meet over the last item.  This is the Chase-Lev deque, with
+//               the memory orders of Le, Pop, Cohen and Zappa Nardelli's
+//               "Correct and Efficient Work-Stealing for Weak Memory
+//               Models" (2013): the owner's pop and a thief's steal only
+//               race with a compare and swap on the top when one item is
+//               left, and nobody ever locks.
+//
+//               The paper's deque grows.  Ours is given its capacity up
+//               front, since all of our work is known before we start, and
+//               Push() fails when it is full.  Only the owner may Push()
+//               and Pop(), and a thread that pushes before the workers are
+//               started counts as the owner, since starting a thread
+//               publishes everything done before it.
+//
+//               The indexes only ever count up, and wrap around the buffer,
+//               which is at least capacity long, with a mask, as in the
+//               SpscQueue.  T has to be something std::atomic can hold,
+//               like the index of a job.
+//
+//============================================================================
+
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "AlignedNew.h"
+
+// Note: top and bottom are cache line aligned, so new goes through
+//       AlignedNew
+template <typename T>
+class WorkStealingDeque : public AlignedNew<WorkStealingDeque<T> > {
+public:
+    explicit WorkStealingDeque(size_t capacity)
+        : top(0),
+          bottom(0),
+          size(1)
+    {
+        while (size < capacity)
+            size *= 2;
+
+        items.reset(new std::atomic<T>[size]);
+    }
+
+    // Owner only.  Returns false if the deque is full.
+    bool Push(const T &item)
+    {
+        long long b = bottom.load(std::memory_order_relaxed);
+        long long t = top.load(std::memory_order_acquire);
+
+        if (b - t >= static_cast<long long>(size))
+            return false;
+
+        items[b & (size - 1)].store(item, std::memory_order_relaxed);
+
+        // the item is in before a thief can see the new bottom
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Owner only.  Take the newest item, or return false if there is none.
+    bool Pop(T &item)
+    {
+        long long b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+
+        // Note: the owner's store to bottom and the load of top have to
+        //       stay in this order, or both ends could take the last item
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long long t = top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // it was empty already
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = items[b & (size - 1)].load(std::memory_order_relaxed);
+        if (t < b)
+            return true;
+
+        // the last one, which a thief may be after too
+        bool won = top.compare_exchange_strong(t, t + 1,
+                                               std::memory_order_seq_cst,
+                                               std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    // Any other thread.  Take the oldest item, or return false if there is
+    // none.  A steal that loses a race for an item tries for the next one,
+    // so false really means empty.
+    bool Steal(T &item)
+    {
+        for (;;) {
+            long long t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            long long b = bottom.load(std::memory_order_acquire);
+
+            if (t >= b)
+                return false;
+
+            item = items[t & (size - 1)].load(std::memory_order_relaxed);
+            if (top.compare_exchange_strong(t, t + 1,
+                                            std::memory_order_seq_cst,
+                                            std::memory_order_relaxed))
+                return true;
+        }
+    }
+
+    // Any thread, but only a hint, unless the workers are stopped
+    size_t Size() const
+    {
+        long long b = bottom.load(std::memory_order_relaxed);
+        long long t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+private:
+    WorkStealingDeque(const WorkStealingDeque &);
+    WorkStealingDeque &operator=(const WorkStealingDeque &);
+
+    // Thieves move the top, and the owner the bottom, so they are kept on
+    // separate cache lines.
+    alignas(64) std::atomic<long long> top;
+    alignas(64) std::atomic<long long> bottom;
+
+    size_t size;
+    std::unique_ptr<std::atomic<T>[]> items;
+};
+
+#endif // WORK_STEALING_DEQUE_H
@@ -0,0 +1,273 @@
+#!/usr/bin/env python3
+#============================================================================
+# Name        : GenerateGLFunctions.py
+# Author      : James L. Makela
+# Version     : 0.1.1
+# Copyright   : LGPL v3.0
+# Description : Writes src/GLFunctions.h and src/GLFunctions.cpp, for
+#               GLLoader, with the OpenGL functions, versions and
+#               extensions that our sources use.
+#
+#               Every gl*() call in src that glext.h has a prototype for
+#               gets a pointer, a lazy stub, and a macro.  The rest are
+#               OpenGL 1.1, which we link against.  Every GLL_VERSION_x_y
+#               and GLL_<vendor>_<extension> gets a flag.
+#
+#               Run it from the top of the tree after calling something
+#               new:
+#                   python3 tools/GenerateGLFunctions.py
+#
+#============================================================================
+
+import argparse
+import os
+import re
+import sys
+
+HEADER = """\
+//============================================================================
+// Name        : {name}
+// Author      : James L. Makela
+// Version     : 0.1.1
+// Copyright   : LGPL v3.0
+// Description : The OpenGL functions, versions and extensions we use.
+//
+//               Written by tools/GenerateGLFunctions.py, from our sources
+//               and glext.h, so don't edit it.  See GLLoader.h.
+//
+//============================================================================
+"""
+
+# what generates, or is generated, doesn't count as a use
+SKIPPED = {"GLFunctions.h", "GLFunctions.cpp", "GLLoader.cpp"}
+
+PROTOTYPE = re.compile(
+    r"^GLAPI\s+(.+?)\s*APIENTRY\s+(gl\w+)\s*\((.*)\);", re.MULTILINE)
+COMMENT_OR_STRING = re.compile(
+    r'//[^\n]*|/\*.*?\*/|"(?:\\.|[^"\\])*"|\'(?:\\.|[^\'\\])*\'', re.DOTALL)
+FUNCTION_USE = re.compile(r"\b(gl[A-Z]\w*)\b")
+VERSION_USE = re.compile(r"\bGLL_VERSION_(\d+)_(\d+)\b")
+EXTENSION_USE = re.compile(r"\bGLL_((?!VERSION_)[A-Z0-9]+_\w+)\b")
+
+WIDTH = 79
+
+
+def ReadPrototypes(path):
+    with open(path) as header:
+        text = header.read()
+
+    prototypes = {}
+    for match in PROTOTYPE.finditer(text):
+        result, name, params = match.groups()
+        params = [p.strip() for p in params.split(",")]
+        if params == ["void"]:
+            params = []
+        prototypes[name] = (result.strip(), params)
+
+    return text, prototypes
+
+
+def ScanSources(directory):
+    functions = set()
+    versions = set()
+    extensions = set()
+
+    for name in sorted(os.listdir(directory)):
+        if not name.endswith((".h", ".cpp")) or name in SKIPPED:
+            continue
+
+        with open(os.path.join(directory, name)) as source:
+            code = COMMENT_OR_STRING.sub(" ", source.read())
+
+        functions.update(FUNCTION_USE.findall(code))
+        versions.update((int(major), int(minor))
+                        for major, minor in VERSION_USE.findall(code))
+        extensions.update(EXTENSION_USE.findall(code))
+
+    return functions, versions, extensions
+
+
+def ParamName(param):
+    return re.search(r"(\w+)\s*$", param).group(1)
+
+
+def Wrap(start, items, end, indent):
+    """start + items, comma separated, + end, broken to fit WIDTH"""
+    lines = []
+    line = start
+    for i, item in enumerate(items):
+        piece = item + ("," if i + 1 < len(items) else end)
+        if line != start and line[-1] != "(" and \
+                len(line) + 1 + len(piece) > WIDTH:
+            lines.append(line)
+            line = indent + piece
+        else:
+            line += ("" if line.endswith("(") else " ") + piece
+    if not items:
+        line += end
+    lines.append(line)
+    return "\n".join(lines)
+
+
+def Cast(target, name, indent):
+    """target = the function, looked up"""
+    cast = "reinterpret_cast<GLLPROC_%s>(" % name
+    resolve = "GLLoaderResolve(\"%s\"));" % name
+    line = "%s%s = %s" % (indent, target, cast)
+    if len(line) <= WIDTH:
+        return "%s\n%s    %s" % (line, indent, resolve)
+    return "%s%s =\n%s    %s\n%s        %s" % (indent, target, indent, cast,
+                                             indent, resolve)
+
+
+def Define(name):
+    """the pointer, starting out at its stub"""
+    line = "GLLPROC_%s gll_%s = Lazy_%s;" % (name, name, name)
+    if len(line) <= WIDTH:
+        return line
+    return "GLLPROC_%s gll_%s =\n    Lazy_%s;" % (name, name, name)
+
+
+def WriteHeader(path, functions, versions, extensions):
+    out = [HEADER.format(name="GLFunctions.h"), """
+#ifndef GL_FUNCTIONS_H
+#define GL_FUNCTIONS_H
+
+// for GLLoader.cpp
+struct GLLoaderVersionFlag {
+    int major;
+    int minor;
+    bool *supported;
+};
+
+struct GLLoaderExtensionFlag {
+    const char *name;
+    bool *supported;
+};
+
+extern const GLLoaderVersionFlag GLLoaderVersions[];
+extern const int GLLoaderVersionCount;
+extern const GLLoaderExtensionFlag GLLoaderExtensions[];
+extern const int GLLoaderExtensionCount;
+extern const int GLLoaderFunctionCount;
+
+// look up every function now, rather than on its first call
+void GLLoaderResolveAll();
+
+// the versions we check for, set by GLLoaderInit()
+"""]
+
+    for major, minor in versions:
+        out.append("extern bool GLL_VERSION_%d_%d;\n" % (major, minor))
+
+    out.append("\n// the extensions we check for\n")
+    for extension in extensions:
+        out.append("extern bool GLL_%s;\n" % extension)
+
+    out.append("\n// the functions we call\n")
+    for name, (result, params) in functions:
+        start = "typedef %s (APIENTRYP GLLPROC_%s)(" % (result, name)
+        out.append(Wrap(start, params or ["void"], ");", "    ") + "\n")
+        out.append("extern GLLPROC_%s gll_%s;\n" % (name, name))
+        out.append("#define %s gll_%s\n\n" % (name, name))
+
+    out.append("#endif // GL_FUNCTIONS_H\n")
+
+    with open(path, "w") as header:
+        header.write("".join(out))
+
+
+def WriteSource(path, functions, versions, extensions):
+    out = [HEADER.format(name="GLFunctions.cpp"),
+           "\n#include \"GLLoader.h\"\n\n"]
+
+    for major, minor in versions:
+        out.append("bool GLL_VERSION_%d_%d = false;\n" % (major, minor))
+    for extension in extensions:
+        out.append("bool GLL_%s = false;\n" % extension)
+
+    out.append("\nconst GLLoaderVersionFlag GLLoaderVersions[] = {\n")
+    for major, minor in versions or [(0, 0)]:
+        flag = "&GLL_VERSION_%d_%d" % (major, minor) if versions \
+               else "nullptr"
+        out.append("    {%d, %d, %s},\n" % (major, minor, flag))
+    out.append("};\n\nconst int GLLoaderVersionCount = %d;\n" %
+               len(versions))
+
+    out.append("\nconst GLLoaderExtensionFlag GLLoaderExtensions[] = {\n")
+    for extension in extensions:
+        out.append("    {\"GL_%s\", &GLL_%s},\n" % (extension, extension))
+    if not extensions:
+        out.append("    {\"\", nullptr},\n")
+    out.append("};\n\nconst int GLLoaderExtensionCount = %d;\n" %
+               len(extensions))
+
+    out.append("\nconst int GLLoaderFunctionCount = %d;\n" % len(functions))
+
+    out.append("\n// Each pointer starts out at a stub that looks the "
+               "function up, keeps it,\n// and passes the call on.\n")
+    for name, (result, params) in functions:
+        names = [ParamName(p) for p in params]
+        out.append("\n")
+        out.append(Wrap("static %s APIENTRY Lazy_%s(" % (result, name),
+                        params, ")", "    ") + "\n")
+        out.append("{\n")
+        out.append(Cast("gll_" + name, name, "    ") + "\n")
+        call = "%sgll_%s(" % ("" if result == "void" else "return ", name)
+        out.append(Wrap("    " + call, names, ");", "        ") + "\n")
+        out.append("}\n\n")
+        out.append(Define(name) + "\n")
+
+    out.append("\nvoid GLLoaderResolveAll()\n{\n")
+    for name, _ in functions:
+        out.append(Cast("gll_" + name, name, "    ") + "\n")
+    out.append("}\n")
+
+    with open(path, "w") as source:
+        source.write("".join(out))
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+    parser = argparse.ArgumentParser(
+        description="Writes src/GLFunctions.h and src/GLFunctions.cpp")
+    parser.add_argument("--glext", default="/usr/include/GL/glext.h",
+                        help="the glext.h to take prototypes from")
+    parser.add_argument("--src", default=os.path.join(root, "src"),
+                        help="the sources to scan, and write to")
+    args = parser.parse_args()
+
+    glext, prototypes = ReadPrototypes(args.glext)
+    used, versions, extensions = ScanSources(args.src)
+
+    functions = sorted((name, prototypes[name]) for name in used
+                       if name in prototypes)
+    versions = sorted(versions)
+    extensions = sorted(extensions)
+
+    failed = False
+    for major, minor in versions:
+        if "#ifndef GL_VERSION_%d_%d\n" % (major, minor) not in glext:
+            print("unknown version GLL_VERSION_%d_%d" % (major, minor),
+                  file=sys.stderr)
+            failed = True
+    for extension in extensions:
+        if "#ifndef GL_%s\n" % extension not in glext:
+            print("unknown extension GLL_%s" % extension, file=sys.stderr)
+            failed = True
+    if failed:
+        return 1
+
+    WriteHeader(os.path.join(args.src, "GLFunctions.h"), functions,
+                versions, extensions)
+    WriteSource(os.path.join(args.src, "GLFunctions.cpp"), functions,
+                versions, extensions)
+
+    print("%d functions, %d versions, %d extensions" %
+          (len(functions), len(versions), len(extensions)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())